@@ -25,6 +25,7 @@
 
 #include <unistd.h>
 #include <stdint.h>
+#include <sys/uio.h>
 #include <vector>
 #include <map>
 #include <string>
@@ -231,6 +232,41 @@ int AioRead(int fd, CurveAioContext* aioctx);
  */
 int AioWrite(int fd, CurveAioContext* aioctx);
 
+/**
+ * 向量化异步模式读，数据按顺序读入iov描述的多段buffer，不经过中间buffer拷贝
+ * @param: fd为当前open返回的文件描述符
+ * @param: aioctx为异步读写的io上下文，offset和length描述读取范围，buf不使用
+ * @param: iov为用户buffer数组，长度之和需要等于aioctx->length，
+ *         iov数组和buffer在回调之前需要保持有效
+ * @param: iovcnt为iov的个数
+ * @return: 成功返回 0,否则-LIBCURVE_ERROR::FAILED
+ */
+int AioReadv(int fd, CurveAioContext* aioctx,
+             const struct iovec* iov, int iovcnt);
+
+/**
+ * 向量化异步模式写，iov描述的多段buffer按顺序拼接后写入，不经过中间buffer拷贝
+ * @param: fd为当前open返回的文件描述符
+ * @param: aioctx为异步读写的io上下文，offset和length描述写入范围，buf不使用
+ * @param: iov为用户buffer数组，长度之和需要等于aioctx->length，
+ *         iov数组和buffer在回调之前需要保持有效
+ * @param: iovcnt为iov的个数
+ * @return: 成功返回 0,否则-LIBCURVE_ERROR::FAILED
+ */
+int AioWritev(int fd, CurveAioContext* aioctx,
+              const struct iovec* iov, int iovcnt);
+
+/**
+ * 批量提交异步读写，类似io_submit，读写类型由各自的aioctx->op决定，
+ * 整批只进行一次提交和调度入队，每个io仍然通过各自的回调返回
+ * 任意一个io参数非法时整批都不提交，length为0的io直接跳过且不会回调
+ * @param: fd为当前open返回的文件描述符
+ * @param: ctxs为异步io上下文数组，数组本身在返回后可以释放
+ * @param: n为ctxs的个数
+ * @return: 成功返回 0,否则-LIBCURVE_ERROR::FAILED等
+ */
+int AioSubmitBatch(int fd, CurveAioContext* ctxs[], int n);
+
 /**
  * 重命名文件
  * @param: userinfo是用户信息
@@ -375,6 +411,10 @@ int GetClusterId(char* buf, int len);
 }
 #endif
 
+namespace butil {
+class IOBuf;
+}  // namespace butil
+
 namespace curve {
 namespace client {
 
@@ -473,6 +513,47 @@ class CurveClient {
      */
     virtual int AioWrite(int fd, CurveAioContext* aioctx);
 
+    /**
+     * 向量化异步读
+     * @param fd 文件fd
+     * @param aioctx 异步读写的io上下文，buf不使用
+     * @param iov 用户buffer数组，回调之前需要保持有效
+     * @param iovcnt iov的个数
+     * @return 返回错误码
+     */
+    virtual int AioReadv(int fd, CurveAioContext* aioctx,
+                         const struct iovec* iov, int iovcnt);
+
+    /**
+     * 向量化异步写
+     * @param fd 文件fd
+     * @param aioctx 异步读写的io上下文，buf不使用
+     * @param iov 用户buffer数组，回调之前需要保持有效
+     * @param iovcnt iov的个数
+     * @return 返回错误码
+     */
+    virtual int AioWritev(int fd, CurveAioContext* aioctx,
+                          const struct iovec* iov, int iovcnt);
+
+    /**
+     * 异步读，数据不拷贝到用户buffer，直接以IOBuf的形式返回
+     * @param fd 文件fd
+     * @param aioctx 异步读写的io上下文，buf不使用
+     * @param data 读取数据的出参，成功回调之前追加读到的数据，回调之前需要保持有效
+     * @return 返回错误码
+     */
+    virtual int AioReadIOBuf(int fd, CurveAioContext* aioctx,
+                             butil::IOBuf* data);
+
+    /**
+     * 批量提交异步读写
+     * @param fd 文件fd
+     * @param ctxs 异步读写的io上下文数组
+     * @param n ctxs的个数
+     * @return 返回错误码
+     */
+    virtual int AioSubmitBatch(int fd, CurveAioContext* ctxs[], int n);
+
     /**
      * 测试使用，设置fileclient
      * @param client 需要设置的fileclient
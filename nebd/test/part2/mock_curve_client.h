@@ -43,6 +43,12 @@ class MockCurveClient : public ::curve::client::CurveClient {
     MOCK_METHOD1(StatFile, int64_t(const std::string&));
     MOCK_METHOD2(AioRead, int(int, CurveAioContext*));
     MOCK_METHOD2(AioWrite, int(int, CurveAioContext*));
+    MOCK_METHOD4(AioReadv, int(int, CurveAioContext*,
+                               const struct iovec*, int));
+    MOCK_METHOD4(AioWritev, int(int, CurveAioContext*,
+                                const struct iovec*, int));
+    MOCK_METHOD3(AioReadIOBuf, int(int, CurveAioContext*, butil::IOBuf*));
+    MOCK_METHOD3(AioSubmitBatch, int(int, CurveAioContext**, int));
 };
 
 }  // namespace server
@@ -42,7 +42,8 @@ namespace chunkserver {
 ChunkServiceImpl::ChunkServiceImpl(ChunkServiceOptions chunkServiceOptions) :
     chunkServiceOptions_(chunkServiceOptions),
     copysetNodeManager_(chunkServiceOptions.copysetNodeManager),
-    inflightThrottle_(chunkServiceOptions.inflightThrottle) {
+    inflightThrottle_(chunkServiceOptions.inflightThrottle),
+    qosThrottle_(chunkServiceOptions.qosThrottle) {
     maxChunkSize_ = copysetNodeManager_->GetCopysetNodeOptions().maxChunkSize;
 }
 
@@ -124,6 +125,20 @@ void ChunkServiceImpl::WriteChunk(RpcController *controller,
         return;
     }
 
+    // 数据在网络传输中被破坏，返回CRC_FAIL让client重试
+    if (!WriteChunkRequest::CheckDataCrc(*request,
+                                         cntl->request_attachment())) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_CRC_FAIL);
+        LOG(ERROR) << "write chunk failed, crc mismatch: "
+                   << request->logicpoolid() << ","
+                   << request->copysetid()
+                   << " chunkid: " << request->chunkid()
+                   << " offset: " << request->offset()
+                   << " size: " << request->size()
+                   << " remote side: " << cntl->remote_side();
+        return;
+    }
+
     // 判断copyset是否存在
     auto nodePtr = copysetNodeManager_->GetCopysetNode(request->logicpoolid(),
                                                        request->copysetid());
@@ -134,6 +149,12 @@ void ChunkServiceImpl::WriteChunk(RpcController *controller,
         return;
     }
 
+    // QoS限流，超出copyset或卷限额的请求在这里排队等待，
+    // 需要排队的时间超过上限时返回OVERLOAD，让client退避重试
+    if (!ThrottleIO(request, response)) {
+        return;
+    }
+
     std::shared_ptr<WriteChunkRequest>
         req = std::make_shared<WriteChunkRequest>(nodePtr,
                                                   controller,
@@ -243,6 +264,12 @@ void ChunkServiceImpl::ReadChunk(RpcController *controller,
         return;
     }
 
+    // QoS限流，超出copyset或卷限额的请求在这里排队等待，
+    // 需要排队的时间超过上限时返回OVERLOAD，让client退避重试
+    if (!ThrottleIO(request, response)) {
+        return;
+    }
+
     std::shared_ptr<ReadChunkRequest> req =
         std::make_shared<ReadChunkRequest>(nodePtr,
                                            chunkServiceOptions_.cloneManager,
@@ -294,6 +321,12 @@ void ChunkServiceImpl::RecoverChunk(RpcController *controller,
         return;
     }
 
+    // QoS限流，超出copyset或卷限额的请求在这里排队等待，
+    // 需要排队的时间超过上限时返回OVERLOAD，让client退避重试
+    if (!ThrottleIO(request, response)) {
+        return;
+    }
+
     // RecoverChunk请求和ReadChunk请求共用ReadChunkRequest
     std::shared_ptr<ReadChunkRequest> req =
         std::make_shared<ReadChunkRequest>(nodePtr,
@@ -448,6 +481,14 @@ void ChunkServiceImpl::GetChunkInfo(RpcController *controller,
         return;
     }
 
+    // datastore还没加载时无法判断chunk是否存在，让client稍后重试
+    if (!nodePtr->IsActivated()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN);
+        LOG(WARNING) << "GetChunkInfo failed, copyset node is not activated: "
+                     << request->logicpoolid() << "," << request->copysetid();
+        return;
+    }
+
     CSErrorCode ret;
     CSChunkInfo chunkInfo;
 
@@ -505,6 +546,14 @@ void ChunkServiceImpl::GetChunkHash(RpcController *controller,
         return;
     }
 
+    // datastore还没加载时无法判断chunk是否存在，让调用方稍后重试
+    if (!nodePtr->IsActivated()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN);
+        LOG(WARNING) << "GetChunkHash failed, copyset node is not activated: "
+                     << request->logicpoolid() << "," << request->copysetid();
+        return;
+    }
+
     CSErrorCode ret;
     std::string hash;
 
@@ -534,6 +583,26 @@ void ChunkServiceImpl::GetChunkHash(RpcController *controller,
     }
 }
 
+bool ChunkServiceImpl::ThrottleIO(const ChunkRequest *request,
+                                  ChunkResponse *response) {
+    if (nullptr == qosThrottle_ || !qosThrottle_->Enabled()) {
+        return true;
+    }
+    if (qosThrottle_->Throttle(request->logicpoolid(),
+                               request->copysetid(),
+                               request->fileid(),
+                               request->size())) {
+        return true;
+    }
+
+    response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_OVERLOAD);
+    LOG_EVERY_N(WARNING, 100)
+        << "request is rejected by qos throttle, copyset: "
+        << ToGroupIdString(request->logicpoolid(), request->copysetid())
+        << ", file id: " << request->fileid();
+    return false;
+}
+
 bool ChunkServiceImpl::CheckRequestOffsetAndLength(uint32_t offset,
                                                    uint32_t len) {
     // 检查offset+len是否越界
@@ -100,10 +100,19 @@ class ChunkServiceImpl : public ChunkService {
      */
     bool CheckRequestOffsetAndLength(uint32_t offset, uint32_t len);
 
+    /**
+     * 对读写请求进行QoS限流，超过限额时在当前bthread中等待
+     * @param request[in]: op request
+     * @param response[out]: 请求被拒绝时设置为CHUNK_OP_STATUS_OVERLOAD
+     * @return 请求可以下发返回true，排队时间超过上限需要拒绝时返回false
+     */
+    bool ThrottleIO(const ChunkRequest *request, ChunkResponse *response);
+
  private:
     ChunkServiceOptions chunkServiceOptions_;
     CopysetNodeManager  *copysetNodeManager_;
     std::shared_ptr<InflightThrottle> inflightThrottle_;
+    std::shared_ptr<QosThrottle> qosThrottle_;
     uint32_t            maxChunkSize_;
 };
 
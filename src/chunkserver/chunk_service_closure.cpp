@@ -149,6 +149,19 @@ void ChunkServiceClosure::OnResonse() {
         default:
             break;
     }
+
+    // 被采样的读写请求记录各阶段的耗时
+    if (trace_.Started()) {
+        trace_.Mark(kOpStageResponded);
+        CSIOMetricType type =
+            request_->optype() == CHUNK_OP_TYPE::CHUNK_OP_READ ?
+            CSIOMetricType::READ_CHUNK : CSIOMetricType::WRITE_CHUNK;
+        metric->OnTrace(request_->logicpoolid(),
+                        request_->copysetid(),
+                        type,
+                        trace_);
+        OpTracer::GetInstance()->OnFinish(*request_, *response_, trace_);
+    }
 }
 
 }  // namespace chunkserver
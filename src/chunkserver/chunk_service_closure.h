@@ -29,6 +29,7 @@
 #include "proto/chunk.pb.h"
 #include "src/chunkserver/op_request.h"
 #include "src/chunkserver/inflight_throttle.h"
+#include "src/chunkserver/op_trace.h"
 #include "src/common/timeutility.h"
 
 namespace curve {
@@ -53,6 +54,13 @@ class ChunkServiceClosure : public braft::Closure {
             }
             // 统计请求数量
             OnRequest();
+            // 采样读写请求各阶段的耗时
+            if (request_ != nullptr &&
+                (request_->optype() == CHUNK_OP_TYPE::CHUNK_OP_READ ||
+                 request_->optype() == CHUNK_OP_TYPE::CHUNK_OP_WRITE) &&
+                OpTracer::GetInstance()->ShouldSample()) {
+                trace_.Mark(kOpStageReceived);
+            }
         }
 
     ~ChunkServiceClosure() = default;
@@ -64,6 +72,14 @@ class ChunkServiceClosure : public braft::Closure {
      */
     void Run() override;
 
+    /**
+     * 获取请求的阶段耗时记录
+     * @return 请求没有被采样时返回nullptr
+     */
+    OpTrace* GetTrace() {
+        return trace_.Started() ? &trace_ : nullptr;
+    }
+
  private:
     /**
      * 统计请求数量和速率
@@ -85,6 +101,8 @@ class ChunkServiceClosure : public braft::Closure {
     google::protobuf::Closure *brpcDone_;
     // 接受到请求的时间
     uint64_t receivedTimeUs_;
+    // 请求各阶段的时间，只有被采样的请求才会记录
+    OpTrace trace_;
 };
 
 }  // namespace chunkserver
@@ -36,11 +36,15 @@
 #include "src/chunkserver/chunk_service.h"
 #include "src/chunkserver/braft_cli_service.h"
 #include "src/chunkserver/braft_cli_service2.h"
+#include "src/chunkserver/integrity_service.h"
 #include "src/chunkserver/chunkserver_helper.h"
 #include "src/chunkserver/uri_paser.h"
+#include "src/chunkserver/replay_scheduler.h"
 #include "src/chunkserver/raftsnapshot/curve_snapshot_attachment.h"
 #include "src/chunkserver/raftsnapshot/curve_file_service.h"
 #include "src/chunkserver/raftsnapshot/curve_snapshot_storage.h"
+#include "src/chunkserver/raftlog/curve_segment_log_storage.h"
+#include "src/chunkserver/raftlog/shared_log_storage.h"
 #include "src/common/curve_version.h"
 
 using ::curve::fs::LocalFileSystem;
@@ -105,6 +109,10 @@ int ChunkServer::Run(int argc, char** argv) {
     ChunkServerMetric* metric = ChunkServerMetric::GetInstance();
     LOG_IF(FATAL, metric->Init(metricOptions) != 0)
         << "Failed to init chunkserver metric.";
+    // 请求阶段耗时采样需要在创建copyset metric之前初始化
+    OpTracerOptions tracerOptions;
+    InitOpTracerOptions(&conf, &tracerOptions);
+    OpTracer::GetInstance()->Init(tracerOptions);
 
     // 初始化并发持久模块
     ConcurrentApplyModule concurrentapply;
@@ -132,6 +140,23 @@ int ChunkServer::Run(int argc, char** argv) {
     LOG_IF(FATAL, false == chunkfilePool->Initialize(chunkFilePoolOptions))
         << "Failed to init chunk file pool";
 
+    // 初始化wal文件池，默认与chunk文件池共用同一个池子
+    bool walUseChunkFilePool = true;
+    if (!conf.GetBoolValue("walfilepool.use_chunk_file_pool",
+                           &walUseChunkFilePool)) {
+        LOG(WARNING) << "walfilepool.use_chunk_file_pool not found, "
+                     << "use chunk file pool as wal file pool";
+        walUseChunkFilePool = true;
+    }
+    std::shared_ptr<ChunkfilePool> walFilePool = chunkfilePool;
+    if (!walUseChunkFilePool) {
+        ChunkfilePoolOptions walFilePoolOptions;
+        InitWalFilePoolOptions(&conf, &walFilePoolOptions);
+        walFilePool = std::make_shared<ChunkfilePool>(fs);
+        LOG_IF(FATAL, false == walFilePool->Initialize(walFilePoolOptions))
+            << "Failed to init wal file pool";
+    }
+
     // 远端拷贝管理模块选项
     CopyerOptions copyerOptions;
     InitCopyerOptions(&conf, &copyerOptions);
@@ -146,8 +171,13 @@ int ChunkServer::Run(int argc, char** argv) {
     LOG_IF(FATAL, !conf.GetUInt32Value("clone.slice_size", &sliceSize));
     bool enablePaste = false;
     LOG_IF(FATAL, !conf.GetBoolValue("clone.enable_paste", &enablePaste));
-    cloneOptions.core =
-        std::make_shared<CloneCore>(sliceSize, enablePaste, copyer);
+    bool pasteByLocation = false;
+    if (!conf.GetBoolValue("clone.paste_by_location", &pasteByLocation)) {
+        LOG(WARNING) << "clone.paste_by_location not found, "
+                     << "use default value " << pasteByLocation;
+    }
+    cloneOptions.core = std::make_shared<CloneCore>(
+        sliceSize, enablePaste, copyer, pasteByLocation);
     LOG_IF(FATAL, cloneManager_.Init(cloneOptions) != 0)
         << "Failed to initialize clone manager.";
 
@@ -179,6 +209,7 @@ int ChunkServer::Run(int argc, char** argv) {
     InitTrashOptions(&conf, &trashOptions);
     trashOptions.localFileSystem = fs;
     trashOptions.chunkfilePool = chunkfilePool;
+    trashOptions.walPool = walFilePool;
     trash_ = std::make_shared<Trash>();
     LOG_IF(FATAL, trash_->Init(trashOptions) != 0)
         << "Failed to init Trash";
@@ -190,6 +221,7 @@ int ChunkServer::Run(int argc, char** argv) {
     copysetNodeOptions.chunkfilePool = chunkfilePool;
     copysetNodeOptions.localFileSystem = fs;
     copysetNodeOptions.trash = trash_;
+    copysetNodeOptions.copyer = copyer;
 
     // install snapshot的带宽限制
     int snapshotThroughputBytes;
@@ -222,6 +254,29 @@ int ChunkServer::Run(int argc, char** argv) {
     }
     // 注册curve snapshot storage
     RegisterCurveSnapshotStorageOrDie();
+    // 注册curve log storage，copyset.raft_log_uri配置为curve://时生效
+    RegisterCurveSegmentLogStorageOrDie(walFilePool);
+    // copyset.raft_log_uri配置为shared://时，盘上所有copyset共享同一个日志
+    if (UriParser::GetProtocolFromUri(copysetNodeOptions.logUri)
+        == kSharedLogStorageProtocol) {
+        SharedLogOptions sharedLogOptions;
+        InitSharedLogOptions(&conf, &sharedLogOptions);
+        sharedLogOptions.copysetsDir =
+            UriParser::GetPathFromUri(copysetNodeOptions.chunkDataUri);
+        sharedLog_ = std::make_shared<SharedLog>(sharedLogOptions);
+        LOG_IF(FATAL, sharedLog_->Init() != 0)
+            << "Failed to init shared log.";
+        RegisterSharedLogStorageOrDie(sharedLog_.get());
+    }
+
+    // qos throttle，copyset删除时需要清理限流状态，先于copyset manager创建
+    QosOptions qosOptions;
+    InitQosOptions(&conf, &qosOptions);
+    std::shared_ptr<QosThrottle> qosThrottle
+        = std::make_shared<QosThrottle>(qosOptions);
+    CHECK(nullptr != qosThrottle) << "new qos throttle failed";
+    copysetNodeOptions.qosThrottle = qosThrottle;
+
     CurveSnapshotStorage::set_server_addr(endPoint);
     copysetNodeManager_ = &CopysetNodeManager::GetInstance();
     LOG_IF(FATAL, copysetNodeManager_->Init(copysetNodeOptions) != 0)
@@ -237,9 +292,32 @@ int ChunkServer::Run(int argc, char** argv) {
     LOG_IF(FATAL, heartbeat_.Init(heartbeatOptions) != 0)
         << "Failed to init Heartbeat manager.";
 
+    // 后台数据扫描模块初始化
+    ScrubOptions scrubOptions;
+    InitScrubOptions(&conf, &scrubOptions);
+    scrubOptions.copysetNodeManager = copysetNodeManager_;
+    scrubOptions.localFileSystem = fs;
+    scrubManager_ = std::make_shared<ScrubManager>();
+    LOG_IF(FATAL, scrubManager_->Init(scrubOptions) != 0)
+        << "Failed to init scrub manager.";
+
+    // clone chunk后台回填模块初始化
+    HydratorOptions hydratorOptions;
+    InitHydratorOptions(&conf, &hydratorOptions);
+    hydratorOptions.sliceSize = sliceSize;
+    hydratorOptions.copysetNodeManager = copysetNodeManager_;
+    hydratorOptions.cloneManager = &cloneManager_;
+    hydratorOptions.localFileSystem = fs;
+    hydrator_ = std::make_shared<CloneHydrator>();
+    LOG_IF(FATAL, hydrator_->Init(hydratorOptions) != 0)
+        << "Failed to init clone hydrator.";
+
     // 监控部分模块的metric指标
     metric->MonitorTrash(trash_.get());
     metric->MonitorChunkFilePool(chunkfilePool.get());
+    if (!walUseChunkFilePool) {
+        metric->MonitorWalFilePool(walFilePool.get());
+    }
     metric->ExposeConfigMetric(&conf);
 
     // ========================添加rpc服务===============================//
@@ -266,6 +344,7 @@ int ChunkServer::Run(int argc, char** argv) {
     chunkServiceOptions.copysetNodeManager = copysetNodeManager_;
     chunkServiceOptions.cloneManager = &cloneManager_;
     chunkServiceOptions.inflightThrottle = inflightThrottle;
+    chunkServiceOptions.qosThrottle = qosThrottle;
     ChunkServiceImpl chunkService(chunkServiceOptions);
     ret = server.AddService(&chunkService,
                         brpc::SERVER_DOESNT_OWN_SERVICE);
@@ -302,11 +381,18 @@ int ChunkServer::Run(int argc, char** argv) {
     CHECK(0 == ret) << "Fail to add FileService";
 
     // chunkserver service
-    ChunkServerServiceImpl chunkserverService(copysetNodeManager_);
+    ChunkServerServiceImpl chunkserverService(copysetNodeManager_,
+                                              qosThrottle);
     ret = server.AddService(&chunkserverService,
         brpc::SERVER_DOESNT_OWN_SERVICE);
     CHECK(0 == ret) << "Fail to add ChunkServerService";
 
+    // integrity service
+    IntegrityServiceImpl integrityService(scrubManager_.get());
+    ret = server.AddService(&integrityService,
+        brpc::SERVER_DOESNT_OWN_SERVICE);
+    CHECK(0 == ret) << "Fail to add IntegrityService";
+
     // 启动rpc service
     LOG(INFO) << "RPC server is going to serve on: "
               << copysetNodeOptions.ip << ":" << copysetNodeOptions.port;
@@ -323,17 +409,29 @@ int ChunkServer::Run(int argc, char** argv) {
      */
     LOG_IF(FATAL, trash_->Run() != 0)
         << "Failed to start trash.";
+    if (sharedLog_ != nullptr) {
+        LOG_IF(FATAL, sharedLog_->Run() != 0)
+            << "Failed to start shared log.";
+    }
     LOG_IF(FATAL, cloneManager_.Run() != 0)
         << "Failed to start clone manager.";
     LOG_IF(FATAL, heartbeat_.Run() != 0)
         << "Failed to start heartbeat manager.";
     LOG_IF(FATAL, copysetNodeManager_->Run() != 0)
         << "Failed to start CopysetNodeManager.";
+    LOG_IF(FATAL, scrubManager_->Run() != 0)
+        << "Failed to start scrub manager.";
+    LOG_IF(FATAL, hydrator_->Run() != 0)
+        << "Failed to start clone hydrator.";
 
     // =======================等待进程退出==================================//
     server.RunUntilAskedToQuit();
 
     LOG(INFO) << "ChunkServer is going to quit.";
+    LOG_IF(ERROR, scrubManager_->Fini() != 0)
+        << "Failed to shutdown scrub manager.";
+    LOG_IF(ERROR, hydrator_->Fini() != 0)
+        << "Failed to shutdown clone hydrator.";
     LOG_IF(ERROR, heartbeat_.Fini() != 0)
         << "Failed to shutdown heartbeat manager.";
     LOG_IF(ERROR, copysetNodeManager_->Fini() != 0)
@@ -344,6 +442,10 @@ int ChunkServer::Run(int argc, char** argv) {
         << "Failed to shutdown clone copyer.";
     LOG_IF(ERROR, trash_->Fini() != 0)
         << "Failed to shutdown trash.";
+    if (sharedLog_ != nullptr) {
+        LOG_IF(ERROR, sharedLog_->Fini() != 0)
+            << "Failed to shutdown shared log.";
+    }
     concurrentapply.Stop();
 
     google::ShutdownGoogleLogging();
@@ -382,6 +484,75 @@ void ChunkServer::InitChunkFilePoolOptions(
     }
 }
 
+void ChunkServer::InitWalFilePoolOptions(
+    common::Configuration *conf, ChunkfilePoolOptions *walPoolOptions) {
+    // wal文件池的配置为可选项，没有配置时使用默认值
+    uint32_t segmentSize = 8 * 1024 * 1024;
+    if (!conf->GetUInt32Value("walfilepool.segment_size", &segmentSize)) {
+        LOG(WARNING) << "walfilepool.segment_size not found, use default "
+                     << segmentSize;
+    }
+    walPoolOptions->chunkSize = segmentSize;
+    uint32_t metaPageSize = 4096;
+    if (!conf->GetUInt32Value("walfilepool.metapage_size", &metaPageSize)) {
+        LOG(WARNING) << "walfilepool.metapage_size not found, use default "
+                     << metaPageSize;
+    }
+    walPoolOptions->metaPageSize = metaPageSize;
+    if (!conf->GetUInt32Value("walfilepool.meta_file_size",
+                              &walPoolOptions->cpMetaFileSize)) {
+        LOG(WARNING) << "walfilepool.meta_file_size not found, use default "
+                     << walPoolOptions->cpMetaFileSize;
+    }
+    if (!conf->GetBoolValue("walfilepool.enable_get_segment_from_pool",
+                            &walPoolOptions->getChunkFromPool)) {
+        LOG(WARNING) << "walfilepool.enable_get_segment_from_pool not found, "
+                     << "use default " << walPoolOptions->getChunkFromPool;
+    }
+
+    if (walPoolOptions->getChunkFromPool == false) {
+        std::string walFilePoolUri;
+        LOG_IF(FATAL, !conf->GetStringValue(
+            "walfilepool.file_pool_dir", &walFilePoolUri));
+        ::memcpy(walPoolOptions->chunkFilePoolDir,
+                 walFilePoolUri.c_str(),
+                 walFilePoolUri.size());
+    } else {
+        std::string metaUri;
+        LOG_IF(FATAL, !conf->GetStringValue(
+            "walfilepool.meta_path", &metaUri));
+        ::memcpy(
+            walPoolOptions->metaPath, metaUri.c_str(), metaUri.size());
+    }
+}
+
+void ChunkServer::InitSharedLogOptions(
+    common::Configuration *conf, SharedLogOptions *sharedLogOptions) {
+    LOG_IF(FATAL, !conf->GetStringValue(
+        "sharedlog.dir", &sharedLogOptions->path));
+    // 以下为可选项，没有配置时使用默认值
+    if (!conf->GetUInt64Value("sharedlog.segment_size",
+                              &sharedLogOptions->segmentSize)) {
+        LOG(WARNING) << "sharedlog.segment_size not found, use default "
+                     << sharedLogOptions->segmentSize;
+    }
+    if (!conf->GetUInt32Value("sharedlog.max_batch_size",
+                              &sharedLogOptions->maxBatchSize)) {
+        LOG(WARNING) << "sharedlog.max_batch_size not found, use default "
+                     << sharedLogOptions->maxBatchSize;
+    }
+    if (!conf->GetUInt32Value("sharedlog.max_segments",
+                              &sharedLogOptions->maxSegments)) {
+        LOG(WARNING) << "sharedlog.max_segments not found, use default "
+                     << sharedLogOptions->maxSegments;
+    }
+    if (!conf->GetUInt32Value("sharedlog.compact_interval_ms",
+                              &sharedLogOptions->compactIntervalMs)) {
+        LOG(WARNING) << "sharedlog.compact_interval_ms not found, "
+                     << "use default " << sharedLogOptions->compactIntervalMs;
+    }
+}
+
 void ChunkServer::InitCopysetNodeOptions(
     common::Configuration *conf, CopysetNodeOptions *copysetNodeOptions) {
     LOG_IF(FATAL, !conf->GetStringValue("global.ip", &copysetNodeOptions->ip));
@@ -420,6 +591,55 @@ void ChunkServer::InitCopysetNodeOptions(
         &copysetNodeOptions->finishLoadMargin));
     LOG_IF(FATAL, !conf->GetUInt32Value("copyset.check_loadmargin_interval_ms",
         &copysetNodeOptions->checkLoadMarginIntervalMs));
+    // 延迟激活和加载提示为可选项，没有配置时保持原来的加载方式
+    if (!conf->GetBoolValue("copyset.lazy_activate",
+        &copysetNodeOptions->lazyActivate)) {
+        LOG(WARNING) << "copyset.lazy_activate not found, use default "
+                     << copysetNodeOptions->lazyActivate;
+    }
+    if (!conf->GetStringValue("copyset.load_hint_path",
+        &copysetNodeOptions->loadHintPath)) {
+        LOG(WARNING) << "copyset.load_hint_path not found, "
+                     << "copyset load hint is disabled";
+    }
+    if (!conf->GetUInt32Value("copyset.load_hint_interval_s",
+        &copysetNodeOptions->loadHintIntervalS)) {
+        LOG(WARNING) << "copyset.load_hint_interval_s not found, "
+                     << "use default " << copysetNodeOptions->loadHintIntervalS;
+    }
+    if (copysetNodeOptions->loadHintIntervalS == 0) {
+        LOG(FATAL) << "Invalid copyset.load_hint_interval_s, "
+                   << "should be positive";
+    }
+    if (!conf->GetUInt32Value("copyset.fetch_clone_data_retry_times",
+        &copysetNodeOptions->fetchCloneDataRetryTimes)) {
+        LOG(WARNING) << "copyset.fetch_clone_data_retry_times not found, "
+                     << "use default "
+                     << copysetNodeOptions->fetchCloneDataRetryTimes;
+    }
+    if (!conf->GetUInt32Value("copyset.fetch_clone_data_retry_interval_ms",
+        &copysetNodeOptions->fetchCloneDataRetryIntervalMs)) {
+        LOG(WARNING) << "copyset.fetch_clone_data_retry_interval_ms not found, "
+                     << "use default "
+                     << copysetNodeOptions->fetchCloneDataRetryIntervalMs;
+    }
+    // 同时回放日志的copyset数量，为0表示不限制
+    uint32_t replayConcurrency = 0;
+    if (!conf->GetUInt32Value("copyset.replay_concurrency",
+        &replayConcurrency)) {
+        LOG(WARNING) << "copyset.replay_concurrency not found, "
+                     << "replay concurrency is unlimited";
+    }
+    if (replayConcurrency > 0) {
+        copysetNodeOptions->replayScheduler =
+            std::make_shared<ReplayScheduler>(replayConcurrency);
+    }
+    if (!conf->GetUInt32Value("copyset.applied_index_sync_interval",
+        &copysetNodeOptions->appliedIndexSyncInterval)) {
+        LOG(WARNING) << "copyset.applied_index_sync_interval not found, "
+                     << "use default "
+                     << copysetNodeOptions->appliedIndexSyncInterval;
+    }
 }
 
 void ChunkServer::InitCopyerOptions(
@@ -450,6 +670,37 @@ void ChunkServer::InitCopyerOptions(
     } else {
         copyerOptions->s3Client = std::make_shared<S3Adapter>();
     }
+
+    // 克隆源数据缓存为可选项，没有配置时不开启
+    if (!conf->GetUInt32Value("clone.cache_extent_size",
+        &copyerOptions->cacheExtentSize)) {
+        LOG(WARNING) << "clone.cache_extent_size not found, "
+                     << "clone source cache is disabled";
+        copyerOptions->cacheExtentSize = 0;
+    }
+    uint64_t cacheCapacityMB = 0;
+    if (!conf->GetUInt64Value("clone.cache_capacity_mb", &cacheCapacityMB)) {
+        LOG(WARNING) << "clone.cache_capacity_mb not found, use default value "
+                     << cacheCapacityMB;
+    }
+    copyerOptions->cacheCapacity = cacheCapacityMB * 1024 * 1024;
+    if (!conf->GetUInt32Value("clone.curve_client_num",
+        &copyerOptions->curveClientNum)) {
+        LOG(WARNING) << "clone.curve_client_num not found, use default value "
+                     << copyerOptions->curveClientNum;
+    }
+    if (!conf->GetUInt32Value("clone.origin_handle_shards",
+        &copyerOptions->handleShardNum)) {
+        LOG(WARNING) << "clone.origin_handle_shards not found, "
+                     << "use default value " << copyerOptions->handleShardNum;
+    }
+    if (!conf->GetUInt32Value("clone.max_opened_origin_files",
+        &copyerOptions->maxOpenedFiles)) {
+        LOG(WARNING) << "clone.max_opened_origin_files not found, "
+                     << "use default value " << copyerOptions->maxOpenedFiles;
+    }
+    LOG_IF(FATAL, !conf->GetUInt32Value("global.chunk_size",
+        &copyerOptions->chunkSize));
 }
 
 void ChunkServer::InitCloneOptions(
@@ -515,6 +766,115 @@ void ChunkServer::InitMetricOptions(
         "metric.onoff", &metricOptions->collectMetric));
 }
 
+void ChunkServer::InitOpTracerOptions(
+    common::Configuration *conf, OpTracerOptions *tracerOptions) {
+    if (!conf->GetUInt32Value("trace.sample_interval",
+        &tracerOptions->sampleInterval)) {
+        LOG(WARNING) << "trace.sample_interval not found, "
+                     << "use default value " << tracerOptions->sampleInterval;
+    }
+    if (!conf->GetUInt64Value("trace.slow_request_us",
+        &tracerOptions->slowRequestUs)) {
+        LOG(WARNING) << "trace.slow_request_us not found, "
+                     << "use default value " << tracerOptions->slowRequestUs;
+    }
+    if (!conf->GetUInt32Value("trace.slow_request_num",
+        &tracerOptions->slowRequestNum)) {
+        LOG(WARNING) << "trace.slow_request_num not found, "
+                     << "use default value " << tracerOptions->slowRequestNum;
+    }
+}
+
+void ChunkServer::InitQosOptions(
+    common::Configuration *conf, QosOptions *qosOptions) {
+    // QoS相关配置项为可选项，没有配置时使用默认值(不限流)
+    if (!conf->GetBoolValue("qos.enable", &qosOptions->enable)) {
+        LOG(WARNING) << "qos.enable not found, qos is disabled";
+        qosOptions->enable = false;
+        return;
+    }
+
+    auto getValue = [conf](const std::string &key, uint64_t *value) {
+        if (!conf->GetUInt64Value(key, value)) {
+            LOG(WARNING) << key << " not found, use default value "
+                         << *value;
+        }
+    };
+    getValue("qos.copyset_iops_limit", &qosOptions->copysetLimit.iopsLimit);
+    getValue("qos.copyset_iops_burst", &qosOptions->copysetLimit.iopsBurst);
+    getValue("qos.copyset_bps_limit", &qosOptions->copysetLimit.bpsLimit);
+    getValue("qos.copyset_bps_burst", &qosOptions->copysetLimit.bpsBurst);
+    getValue("qos.file_iops_limit", &qosOptions->fileLimit.iopsLimit);
+    getValue("qos.file_iops_burst", &qosOptions->fileLimit.iopsBurst);
+    getValue("qos.file_bps_limit", &qosOptions->fileLimit.bpsLimit);
+    getValue("qos.file_bps_burst", &qosOptions->fileLimit.bpsBurst);
+    getValue("qos.max_wait_us", &qosOptions->maxWaitUs);
+    getValue("qos.file_bucket_idle_s", &qosOptions->fileBucketIdleS);
+}
+
+void ChunkServer::InitScrubOptions(
+    common::Configuration *conf, ScrubOptions *scrubOptions) {
+    // 扫描相关配置项为可选项，没有配置时不开启扫描
+    if (!conf->GetBoolValue("scrub.enable", &scrubOptions->enable)) {
+        LOG(WARNING) << "scrub.enable not found, scrub is disabled";
+        scrubOptions->enable = false;
+    }
+
+    uint64_t bandwidthMBps = scrubOptions->bandwidthBytes / 1024 / 1024;
+    if (!conf->GetUInt64Value("scrub.bandwidth_mbps", &bandwidthMBps)) {
+        LOG(WARNING) << "scrub.bandwidth_mbps not found, use default value "
+                     << bandwidthMBps;
+    }
+    scrubOptions->bandwidthBytes = bandwidthMBps * 1024 * 1024;
+    if (!conf->GetUInt32Value("scrub.read_size", &scrubOptions->readSize)) {
+        LOG(WARNING) << "scrub.read_size not found, use default value "
+                     << scrubOptions->readSize;
+    }
+    if (!conf->GetUInt64Value("scrub.pause_iops", &scrubOptions->pauseIops)) {
+        LOG(WARNING) << "scrub.pause_iops not found, use default value "
+                     << scrubOptions->pauseIops;
+    }
+    if (!conf->GetBoolValue("scrub.compare_replicas",
+                            &scrubOptions->compareReplicas)) {
+        LOG(WARNING) << "scrub.compare_replicas not found, use default value "
+                     << scrubOptions->compareReplicas;
+    }
+    if (!conf->GetUInt32Value("scrub.auto_interval_s",
+                              &scrubOptions->autoIntervalS)) {
+        LOG(WARNING) << "scrub.auto_interval_s not found, use default value "
+                     << scrubOptions->autoIntervalS;
+    }
+}
+
+void ChunkServer::InitHydratorOptions(
+    common::Configuration *conf, HydratorOptions *hydratorOptions) {
+    // 回填相关配置项为可选项，没有配置时不开启回填
+    if (!conf->GetBoolValue("clone.hydrate_enable",
+                            &hydratorOptions->enable)) {
+        LOG(WARNING) << "clone.hydrate_enable not found, "
+                     << "hydrate is disabled";
+        hydratorOptions->enable = false;
+    }
+
+    uint64_t bandwidthMBps = hydratorOptions->bandwidthBytes / 1024 / 1024;
+    if (!conf->GetUInt64Value("clone.hydrate_bandwidth_mbps",
+                              &bandwidthMBps)) {
+        LOG(WARNING) << "clone.hydrate_bandwidth_mbps not found, "
+                     << "use default value " << bandwidthMBps;
+    }
+    hydratorOptions->bandwidthBytes = bandwidthMBps * 1024 * 1024;
+    if (!conf->GetUInt64Value("clone.hydrate_pause_iops",
+                              &hydratorOptions->pauseIops)) {
+        LOG(WARNING) << "clone.hydrate_pause_iops not found, "
+                     << "use default value " << hydratorOptions->pauseIops;
+    }
+    if (!conf->GetUInt32Value("clone.hydrate_scan_interval_s",
+                              &hydratorOptions->scanIntervalS)) {
+        LOG(WARNING) << "clone.hydrate_scan_interval_s not found, "
+                     << "use default value " << hydratorOptions->scanIntervalS;
+    }
+}
+
 void ChunkServer::LoadConfigFromCmdline(common::Configuration *conf) {
     // 如果命令行有设置, 命令行覆盖配置文件中的字段
     google::CommandLineFlagInfo info;
@@ -29,9 +29,13 @@
 #include "src/chunkserver/copyset_node_manager.h"
 #include "src/chunkserver/heartbeat.h"
 #include "src/chunkserver/clone_manager.h"
+#include "src/chunkserver/clone_hydrator.h"
 #include "src/chunkserver/register.h"
 #include "src/chunkserver/trash.h"
 #include "src/chunkserver/chunkserver_metrics.h"
+#include "src/chunkserver/op_trace.h"
+#include "src/chunkserver/raftlog/shared_log.h"
+#include "src/chunkserver/scrub_manager.h"
 
 namespace curve {
 namespace chunkserver {
@@ -56,6 +60,12 @@ class ChunkServer {
     void InitChunkFilePoolOptions(common::Configuration *conf,
         ChunkfilePoolOptions *chunkFilePoolOptions);
 
+    void InitWalFilePoolOptions(common::Configuration *conf,
+        ChunkfilePoolOptions *walPoolOptions);
+
+    void InitSharedLogOptions(common::Configuration *conf,
+        SharedLogOptions *sharedLogOptions);
+
     void InitCopysetNodeOptions(common::Configuration *conf,
         CopysetNodeOptions *copysetNodeOptions);
 
@@ -77,6 +87,18 @@ class ChunkServer {
     void InitMetricOptions(common::Configuration *conf,
         ChunkServerMetricOptions *metricOptions);
 
+    void InitQosOptions(common::Configuration *conf,
+        QosOptions *qosOptions);
+
+    void InitScrubOptions(common::Configuration *conf,
+        ScrubOptions *scrubOptions);
+
+    void InitHydratorOptions(common::Configuration *conf,
+        HydratorOptions *hydratorOptions);
+
+    void InitOpTracerOptions(common::Configuration *conf,
+        OpTracerOptions *tracerOptions);
+
     void LoadConfigFromCmdline(common::Configuration *conf);
 
     int GetChunkServerMetaFromLocal(const std::string &storeUri,
@@ -102,6 +124,15 @@ class ChunkServer {
 
     // install snapshot流控
     scoped_refptr<SnapshotThrottle> snapshotThrottle_;
+
+    // 盘上所有copyset共享的raft日志，raft_log_uri为shared://时才会创建
+    std::shared_ptr<SharedLog> sharedLog_;
+
+    // scrubManager_ 后台扫描copyset的数据，检查坏盘和副本不一致
+    std::shared_ptr<ScrubManager> scrubManager_;
+
+    // hydrator_ 后台将clone chunk未写过的数据从源端拷贝到本地
+    std::shared_ptr<CloneHydrator> hydrator_;
 };
 
 }  // namespace chunkserver
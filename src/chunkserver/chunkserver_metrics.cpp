@@ -200,9 +200,63 @@ int CSCopysetMetric::Init(const LogicPoolID& logicPoolId,
                    << " metric failed.";
         return -1;
     }
+    throttleLatency_ = std::make_shared<bvar::LatencyRecorder>();
+    if (throttleLatency_->expose(Prefix(), "qos_throttle") != 0) {
+        LOG(ERROR) << "Init Copyset ("
+                   << logicPoolId << "," << copysetId << ")"
+                   << " qos throttle metric failed.";
+        return -1;
+    }
+
+    replayRemaining_ = std::make_shared<bvar::Status<int64_t>>(
+        Prefix(), "replay_remaining", 0);
+    replayedCount_ = std::make_shared<bvar::Adder<uint64_t>>(
+        Prefix(), "replay_applied");
+    replaySkippedCount_ = std::make_shared<bvar::Adder<uint64_t>>(
+        Prefix(), "replay_skipped");
+    replayThroughput_ =
+        std::make_shared<bvar::PerSecond<bvar::Adder<uint64_t>>>(
+            Prefix(), "replay_applied_per_second", replayedCount_.get());
+
+    // 没有开启采样时不创建各阶段的统计项，避免copyset较多时占用内存
+    if (!OpTracer::GetInstance()->Enabled()) {
+        return 0;
+    }
+    readStageLatency_.resize(kOpStageNum);
+    writeStageLatency_.resize(kOpStageNum);
+    for (int stage = kOpStageThrottled; stage < kOpStageNum; ++stage) {
+        std::string name = OpStageName(static_cast<OpStage>(stage));
+        readStageLatency_[stage] = std::make_shared<bvar::LatencyRecorder>();
+        writeStageLatency_[stage] = std::make_shared<bvar::LatencyRecorder>();
+        if (readStageLatency_[stage]->expose(Prefix(), "read_" + name) != 0 ||
+            writeStageLatency_[stage]->expose(Prefix(), "write_" + name) != 0) {
+            LOG(ERROR) << "Init Copyset ("
+                       << logicPoolId << "," << copysetId << ")"
+                       << " stage latency metric failed.";
+            return -1;
+        }
+    }
     return 0;
 }
 
+void CSCopysetMetric::OnTrace(CSIOMetricType type, const OpTrace& trace) {
+    std::vector<std::shared_ptr<bvar::LatencyRecorder>>* recorders = nullptr;
+    if (type == CSIOMetricType::READ_CHUNK) {
+        recorders = &readStageLatency_;
+    } else if (type == CSIOMetricType::WRITE_CHUNK) {
+        recorders = &writeStageLatency_;
+    }
+    if (recorders == nullptr || recorders->empty()) {
+        return;
+    }
+    for (int stage = kOpStageThrottled; stage < kOpStageNum; ++stage) {
+        int64_t latency = trace.StageLatency(static_cast<OpStage>(stage));
+        if (latency >= 0) {
+            *(*recorders)[stage] << latency;
+        }
+    }
+}
+
 void CSCopysetMetric::MonitorDataStore(CSDataStore* datastore) {
     std::string chunkCountPrefix = Prefix() + "_chunk_count";
     std::string snapshotCountPrefix = Prefix() + "snapshot_count";
@@ -213,16 +267,21 @@ void CSCopysetMetric::MonitorDataStore(CSDataStore* datastore) {
         snapshotCountPrefix, GetDatastoreSnapshotCountFunc, datastore);
     cloneChunkCount_ = std::make_shared<bvar::PassiveStatus<uint32_t>>(
         cloneChunkCountPrefix, GetDatastoreCloneChunkCountFunc, datastore);
+    if (datastore->GetMetric() != nullptr) {
+        datastore->GetMetric()->cowLatency.expose(Prefix(), "write_cow");
+    }
 }
 
 ChunkServerMetric::ChunkServerMetric()
     : hasInited_(false)
     , leaderCount_(nullptr)
     , chunkLeft_(nullptr)
+    , walLeft_(nullptr)
     , chunkTrashed_(nullptr)
     , chunkCount_(nullptr)
     , snapshotCount_(nullptr)
-    , cloneChunkCount_(nullptr) {}
+    , cloneChunkCount_(nullptr)
+    , throttleLatency_(nullptr) {}
 
 ChunkServerMetric* ChunkServerMetric::self_ = nullptr;
 
@@ -271,6 +330,12 @@ int ChunkServerMetric::Init(const ChunkServerMetricOptions& option) {
     cloneChunkCount_ = std::make_shared<bvar::PassiveStatus<uint32_t>>(
         cloneChunkCountPrefix, GetTotalCloneChunkCountFunc, this);
 
+    throttleLatency_ = std::make_shared<bvar::LatencyRecorder>();
+    if (throttleLatency_->expose(Prefix(), "qos_throttle") != 0) {
+        LOG(ERROR) << "Init chunkserver qos throttle metric failed.";
+        return -1;
+    }
+
     hasInited_ = true;
     LOG(INFO) << "Init chunkserver metric success.";
     return 0;
@@ -281,10 +346,12 @@ int ChunkServerMetric::Fini() {
     ioMetrics_.Fini();
     leaderCount_ = nullptr;
     chunkLeft_ = nullptr;
+    walLeft_ = nullptr;
     chunkTrashed_ = nullptr;
     chunkCount_ = nullptr;
     snapshotCount_ = nullptr;
     cloneChunkCount_ = nullptr;
+    throttleLatency_ = nullptr;
     copysetMetricMap_.Clear();
     hasInited_ = false;
     return 0;
@@ -369,6 +436,49 @@ void ChunkServerMetric::OnResponse(const LogicPoolID& logicPoolId,
     ioMetrics_.OnResponse(type, size, latUs, hasError);
 }
 
+void ChunkServerMetric::OnThrottle(const LogicPoolID& logicPoolId,
+                                   const CopysetID& copysetId,
+                                   int64_t waitUs) {
+    if (!option_.collectMetric) {
+        return;
+    }
+
+    CopysetMetricPtr cpMetric = GetCopysetMetric(logicPoolId, copysetId);
+    if (cpMetric != nullptr) {
+        cpMetric->OnThrottle(waitUs);
+    }
+    if (throttleLatency_ != nullptr) {
+        *throttleLatency_ << waitUs;
+    }
+}
+
+void ChunkServerMetric::OnTrace(const LogicPoolID& logicPoolId,
+                                const CopysetID& copysetId,
+                                CSIOMetricType type,
+                                const OpTrace& trace) {
+    if (!option_.collectMetric) {
+        return;
+    }
+
+    CopysetMetricPtr cpMetric = GetCopysetMetric(logicPoolId, copysetId);
+    if (cpMetric != nullptr) {
+        cpMetric->OnTrace(type, trace);
+    }
+}
+
+uint64_t ChunkServerMetric::GetForegroundIops() {
+    uint64_t iops = 0;
+    IOMetricPtr readMetric = GetIOMetric(CSIOMetricType::READ_CHUNK);
+    if (readMetric != nullptr) {
+        iops += readMetric->rps_.get_value();
+    }
+    IOMetricPtr writeMetric = GetIOMetric(CSIOMetricType::WRITE_CHUNK);
+    if (writeMetric != nullptr) {
+        iops += writeMetric->rps_.get_value();
+    }
+    return iops;
+}
+
 void ChunkServerMetric::MonitorChunkFilePool(ChunkfilePool* chunkfilePool) {
     if (!option_.collectMetric) {
         return;
@@ -379,6 +489,16 @@ void ChunkServerMetric::MonitorChunkFilePool(ChunkfilePool* chunkfilePool) {
         chunkLeftPrefix, GetChunkLeftFunc, chunkfilePool);
 }
 
+void ChunkServerMetric::MonitorWalFilePool(ChunkfilePool* walFilePool) {
+    if (!option_.collectMetric) {
+        return;
+    }
+
+    std::string walLeftPrefix = Prefix() + "_walfilepool_left";
+    walLeft_ = std::make_shared<bvar::PassiveStatus<uint32_t>>(
+        walLeftPrefix, GetChunkLeftFunc, walFilePool);
+}
+
 void ChunkServerMetric::MonitorTrash(Trash* trash) {
     if (!option_.collectMetric) {
         return;
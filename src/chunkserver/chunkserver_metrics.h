@@ -34,6 +34,7 @@
 #include "src/common/uncopyable.h"
 #include "src/common/concurrent/rw_lock.h"
 #include "src/common/configuration.h"
+#include "src/chunkserver/op_trace.h"
 
 using curve::common::Uncopyable;
 using curve::common::RWLock;
@@ -183,7 +184,12 @@ class CSCopysetMetric {
         , copysetId_(0)
         , chunkCount_(nullptr)
         , snapshotCount_(nullptr)
-        , cloneChunkCount_(nullptr) {}
+        , cloneChunkCount_(nullptr)
+        , throttleLatency_(nullptr)
+        , replayRemaining_(nullptr)
+        , replayedCount_(nullptr)
+        , replaySkippedCount_(nullptr)
+        , replayThroughput_(nullptr) {}
 
     ~CSCopysetMetric() {}
 
@@ -233,6 +239,68 @@ class CSCopysetMetric {
         return ioMetrics_.GetIOMetric(type);
     }
 
+    /**
+     * 记录被采样请求各阶段的耗时，只统计读写请求
+     * @param type: 请求对应的metric类型
+     * @param trace: 请求各阶段的时间
+     */
+    void OnTrace(CSIOMetricType type, const OpTrace& trace);
+
+    /**
+     * 回放一批重启前的raft日志后记录metric
+     * @param replayed: 实际apply的日志数量
+     * @param skipped: chunk上已经执行过而跳过的日志数量
+     * @param remaining: 剩余需要回放的日志数量
+     */
+    void OnReplay(uint32_t replayed, uint32_t skipped, int64_t remaining) {
+        if (replayRemaining_ == nullptr) {
+            return;
+        }
+        *replayedCount_ << replayed;
+        *replaySkippedCount_ << skipped;
+        replayRemaining_->set_value(remaining);
+    }
+
+    /**
+     * 剩余需要回放的日志数量
+     */
+    const int64_t GetReplayRemaining() const {
+        if (replayRemaining_ == nullptr) {
+            return 0;
+        }
+        return replayRemaining_->get_value();
+    }
+
+    /**
+     * 请求被QoS限流时记录metric
+     * @param waitUs: 请求排队等待的时间
+     */
+    void OnThrottle(int64_t waitUs) {
+        if (throttleLatency_ != nullptr) {
+            *throttleLatency_ << waitUs;
+        }
+    }
+
+    /**
+     * 获取最近1秒被限流的请求数量
+     */
+    const uint32_t GetThrottledIOPS() const {
+        if (throttleLatency_ == nullptr) {
+            return 0;
+        }
+        return throttleLatency_->qps(1);
+    }
+
+    /**
+     * 获取最近1秒被限流请求的平均等待时间
+     */
+    const uint64_t GetThrottleWaitUs() const {
+        if (throttleLatency_ == nullptr) {
+            return 0;
+        }
+        return throttleLatency_->latency(1);
+    }
+
     const uint32_t GetChunkCount() const {
         if (chunkCount_ == nullptr) {
             return 0;
@@ -273,6 +341,18 @@ class CSCopysetMetric {
     PassiveStatusPtr<uint32_t> snapshotCount_;
     // copyset上的 clone chunk 的数量
     PassiveStatusPtr<uint32_t> cloneChunkCount_;
+    // copyset上被QoS限流的请求及其等待时间
+    std::shared_ptr<bvar::LatencyRecorder> throttleLatency_;
+    // 重启后剩余需要回放的日志数量
+    std::shared_ptr<bvar::Status<int64_t>> replayRemaining_;
+    // 重启后已经回放的日志数量，包括apply的和跳过的
+    AdderPtr<uint64_t> replayedCount_;
+    AdderPtr<uint64_t> replaySkippedCount_;
+    // 每秒apply的日志数量
+    std::shared_ptr<bvar::PerSecond<bvar::Adder<uint64_t>>> replayThroughput_;
+    // 被采样的读写请求在各阶段的耗时，按照OpStage索引，开启采样时才会创建
+    std::vector<std::shared_ptr<bvar::LatencyRecorder>> readStageLatency_;
+    std::vector<std::shared_ptr<bvar::LatencyRecorder>> writeStageLatency_;
     // copyset上的IO类型的metric统计
     CSIOMetric ioMetrics_;
 };
@@ -392,6 +472,28 @@ class ChunkServerMetric : public Uncopyable {
                     int64_t latUs,
                     bool hasError);
 
+    /**
+     * 请求被QoS限流时记录metric
+     * @param logicPoolId: 此次io操作所在的逻辑池id
+     * @param copysetId: 此次io操作所在的copysetid
+     * @param waitUs: 请求排队等待的时间
+     */
+    void OnThrottle(const LogicPoolID& logicPoolId,
+                    const CopysetID& copysetId,
+                    int64_t waitUs);
+
+    /**
+     * 记录被采样请求各阶段的耗时
+     * @param logicPoolId: 此次io操作所在的逻辑池id
+     * @param copysetId: 此次io操作所在的copysetid
+     * @param type: 请求类型
+     * @param trace: 请求各阶段的时间
+     */
+    void OnTrace(const LogicPoolID& logicPoolId,
+                 const CopysetID& copysetId,
+                 CSIOMetricType type,
+                 const OpTrace& trace);
+
     /**
      * 创建指定copyset的metric
      * 如果collectMetric为false，返回0，但实际并不会创建
@@ -426,6 +528,12 @@ class ChunkServerMetric : public Uncopyable {
      */
     void MonitorChunkFilePool(ChunkfilePool* chunkfilePool);
 
+    /**
+     * 监视wal文件池，仅在wal文件池没有与chunk文件池共用时需要
+     * @param walFilePool: wal文件池的对象指针
+     */
+    void MonitorWalFilePool(ChunkfilePool* walFilePool);
+
     /**
      * 监视回收站
      * @param trash: trash的对象指针
@@ -457,6 +565,11 @@ class ChunkServerMetric : public Uncopyable {
         return ioMetrics_.GetIOMetric(type);
     }
 
+    /**
+     * 获取前台读写chunk请求的rps之和，后台任务据此判断是否需要让出磁盘
+     */
+    uint64_t GetForegroundIops();
+
     CopysetMetricMap* GetCopysetMetricMap() {
         return &copysetMetricMap_;
     }
@@ -495,6 +608,12 @@ class ChunkServerMetric : public Uncopyable {
         return chunkLeft_->get_value();
     }
 
+    const uint32_t GetWalSegmentLeftCount() const {
+        if (walLeft_ == nullptr)
+            return 0;
+        return walLeft_->get_value();
+    }
+
     const uint32_t GetChunkTrashedCount() const {
         if (chunkTrashed_ == nullptr)
             return 0;
@@ -517,6 +636,8 @@ class ChunkServerMetric : public Uncopyable {
     AdderPtr<uint32_t> leaderCount_;
     // chunkfilepool 中剩余的 chunk 的数量
     PassiveStatusPtr<uint32_t> chunkLeft_;
+    // walfilepool 中剩余的 segment 的数量
+    PassiveStatusPtr<uint32_t> walLeft_;
     // trash 中的 chunk 的数量
     PassiveStatusPtr<uint32_t> chunkTrashed_;
     // chunkserver上的 chunk 的数量
@@ -525,6 +646,8 @@ class ChunkServerMetric : public Uncopyable {
     PassiveStatusPtr<uint32_t> snapshotCount_;
     // chunkserver上的 clone chunk 的数量
     PassiveStatusPtr<uint32_t> cloneChunkCount_;
+    // chunkserver上被QoS限流的请求及其等待时间
+    std::shared_ptr<bvar::LatencyRecorder> throttleLatency_;
     // 各复制组metric的映射表，用GroupId作为key
     CopysetMetricMap copysetMetricMap_;
     // chunkserver上的IO类型的metric统计
@@ -46,6 +46,102 @@ void ChunkServerServiceImpl::ChunkServerStatus(
         << ". [ChunkServerStatusResponse] " << response->DebugString();
 }
 
+namespace {
+const int kQosOk = 0;
+const int kQosInvalidParam = -1;
+const int kQosDisabled = -2;
+
+void QosLimitFromConf(const QosLimitConf& conf, QosLimit* limit) {
+    limit->iopsLimit = conf.iopslimit();
+    limit->iopsBurst = conf.iopsburst();
+    limit->bpsLimit = conf.bpslimit();
+    limit->bpsBurst = conf.bpsburst();
+}
+
+void QosLimitToConf(const QosLimit& limit, QosLimitConf* conf) {
+    conf->set_iopslimit(limit.iopsLimit);
+    conf->set_iopsburst(limit.iopsBurst);
+    conf->set_bpslimit(limit.bpsLimit);
+    conf->set_bpsburst(limit.bpsBurst);
+}
+
+// copyset和卷必须且只能指定其中之一
+template <typename Request>
+bool CheckQosTarget(const Request& request) {
+    bool hasCopyset = request.has_logicpoolid() && request.has_copysetid();
+    bool hasFile = request.has_fileid() && request.fileid() != 0;
+    return hasCopyset != hasFile;
+}
+}  // namespace
+
+void ChunkServerServiceImpl::UpdateQosLimit(
+    RpcController *controller,
+    const UpdateQosLimitRequest *request,
+    UpdateQosLimitResponse *response,
+    Closure *done) {
+    brpc::ClosureGuard done_guard(done);
+
+    brpc::Controller* cntl =
+        static_cast<brpc::Controller*>(controller);
+    LOG(INFO) << "Received request[log_id=" << cntl->log_id()
+        << "] from " << cntl->remote_side() << " to " << cntl->local_side()
+        << ". [UpdateQosLimitRequest] " << request->DebugString();
+
+    if (qosThrottle_ == nullptr || !qosThrottle_->Enabled()) {
+        LOG(WARNING) << "Update qos limit failed, qos is not enabled";
+        response->set_status(kQosDisabled);
+        return;
+    }
+
+    if (!CheckQosTarget(*request)) {
+        LOG(WARNING) << "Update qos limit failed, invalid request: "
+                     << request->ShortDebugString();
+        response->set_status(kQosInvalidParam);
+        return;
+    }
+
+    QosLimit limit;
+    QosLimitFromConf(request->limit(), &limit);
+    if (request->has_fileid() && request->fileid() != 0) {
+        qosThrottle_->UpdateFileLimit(request->fileid(), limit);
+    } else {
+        qosThrottle_->UpdateCopysetLimit(request->logicpoolid(),
+                                         request->copysetid(),
+                                         limit);
+    }
+    response->set_status(kQosOk);
+}
+
+void ChunkServerServiceImpl::GetQosLimit(
+    RpcController *controller,
+    const GetQosLimitRequest *request,
+    GetQosLimitResponse *response,
+    Closure *done) {
+    brpc::ClosureGuard done_guard(done);
+
+    if (qosThrottle_ == nullptr || !qosThrottle_->Enabled()) {
+        response->set_status(kQosOk);
+        response->set_enable(false);
+        return;
+    }
+
+    if (!CheckQosTarget(*request)) {
+        response->set_status(kQosInvalidParam);
+        return;
+    }
+
+    QosLimit limit;
+    if (request->has_fileid() && request->fileid() != 0) {
+        limit = qosThrottle_->GetFileLimit(request->fileid());
+    } else {
+        limit = qosThrottle_->GetCopysetLimit(request->logicpoolid(),
+                                              request->copysetid());
+    }
+    response->set_status(kQosOk);
+    response->set_enable(true);
+    QosLimitToConf(limit, response->mutable_limit());
+}
+
 }  // namespace chunkserver
 }  // namespace curve
 
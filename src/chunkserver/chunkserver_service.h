@@ -26,14 +26,18 @@
 #include <memory>
 #include "proto/chunkserver.pb.h"
 #include "src/chunkserver/copyset_node_manager.h"
+#include "src/chunkserver/qos_throttle.h"
 
 namespace curve {
 namespace chunkserver {
 
 class ChunkServerServiceImpl : public ChunkServerService {
  public:
-    explicit ChunkServerServiceImpl(CopysetNodeManager* copysetNodeManager)
-        : copysetNodeManager_(copysetNodeManager) {}
+    explicit ChunkServerServiceImpl(
+        CopysetNodeManager* copysetNodeManager,
+        std::shared_ptr<QosThrottle> qosThrottle = nullptr)
+        : copysetNodeManager_(copysetNodeManager),
+          qosThrottle_(qosThrottle) {}
 
     virtual void ChunkServerStatus(
         RpcController *controller,
@@ -41,8 +45,27 @@ class ChunkServerServiceImpl : public ChunkServerService {
         ChunkServerStatusResponse *response,
         Closure *done);
 
+    /**
+     * 运行时修改copyset或卷的QoS限流参数
+     */
+    virtual void UpdateQosLimit(
+        RpcController *controller,
+        const UpdateQosLimitRequest *request,
+        UpdateQosLimitResponse *response,
+        Closure *done);
+
+    /**
+     * 查询copyset或卷当前生效的QoS限流参数
+     */
+    virtual void GetQosLimit(
+        RpcController *controller,
+        const GetQosLimitRequest *request,
+        GetQosLimitResponse *response,
+        Closure *done);
+
  private:
     CopysetNodeManager *copysetNodeManager_;
+    std::shared_ptr<QosThrottle> qosThrottle_;
 };
 
 }  // namespace chunkserver
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include "src/chunkserver/clone_cache.h"
+
+namespace curve {
+namespace chunkserver {
+
+bool CloneSourceCache::Get(const std::string& key, ExtentData* data) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        return false;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    *data = it->second->second;
+    return true;
+}
+
+void CloneSourceCache::Put(const std::string& key, const ExtentData& data) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    // 单个extent超过容量时不缓存
+    if (data == nullptr || data->size() > capacity_) {
+        return;
+    }
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        bytes_ -= it->second->second->size();
+        lru_.erase(it->second);
+        index_.erase(it);
+    }
+    lru_.emplace_front(key, data);
+    index_[key] = lru_.begin();
+    bytes_ += data->size();
+    EvictIfNeeded();
+}
+
+void CloneSourceCache::EvictIfNeeded() {
+    while (bytes_ > capacity_ && !lru_.empty()) {
+        const Entry& entry = lru_.back();
+        bytes_ -= entry.second->size();
+        index_.erase(entry.first);
+        lru_.pop_back();
+    }
+}
+
+}  // namespace chunkserver
+}  // namespace curve
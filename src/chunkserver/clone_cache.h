@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef SRC_CHUNKSERVER_CLONE_CACHE_H_
+#define SRC_CHUNKSERVER_CLONE_CACHE_H_
+
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace curve {
+namespace chunkserver {
+
+using ExtentData = std::shared_ptr<const std::string>;
+
+/**
+ * 克隆源数据的内存缓存，所有copyset共享
+ * key为源数据的位置和extent的偏移，value为extent的数据，
+ * 缓存的总字节数超过容量时按照LRU淘汰
+ */
+class CloneSourceCache {
+ public:
+    explicit CloneSourceCache(uint64_t capacity)
+        : capacity_(capacity), bytes_(0) {}
+
+    /**
+     * 查找extent，命中时将其移到LRU链表头部
+     * @return 命中返回true
+     */
+    bool Get(const std::string& key, ExtentData* data);
+
+    /**
+     * 插入extent，已经存在时覆盖
+     */
+    void Put(const std::string& key, const ExtentData& data);
+
+    uint64_t Bytes() const {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return bytes_;
+    }
+
+    size_t Count() const {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return lru_.size();
+    }
+
+ private:
+    using Entry = std::pair<std::string, ExtentData>;
+
+    void EvictIfNeeded();
+
+ private:
+    mutable std::mutex mtx_;
+    // 缓存的字节数上限
+    uint64_t capacity_;
+    // 当前缓存的字节数
+    uint64_t bytes_;
+    // 头部为最近访问的extent
+    std::list<Entry> lru_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_CLONE_CACHE_H_
@@ -20,12 +20,132 @@
  * Author: yangyaokai
  */
 
+#include <bvar/bvar.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
 #include "src/chunkserver/clone_copyer.h"
 #include "src/chunkserver/clone_core.h"
+#include "src/common/concurrent/count_down_event.h"
 
 namespace curve {
 namespace chunkserver {
 
+using curve::common::CountDownEvent;
+
+namespace {
+// 没有配置chunk大小时，按照16MB将源文件的请求分散到不同的client
+const uint64_t kDefaultSpreadUnit = 16 * 1024 * 1024;
+
+bvar::Adder<uint64_t> g_clone_cache_hit("chunkserver_clone_cache_hit");
+bvar::Adder<uint64_t> g_clone_cache_miss("chunkserver_clone_cache_miss");
+// 与正在下载的同一个extent合并的请求数
+bvar::Adder<uint64_t> g_clone_cache_coalesced(
+    "chunkserver_clone_cache_coalesced");
+// 从源端下载的字节数
+bvar::Adder<uint64_t> g_clone_fetch_bytes("chunkserver_clone_fetch_bytes");
+
+double GetCloneCacheHitRatio(void*) {
+    uint64_t hit = g_clone_cache_hit.get_value()
+                 + g_clone_cache_coalesced.get_value();
+    uint64_t total = hit + g_clone_cache_miss.get_value();
+    return total == 0 ? 0 : static_cast<double>(hit) / total;
+}
+bvar::PassiveStatus<double> g_clone_cache_hit_ratio(
+    "chunkserver_clone_cache_hit_ratio", GetCloneCacheHitRatio, nullptr);
+}  // namespace
+
+// 一个下载请求可能跨越多个extent，所有extent都完成之后再回调
+struct PendingDownload {
+    DownloadClosure* done;
+    std::atomic<uint32_t> remaining;
+    std::atomic<bool> failed;
+
+    PendingDownload(DownloadClosure* closure, uint32_t count)
+        : done(closure), remaining(count), failed(false) {}
+
+    void OnPieceDone(bool pieceFailed) {
+        if (pieceFailed) {
+            failed.store(true);
+        }
+        if (remaining.fetch_sub(1) == 1) {
+            if (failed.load()) {
+                done->SetFailed();
+            }
+            done->Run();
+            delete this;
+        }
+    }
+};
+
+// 等待extent下载完成的请求，extent下载完成后拷贝其中[offset, offset+length)
+struct ExtentWaiter {
+    PendingDownload* pending;
+    char* dst;
+    uint32_t offset;
+    uint32_t length;
+};
+
+class ExtentDownloadClosure : public DownloadClosure {
+ public:
+    ExtentDownloadClosure(OriginCopyer* copyer,
+                          const std::string& key,
+                          uint32_t length)
+        : DownloadClosure(nullptr, nullptr, &context_, nullptr)
+        , copyer_(copyer)
+        , key_(key)
+        , data_(std::make_shared<std::string>(length, '\0')) {
+        context_.offset = 0;
+        context_.size = length;
+        context_.buf = &(*data_)[0];
+    }
+
+    void Run() override {
+        std::unique_ptr<ExtentDownloadClosure> selfGuard(this);
+        copyer_->OnExtentDownloaded(this);
+    }
+
+    bool Failed() const {
+        return isFailed_;
+    }
+
+ private:
+    friend class OriginCopyer;
+
+    OriginCopyer* copyer_;
+    std::string key_;
+    std::shared_ptr<std::string> data_;
+    AsyncDownloadContext context_;
+    // 由OriginCopyer::inflightMtx_保护
+    std::vector<ExtentWaiter> waiters_;
+};
+
+// 同步下载使用的closure，由调用方持有，下载结束后通知调用方
+class SyncDownloadClosure : public DownloadClosure {
+ public:
+    explicit SyncDownloadClosure(AsyncDownloadContext* context)
+        : DownloadClosure(nullptr, nullptr, context, nullptr)
+        , event_(1) {}
+
+    void Run() override {
+        event_.Signal();
+    }
+
+    void Wait() {
+        event_.Wait();
+    }
+
+    bool Failed() const {
+        return isFailed_;
+    }
+
+ private:
+    CountDownEvent event_;
+};
+
 std::ostream& operator<<(std::ostream& out, const AsyncDownloadContext& rhs) {
     out  << "{ location: " << rhs.location
         << ", offset: " << rhs.offset
@@ -36,6 +156,8 @@ std::ostream& operator<<(std::ostream& out, const AsyncDownloadContext& rhs) {
 
 struct CurveAioCombineContext {
     DownloadClosure* done;
+    // 读请求持有源文件句柄的引用，读结束之前句柄不会被关闭
+    OriginHandle* handle;
     CurveAioContext curveCtx;
 };
 
@@ -47,26 +169,58 @@ void CurveAioCallback(struct CurveAioContext* context) {
     if (context->ret < 0) {
         done->SetFailed();
     }
+    curveCombineCtx->handle->Release();
     delete curveCombineCtx;
 
     brpc::ClosureGuard doneGuard(done);
 }
 
 OriginCopyer::OriginCopyer()
-    : curveClient_(nullptr)
-    , s3Client_(nullptr) {}
+    : s3Client_(nullptr)
+    , extentSize_(0)
+    , chunkSize_(0)
+    , cache_(nullptr) {}
 
 int OriginCopyer::Init(const CopyerOptions& options) {
-    curveClient_ = options.curveClient;
     s3Client_ = options.s3Client;
-    if (curveClient_ != nullptr) {
-        int errorCode = curveClient_->Init(options.curveConf.c_str());
-        if (errorCode != 0) {
-            LOG(ERROR) << "Init curve client failed."
-                    << "error code: " << errorCode;
-            return -1;
+    if (options.curveClient != nullptr) {
+        curveClients_.clear();
+        handleTables_.clear();
+        curveClients_.push_back(options.curveClient);
+        for (uint32_t i = 1; i < options.curveClientNum; ++i) {
+            curveClients_.push_back(std::make_shared<FileClient>());
+        }
+        for (auto& client : curveClients_) {
+            int errorCode = client->Init(options.curveConf.c_str());
+            if (errorCode != 0) {
+                LOG(ERROR) << "Init curve client failed."
+                        << "error code: " << errorCode;
+                curveClients_.clear();
+                return -1;
+            }
         }
         curveUser_ = options.curveUser;
+        for (auto& client : curveClients_) {
+            auto opener = [this, client](const std::string& fileName) {
+                int fd = client->Open4ReadOnly(fileName, curveUser_);
+                if (fd < 0) {
+                    LOG(ERROR) << "Open curve file failed."
+                               << "file name: " << fileName
+                               << " ,return code: " << fd;
+                }
+                return fd;
+            };
+            auto closer = [client](int fd) {
+                client->Close(fd);
+            };
+            handleTables_.emplace_back(
+                new OriginHandleTable(options.handleShardNum,
+                                      options.maxOpenedFiles,
+                                      opener, closer));
+        }
+        LOG(INFO) << "Init " << curveClients_.size() << " curve clients, "
+                  << "max opened files per client: "
+                  << options.maxOpenedFiles;
     } else {
         LOG(WARNING) << "Curve client is disabled.";
     }
@@ -75,16 +229,26 @@ int OriginCopyer::Init(const CopyerOptions& options) {
     } else {
         LOG(WARNING) << "s3 adapter is disabled.";
     }
+    chunkSize_ = options.chunkSize;
+    if (options.cacheExtentSize > 0 && options.chunkSize > 0) {
+        extentSize_ = options.cacheExtentSize;
+        cache_ = std::make_shared<CloneSourceCache>(options.cacheCapacity);
+        LOG(INFO) << "Clone source cache is enabled, extent size: "
+                  << extentSize_ << ", capacity: " << options.cacheCapacity;
+    }
     return 0;
 }
 
 int OriginCopyer::Fini() {
-    if (curveClient_ != nullptr) {
-        for (auto &pair : fdMap_) {
-            curveClient_->Close(pair.second);
-        }
-        curveClient_->UnInit();
+    // 先关闭所有源文件句柄，再释放client
+    for (auto& table : handleTables_) {
+        table->CloseAll();
+    }
+    handleTables_.clear();
+    for (auto& client : curveClients_) {
+        client->UnInit();
     }
+    curveClients_.clear();
     if (s3Client_ != nullptr) {
         s3Client_->Deinit();
     }
@@ -108,14 +272,22 @@ void OriginCopyer::DownloadAsync(DownloadClosure* done) {
             done->SetFailed();
             return;
         }
-        DownloadFromCurve(fileName, chunkOffset + context->offset,
-                          context->size, context->buf,
-                          done);
+        if (cache_ != nullptr) {
+            DownloadWithCache(type, fileName, chunkOffset, done);
+        } else {
+            DownloadFromCurve(fileName, chunkOffset + context->offset,
+                              context->size, context->buf,
+                              done);
+        }
         doneGuard.release();
     } else if (type == OriginType::S3Origin) {
-        DownloadFromS3(originPath, context->offset,
-                       context->size, context->buf,
-                       done);
+        if (cache_ != nullptr) {
+            DownloadWithCache(type, originPath, 0, done);
+        } else {
+            DownloadFromS3(originPath, context->offset,
+                           context->size, context->buf,
+                           done);
+        }
         doneGuard.release();
     } else {
         LOG(ERROR) << "Unknown origin location."
@@ -124,6 +296,145 @@ void OriginCopyer::DownloadAsync(DownloadClosure* done) {
     }
 }
 
+int OriginCopyer::DownloadSync(const string& location,
+                               off_t offset,
+                               size_t size,
+                               butil::IOBuf* data) {
+    std::unique_ptr<char[]> buf(new (std::nothrow) char[size]);
+    if (nullptr == buf) {
+        LOG(ERROR) << "Alloc download buffer failed, location: " << location
+                   << ", offset: " << offset << ", size: " << size;
+        return -1;
+    }
+    AsyncDownloadContext context;
+    context.location = location;
+    context.offset = offset;
+    context.size = size;
+    context.buf = buf.get();
+    SyncDownloadClosure done(&context);
+    DownloadAsync(&done);
+    done.Wait();
+    if (done.Failed()) {
+        LOG(ERROR) << "Download origin data failed: " << context;
+        return -1;
+    }
+    data->append(buf.get(), size);
+    return 0;
+}
+
+void OriginCopyer::Download(OriginType type,
+                            const string& path,
+                            off_t off,
+                            size_t size,
+                            char* buf,
+                            DownloadClosure* done) {
+    if (type == OriginType::CurveOrigin) {
+        DownloadFromCurve(path, off, size, buf, done);
+    } else {
+        DownloadFromS3(path, off, size, buf, done);
+    }
+}
+
+void OriginCopyer::DownloadWithCache(OriginType type,
+                                     const string& path,
+                                     off_t chunkOffset,
+                                     DownloadClosure* done) {
+    // 最后一个extent完成时context会随着done一起被释放，这里先拷贝出来
+    AsyncDownloadContext* context = done->GetDownloadContext();
+    const std::string location = context->location;
+    const uint64_t begin = context->offset;
+    const uint64_t end = begin + context->size;
+    char* buf = context->buf;
+
+    // 超出源chunk范围的请求不经过缓存
+    if (begin >= end || end > chunkSize_) {
+        Download(type, path, chunkOffset + begin, end - begin, buf, done);
+        return;
+    }
+
+    uint64_t firstExtent = begin / extentSize_;
+    uint64_t lastExtent = (end - 1) / extentSize_;
+    PendingDownload* pending =
+        new PendingDownload(done, lastExtent - firstExtent + 1);
+    for (uint64_t index = firstExtent; index <= lastExtent; ++index) {
+        uint64_t extentOff = index * extentSize_;
+        uint32_t extentLen =
+            std::min<uint64_t>(extentSize_, chunkSize_ - extentOff);
+        uint64_t pieceBegin = std::max(begin, extentOff);
+        uint64_t pieceEnd = std::min(end, extentOff + extentLen);
+        ExtentWaiter waiter;
+        waiter.pending = pending;
+        waiter.dst = buf + (pieceBegin - begin);
+        waiter.offset = pieceBegin - extentOff;
+        waiter.length = pieceEnd - pieceBegin;
+
+        std::string key = location + "#" + std::to_string(extentOff);
+        ExtentData data;
+        if (cache_->Get(key, &data)) {
+            g_clone_cache_hit << 1;
+            memcpy(waiter.dst, data->data() + waiter.offset, waiter.length);
+            pending->OnPieceDone(false);
+            continue;
+        }
+
+        ExtentDownloadClosure* closure = nullptr;
+        bool cached = false;
+        {
+            std::lock_guard<std::mutex> lock(inflightMtx_);
+            auto iter = inflight_.find(key);
+            if (iter != inflight_.end()) {
+                g_clone_cache_coalesced << 1;
+                iter->second->waiters_.push_back(waiter);
+                continue;
+            }
+            // 下载完成时先放入缓存再从inflight_中删除，上面未命中之后
+            // 下载可能刚好完成，需要在锁内再查一次缓存，避免重复下载
+            cached = cache_->Get(key, &data);
+            if (!cached) {
+                closure = new ExtentDownloadClosure(this, key, extentLen);
+                closure->waiters_.push_back(waiter);
+                inflight_[key] = closure;
+            }
+        }
+        if (cached) {
+            g_clone_cache_hit << 1;
+            memcpy(waiter.dst, data->data() + waiter.offset, waiter.length);
+            pending->OnPieceDone(false);
+            continue;
+        }
+        g_clone_cache_miss << 1;
+        Download(type, path, chunkOffset + extentOff, extentLen,
+                 closure->context_.buf, closure);
+    }
+}
+
+void OriginCopyer::OnExtentDownloaded(ExtentDownloadClosure* closure) {
+    bool failed = closure->Failed();
+    // 先放入缓存再从inflight_中删除，避免后续请求重复下载
+    if (!failed) {
+        g_clone_fetch_bytes << closure->data_->size();
+        cache_->Put(closure->key_, closure->data_);
+    }
+
+    std::vector<ExtentWaiter> waiters;
+    {
+        std::lock_guard<std::mutex> lock(inflightMtx_);
+        waiters.swap(closure->waiters_);
+        inflight_.erase(closure->key_);
+    }
+    if (failed) {
+        LOG(ERROR) << "Download clone source extent failed, extent: "
+                   << closure->key_;
+    }
+    for (auto& waiter : waiters) {
+        if (!failed) {
+            memcpy(waiter.dst, closure->data_->data() + waiter.offset,
+                   waiter.length);
+        }
+        waiter.pending->OnPieceDone(failed);
+    }
+}
+
 void OriginCopyer::DownloadFromS3(const string& objectName,
                                  off_t off,
                                  size_t size,
@@ -163,45 +474,52 @@ void OriginCopyer::DownloadFromCurve(const string& fileName,
                                     char* buf,
                                     DownloadClosure* done) {
     brpc::ClosureGuard doneGuard(done);
-    if (curveClient_ == nullptr) {
+    if (curveClients_.empty()) {
         LOG(ERROR) << "Failed to read curve file."
                    << "curve client is disabled";
         done->SetFailed();
         return;
     }
 
-    int fd = 0;
-    {
-        std::unique_lock<std::mutex> lock(mtx_);
-        auto iter = fdMap_.find(fileName);
-        if (iter != fdMap_.end()) {
-            fd = iter->second;
-        } else {
-            fd = curveClient_->Open4ReadOnly(fileName, curveUser_);
-            if (fd < 0) {
-                LOG(ERROR) << "Open curve file failed."
-                        << "file name: " << fileName
-                        << " ,return code: " << fd;
-                done->SetFailed();
-                return;
-            }
-            fdMap_[fileName] = fd;
-        }
+    // 句柄不存在时在后台打开文件，打开之后再发起读请求
+    uint32_t index = PickCurveClient(fileName, off);
+    handleTables_[index]->Get(fileName,
+        [=](const scoped_refptr<OriginHandle>& handle) {
+            ReadFromCurve(index, handle, fileName, off, size, buf, done);
+        });
+    doneGuard.release();
+}
+
+void OriginCopyer::ReadFromCurve(uint32_t index,
+                                 const scoped_refptr<OriginHandle>& handle,
+                                 const string& fileName,
+                                 off_t off,
+                                 size_t size,
+                                 char* buf,
+                                 DownloadClosure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    if (handle == nullptr) {
+        done->SetFailed();
+        return;
     }
 
     CurveAioCombineContext *curveCombineCtx = new CurveAioCombineContext();
     curveCombineCtx->done = done;
+    curveCombineCtx->handle = handle.get();
     curveCombineCtx->curveCtx.offset = off;
     curveCombineCtx->curveCtx.length = size;
     curveCombineCtx->curveCtx.buf = buf;
     curveCombineCtx->curveCtx.op = LIBCURVE_OP::LIBCURVE_OP_READ;
     curveCombineCtx->curveCtx.cb = CurveAioCallback;
+    handle->AddRef();
 
-    int ret = curveClient_->AioRead(fd,  &curveCombineCtx->curveCtx);
+    int ret = curveClients_[index]->AioRead(handle->Fd(),
+                                            &curveCombineCtx->curveCtx);
     if (ret !=  LIBCURVE_ERROR::OK) {
         LOG(ERROR) << "Read curve file failed."
                    << "file name: " << fileName
                    << " ,error code: " << ret;
+        handle->Release();
         delete curveCombineCtx;
         done->SetFailed();
     } else {
@@ -209,5 +527,16 @@ void OriginCopyer::DownloadFromCurve(const string& fileName,
     }
 }
 
+uint32_t OriginCopyer::PickCurveClient(const string& fileName,
+                                       off_t off) const {
+    if (curveClients_.size() == 1) {
+        return 0;
+    }
+    // 按照源chunk分散，同一个源chunk的请求使用同一个client
+    uint64_t unit = chunkSize_ > 0 ? chunkSize_ : kDefaultSpreadUnit;
+    return (std::hash<std::string>()(fileName) + off / unit)
+           % curveClients_.size();
+}
+
 }  // namespace chunkserver
 }  // namespace curve
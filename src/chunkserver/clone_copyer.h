@@ -24,9 +24,12 @@
 #define SRC_CHUNKSERVER_CLONE_COPYER_H_
 
 #include <glog/logging.h>
+#include <butil/iobuf.h>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 #include "include/chunkserver/chunkserver_common.h"
 #include "src/common/location_operator.h"
@@ -35,6 +38,8 @@
 #include "src/client/client_common.h"
 #include "include/client/libcurve.h"
 #include "src/common/s3_adapter.h"
+#include "src/chunkserver/clone_cache.h"
+#include "src/chunkserver/origin_handle_table.h"
 
 namespace curve {
 namespace chunkserver {
@@ -49,6 +54,7 @@ using curve::common::GetObjectAsyncContext;
 using std::string;
 
 class DownloadClosure;
+class ExtentDownloadClosure;
 
 struct CopyerOptions {
     // curvefs上的root用户信息
@@ -61,6 +67,30 @@ struct CopyerOptions {
     std::shared_ptr<FileClient> curveClient;
     // s3 adapter的对象指针
     std::shared_ptr<S3Adapter> s3Client;
+    // 下载请求按照extent对齐并扩展到整个extent，最近下载的extent缓存在内存中，
+    // 并发下载同一个extent的请求会被合并，0表示不缓存
+    uint32_t cacheExtentSize;
+    // 缓存的容量，单位字节
+    uint64_t cacheCapacity;
+    // 源chunk的大小，extent不会超过源chunk的边界
+    uint32_t chunkSize;
+    // 读curve源文件使用的client个数，curveClient为第一个，其余的在Init时创建，
+    // 同一个源文件的不同chunk分散到不同的client上读取
+    uint32_t curveClientNum;
+    // 源文件句柄表的分片个数
+    uint32_t handleShardNum;
+    // 每个client最多保留的源文件句柄个数，超过时关闭最久未使用的句柄
+    uint32_t maxOpenedFiles;
+
+    CopyerOptions()
+        : curveClient(nullptr),
+          s3Client(nullptr),
+          cacheExtentSize(0),
+          cacheCapacity(0),
+          chunkSize(0),
+          curveClientNum(1),
+          handleShardNum(16),
+          maxOpenedFiles(1024) {}
 };
 
 struct AsyncDownloadContext {
@@ -101,7 +131,38 @@ class OriginCopyer {
      */
     virtual void DownloadAsync(DownloadClosure* done);
 
+    /**
+     * 同步地从源端拷贝数据，会阻塞调用线程直到下载结束
+     * @param location: 源chunk的位置信息
+     * @param offset: 数据在源chunk中的偏移
+     * @param size: 数据的长度
+     * @param[out] data: 下载的数据
+     * @return: 成功返回0，失败返回-1
+     */
+    virtual int DownloadSync(const string& location,
+                             off_t offset,
+                             size_t size,
+                             butil::IOBuf* data);
+
  private:
+    friend class ExtentDownloadClosure;
+
+    void Download(OriginType type,
+                  const string& path,
+                  off_t off,
+                  size_t size,
+                  char* buf,
+                  DownloadClosure* done);
+    /**
+     * 按照extent下载数据，extent在缓存中时直接拷贝，
+     * 否则下载整个extent，或者等待正在下载的同一个extent
+     * @param chunkOffset: 源chunk在源文件中的偏移，s3对象为0
+     */
+    void DownloadWithCache(OriginType type,
+                           const string& path,
+                           off_t chunkOffset,
+                           DownloadClosure* done);
+    void OnExtentDownloaded(ExtentDownloadClosure* closure);
     void DownloadFromS3(const string& objectName,
                        off_t off,
                        size_t size,
@@ -112,18 +173,35 @@ class OriginCopyer {
                           size_t size,
                           char* buf,
                           DownloadClosure* done);
+    // 获取到源文件句柄之后发起读请求，handle为nullptr表示打开文件失败
+    void ReadFromCurve(uint32_t index,
+                       const scoped_refptr<OriginHandle>& handle,
+                       const string& fileName,
+                       off_t off,
+                       size_t size,
+                       char* buf,
+                       DownloadClosure* done);
+    // 选择读取源文件使用的client
+    uint32_t PickCurveClient(const string& fileName, off_t off) const;
 
  private:
     // curvefs上的root用户信息
     UserInfo curveUser_;
-    // 负责跟curve交互
-    std::shared_ptr<FileClient> curveClient_;
+    // 负责跟curve交互，为空表示禁用curve client
+    std::vector<std::shared_ptr<FileClient>> curveClients_;
+    // 每个client打开的源文件句柄，与curveClients_一一对应
+    std::vector<std::unique_ptr<OriginHandleTable>> handleTables_;
     // 负责跟s3交互
     std::shared_ptr<S3Adapter>  s3Client_;
-    // 保护fdMap_的互斥锁
-    std::mutex  mtx_;
-    // 文件名->文件fd 的映射
-    std::unordered_map<std::string, int> fdMap_;
+    // extent的大小，0表示不缓存
+    uint32_t extentSize_;
+    uint32_t chunkSize_;
+    // 最近下载的extent
+    std::shared_ptr<CloneSourceCache> cache_;
+    // 保护inflight_的互斥锁
+    std::mutex inflightMtx_;
+    // 正在下载的extent
+    std::unordered_map<std::string, ExtentDownloadClosure*> inflight_;
 };
 
 }  // namespace chunkserver
@@ -97,6 +97,7 @@ void DownloadClosure::Run() {
         // release doneGuard，将closure交给paste请求处理
         cloneCore_->PasteCloneData(readRequest_,
                                    &copyData,
+                                   downloadCtx_->location,
                                    downloadCtx_->offset,
                                    downloadCtx_->size,
                                    doneGuard.release());
@@ -107,6 +108,7 @@ void DownloadClosure::Run() {
         // paste clone data是异步操作，很快就能处理完
         cloneCore_->PasteCloneData(readRequest_,
                                    &copyData,
+                                   downloadCtx_->location,
                                    downloadCtx_->offset,
                                    downloadCtx_->size,
                                    nullptr);
@@ -289,6 +291,7 @@ int CloneCore::ReadChunk(std::shared_ptr<ReadChunkRequest> readRequest) {
     // Return 完成数据读取后可以将结果返回给用户
     readRequest->cntl_->response_attachment().append(
         chunkData.get(), length);
+    readRequest->SetResponseCrc();
     SetResponse(readRequest, CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
     return 0;
 }
@@ -341,6 +344,7 @@ int CloneCore::SetReadChunkResponse(
         responseData = *cloneData;
     }
     readRequest->cntl_->response_attachment().append(responseData);
+    readRequest->SetResponseCrc();
 
     // 读成功后需要更新 apply index
     readRequest->node_->UpdateAppliedIndex(readRequest->applyIndex);
@@ -417,6 +421,7 @@ int CloneCore::ReadThenMerge(std::shared_ptr<ReadChunkRequest> readRequest,
 
 void CloneCore::PasteCloneData(std::shared_ptr<ReadChunkRequest> readRequest,
                                const butil::IOBuf* cloneData,
+                               const std::string& location,
                                off_t offset,
                                size_t cloneDataSize,
                                Closure* done) {
@@ -433,6 +438,9 @@ void CloneCore::PasteCloneData(std::shared_ptr<ReadChunkRequest> readRequest,
     pasteRequest->set_chunkid(request->chunkid());
     pasteRequest->set_offset(offset);
     pasteRequest->set_size(cloneDataSize);
+    if (pasteByLocation_) {
+        pasteRequest->set_location(location);
+    }
     std::shared_ptr<PasteChunkInternalRequest> req = nullptr;
 
     ChunkResponse* pasteResponse = new ChunkResponse();
@@ -115,9 +115,11 @@ class CloneCore : public std::enable_shared_from_this<CloneCore> {
     friend class DownloadClosure;
  public:
     CloneCore(uint32_t sliceSize, bool enablePaste,
-              std::shared_ptr<OriginCopyer> copyer)
+              std::shared_ptr<OriginCopyer> copyer,
+              bool pasteByLocation = false)
         : sliceSize_(sliceSize)
         , enablePaste_(enablePaste)
+        , pasteByLocation_(pasteByLocation)
         , copyer_(copyer) {}
     virtual ~CloneCore() {}
 
@@ -177,12 +179,14 @@ class CloneCore : public std::enable_shared_from_this<CloneCore> {
      * 将从源端下载下来的数据paste到本地chunk文件中
      * @param readRequest: 用户的ReadRequest
      * @param cloneData: 从源端下载的数据
+     * @param location: 源chunk的位置
      * @param offset: 下载的数据在chunk文件中的偏移
      * @param cloneDataSize: 下载的数据长度
      * @param done:任务完成后要执行的closure
      */
     void PasteCloneData(std::shared_ptr<ReadChunkRequest> readRequest,
                         const butil::IOBuf* cloneData,
+                        const std::string& location,
                         off_t offset,
                         size_t cloneDataSize,
                         Closure* done);
@@ -195,6 +199,9 @@ class CloneCore : public std::enable_shared_from_this<CloneCore> {
     uint32_t sliceSize_;
     // 判断read chunk类型的请求是否需要paste, true需要paste，false表示不需要
     bool enablePaste_;
+    // paste请求的日志中是否只记录源端位置，由各副本自己从源端拷贝数据，
+    // 避免克隆数据写入所有副本的raft日志
+    bool pasteByLocation_;
     // 负责从源端下载数据
     std::shared_ptr<OriginCopyer> copyer_;
 };
@@ -0,0 +1,308 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <glog/logging.h>
+#include <bvar/bvar.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+
+#include "src/chunkserver/clone_hydrator.h"
+#include "src/chunkserver/chunkserver_metrics.h"
+#include "src/chunkserver/op_request.h"
+#include "src/chunkserver/datastore/filename_operator.h"
+#include "src/chunkserver/raftsnapshot/define.h"
+#include "src/common/concurrent/count_down_event.h"
+#include "src/common/timeutility.h"
+#include "proto/chunk.pb.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::common::TimeUtility;
+using curve::common::CountDownEvent;
+
+namespace {
+bvar::Adder<uint64_t> g_hydrate_bytes("chunkserver_clone_hydrate_bytes");
+bvar::Adder<uint64_t> g_hydrate_chunks("chunkserver_clone_hydrate_chunks");
+bvar::Adder<uint64_t> g_hydrate_errors("chunkserver_clone_hydrate_errors");
+bvar::PerSecond<bvar::Adder<uint64_t>> g_hydrate_bps(
+    "chunkserver_clone_hydrate_bps", &g_hydrate_bytes);
+
+/**
+ * 后台回填发起的recover请求不经过rpc，request和response由调用方持有，
+ * 请求结束时通知调用方
+ */
+class HydrateClosure : public ::google::protobuf::Closure {
+ public:
+    HydrateClosure() : event_(1) {}
+    virtual ~HydrateClosure() = default;
+
+    void Run() override {
+        event_.Signal();
+    }
+
+    void Wait() {
+        event_.Wait();
+    }
+
+ private:
+    CountDownEvent event_;
+};
+}  // namespace
+
+CloneHydrator::CloneHydrator()
+    : isStop_(true),
+      exiting_(false) {}
+
+CloneHydrator::~CloneHydrator() {
+    Fini();
+}
+
+int CloneHydrator::Init(const HydratorOptions& options) {
+    if (options.copysetNodeManager == nullptr ||
+        options.cloneManager == nullptr ||
+        options.localFileSystem == nullptr) {
+        LOG(ERROR) << "Invalid hydrator options, copyset node manager, "
+                   << "clone manager or local filesystem is null";
+        return -1;
+    }
+    if (options.sliceSize == 0 ||
+        options.sliceSize % kOpRequestAlignSize != 0) {
+        LOG(ERROR) << "Invalid hydrate slice size " << options.sliceSize
+                   << ", should be a multiple of " << kOpRequestAlignSize;
+        return -1;
+    }
+    if (options.scanIntervalS == 0) {
+        LOG(ERROR) << "Invalid hydrate scan interval, should be positive";
+        return -1;
+    }
+    options_ = options;
+    bandwidth_.reset(new TokenBucket(options_.bandwidthBytes, 0));
+    exiting_.store(false);
+    return 0;
+}
+
+int CloneHydrator::Run() {
+    if (!options_.enable) {
+        LOG(INFO) << "Clone hydrator is disabled.";
+        return 0;
+    }
+    if (isStop_.exchange(false)) {
+        hydrateThread_ = Thread(&CloneHydrator::HydrateInterval, this);
+        LOG(INFO) << "Start clone hydrator thread ok.";
+        return 0;
+    }
+    return -1;
+}
+
+int CloneHydrator::Fini() {
+    exiting_.store(true);
+    if (!isStop_.exchange(true)) {
+        LOG(INFO) << "stop clone hydrator...";
+        sleeper_.interrupt();
+        hydrateThread_.join();
+        LOG(INFO) << "stop clone hydrator ok.";
+    }
+    return 0;
+}
+
+void CloneHydrator::HydrateInterval() {
+    while (sleeper_.wait_for(std::chrono::seconds(options_.scanIntervalS))) {
+        HydrateOnce();
+    }
+}
+
+void CloneHydrator::HydrateOnce() {
+    std::vector<CopysetNodePtr> nodes;
+    ListCopysetNodes(&nodes);
+    for (const auto& node : nodes) {
+        if (exiting_.load()) {
+            return;
+        }
+        // 只有leader发起回填，数据通过raft同步到其他副本
+        if (!node->IsLeaderTerm()) {
+            continue;
+        }
+        // datastore还没加载的copyset等激活之后的下一轮再回填
+        if (!node->IsActivated() ||
+            node->GetDataStore()->GetStatus().cloneChunkCount == 0) {
+            continue;
+        }
+        HydrateCopyset(node);
+    }
+}
+
+void CloneHydrator::HydrateCopyset(const CopysetNodePtr& node) {
+    std::vector<ChunkID> chunks;
+    if (ListChunks(node, &chunks) != 0) {
+        return;
+    }
+    for (ChunkID chunkId : chunks) {
+        if (exiting_.load() || !node->IsLeaderTerm()) {
+            return;
+        }
+        CSChunkInfo info;
+        CSErrorCode errorCode =
+            node->GetDataStore()->GetChunkInfo(chunkId, &info);
+        if (errorCode != CSErrorCode::Success || !info.isClone) {
+            continue;
+        }
+        LOG(INFO) << "Start hydrate clone chunk " << chunkId
+                  << " of copyset " << node->GroupIdString()
+                  << ", location: " << info.location;
+        if (HydrateChunk(node, chunkId)) {
+            g_hydrate_chunks << 1;
+            LOG(INFO) << "Hydrate clone chunk " << chunkId
+                      << " of copyset " << node->GroupIdString()
+                      << " success";
+        }
+    }
+}
+
+bool CloneHydrator::HydrateChunk(const CopysetNodePtr& node,
+                                 ChunkID chunkId) {
+    std::shared_ptr<CSDataStore> dataStore = node->GetDataStore();
+    for (uint64_t offset = 0; ; offset += options_.sliceSize) {
+        if (exiting_.load()) {
+            return false;
+        }
+        // 每个slice之前都重新获取chunk信息，前台io可能已经写过部分页，
+        // chunk也可能已经被删除或者转为普通chunk
+        CSChunkInfo info;
+        CSErrorCode errorCode = dataStore->GetChunkInfo(chunkId, &info);
+        if (errorCode != CSErrorCode::Success) {
+            return false;
+        }
+        if (!info.isClone) {
+            return true;
+        }
+        if (offset >= info.chunkSize || info.bitmap == nullptr) {
+            return false;
+        }
+
+        uint64_t length = std::min<uint64_t>(options_.sliceSize,
+                                             info.chunkSize - offset);
+        uint32_t beginIndex = offset / info.pageSize;
+        uint32_t endIndex = (offset + length - 1) / info.pageSize;
+        if (info.bitmap->NextClearBit(beginIndex, endIndex) == Bitmap::NO_POS) {
+            continue;
+        }
+
+        if (!WaitForHydrate(length)) {
+            return false;
+        }
+        if (!node->IsLeaderTerm()) {
+            return false;
+        }
+        if (RecoverChunk(node, chunkId, offset, length) != 0) {
+            g_hydrate_errors << 1;
+            LOG(WARNING) << "Hydrate clone chunk " << chunkId
+                         << " of copyset " << node->GroupIdString()
+                         << " failed, offset: " << offset
+                         << ", length: " << length;
+            return false;
+        }
+        g_hydrate_bytes << length;
+    }
+}
+
+bool CloneHydrator::WaitForHydrate(uint64_t bytes) {
+    while (options_.pauseIops > 0 &&
+           ForegroundIops() > options_.pauseIops) {
+        if (!sleeper_.wait_for(std::chrono::milliseconds(
+                options_.pauseCheckIntervalMs))) {
+            return false;
+        }
+    }
+
+    // 后台任务不设最长等待时间，透支多少就等待多少
+    uint64_t waitUs = 0;
+    bandwidth_->Reserve(bytes, TimeUtility::GetTimeofDayUs(), UINT64_MAX,
+                        &waitUs);
+    if (waitUs > 0 &&
+        !sleeper_.wait_for(std::chrono::microseconds(waitUs))) {
+        return false;
+    }
+    return true;
+}
+
+void CloneHydrator::ListCopysetNodes(std::vector<CopysetNodePtr>* nodes) {
+    options_.copysetNodeManager->GetAllCopysetNodes(nodes);
+}
+
+int CloneHydrator::ListChunks(const CopysetNodePtr& node,
+                              std::vector<ChunkID>* chunks) {
+    std::string dataDir = node->GetCopysetDir() + "/" + RAFT_DATA_DIR;
+    std::vector<std::string> files;
+    if (options_.localFileSystem->List(dataDir, &files) != 0) {
+        LOG(ERROR) << "List chunk files failed, dir: " << dataDir;
+        return -1;
+    }
+    for (const auto& file : files) {
+        FileNameOperator::FileInfo info =
+            FileNameOperator::ParseFileName(file);
+        if (info.type == FileNameOperator::FileType::CHUNK) {
+            chunks->push_back(info.id);
+        }
+    }
+    std::sort(chunks->begin(), chunks->end());
+    return 0;
+}
+
+uint64_t CloneHydrator::ForegroundIops() {
+    return ChunkServerMetric::GetInstance()->GetForegroundIops();
+}
+
+int CloneHydrator::RecoverChunk(const CopysetNodePtr& node,
+                                ChunkID chunkId,
+                                off_t offset,
+                                size_t length) {
+    ChunkRequest request;
+    ChunkResponse response;
+    request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_RECOVER);
+    request.set_logicpoolid(node->GetLogicPoolId());
+    request.set_copysetid(node->GetCopysetId());
+    request.set_chunkid(chunkId);
+    request.set_offset(offset);
+    request.set_size(length);
+
+    // 复用recover请求的克隆流程，下载的数据经raft paste到所有副本；
+    // recover请求不使用rpc controller
+    HydrateClosure done;
+    auto req = std::make_shared<ReadChunkRequest>(node,
+                                                  options_.cloneManager,
+                                                  nullptr,
+                                                  &request,
+                                                  &response,
+                                                  &done);
+    req->Process();
+    done.Wait();
+
+    if (response.status() != CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS) {
+        return -1;
+    }
+    return 0;
+}
+
+}  // namespace chunkserver
+}  // namespace curve
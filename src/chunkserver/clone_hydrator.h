@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef SRC_CHUNKSERVER_CLONE_HYDRATOR_H_
+#define SRC_CHUNKSERVER_CLONE_HYDRATOR_H_
+
+#include <memory>
+#include <vector>
+
+#include "src/chunkserver/copyset_node_manager.h"
+#include "src/chunkserver/clone_manager.h"
+#include "src/chunkserver/qos_throttle.h"
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/interruptible_sleeper.h"
+#include "src/fs/local_filesystem.h"
+
+namespace curve {
+namespace chunkserver {
+
+using ::curve::common::Thread;
+using ::curve::common::Atomic;
+using ::curve::common::InterruptibleSleeper;
+using curve::fs::LocalFileSystem;
+
+struct HydratorOptions {
+    // 是否开启后台回填
+    bool enable;
+    // 每次回填的数据大小，与clone.slice_size保持一致
+    uint32_t sliceSize;
+    // 回填的带宽上限，单位字节/秒，0表示不限制
+    uint64_t bandwidthBytes;
+    // 前台读写请求的rps超过该值时暂停回填，0表示不暂停
+    uint64_t pauseIops;
+    // 因前台负载暂停时，每次检查的间隔
+    uint32_t pauseCheckIntervalMs;
+    // 两轮扫描之间的间隔
+    uint32_t scanIntervalS;
+
+    CopysetNodeManager* copysetNodeManager;
+    CloneManager* cloneManager;
+    std::shared_ptr<LocalFileSystem> localFileSystem;
+
+    HydratorOptions()
+        : enable(false),
+          sliceSize(1024 * 1024),
+          bandwidthBytes(16 * 1024 * 1024),
+          pauseIops(0),
+          pauseCheckIntervalMs(100),
+          scanIntervalS(10),
+          copysetNodeManager(nullptr),
+          cloneManager(nullptr) {}
+};
+
+/**
+ * 后台将clone chunk中未写过的数据从源端拷贝到本地，直到chunk不再依赖源端:
+ * 1. 周期性扫描本节点为leader且存在clone chunk的copyset
+ * 2. 按slice检查chunk的bitmap，已经被前台io写过的slice直接跳过
+ * 3. 剩余的slice以recover请求的方式走克隆流程，数据经raft paste到所有副本，
+ *    所有页都写过之后datastore会将chunk转为普通chunk
+ * 4. 按照配置的带宽限速，前台读写压力超过阈值时暂停
+ */
+class CloneHydrator {
+ public:
+    CloneHydrator();
+    virtual ~CloneHydrator();
+
+    int Init(const HydratorOptions& options);
+
+    int Run();
+
+    int Fini();
+
+    // 对所有copyset执行一轮回填，单元测试使用
+    void HydrateOnce();
+
+ protected:
+    // 以下接口为虚函数，方便单元测试
+    virtual void ListCopysetNodes(std::vector<CopysetNodePtr>* nodes);
+
+    // 获取copyset下所有chunk的id，不包括快照
+    virtual int ListChunks(const CopysetNodePtr& node,
+                           std::vector<ChunkID>* chunks);
+
+    // 当前前台读写请求的rps
+    virtual uint64_t ForegroundIops();
+
+    // 同步执行recover请求，成功返回0
+    virtual int RecoverChunk(const CopysetNodePtr& node,
+                             ChunkID chunkId,
+                             off_t offset,
+                             size_t length);
+
+ private:
+    void HydrateInterval();
+
+    void HydrateCopyset(const CopysetNodePtr& node);
+
+    // chunk所有页都写过之后返回true，中途失败或者模块停止返回false
+    bool HydrateChunk(const CopysetNodePtr& node, ChunkID chunkId);
+
+    // 按照带宽和前台负载限速，模块停止返回false
+    bool WaitForHydrate(uint64_t bytes);
+
+ private:
+    HydratorOptions options_;
+
+    std::unique_ptr<TokenBucket> bandwidth_;
+
+    Thread hydrateThread_;
+    Atomic<bool> isStop_;
+    // Fini时置为true，使正在执行的一轮回填尽快退出
+    Atomic<bool> exiting_;
+    InterruptibleSleeper sleeper_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_CLONE_HYDRATOR_H_
@@ -65,7 +65,7 @@ class CURVE_CACHELINE_ALIGNMENT ConcurrentApplyModule {
         }
 
         auto task = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
-        applypoolMap_[Hash(key)]->tq.Push(task);
+        applypoolMap_[Hash(key)]->tq.Push(std::move(task));
         return true;
     };                                                                                  // NOLINT
 
@@ -46,7 +46,8 @@ CopysetNodeOptions::CopysetNodeOptions()
       concurrentapply(nullptr),
       chunkfilePool(nullptr),
       localFileSystem(nullptr),
-      snapshotThrottle(nullptr) {
+      snapshotThrottle(nullptr),
+      copyer(nullptr) {
 }
 
 }  // namespace chunkserver
@@ -29,6 +29,7 @@
 #include "src/fs/local_filesystem.h"
 #include "src/chunkserver/trash.h"
 #include "src/chunkserver/inflight_throttle.h"
+#include "src/chunkserver/qos_throttle.h"
 #include "include/chunkserver/chunkserver_common.h"
 
 namespace curve {
@@ -40,6 +41,8 @@ class ConcurrentApplyModule;
 class ChunkfilePool;
 class CopysetNodeManager;
 class CloneManager;
+class OriginCopyer;
+class ReplayScheduler;
 
 /**
  * copyset node的配置选项
@@ -104,6 +107,16 @@ struct CopysetNodeOptions {
     // snapshot流控
     scoped_refptr<SnapshotThrottle> *snapshotThrottle;
 
+    // 从源端拷贝数据，只记录源端位置的paste日志在apply时通过它获取数据
+    std::shared_ptr<OriginCopyer> copyer;
+
+    // QoS限流，copyset删除时清理它的限流状态，为nullptr表示没有开启
+    std::shared_ptr<QosThrottle> qosThrottle;
+    // apply只记录源端位置的paste日志时从源端拷贝数据的重试次数和间隔，
+    // 重试后仍然失败时copyset进入错误状态，不会跳过这条日志
+    uint32_t fetchCloneDataRetryTimes = 5;
+    uint32_t fetchCloneDataRetryIntervalMs = 500;
+
     // 限制chunkserver启动时copyset并发恢复加载的数量,为0表示不限制
     uint32_t loadConcurrency = 0;
     // 检查copyset是否加载完成出现异常时的最大重试次数
@@ -115,6 +128,19 @@ struct CopysetNodeOptions {
     uint32_t finishLoadMargin = 2000;
     // 循环判定copyset是否加载完成的内部睡眠时间
     uint32_t checkLoadMarginIntervalMs = 1000;
+    // 启动时copyset只注册raft node，datastore按优先级在后台预热或者
+    // 第一次使用时加载，不等待日志追上leader
+    bool lazyActivate = false;
+    // 记录各copyset是否为leader以及最近是否有io的文件，用于决定预热顺序，
+    // 为空表示不记录
+    std::string loadHintPath;
+    // 更新加载提示文件的间隔
+    uint32_t loadHintIntervalS = 60;
+    // 控制重启后同时回放raft日志的copyset数量，为nullptr表示不限制
+    std::shared_ptr<ReplayScheduler> replayScheduler;
+    // 每个chunk每apply多少次请求将applied index更新到metapage，
+    // 回放时跳过chunk上已经执行过的日志，0表示不记录
+    uint32_t appliedIndexSyncInterval = 0;
 
     CopysetNodeOptions();
 };
@@ -126,6 +152,8 @@ struct ChunkServiceOptions {
     CopysetNodeManager *copysetNodeManager;
     CloneManager *cloneManager;
     std::shared_ptr<InflightThrottle> inflightThrottle;
+    // 为nullptr时不做QoS限流
+    std::shared_ptr<QosThrottle> qosThrottle;
 };
 
 }  // namespace chunkserver
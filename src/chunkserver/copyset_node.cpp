@@ -25,6 +25,8 @@
 #include <glog/logging.h>
 #include <brpc/controller.h>
 #include <butil/sys_byteorder.h>
+#include <butil/object_pool.h>
+#include <bthread/bthread.h>
 #include <braft/closure_helper.h>
 #include <braft/snapshot.h>
 #include <braft/protobuf_file.h>
@@ -35,19 +37,23 @@
 
 #include "src/chunkserver/raftsnapshot/curve_filesystem_adaptor.h"
 #include "src/chunkserver/chunk_closure.h"
+#include "src/chunkserver/clone_copyer.h"
 #include "src/chunkserver/op_request.h"
 #include "src/fs/fs_common.h"
 #include "src/chunkserver/copyset_node_manager.h"
 #include "src/chunkserver/datastore/define.h"
 #include "src/chunkserver/datastore/datastore_file_helper.h"
 #include "src/chunkserver/uri_paser.h"
+#include "src/chunkserver/replay_scheduler.h"
 #include "src/common/crc32.h"
 #include "src/common/fs_util.h"
+#include "src/common/timeutility.h"
 
 namespace curve {
 namespace chunkserver {
 
 using curve::fs::FileSystemInfo;
+using curve::common::TimeUtility;
 
 const char *kCurveConfEpochFilename = "conf.epoch";
 
@@ -63,8 +69,23 @@ CopysetNode::CopysetNode(const LogicPoolID &logicPoolId,
     raftNode_(nullptr),
     chunkDataApath_(),
     chunkDataRpath_(),
+    activated_(false),
+    fetchCloneDataRetryTimes_(0),
+    fetchCloneDataRetryIntervalMs_(0),
+    applyError_(false),
+    replayScheduler_(nullptr),
+    replayTarget_(0),
+    replayBeginTimeMs_(0),
+    replaySkipped_(0),
+    replayDeferred_(false),
+    replayStarted_(false),
+    replayStopped_(false),
+    replayTid_(INVALID_BTHREAD),
+    replayTicket_(0),
+    replayInflight_(0),
     appliedIndex_(0),
     leaderTerm_(-1),
+    followingTerm_(-1),
     configChange_(std::make_shared<ConfigurationChange>()) {
 }
 
@@ -112,14 +133,15 @@ int CopysetNode::Init(const CopysetNodeOptions &options) {
     dsOptions.chunkSize = options.maxChunkSize;
     dsOptions.pageSize = options.pageSize;
     dsOptions.locationLimit = options.locationLimit;
+    dsOptions.appliedIndexSyncInterval = options.appliedIndexSyncInterval;
     dataStore_ = std::make_shared<CSDataStore>(options.localFileSystem,
                                                options.chunkfilePool,
                                                dsOptions);
     CHECK(nullptr != dataStore_);
-    if (false == dataStore_->Initialize()) {
+    // 延迟激活时只创建datastore，不扫描chunk目录，
+    // 由copyset manager按优先级预热或者在第一次使用时加载
+    if (!options.lazyActivate && 0 != ActivateDataStore()) {
         // TODO(wudemiao): 增加必要的错误码并返回
-        LOG(ERROR) << "data store init failed. "
-                   << "Copyset: " << GroupIdString();
         return -1;
     }
 
@@ -170,6 +192,10 @@ int CopysetNode::Init(const CopysetNodeOptions &options) {
     peerId_ = PeerId(addr, 0);
     raftNode_ = std::make_shared<RaftNode>(groupId, peerId_);
     concurrentapply_ = options.concurrentapply;
+    copyer_ = options.copyer;
+    fetchCloneDataRetryTimes_ = options.fetchCloneDataRetryTimes;
+    fetchCloneDataRetryIntervalMs_ = options.fetchCloneDataRetryIntervalMs;
+    replayScheduler_ = options.replayScheduler;
 
     /*
      * 初始化copyset性能metrics
@@ -198,6 +224,21 @@ int CopysetNode::Run() {
                    << "Copyset: " << GroupIdString();
         return -1;
     }
+
+    // 加载快照之后，重启前已经写入但还没有apply的日志需要回放
+    NodeStatus status;
+    raftNode_->get_status(&status);
+    if (status.last_index > status.known_applied_index) {
+        replayBeginTimeMs_ = TimeUtility::GetTimeofDayMs();
+        replayTarget_.store(status.last_index, std::memory_order_release);
+        if (metric_ != nullptr) {
+            metric_->OnReplay(0, 0,
+                status.last_index - status.known_applied_index);
+        }
+        LOG(INFO) << "Copyset " << GroupIdString() << " need to replay log"
+                  << " from " << status.known_applied_index + 1
+                  << " to " << status.last_index;
+    }
     LOG(INFO) << "Run copyset success."
               << "Copyset: " << GroupIdString();
     return 0;
@@ -210,6 +251,7 @@ void CopysetNode::Fini() {
         // 等待所有的正在处理的task结束
         raftNode_->join();
     }
+    AbortReplay();
     if (nullptr != concurrentapply_) {
         // 将未刷盘的数据落盘，如果不刷盘
         // 迁移copyset时，copyset移除后再去执行WriteChunk操作可能出错
@@ -217,11 +259,60 @@ void CopysetNode::Fini() {
     }
 }
 
+int CopysetNode::Activate() {
+    return ActivateDataStore();
+}
+
+bool CopysetNode::IsActivated() const {
+    return activated_.load(std::memory_order_acquire);
+}
+
+int CopysetNode::ActivateDataStore() {
+    if (activated_.load(std::memory_order_acquire)) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lockGuard(activateLock_);
+    if (activated_.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+    uint64_t beginTime = TimeUtility::GetTimeofDayMs();
+    if (false == dataStore_->Initialize()) {
+        LOG(ERROR) << "data store init failed. "
+                   << "Copyset: " << ToGroupIdString(logicPoolId_, copysetId_);
+        return -1;
+    }
+    activated_.store(true, std::memory_order_release);
+    LOG(INFO) << "Activate copyset "
+              << ToGroupIdString(logicPoolId_, copysetId_)
+              << " success, time used (ms): "
+              << TimeUtility::GetTimeofDayMs() - beginTime;
+    return 0;
+}
+
 void CopysetNode::on_apply(::braft::Iterator &iter) {
+    // 延迟激活的copyset在apply第一条日志之前必须加载datastore，
+    // 否则日志会被apply到空的datastore上
+    if (iter.valid() && 0 != ActivateDataStore()) {
+        butil::Status status(-1, "Fail to activate copyset %s",
+                             GroupIdString().c_str());
+        iter.set_error_and_rollback(1, &status);
+        return;
+    }
     for (; iter.valid(); iter.next()) {
+        // 之前的日志apply失败，不能跳过继续apply后面的日志，否则副本间
+        // 数据会不一致，停止状态机，重启后从快照和日志重新回放
+        if (applyError_.load(std::memory_order_acquire)) {
+            butil::Status status(-1, "Fail to apply log of copyset %s",
+                                 GroupIdString().c_str());
+            iter.set_error_and_rollback(1, &status);
+            return;
+        }
         // 放在bthread中异步执行，避免阻塞当前状态机的执行
         braft::AsyncClosureGuard doneGuard(iter.done());
 
+        ApplyTask task;
+        task.index = iter.index();
+
         /**
          * 获取向braft提交任务时候传递的ChunkClosure，里面包含了
          * Op的所有上下文 ChunkOpRequest
@@ -237,35 +328,346 @@ void CopysetNode::on_apply(::braft::Iterator &iter) {
                 *chunkClosure = dynamic_cast<ChunkClosure *>(iter.done());
             CHECK(nullptr != chunkClosure)
                 << "ChunkClosure dynamic cast failed";
-            std::shared_ptr<ChunkOpRequest> opRequest = chunkClosure->request_;
-            auto task = std::bind(&ChunkOpRequest::OnApply,
-                                  opRequest,
-                                  iter.index(),
-                                  doneGuard.release());
-            concurrentapply_->Push(opRequest->ChunkId(), task);
+            task.opRequest = chunkClosure->request_;
+            task.opRequest->MarkStage(kOpStageCommitted);
+            task.done = doneGuard.release();
         } else {
-            // 获取log entry
-            butil::IOBuf log = iter.data();
             /**
              * 2.closure是null，有两种情况：
              * 2.1. 节点重启，回放apply，这里会将Op log entry进行反序列化，
              * 然后获取Op信息进行apply
              * 2.2. follower apply
+             * 解析出的请求放在对象池中复用，并且直接在iter的log上解析，
+             * 每条日志不需要再分配ChunkRequest和ChunkOpRequest
              */
-            ChunkRequest request;
-            butil::IOBuf data;
-            auto opReq = ChunkOpRequest::Decode(log, &request, &data);
-            auto chunkId = request.chunkid();
-            auto task = std::bind(&ChunkOpRequest::OnApplyFromLog,
-                                  opReq,
-                                  dataStore_,
-                                  std::move(request),
-                                  data);
-            concurrentapply_->Push(chunkId, task);
+            task.entry = ParseLogEntry(iter);
+        }
+
+        // 回放期间还没有获得名额时日志先排队，保证同一个chunk上的日志按顺序执行
+        if (!DeferApplyTask(task)) {
+            PushApplyTask(task);
         }
     }
 }
 
+CopysetNode::LogEntry *CopysetNode::ParseLogEntry(::braft::Iterator &iter) {
+    LogEntry *entry = butil::get_object<LogEntry>();
+    CHECK(nullptr != entry) << "get log entry from pool failed";
+    int ret = ChunkOpRequest::DecodeLogEntry(iter.data(),
+                                             &entry->request,
+                                             &entry->data);
+    CHECK(0 == ret) << "decode log entry failed, copyset: "
+                    << GroupIdString()
+                    << ", index: " << iter.index();
+    entry->applier = ChunkOpRequest::GetLogApplier(entry->request.optype());
+    CHECK(nullptr != entry->applier)
+        << "unknown op type: " << entry->request.optype()
+        << ", copyset: " << GroupIdString()
+        << ", index: " << iter.index();
+    return entry;
+}
+
+void CopysetNode::ReturnLogEntry(LogEntry *entry) {
+    // 归还对象池之前清空，ChunkRequest会保留已分配的空间供下次使用
+    entry->request.Clear();
+    entry->data.clear();
+    entry->applier = nullptr;
+    butil::return_object(entry);
+}
+
+void CopysetNode::PushApplyTask(const ApplyTask &task) {
+    if (nullptr != task.opRequest) {
+        concurrentapply_->Push(task.opRequest->ChunkId(),
+                               &CopysetNode::ApplyOpRequest,
+                               this,
+                               task.opRequest,
+                               task.index,
+                               task.done);
+        return;
+    }
+
+    LogEntry *entry = task.entry;
+    uint64_t replayTarget = replayTarget_.load(std::memory_order_acquire);
+    if (task.index > replayTarget) {
+        concurrentapply_->Push(entry->request.chunkid(),
+                               &CopysetNode::ApplyLogEntry,
+                               this,
+                               entry,
+                               task.index);
+        return;
+    }
+
+    // chunk上已经执行过这条日志，不需要再执行
+    if (task.index <=
+        dataStore_->GetChunkAppliedIndex(entry->request.chunkid())) {
+        UpdateAppliedIndex(task.index);
+        ReturnLogEntry(entry);
+        ++replaySkipped_;
+        if (metric_ != nullptr) {
+            metric_->OnReplay(0, 1, replayTarget - task.index);
+        }
+        return;
+    }
+    replayInflight_.fetch_add(1, std::memory_order_acq_rel);
+    concurrentapply_->Push(entry->request.chunkid(),
+                           &CopysetNode::ReplayLogEntry,
+                           this,
+                           entry,
+                           task.index);
+    if (metric_ != nullptr) {
+        metric_->OnReplay(1, 0, replayTarget - task.index);
+    }
+}
+
+bool CopysetNode::DeferApplyTask(const ApplyTask &task) {
+    uint64_t replayTarget = replayTarget_.load(std::memory_order_acquire);
+    // 只有on_apply会将replayDeferred_置为true，这里读到false时不会再变化
+    if (replayTarget == 0 &&
+        !replayDeferred_.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    std::lock_guard<bthread::Mutex> lock(replayMutex_);
+    if (!replayStarted_) {
+        // 重启后新提交的请求，或者回放目标之前只有非数据日志，没有需要回放的日志
+        if (replayStopped_ || replayTarget == 0 ||
+            nullptr != task.opRequest || task.index > replayTarget) {
+            FinishReplay();
+            return false;
+        }
+        // 名额在回放bthread中等待，on_apply只申请不等待
+        if (replayScheduler_ != nullptr) {
+            replayTicket_ = replayScheduler_->Submit(
+                replayTarget - task.index + 1);
+            replayDeferred_.store(true, std::memory_order_release);
+        }
+        int ret = bthread_start_background(&replayTid_, nullptr,
+                                           RunReplayLog, this);
+        CHECK(0 == ret) << "start replay bthread failed, copyset: "
+                        << GroupIdString();
+        replayStarted_ = true;
+    }
+    if (!replayDeferred_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    replayQueue_.push_back(task);
+    replayCond_.notify_one();
+    return true;
+}
+
+void *CopysetNode::RunReplayLog(void *arg) {
+    static_cast<CopysetNode *>(arg)->ReplayLog();
+    return nullptr;
+}
+
+void CopysetNode::ReplayLog() {
+    if (replayScheduler_ != nullptr &&
+        !replayScheduler_->Wait(replayTicket_)) {
+        // 排队时回放被中止
+        return;
+    }
+
+    // 回放完成前没有新的日志时，定期检查状态机是否已经apply到回放目标，
+    // 回放目标可能是配置变更等不会经过on_apply的日志
+    const int64_t kCheckIntervalUs = 100 * 1000;
+    std::unique_lock<bthread::Mutex> lock(replayMutex_);
+    while (!replayStopped_) {
+        if (!replayQueue_.empty()) {
+            std::deque<ApplyTask> tasks;
+            tasks.swap(replayQueue_);
+            lock.unlock();
+            for (const auto &task : tasks) {
+                PushApplyTask(task);
+            }
+            lock.lock();
+            continue;
+        }
+        // 队列清空后on_apply直接将日志交给并发模块
+        replayDeferred_.store(false, std::memory_order_release);
+        lock.unlock();
+        if (ReplayCaughtUp()) {
+            FinishReplay();
+            lock.lock();
+            break;
+        }
+        lock.lock();
+        if (!replayStopped_) {
+            replayCond_.wait_for(lock, kCheckIntervalUs);
+        }
+    }
+    lock.unlock();
+
+    if (replayScheduler_ != nullptr) {
+        replayScheduler_->Release();
+    }
+}
+
+bool CopysetNode::ReplayCaughtUp() {
+    uint64_t replayTarget = replayTarget_.load(std::memory_order_acquire);
+    if (replayTarget == 0) {
+        return true;
+    }
+    if (replayInflight_.load(std::memory_order_acquire) > 0) {
+        return false;
+    }
+    NodeStatus status;
+    raftNode_->get_status(&status);
+    return status.known_applied_index >= (int64_t)replayTarget;
+}
+
+void CopysetNode::ReplayLogEntry(LogEntry *entry, uint64_t index) {
+    ApplyLogEntry(entry, index);
+    if (1 == replayInflight_.fetch_sub(1, std::memory_order_acq_rel)) {
+        replayCond_.notify_one();
+    }
+}
+
+void CopysetNode::AbortReplay() {
+    std::deque<ApplyTask> tasks;
+    {
+        std::lock_guard<bthread::Mutex> lock(replayMutex_);
+        // init时加载本地快照不影响之后的回放
+        if (!replayStarted_) {
+            return;
+        }
+        replayStarted_ = false;
+        replayStopped_ = true;
+        replayDeferred_.store(false, std::memory_order_release);
+        tasks.swap(replayQueue_);
+    }
+    if (replayScheduler_ != nullptr) {
+        replayScheduler_->Cancel(replayTicket_);
+    }
+    replayCond_.notify_all();
+    bthread_join(replayTid_, nullptr);
+
+    // 排队的日志已经不需要再执行，本节点提交的请求让client重试
+    for (const auto &task : tasks) {
+        if (nullptr != task.opRequest) {
+            brpc::ClosureGuard doneGuard(task.done);
+            task.opRequest->RedirectChunkRequest();
+        } else {
+            ReturnLogEntry(task.entry);
+        }
+    }
+    // 已经交给并发模块的回放日志执行完成后再返回
+    concurrentapply_->Flush();
+    FinishReplay();
+}
+
+void CopysetNode::FinishReplay() {
+    uint64_t replayTarget = replayTarget_.exchange(0,
+                                                   std::memory_order_acq_rel);
+    if (replayTarget == 0) {
+        return;
+    }
+    if (metric_ != nullptr) {
+        metric_->OnReplay(0, 0, 0);
+    }
+    LOG(INFO) << "Copyset " << GroupIdString()
+              << " finish replaying log to " << replayTarget
+              << ", skipped: " << replaySkipped_
+              << ", time used (ms): "
+              << TimeUtility::GetTimeofDayMs() - replayBeginTimeMs_;
+}
+
+void CopysetNode::ApplyOpRequest(std::shared_ptr<ChunkOpRequest> opRequest,
+                                 uint64_t index,
+                                 ::google::protobuf::Closure *done) {
+    if (applyError_.load(std::memory_order_acquire)) {
+        // copyset即将进入错误状态，让client重试到新的leader
+        brpc::ClosureGuard doneGuard(done);
+        opRequest->RedirectChunkRequest();
+        return;
+    }
+    // done执行之后请求可能已经释放，需要提前取出
+    CHUNK_OP_TYPE opType = opRequest->OpType();
+    ChunkID chunkId = opRequest->ChunkId();
+    opRequest->OnApply(index, done);
+    // apply失败时不记录chunk的applied index，重启后这条日志需要重新回放
+    if (!applyError_.load(std::memory_order_acquire)) {
+        RecordChunkAppliedIndex(opType, chunkId, index);
+    }
+}
+
+void CopysetNode::RecordChunkAppliedIndex(CHUNK_OP_TYPE opType,
+                                          ChunkID chunkId,
+                                          uint64_t index) {
+    // 只读请求不改变chunk，不记录，避免读多的场景频繁更新metapage
+    if (opType == CHUNK_OP_TYPE::CHUNK_OP_READ ||
+        opType == CHUNK_OP_TYPE::CHUNK_OP_READ_SNAP ||
+        opType == CHUNK_OP_TYPE::CHUNK_OP_RECOVER) {
+        return;
+    }
+    dataStore_->UpdateAppliedIndex(chunkId, index);
+}
+
+void CopysetNode::ApplyLogEntry(LogEntry *entry, uint64_t index) {
+    ApplyFromLog(entry->applier, entry->request, entry->data, index);
+    ReturnLogEntry(entry);
+}
+
+void CopysetNode::ApplyFromLog(ChunkOpRequest *opRequest,
+                               const ChunkRequest &request,
+                               const butil::IOBuf &data,
+                               uint64_t index) {
+    // 之前的日志apply失败，copyset即将进入错误状态，后面的日志都不再apply，
+    // 也不更新applied index，重启后从这里重新回放
+    if (applyError_.load(std::memory_order_acquire)) {
+        return;
+    }
+    if (PasteChunkInternalRequest::IsLocationOnly(request, data)) {
+        // 日志中只有源端的位置，各副本自己从源端拷贝数据后再paste；
+        // 拷贝失败时不能跳过这条日志，否则该副本上这部分数据和其他副本不一致
+        butil::IOBuf cloneData;
+        if (FetchCloneData(request, &cloneData) != 0) {
+            return;
+        }
+        opRequest->OnApplyFromLog(dataStore_, request, cloneData);
+    } else {
+        opRequest->OnApplyFromLog(dataStore_, request, data);
+    }
+    RecordChunkAppliedIndex(request.optype(), request.chunkid(), index);
+    // follower同样维护applied index，用于判断能否处理follower read
+    UpdateAppliedIndex(index);
+}
+
+int CopysetNode::FetchCloneData(const ChunkRequest &request,
+                                butil::IOBuf *data) {
+    if (nullptr == copyer_) {
+        LOG(ERROR) << "Fetch clone data failed, copyer is null, copyset: "
+                   << GroupIdString();
+        return -1;
+    }
+    // 源端数据不会变化，重试拿到的数据和其他副本相同
+    for (uint32_t retry = 0; retry <= fetchCloneDataRetryTimes_; ++retry) {
+        if (retry > 0) {
+            bthread_usleep(fetchCloneDataRetryIntervalMs_ * 1000);
+        }
+        data->clear();
+        int ret = copyer_->DownloadSync(request.location(),
+                                        request.offset(),
+                                        request.size(),
+                                        data);
+        if (ret == 0) {
+            return 0;
+        }
+        LOG(WARNING) << "Fetch clone data failed, copyset: "
+                     << GroupIdString()
+                     << ", chunkid: " << request.chunkid()
+                     << ", location: " << request.location()
+                     << ", offset: " << request.offset()
+                     << ", length: " << request.size()
+                     << ", retry: " << retry;
+    }
+    LOG(ERROR) << "Fetch clone data failed after " << fetchCloneDataRetryTimes_
+               << " retries, copyset " << GroupIdString()
+               << " will stop applying log, chunkid: " << request.chunkid()
+               << ", location: " << request.location();
+    applyError_.store(true, std::memory_order_release);
+    return -1;
+}
+
 void CopysetNode::on_shutdown() {
     LOG(INFO) << GroupIdString() << " is shutdown";
 }
@@ -274,6 +676,15 @@ void CopysetNode::on_snapshot_save(::braft::SnapshotWriter *writer,
                                    ::braft::Closure *done) {
     brpc::ClosureGuard doneGuard(done);
 
+    // 等待回放名额的日志还没有交给并发模块，这时打快照会丢失这部分数据，
+    // 等下一次快照时再打
+    if (replayDeferred_.load(std::memory_order_acquire)) {
+        done->status().set_error(EBUSY, "copyset is waiting to replay log");
+        LOG(WARNING) << "Skip snapshot while waiting to replay log. "
+                     << "Copyset: " << GroupIdString();
+        return;
+    }
+
     /**
      * 1.flush I/O to disk，确保数据都落盘
      */
@@ -328,6 +739,9 @@ void CopysetNode::on_snapshot_save(::braft::SnapshotWriter *writer,
 }
 
 int CopysetNode::on_snapshot_load(::braft::SnapshotReader *reader) {
+    // 快照已经包含了还没有回放的日志，回放的日志不能再apply到快照的数据上
+    AbortReplay();
+
     /**
      * 1. 加载快照数据
      */
@@ -404,10 +818,14 @@ int CopysetNode::on_snapshot_load(::braft::SnapshotReader *reader) {
      * 后面的write的数据就会丢，除此之外，如果 datastore init没有重新open
      * 文件，也将导致read不到恢复过来的数据，而是read到老的数据。
      */
-    if (!dataStore_->Initialize()) {
-        LOG(ERROR) << "data store init failed in on snapshot load. "
-                   << "Copyset: " << GroupIdString();
-        return -1;
+    {
+        std::lock_guard<std::mutex> lockGuard(activateLock_);
+        if (!dataStore_->Initialize()) {
+            LOG(ERROR) << "data store init failed in on snapshot load. "
+                       << "Copyset: " << GroupIdString();
+            return -1;
+        }
+        activated_.store(true, std::memory_order_release);
     }
 
     /**
@@ -461,12 +879,14 @@ void CopysetNode::on_configuration_committed(const Configuration &conf) {
 }
 
 void CopysetNode::on_stop_following(const ::braft::LeaderChangeContext &ctx) {
+    followingTerm_.store(-1, std::memory_order_release);
     LOG(INFO) << "Copyset: " << GroupIdString()
               << ", peer id: " << peerId_.to_string()
               << " stops following" << ctx;
 }
 
 void CopysetNode::on_start_following(const ::braft::LeaderChangeContext &ctx) {
+    followingTerm_.store(ctx.term(), std::memory_order_release);
     LOG(INFO) << "Copyset: " << GroupIdString()
               << ", peer id: " << peerId_.to_string()
               << "start following" << ctx;
@@ -535,6 +955,7 @@ void CopysetNode::ListPeers(std::vector<Peer>* peers) {
 
 void CopysetNode::SetCSDateStore(std::shared_ptr<CSDataStore> datastore) {
     dataStore_ = datastore;
+    activated_.store(true, std::memory_order_release);
 }
 
 void CopysetNode::SetLocalFileSystem(std::shared_ptr<LocalFileSystem> fs) {
@@ -559,6 +980,10 @@ bool CopysetNode::IsLeaderTerm() const {
     return false;
 }
 
+bool CopysetNode::IsFollowingLeader() const {
+    return 0 < followingTerm_.load(std::memory_order_acquire);
+}
+
 PeerId CopysetNode::GetLeaderId() const {
     return raftNode_->leader_id();
 }
@@ -24,10 +24,14 @@
 #define SRC_CHUNKSERVER_COPYSET_NODE_H_
 
 #include <butil/memory/ref_counted.h>
+#include <bthread/bthread.h>
+#include <bthread/mutex.h>
+#include <bthread/condition_variable.h>
 
 #include <string>
 #include <vector>
 #include <climits>
+#include <deque>
 #include <memory>
 
 #include "src/chunkserver/concurrent_apply.h"
@@ -39,6 +43,7 @@
 #include "src/chunkserver/raftsnapshot/curve_snapshot_writer.h"
 #include "src/common/string_util.h"
 #include "src/chunkserver/raft_node.h"
+#include "src/chunkserver/replay_scheduler.h"
 #include "proto/heartbeat.pb.h"
 #include "proto/chunk.pb.h"
 #include "proto/common.pb.h"
@@ -52,6 +57,8 @@ using ::curve::mds::heartbeat::ConfigChangeType;
 using ::curve::common::Peer;
 
 class CopysetNodeManager;
+class ChunkOpRequest;
+class OriginCopyer;
 
 extern const char *kCurveConfEpochFilename;
 
@@ -131,6 +138,18 @@ class CopysetNode : public braft::StateMachine,
      */
     virtual void Fini();
 
+    /**
+     * 激活copyset，加载datastore中的chunk元数据。以延迟激活的方式Init时，
+     * copyset只注册了raft node，datastore在第一次使用或者后台预热时才加载
+     * @return 0成功，-1失败
+     */
+    virtual int Activate();
+
+    /**
+     * 返回copyset的datastore是否已经加载
+     */
+    virtual bool IsActivated() const;
+
     /**
      * 返回复制组的逻辑池ID
      * @return
@@ -161,6 +180,13 @@ class CopysetNode : public braft::StateMachine,
      */
     virtual uint64_t LeaderTerm() const;
 
+    /**
+     * 返回当前副本是否作为follower跟随着一个有效的leader，follower在选举
+     * 超时时间内没有收到leader的心跳会停止following，此时不再处理follower read
+     * @return
+     */
+    virtual bool IsFollowingLeader() const;
+
     /**
      * 返回leader id
      * @return
@@ -245,7 +271,8 @@ class CopysetNode : public braft::StateMachine,
     virtual bool GetLeaderStatus(NodeStatus *leaderStaus);
 
     /**
-     * 返回data store指针
+     * 返回data store指针，不会触发激活；延迟激活的copyset加载完成之前
+     * datastore中没有chunk，读取chunk之前需要先用IsActivated判断
      * @return
      */
     virtual std::shared_ptr<CSDataStore> GetDataStore() const;
@@ -255,6 +282,17 @@ class CopysetNode : public braft::StateMachine,
      */
     virtual ConcurrentApplyModule* GetConcurrentApplyModule() const;
 
+    /**
+     * 从源端拷贝paste请求对应的数据，用于只记录了源端位置的paste日志；
+     * 失败时按配置重试，重试后仍然失败则将copyset置为错误状态，
+     * 之后的日志不再apply，下一次on_apply时通知braft停止状态机
+     * @param request: paste请求，location为源chunk的位置
+     * @param[out] data: 从源端拷贝的数据
+     * @return 成功返回0，失败返回-1
+     */
+    virtual int FetchCloneData(const ChunkRequest &request,
+                               butil::IOBuf *data);
+
     /**
      * 向copyset node propose一个op request
      * @param task
@@ -266,7 +304,7 @@ class CopysetNode : public braft::StateMachine,
      * @param peers:返回的成员列表(输出参数)
      * @return
      */
-    void ListPeers(std::vector<Peer>* peers);
+    virtual void ListPeers(std::vector<Peer>* peers);
 
     /**
      * 下面的接口都是继承StateMachine实现的接口
@@ -385,6 +423,105 @@ class CopysetNode : public braft::StateMachine,
         return ToGroupIdString(logicPoolId_, copysetId_);
     }
 
+    // 从日志中解析出的请求，通过对象池复用
+    struct LogEntry {
+        ChunkRequest request;
+        butil::IOBuf data;
+        // 对应op类型的applier，所有日志共用
+        ChunkOpRequest *applier = nullptr;
+    };
+
+    // on_apply中取出的一条日志，等待交给并发模块执行
+    struct ApplyTask {
+        // 本节点提交的请求及其closure
+        std::shared_ptr<ChunkOpRequest> opRequest;
+        ::google::protobuf::Closure *done = nullptr;
+        // 从日志中解析出的请求
+        LogEntry *entry = nullptr;
+        uint64_t index = 0;
+    };
+
+    /**
+     * 加载datastore，已加载则直接返回，可以并发调用
+     */
+    int ActivateDataStore();
+
+    /**
+     * 从对象池中取出entry，并解析iter当前指向的日志
+     */
+    LogEntry *ParseLogEntry(::braft::Iterator &iter);
+
+    /**
+     * 在并发apply模块中执行日志中的请求，执行完之后将entry归还对象池
+     */
+    void ApplyLogEntry(LogEntry *entry, uint64_t index);
+
+    /**
+     * 在并发apply模块中执行leader上提交的请求，并记录chunk的applied index
+     */
+    void ApplyOpRequest(std::shared_ptr<ChunkOpRequest> opRequest,
+                        uint64_t index,
+                        ::google::protobuf::Closure *done);
+
+    /**
+     * 请求执行完成后记录到chunk上，只读请求不记录
+     */
+    void RecordChunkAppliedIndex(CHUNK_OP_TYPE opType,
+                                 ChunkID chunkId,
+                                 uint64_t index);
+
+    /**
+     * 清空entry并归还对象池
+     */
+    static void ReturnLogEntry(LogEntry *entry);
+
+    /**
+     * 将日志交给并发模块执行，回放的日志如果chunk上已经执行过则直接跳过
+     */
+    void PushApplyTask(const ApplyTask &task);
+
+    /**
+     * 回放期间获得名额之前，日志按顺序在replayQueue_中排队，不阻塞on_apply。
+     * 回放第一条日志时申请名额并启动回放bthread
+     * @return: 日志进入队列返回true，否则需要直接交给并发模块
+     */
+    bool DeferApplyTask(const ApplyTask &task);
+
+    /**
+     * 回放bthread，等待名额后按顺序执行排队的日志，并一直持有名额到
+     * 回放完成，即回放目标之前的日志都已经apply
+     */
+    static void *RunReplayLog(void *arg);
+    void ReplayLog();
+
+    /**
+     * 回放目标之前的日志是否都已经apply
+     */
+    bool ReplayCaughtUp();
+
+    /**
+     * 执行一条回放的日志，完成之后通知ReplayLog
+     */
+    void ReplayLogEntry(LogEntry *entry, uint64_t index);
+
+    /**
+     * 加载快照或者停止copyset时中止回放，丢弃还在排队的日志
+     */
+    void AbortReplay();
+
+    /**
+     * 回放完成，记录耗时
+     */
+    void FinishReplay();
+
+    /**
+     * apply从日志中解析出的op，并更新applied index
+     */
+    void ApplyFromLog(ChunkOpRequest *opRequest,
+                      const ChunkRequest &request,
+                      const butil::IOBuf &data,
+                      uint64_t index);
+
  private:
     // 逻辑池 id
     LogicPoolID logicPoolId_;
@@ -412,14 +549,48 @@ class CopysetNode : public braft::StateMachine,
     std::shared_ptr<LocalFileSystem> fs_;
     // Chunk持久化操作接口
     std::shared_ptr<CSDataStore> dataStore_;
+    // datastore是否已经加载，延迟激活时在Activate或apply第一条日志时加载
+    std::atomic<bool> activated_;
+    // 保证datastore只加载一次
+    std::mutex activateLock_;
     // 并发模块
     ConcurrentApplyModule *concurrentapply_;
+    // 从源端拷贝数据
+    std::shared_ptr<OriginCopyer> copyer_;
+    // 从源端拷贝数据的重试次数和间隔
+    uint32_t fetchCloneDataRetryTimes_;
+    uint32_t fetchCloneDataRetryIntervalMs_;
+    // 有日志apply失败，不能跳过，copyset需要进入错误状态
+    std::atomic<bool> applyError_;
     // 配置版本持久化工具接口
     std::unique_ptr<ConfEpochFile> epochFile_;
+    // 控制重启后同时回放日志的copyset数量
+    std::shared_ptr<ReplayScheduler> replayScheduler_;
+    // 重启前写入的最后一条日志的index，小于等于它的日志需要回放，0表示回放完成
+    std::atomic<uint64_t> replayTarget_;
+    // 开始回放的时间和跳过的日志数量，用于回放完成时打印
+    uint64_t replayBeginTimeMs_;
+    uint64_t replaySkipped_;
+    // 获得回放名额之前按顺序排队的日志
+    std::deque<ApplyTask> replayQueue_;
+    // 日志是否需要先进入replayQueue_排队，获得名额并清空队列后置为false
+    std::atomic<bool> replayDeferred_;
+    // 是否已经启动回放bthread，以及回放是否被中止
+    bool replayStarted_;
+    bool replayStopped_;
+    bthread_t replayTid_;
+    // 向ReplayScheduler申请名额的序号
+    uint64_t replayTicket_;
+    // 已经交给并发模块但还没有执行完成的回放日志数量
+    std::atomic<int64_t> replayInflight_;
+    bthread::Mutex replayMutex_;
+    bthread::ConditionVariable replayCond_;
     // 复制组的apply index
     std::atomic<uint64_t> appliedIndex_;
     // 复制组当前任期，如果<=0表明不是leader
     std::atomic<int64_t> leaderTerm_;
+    // 当前跟随的leader的任期，如果<=0表明没有跟随有效的leader
+    std::atomic<int64_t> followingTerm_;
     // 复制组数据回收站目录
     std::string recyclerUri_;
     // 复制组的metric信息
@@ -22,6 +22,8 @@
 
 #include "src/chunkserver/copyset_node_manager.h"
 
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <glog/logging.h>
 #include <braft/file_service.h>
 #include <braft/node_manager.h>
@@ -29,6 +31,7 @@
 #include <vector>
 #include <string>
 #include <utility>
+#include <algorithm>
 
 #include "src/common/string_util.h"
 #include "src/common/timeutility.h"
@@ -79,6 +82,12 @@ int CopysetNodeManager::Run() {
     if (ret == 0) {
         loadFinished_.exchange(true, std::memory_order_acq_rel);
         LOG(INFO) << "Reload copysets success.";
+        if (copysetNodeOptions_.lazyActivate ||
+            !copysetNodeOptions_.loadHintPath.empty()) {
+            sleeper_.reset(new InterruptibleSleeper());
+            activateThread_ =
+                Thread(&CopysetNodeManager::BackgroundActivate, this);
+        }
     }
     return ret;
 }
@@ -94,6 +103,13 @@ int CopysetNodeManager::Fini() {
         copysetLoader_ = nullptr;
     }
 
+    if (activateThread_.joinable()) {
+        sleeper_->interrupt();
+        activateThread_.join();
+    }
+    // 在停止copyset之前记录，保留退出时的leader信息
+    SaveLoadHints();
+
     {
         ReadLockGuard readLockGuard(rwLock_);
         for (auto& copysetNode : copysetNodeMap_) {
@@ -122,6 +138,7 @@ int CopysetNodeManager::ReloadCopysets() {
         return -1;
     }
 
+    std::vector<GroupNid> groupIds;
     vector<std::string>::iterator it = items.begin();
     for (; it != items.end(); ++it) {
         LOG(INFO) << "Found copyset dir " << *it;
@@ -131,6 +148,19 @@ int CopysetNodeManager::ReloadCopysets() {
             LOG(ERROR) << "parse " << *it << " to graoupId err";
             return -1;
         }
+        groupIds.push_back(groupId);
+    }
+
+    // 按照上次记录的提示排序，重启前的leader和最近有io的copyset先加载
+    LoadLoadHints();
+    std::stable_sort(groupIds.begin(), groupIds.end(),
+        [this](GroupNid a, GroupNid b) {
+            return LoadPriority(a, false) < LoadPriority(b, false);
+        });
+
+    // 延迟激活时copyset只需要注册，不等待日志追上leader
+    bool needCheckLoadFinished = !copysetNodeOptions_.lazyActivate;
+    for (GroupNid groupId : groupIds) {
         uint64_t poolId = GetPoolID(groupId);
         uint64_t copysetId = GetCopysetID(groupId);
         LOG(INFO) << "Parsed groupid " << groupId
@@ -144,7 +174,7 @@ int CopysetNodeManager::ReloadCopysets() {
                           this,
                           poolId,
                           copysetId,
-                          true));
+                          needCheckLoadFinished));
         }
     }
 
@@ -166,6 +196,178 @@ bool CopysetNodeManager::LoadFinished() {
     return loadFinished_.load(std::memory_order_acquire);
 }
 
+void CopysetNodeManager::ActivateCopysets() {
+    std::vector<CopysetNodePtr> nodes;
+    GetAllCopysetNodes(&nodes);
+
+    uint64_t beginTime = TimeUtility::GetTimeofDayMs();
+    uint32_t activated = 0;
+    auto priority = [this](const CopysetNodePtr &node) {
+        return LoadPriority(
+            ToGroupNid(node->GetLogicPoolId(), node->GetCopysetId()),
+            node->IsLeaderTerm());
+    };
+    while (!nodes.empty() && running_.load(std::memory_order_acquire)) {
+        // 注册之后leader才陆续选出来，所以每次都重新挑选优先级最高的copyset
+        auto it = std::min_element(nodes.begin(), nodes.end(),
+            [&priority](const CopysetNodePtr &a, const CopysetNodePtr &b) {
+                return priority(a) < priority(b);
+            });
+        CopysetNodePtr node = *it;
+        nodes.erase(it);
+        // 可能已经被io或者日志回放按需激活
+        if (node->IsActivated()) {
+            continue;
+        }
+
+        LogicPoolID logicPoolId = node->GetLogicPoolId();
+        CopysetID copysetId = node->GetCopysetId();
+        if (0 != node->Activate()) {
+            LOG(ERROR) << "Failed to activate copyset "
+                       << ToGroupIdString(logicPoolId, copysetId)
+                       << ", delete it";
+            DeleteCopysetNode(logicPoolId, copysetId);
+            continue;
+        }
+        ++activated;
+    }
+    LOG(INFO) << "Activate " << activated << " copysets end, "
+              << "time used (ms): "
+              << TimeUtility::GetTimeofDayMs() - beginTime;
+}
+
+int CopysetNodeManager::LoadPriority(GroupNid groupId, bool isLeader) const {
+    if (isLeader) {
+        return 0;
+    }
+    auto it = loadHints_.find(groupId);
+    if (it == loadHints_.end()) {
+        return 3;
+    }
+    if (it->second.leader()) {
+        return 1;
+    }
+    return it->second.recentio() ? 2 : 3;
+}
+
+void CopysetNodeManager::LoadLoadHints() {
+    std::lock_guard<std::mutex> lockGuard(hintLock_);
+    loadHints_.clear();
+    lastAppliedIndex_.clear();
+
+    const std::string &path = copysetNodeOptions_.loadHintPath;
+    std::shared_ptr<LocalFileSystem> lfs = copysetNodeOptions_.localFileSystem;
+    if (path.empty() || !lfs->FileExists(path)) {
+        return;
+    }
+
+    // 提示只影响加载顺序，读取失败时按照没有提示处理
+    int fd = lfs->Open(path, O_RDONLY);
+    if (fd < 0) {
+        LOG(WARNING) << "Failed to open copyset load hint file " << path;
+        return;
+    }
+    struct stat info;
+    if (0 != lfs->Fstat(fd, &info)) {
+        LOG(WARNING) << "Failed to stat copyset load hint file " << path;
+        lfs->Close(fd);
+        return;
+    }
+    std::string buf(info.st_size, '\0');
+    int size = lfs->Read(fd, &buf[0], 0, info.st_size);
+    lfs->Close(fd);
+
+    CopysetLoadHints hints;
+    if (size != info.st_size || !hints.ParseFromString(buf)) {
+        LOG(WARNING) << "Ignore broken copyset load hint file " << path;
+        return;
+    }
+    for (const CopysetLoadHint &hint : hints.hints()) {
+        loadHints_[hint.groupid()] = hint;
+    }
+    LOG(INFO) << "Load " << loadHints_.size()
+              << " copyset load hints from " << path;
+}
+
+int CopysetNodeManager::SaveLoadHints() {
+    const std::string &path = copysetNodeOptions_.loadHintPath;
+    if (path.empty()) {
+        return 0;
+    }
+
+    std::vector<CopysetNodePtr> nodes;
+    GetAllCopysetNodes(&nodes);
+
+    std::lock_guard<std::mutex> lockGuard(hintLock_);
+    CopysetLoadHints hints;
+    for (const CopysetNodePtr &node : nodes) {
+        GroupNid groupId =
+            ToGroupNid(node->GetLogicPoolId(), node->GetCopysetId());
+        uint64_t appliedIndex = node->GetAppliedIndex();
+        bool recentIO = false;
+        auto it = lastAppliedIndex_.find(groupId);
+        if (it != lastAppliedIndex_.end()) {
+            recentIO = appliedIndex != it->second;
+        } else {
+            // 启动后第一次记录时没有对比的基准，沿用上次的提示
+            auto hint = loadHints_.find(groupId);
+            recentIO = hint != loadHints_.end() && hint->second.recentio();
+        }
+        lastAppliedIndex_[groupId] = appliedIndex;
+
+        CopysetLoadHint *hint = hints.add_hints();
+        hint->set_groupid(groupId);
+        hint->set_leader(node->IsLeaderTerm());
+        hint->set_recentio(recentIO);
+    }
+
+    std::string buf;
+    if (!hints.SerializeToString(&buf)) {
+        LOG(ERROR) << "Failed to serialize copyset load hints";
+        return -1;
+    }
+
+    // 先写临时文件再rename，避免重启时读到写了一半的文件
+    std::shared_ptr<LocalFileSystem> lfs = copysetNodeOptions_.localFileSystem;
+    std::string tmpPath = path + ".tmp";
+    int fd = lfs->Open(tmpPath, O_RDWR | O_CREAT | O_TRUNC);
+    if (fd < 0) {
+        LOG(ERROR) << "Failed to open copyset load hint file " << tmpPath;
+        return -1;
+    }
+    if (static_cast<int>(buf.size()) !=
+        lfs->Write(fd, buf.data(), 0, buf.size())) {
+        LOG(ERROR) << "Failed to write copyset load hint file " << tmpPath;
+        lfs->Close(fd);
+        return -1;
+    }
+    if (0 != lfs->Fsync(fd)) {
+        LOG(ERROR) << "Failed to sync copyset load hint file " << tmpPath;
+        lfs->Close(fd);
+        return -1;
+    }
+    lfs->Close(fd);
+    if (0 != lfs->Rename(tmpPath, path)) {
+        LOG(ERROR) << "Failed to rename copyset load hint file "
+                   << tmpPath << " to " << path;
+        return -1;
+    }
+    return 0;
+}
+
+void CopysetNodeManager::BackgroundActivate() {
+    if (copysetNodeOptions_.lazyActivate) {
+        ActivateCopysets();
+    }
+    if (copysetNodeOptions_.loadHintPath.empty()) {
+        return;
+    }
+    while (sleeper_->wait_for(
+        std::chrono::seconds(copysetNodeOptions_.loadHintIntervalS))) {
+        SaveLoadHints();
+    }
+}
+
 void CopysetNodeManager::LoadCopyset(const LogicPoolID &logicPoolId,
                                      const CopysetID &copysetId,
                                      bool needCheckLoadFinished) {
@@ -432,6 +634,7 @@ bool CopysetNodeManager::DeleteCopysetNode(const LogicPoolID &logicPoolId,
         auto it = copysetNodeMap_.find(groupId);
         if (copysetNodeMap_.end() != it) {
             copysetNodeMap_.erase(it);
+            RemoveQosState(logicPoolId, copysetId);
             ret = true;
             LOG(INFO) << "Delete copyset "
                       << ToGroupIdString(logicPoolId, copysetId)
@@ -474,6 +677,7 @@ bool CopysetNodeManager::PurgeCopysetNodeData(const LogicPoolID &logicPoolId,
                       << ToGroupIdString(logicPoolId, copysetId)
                       << "to trash success.";
             copysetNodeMap_.erase(it);
+            RemoveQosState(logicPoolId, copysetId);
             ret = true;
         }
     }
@@ -481,6 +685,13 @@ bool CopysetNodeManager::PurgeCopysetNodeData(const LogicPoolID &logicPoolId,
     return ret;
 }
 
+void CopysetNodeManager::RemoveQosState(const LogicPoolID &logicPoolId,
+                                        const CopysetID &copysetId) {
+    if (copysetNodeOptions_.qosThrottle != nullptr) {
+        copysetNodeOptions_.qosThrottle->RemoveCopyset(logicPoolId, copysetId);
+    }
+}
+
 bool CopysetNodeManager::IsExist(const LogicPoolID &logicPoolId,
                                  const CopysetID &copysetId) {
     /* 加读锁 */
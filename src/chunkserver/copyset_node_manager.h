@@ -32,6 +32,9 @@
 #include "src/common/concurrent/rw_lock.h"
 #include "src/common/uncopyable.h"
 #include "src/common/concurrent/task_thread_pool.h"
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/interruptible_sleeper.h"
+#include "proto/copyset.pb.h"
 
 namespace curve {
 namespace chunkserver {
@@ -40,6 +43,8 @@ using curve::common::RWLock;
 using curve::common::ReadLockGuard;
 using curve::common::WriteLockGuard;
 using curve::common::TaskThreadPool;
+using curve::common::Thread;
+using curve::common::InterruptibleSleeper;
 
 class ChunkOpRequest;
 
@@ -62,11 +67,27 @@ class CopysetNodeManager : public curve::common::Uncopyable {
 
     /**
      * @brief 加载目录下的所有copyset
+     * 开启延迟激活时，按照加载提示的优先级注册copyset的raft node，
+     * 不加载datastore，也不等待日志追上leader
      *
      * @return 0表示加载成功，非0表示加载失败
      */
     int ReloadCopysets();
 
+    /**
+     * @brief 按优先级激活所有未激活的copyset：当前的leader，重启前的leader，
+     * 重启前最近有io的copyset，最后是其余的copyset。激活失败的copyset
+     * 会被删除，与启动时加载失败的处理一致
+     */
+    void ActivateCopysets();
+
+    /**
+     * @brief 将各copyset是否为leader、最近是否有io记录到加载提示文件
+     *
+     * @return 0表示成功，-1表示失败
+     */
+    int SaveLoadHints();
+
     /**
      * 创建copyset node，两种情况需要创建copyset node
      * TODO(wudemiao): 后期替换之后删除掉
@@ -195,6 +216,27 @@ class CopysetNodeManager : public curve::common::Uncopyable {
         const CopysetID &copysetId,
         const Configuration &conf);
 
+    /**
+     * 清理copyset的QoS限流状态，copyset从map中删除时调用
+     */
+    void RemoveQosState(const LogicPoolID &logicPoolId,
+                        const CopysetID &copysetId);
+
+    /**
+     * 从加载提示文件中读取上次记录的提示，文件不存在或者损坏时忽略
+     */
+    void LoadLoadHints();
+
+    /**
+     * 返回copyset的激活优先级，值越小越先激活
+     */
+    int LoadPriority(GroupNid groupId, bool isLeader) const;
+
+    /**
+     * 后台线程：按优先级激活copyset，之后定期更新加载提示文件
+     */
+    void BackgroundActivate();
+
  private:
     using CopysetNodeMap = std::unordered_map<GroupId,
                                               std::shared_ptr<CopysetNode>>;
@@ -210,6 +252,15 @@ class CopysetNodeManager : public curve::common::Uncopyable {
     Atomic<bool> running_;
     // 表示copyset node manager当前是否已经完成加载
     Atomic<bool> loadFinished_;
+    // 保护加载提示
+    std::mutex hintLock_;
+    // 启动时读取的加载提示
+    std::unordered_map<GroupNid, CopysetLoadHint> loadHints_;
+    // 上次记录提示时各copyset的applied index，用于判断最近是否有io
+    std::unordered_map<GroupNid, uint64_t> lastAppliedIndex_;
+    // 后台激活copyset以及记录加载提示的线程
+    Thread activateThread_;
+    std::unique_ptr<InterruptibleSleeper> sleeper_;
 };
 
 }  // namespace chunkserver
@@ -20,6 +20,7 @@
  * Author: yangyaokai
  */
 #include <fcntl.h>
+#include <butil/time.h>
 #include <algorithm>
 #include <memory>
 
@@ -35,6 +36,7 @@ ChunkFileMetaPage::ChunkFileMetaPage(const ChunkFileMetaPage& metaPage) {
     sn = metaPage.sn;
     correctedSn = metaPage.correctedSn;
     location = metaPage.location;
+    appliedIndex = metaPage.appliedIndex;
     if (metaPage.bitmap != nullptr) {
         bitmap = std::make_shared<Bitmap>(metaPage.bitmap->Size(),
                                           metaPage.bitmap->GetBitmap());
@@ -51,6 +53,7 @@ ChunkFileMetaPage& ChunkFileMetaPage::operator =(
     sn = metaPage.sn;
     correctedSn = metaPage.correctedSn;
     location = metaPage.location;
+    appliedIndex = metaPage.appliedIndex;
     if (metaPage.bitmap != nullptr) {
         bitmap = std::make_shared<Bitmap>(metaPage.bitmap->Size(),
                                           metaPage.bitmap->GetBitmap());
@@ -84,6 +87,13 @@ void ChunkFileMetaPage::encode(char* buf) {
     }
     uint32_t crc = ::curve::common::CRC32(buf, len);
     memcpy(buf + len, &crc, sizeof(crc));
+    len += sizeof(crc);
+    // appliedIndex放在crc之后并单独校验，老版本不会解析这部分内容，
+    // 老版本写入的metapage这部分为0，解析时校验失败当作0处理
+    memcpy(buf + len, &appliedIndex, sizeof(appliedIndex));
+    uint32_t indexCrc = ::curve::common::CRC32(buf + len, sizeof(appliedIndex));
+    len += sizeof(appliedIndex);
+    memcpy(buf + len, &indexCrc, sizeof(indexCrc));
 }
 
 CSErrorCode ChunkFileMetaPage::decode(const char* buf) {
@@ -125,6 +135,16 @@ CSErrorCode ChunkFileMetaPage::decode(const char* buf) {
                     << static_cast<uint32_t>(FORMAT_VERSION);
         return CSErrorCode::IncompatibleError;
     }
+
+    len += sizeof(recordCrc);
+    uint32_t recordIndexCrc;
+    memcpy(&appliedIndex, buf + len, sizeof(appliedIndex));
+    memcpy(&recordIndexCrc, buf + len + sizeof(appliedIndex),
+           sizeof(recordIndexCrc));
+    if (recordIndexCrc !=
+        ::curve::common::CRC32(buf + len, sizeof(appliedIndex))) {
+        appliedIndex = 0;
+    }
     return CSErrorCode::Success;
 }
 
@@ -137,6 +157,9 @@ CSChunkFile::CSChunkFile(std::shared_ptr<LocalFileSystem> lfs,
       chunkId_(options.id),
       baseDir_(options.baseDir),
       isCloneChunk_(false),
+      appliedIndex_(0),
+      appliedIndexSyncInterval_(options.appliedIndexSyncInterval),
+      unsyncedApplies_(0),
       snapshot_(nullptr),
       chunkfilePool_(chunkfilePool),
       lfs_(lfs),
@@ -220,6 +243,7 @@ CSErrorCode CSChunkFile::Open(bool createFile) {
     }
 
     CSErrorCode errCode = loadMetaPage();
+    appliedIndex_ = metaPage_.appliedIndex;
     // 重启后，只有重新open加载metapage后，才能知道是否为clone chunk
     if (!metaPage_.location.empty() && !isCloneChunk_) {
         if (metric_ != nullptr) {
@@ -349,7 +373,11 @@ CSErrorCode CSChunkFile::Write(SequenceNum sn,
     }
     // 判断是否要cow,若是先将数据拷贝到快照文件
     if (needCow(sn)) {
+        int64_t cowStartUs = butil::cpuwide_time_us();
         CSErrorCode errorCode = copy2Snapshot(offset, length);
+        if (metric_ != nullptr) {
+            metric_->cowLatency << butil::cpuwide_time_us() - cowStartUs;
+        }
         if (errorCode != CSErrorCode::Success) {
             LOG(ERROR) << "Copy data to snapshot failed."
                         << "ChunkID: " << chunkId_
@@ -762,7 +790,36 @@ bool CSChunkFile::needCow(SequenceNum sn) {
     return true;
 }
 
+CSErrorCode CSChunkFile::UpdateAppliedIndex(uint64_t index) {
+    WriteLockGuard writeGuard(rwLock_);
+    if (index <= appliedIndex_) {
+        return CSErrorCode::Success;
+    }
+    appliedIndex_ = index;
+    if (appliedIndexSyncInterval_ == 0 ||
+        ++unsyncedApplies_ < appliedIndexSyncInterval_) {
+        return CSErrorCode::Success;
+    }
+    ChunkFileMetaPage tempMeta = metaPage_;
+    CSErrorCode errorCode = updateMetaPage(&tempMeta);
+    if (errorCode != CSErrorCode::Success) {
+        LOG(WARNING) << "Update applied index failed."
+                     << "ChunkID: " << chunkId_
+                     << ",applied index: " << index;
+        return errorCode;
+    }
+    metaPage_.appliedIndex = tempMeta.appliedIndex;
+    return CSErrorCode::Success;
+}
+
+uint64_t CSChunkFile::GetAppliedIndex() {
+    ReadLockGuard readGuard(rwLock_);
+    return appliedIndex_;
+}
+
 CSErrorCode CSChunkFile::updateMetaPage(ChunkFileMetaPage* metaPage) {
+    // 内存中的appliedIndex对应的请求都已经执行完成，可以随metapage一起持久化
+    metaPage->appliedIndex = appliedIndex_;
     char buf[pageSize_] = {0};
     metaPage->encode(buf);
     int rc = writeMetaPage(buf);
@@ -772,6 +829,7 @@ CSErrorCode CSChunkFile::updateMetaPage(ChunkFileMetaPage* metaPage) {
                    << ",chunk sn: " << metaPage_.sn;
         return CSErrorCode::InternalError;
     }
+    unsyncedApplies_ = 0;
     return CSErrorCode::Success;
 }
 
@@ -59,7 +59,9 @@ struct DataStoreMetric;
  * sn: 8 bytes
  * correctedSn: 8 bytes
  * crc: 4 bytes
- * padding: 4075 bytes
+ * appliedIndex: 8 bytes
+ * appliedIndex crc: 4 bytes
+ * padding: 4063 bytes
  */
 struct ChunkFileMetaPage {
     // 文件格式的版本
@@ -72,12 +74,15 @@ struct ChunkFileMetaPage {
     string location;
     // 表示当前Chunk中page的状态，如果不是CloneChunk则为nullptr
     std::shared_ptr<Bitmap> bitmap;
+    // 该chunk上已经执行完成的raft日志的最大index，日志回放时跳过这之前的日志
+    uint64_t appliedIndex;
 
     ChunkFileMetaPage() : version(FORMAT_VERSION)
                         , sn(0)
                         , correctedSn(0)
                         , location("")
-                        , bitmap(nullptr) {}
+                        , bitmap(nullptr)
+                        , appliedIndex(0) {}
     ChunkFileMetaPage(const ChunkFileMetaPage& metaPage);
     ChunkFileMetaPage& operator = (const ChunkFileMetaPage& metaPage);
 
@@ -102,6 +107,8 @@ struct ChunkOptions {
     PageSizeType    pageSize;
     // datastore内部统计指标
     std::shared_ptr<DataStoreMetric> metric;
+    // 每apply多少次请求将appliedIndex更新到metapage，0表示不更新
+    uint32_t        appliedIndexSyncInterval;
 
     ChunkOptions() : id(0)
                    , sn(0)
@@ -110,7 +117,8 @@ struct ChunkOptions {
                    , location("")
                    , chunkSize(0)
                    , pageSize(0)
-                   , metric(nullptr) {}
+                   , metric(nullptr)
+                   , appliedIndexSyncInterval(0) {}
 };
 
 class CSChunkFile {
@@ -211,6 +219,19 @@ class CSChunkFile {
     CSErrorCode GetHash(off_t offset,
                         size_t length,
                         std::string *hash);
+    /**
+     * 记录已经apply到该chunk的raft日志index，调用时该chunk上index之前的
+     * 请求都已经执行完成。每apply appliedIndexSyncInterval次更新一次metapage
+     * 可能与其他操作存在并发，加写锁
+     * @param index: 已经执行完成的日志index
+     * @return: 返回错误码
+     */
+    CSErrorCode UpdateAppliedIndex(uint64_t index);
+    /**
+     * 获取该chunk上已经执行完成的raft日志的最大index
+     * 可能存在并发，加读锁
+     */
+    uint64_t GetAppliedIndex();
 
  private:
     /**
@@ -323,6 +344,12 @@ class CSChunkFile {
     bool isCloneChunk_;
     // chunk的metapage
     ChunkFileMetaPage metaPage_;
+    // 已经执行完成的raft日志的最大index，可能比metapage中记录的新
+    uint64_t appliedIndex_;
+    // 更新appliedIndex到metapage的间隔
+    uint32_t appliedIndexSyncInterval_;
+    // 上次更新metapage之后apply的次数
+    uint32_t unsyncedApplies_;
     // 被写过但还未更新到metapage中的page索引
     std::set<uint32_t> dirtyPages_;
     // 读写锁
@@ -41,8 +41,10 @@ CSDataStore::CSDataStore(std::shared_ptr<LocalFileSystem> lfs,
       pageSize_(options.pageSize),
       baseDir_(options.baseDir),
       locationLimit_(options.locationLimit),
+      appliedIndexSyncInterval_(options.appliedIndexSyncInterval),
       chunkfilePool_(chunkfilePool),
-      lfs_(lfs) {
+      lfs_(lfs),
+      metric_(std::make_shared<DataStoreMetric>()) {
     CHECK(!baseDir_.empty()) << "Create datastore failed";
     CHECK(lfs_ != nullptr) << "Create datastore failed";
     CHECK(chunkfilePool_ != nullptr) << "Create datastore failed";
@@ -231,6 +233,7 @@ CSErrorCode CSDataStore::WriteChunk(ChunkID id,
         options.location = cloneSourceLocation;
         options.pageSize = pageSize_;
         options.metric = metric_;
+        options.appliedIndexSyncInterval = appliedIndexSyncInterval_;
         CSErrorCode errorCode = CreateChunkFile(options, &chunkFile);
         if (errorCode != CSErrorCode::Success) {
             return errorCode;
@@ -279,6 +282,7 @@ CSErrorCode CSDataStore::CreateCloneChunk(ChunkID id,
         options.chunkSize = chunkSize_;
         options.pageSize = pageSize_;
         options.metric = metric_;
+        options.appliedIndexSyncInterval = appliedIndexSyncInterval_;
         CSErrorCode errorCode = CreateChunkFile(options, &chunkFile);
         if (errorCode != CSErrorCode::Success) {
             return errorCode;
@@ -349,6 +353,22 @@ CSErrorCode CSDataStore::GetChunkHash(ChunkID id,
     return chunkFile->GetHash(offset, length, hash);
 }
 
+void CSDataStore::UpdateAppliedIndex(ChunkID id, uint64_t index) {
+    auto chunkFile = metaCache_.Get(id);
+    if (chunkFile == nullptr) {
+        return;
+    }
+    chunkFile->UpdateAppliedIndex(index);
+}
+
+uint64_t CSDataStore::GetChunkAppliedIndex(ChunkID id) {
+    auto chunkFile = metaCache_.Get(id);
+    if (chunkFile == nullptr) {
+        return 0;
+    }
+    return chunkFile->GetAppliedIndex();
+}
+
 DataStoreStatus CSDataStore::GetStatus() {
     DataStoreStatus status;
     status.chunkFileCount = metric_->chunkFileCount.get_value();
@@ -367,6 +387,7 @@ CSErrorCode CSDataStore::loadChunkFile(ChunkID id) {
         options.chunkSize = chunkSize_;
         options.pageSize = pageSize_;
         options.metric = metric_;
+        options.appliedIndexSyncInterval = appliedIndexSyncInterval_;
         CSChunkFilePtr chunkFilePtr =
             std::make_shared<CSChunkFile>(lfs_,
                                           chunkfilePool_,
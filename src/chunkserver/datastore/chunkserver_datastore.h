@@ -56,6 +56,8 @@ struct DataStoreOptions {
     ChunkSizeType                       chunkSize;
     PageSizeType                        pageSize;
     uint32_t                            locationLimit;
+    // 每个chunk每apply多少次请求将appliedIndex更新到metapage，0表示不更新
+    uint32_t                            appliedIndexSyncInterval = 0;
 };
 
 /**
@@ -83,6 +85,8 @@ struct DataStoreMetric {
     bvar::Adder<uint32_t> chunkFileCount;
     bvar::Adder<uint32_t> snapshotCount;
     bvar::Adder<uint32_t> cloneChunkCount;
+    // 写请求copy-on-write到快照文件的耗时
+    bvar::LatencyRecorder cowLatency;
 };
 using DataStoreMetricPtr = std::shared_ptr<DataStoreMetric>;
 
@@ -256,11 +260,29 @@ class CSDataStore {
                                      off_t offset,
                                      size_t length,
                                      std::string* hash);
+    /**
+     * 记录已经apply到chunk的raft日志index，调用时该chunk上index之前的请求
+     * 都已经执行完成，chunk不存在时忽略
+     * @param id: chunk id
+     * @param index: 已经执行完成的日志index
+     */
+    virtual void UpdateAppliedIndex(ChunkID id, uint64_t index);
+    /**
+     * 获取chunk上已经执行完成的raft日志的最大index，
+     * 日志回放时小于等于该index的请求可以跳过
+     * @param id: chunk id
+     * @return: chunk不存在或者没有记录时返回0
+     */
+    virtual uint64_t GetChunkAppliedIndex(ChunkID id);
     /** 获取DataStore的内部统计信息
      * @return：datastore的内部统计信息
      */
     virtual DataStoreStatus GetStatus();
 
+    DataStoreMetricPtr GetMetric() {
+        return metric_;
+    }
+
  private:
     CSErrorCode loadChunkFile(ChunkID id);
     CSErrorCode CreateChunkFile(const ChunkOptions & ops,
@@ -273,6 +295,8 @@ class CSDataStore {
     PageSizeType pageSize_;
     // clone chunk location长度限制
     uint32_t locationLimit_;
+    // 更新chunk metapage中appliedIndex的间隔
+    uint32_t appliedIndexSyncInterval_;
     // datastore的管理目录
     std::string baseDir_;
     // 为chunkid->chunkfile的映射
@@ -171,6 +171,8 @@ int Heartbeat::BuildCopysetInfo(curve::mds::heartbeat::CopySetInfo* info,
             stats->set_writerate(writeMetric->bps_.get_value(1));
             stats->set_readiops(readMetric->iops_.get_value(1));
             stats->set_writeiops(writeMetric->iops_.get_value(1));
+            stats->set_throttlediops(copysetMetric->GetThrottledIOPS());
+            stats->set_throttlewaitus(copysetMetric->GetThrottleWaitUs());
             info->set_allocated_stats(stats);
         } else {
             LOG(ERROR) << "Failed to get copyset io metric."
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <brpc/closure_guard.h>
+#include <brpc/controller.h>
+#include <glog/logging.h>
+
+#include <vector>
+
+#include "src/chunkserver/integrity_service.h"
+
+namespace curve {
+namespace chunkserver {
+
+void IntegrityServiceImpl::ScheduleJob(RpcController *controller,
+                                       const IntegrityRequest *request,
+                                       IntegrityResponse *response,
+                                       Closure *done) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+    LOG(INFO) << "Received request[log_id=" << cntl->log_id()
+        << "] from " << cntl->remote_side() << " to " << cntl->local_side()
+        << ". [IntegrityRequest] " << request->ShortDebugString();
+
+    IntegrityJob job;
+    if (!request->job().has_logicpoolid() ||
+        0 != scrubManager_->ScheduleJob(request->job().logicpoolid(),
+                                        request->job().copyset(),
+                                        &job)) {
+        response->set_status(INTEGRITY_OP_STATUS_FAILURE_UNKNOWN);
+        return;
+    }
+    *response->add_job() = job;
+    response->set_status(INTEGRITY_OP_STATUS_SUCCESS);
+}
+
+void IntegrityServiceImpl::CancelJob(RpcController *controller,
+                                     const IntegrityRequest *request,
+                                     IntegrityResponse *response,
+                                     Closure *done) {
+    brpc::ClosureGuard doneGuard(done);
+    IntegrityJob job;
+    if (0 != scrubManager_->CancelJob(request->job().id(), &job)) {
+        response->set_status(INTEGRITY_OP_STATUS_FAILURE_UNKNOWN);
+        return;
+    }
+    *response->add_job() = job;
+    response->set_status(INTEGRITY_OP_STATUS_SUCCESS);
+}
+
+void IntegrityServiceImpl::PauseJob(RpcController *controller,
+                                    const IntegrityRequest *request,
+                                    IntegrityResponse *response,
+                                    Closure *done) {
+    brpc::ClosureGuard doneGuard(done);
+    IntegrityJob job;
+    if (0 != scrubManager_->PauseJob(request->job().id(), &job)) {
+        response->set_status(INTEGRITY_OP_STATUS_FAILURE_UNKNOWN);
+        return;
+    }
+    *response->add_job() = job;
+    response->set_status(INTEGRITY_OP_STATUS_SUCCESS);
+}
+
+void IntegrityServiceImpl::ResumeJob(RpcController *controller,
+                                     const IntegrityRequest *request,
+                                     IntegrityResponse *response,
+                                     Closure *done) {
+    brpc::ClosureGuard doneGuard(done);
+    IntegrityJob job;
+    if (0 != scrubManager_->ResumeJob(request->job().id(), &job)) {
+        response->set_status(INTEGRITY_OP_STATUS_FAILURE_UNKNOWN);
+        return;
+    }
+    *response->add_job() = job;
+    response->set_status(INTEGRITY_OP_STATUS_SUCCESS);
+}
+
+void IntegrityServiceImpl::ListJobs(RpcController *controller,
+                                    const IntegrityRequest *request,
+                                    IntegrityResponse *response,
+                                    Closure *done) {
+    brpc::ClosureGuard doneGuard(done);
+    std::vector<IntegrityJob> jobs;
+    scrubManager_->ListJobs(&jobs);
+    bool filter = request->job().has_logicpoolid();
+    for (const auto& job : jobs) {
+        if (filter && (job.logicpoolid() != request->job().logicpoolid() ||
+                       job.copyset() != request->job().copyset())) {
+            continue;
+        }
+        *response->add_job() = job;
+    }
+    response->set_status(INTEGRITY_OP_STATUS_SUCCESS);
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef SRC_CHUNKSERVER_INTEGRITY_SERVICE_H_
+#define SRC_CHUNKSERVER_INTEGRITY_SERVICE_H_
+
+#include "proto/integrity.pb.h"
+#include "src/chunkserver/scrub_manager.h"
+
+namespace curve {
+namespace chunkserver {
+
+using ::google::protobuf::RpcController;
+using ::google::protobuf::Closure;
+
+/**
+ * 数据扫描任务的Rpc服务，请求中的job只使用id，ScheduleJob使用
+ * logicPoolId和copyset，返回的job为任务当前的状态
+ */
+class IntegrityServiceImpl : public IntegrityService {
+ public:
+    explicit IntegrityServiceImpl(ScrubManager* scrubManager)
+        : scrubManager_(scrubManager) {}
+    ~IntegrityServiceImpl() {}
+
+    void ScheduleJob(RpcController *controller,
+                     const IntegrityRequest *request,
+                     IntegrityResponse *response,
+                     Closure *done);
+
+    void CancelJob(RpcController *controller,
+                   const IntegrityRequest *request,
+                   IntegrityResponse *response,
+                   Closure *done);
+
+    void PauseJob(RpcController *controller,
+                  const IntegrityRequest *request,
+                  IntegrityResponse *response,
+                  Closure *done);
+
+    void ResumeJob(RpcController *controller,
+                   const IntegrityRequest *request,
+                   IntegrityResponse *response,
+                   Closure *done);
+
+    /**
+     * 列出所有任务，request中的job指定了logicPoolId时只返回该copyset的任务
+     */
+    void ListJobs(RpcController *controller,
+                  const IntegrityRequest *request,
+                  IntegrityResponse *response,
+                  Closure *done);
+
+ private:
+    ScrubManager* scrubManager_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_INTEGRITY_SERVICE_H_
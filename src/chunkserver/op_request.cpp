@@ -32,8 +32,10 @@
 
 #include "src/chunkserver/copyset_node.h"
 #include "src/chunkserver/chunk_closure.h"
+#include "src/chunkserver/chunk_service_closure.h"
 #include "src/chunkserver/clone_manager.h"
 #include "src/chunkserver/clone_task.h"
+#include "src/common/crc32.h"
 
 namespace curve {
 namespace chunkserver {
@@ -44,7 +46,8 @@ ChunkOpRequest::ChunkOpRequest() :
     cntl_(nullptr),
     request_(nullptr),
     response_(nullptr),
-    done_(nullptr) {
+    done_(nullptr),
+    trace_(nullptr) {
 }
 
 ChunkOpRequest::ChunkOpRequest(std::shared_ptr<CopysetNode> nodePtr,
@@ -57,11 +60,21 @@ ChunkOpRequest::ChunkOpRequest(std::shared_ptr<CopysetNode> nodePtr,
     cntl_(dynamic_cast<brpc::Controller *>(cntl)),
     request_(request),
     response_(response),
-    done_(done) {
+    done_(done),
+    trace_(nullptr) {
+    // 只有chunk service发起的请求才可能被采样
+    if (OpTracer::GetInstance()->Enabled()) {
+        ChunkServiceClosure *closure =
+            dynamic_cast<ChunkServiceClosure *>(done);
+        if (closure != nullptr) {
+            trace_ = closure->GetTrace();
+        }
+    }
 }
 
 void ChunkOpRequest::Process() {
     brpc::ClosureGuard doneGuard(done_);
+    MarkStage(kOpStageThrottled);
     /**
      * 如果propose成功，说明request成功交给了raft处理，
      * 那么done_就不能被调用，只有propose失败了才需要提前返回
@@ -97,6 +110,8 @@ int ChunkOpRequest::Propose(const ChunkRequest *request,
      */
     task.expected_term = node_->LeaderTerm();
 
+    // propose之后请求可能已经apply完成并返回，需要在propose之前记录
+    MarkStage(kOpStageProposed);
     node_->Propose(task);
 
     return 0;
@@ -137,19 +152,9 @@ int ChunkOpRequest::Encode(const ChunkRequest *request,
 std::shared_ptr<ChunkOpRequest> ChunkOpRequest::Decode(butil::IOBuf log,
                                                        ChunkRequest *request,
                                                        butil::IOBuf *data) {
-    uint32_t metaSize = 0;
-    log.cutn(&metaSize, sizeof(uint32_t));
-    metaSize = butil::NetToHost32(metaSize);
-
-    butil::IOBuf meta;
-    log.cutn(&meta, metaSize);
-    butil::IOBufAsZeroCopyInputStream wrapper(meta);
-    bool ret = request->ParseFromZeroCopyStream(&wrapper);
-    if (false == ret) {
-        LOG(ERROR) << "failed deserialize";
+    if (0 != DecodeLogEntry(log, request, data)) {
         return nullptr;
     }
-    data->swap(log);
 
     switch (request->optype()) {
         case CHUNK_OP_TYPE::CHUNK_OP_READ:
@@ -172,6 +177,64 @@ std::shared_ptr<ChunkOpRequest> ChunkOpRequest::Decode(butil::IOBuf log,
     }
 }
 
+int ChunkOpRequest::DecodeLogEntry(const butil::IOBuf &log,
+                                   ChunkRequest *request,
+                                   butil::IOBuf *data) {
+    uint32_t metaSize = 0;
+    if (log.copy_to(&metaSize, sizeof(uint32_t)) != sizeof(uint32_t)) {
+        LOG(ERROR) << "log entry too short, size: " << log.size();
+        return -1;
+    }
+    metaSize = butil::NetToHost32(metaSize);
+    if (log.size() < sizeof(uint32_t) + metaSize) {
+        LOG(ERROR) << "log entry too short, size: " << log.size()
+                   << ", meta size: " << metaSize;
+        return -1;
+    }
+
+    // 直接在log上解析，不需要再切出一个meta的IOBuf
+    butil::IOBufAsZeroCopyInputStream wrapper(log);
+    wrapper.Skip(sizeof(uint32_t));
+    if (!request->ParseFromBoundedZeroCopyStream(&wrapper, metaSize)) {
+        LOG(ERROR) << "failed deserialize";
+        return -1;
+    }
+    // 只增加block的引用计数，不拷贝数据
+    data->clear();
+    log.append_to(data, butil::IOBuf::npos, sizeof(uint32_t) + metaSize);
+    return 0;
+}
+
+ChunkOpRequest* ChunkOpRequest::GetLogApplier(CHUNK_OP_TYPE opType) {
+    static ReadChunkRequest readApplier;
+    static WriteChunkRequest writeApplier;
+    static DeleteChunkRequest deleteApplier;
+    static ReadSnapshotRequest readSnapApplier;
+    static DeleteSnapshotRequest deleteSnapApplier;
+    static PasteChunkInternalRequest pasteApplier;
+    static CreateCloneChunkRequest createCloneApplier;
+
+    switch (opType) {
+        case CHUNK_OP_TYPE::CHUNK_OP_READ:
+        case CHUNK_OP_TYPE::CHUNK_OP_RECOVER:
+            return &readApplier;
+        case CHUNK_OP_TYPE::CHUNK_OP_WRITE:
+            return &writeApplier;
+        case CHUNK_OP_TYPE::CHUNK_OP_DELETE:
+            return &deleteApplier;
+        case CHUNK_OP_TYPE::CHUNK_OP_READ_SNAP:
+            return &readSnapApplier;
+        case CHUNK_OP_TYPE::CHUNK_OP_DELETE_SNAP:
+            return &deleteSnapApplier;
+        case CHUNK_OP_TYPE::CHUNK_OP_PASTE:
+            return &pasteApplier;
+        case CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE:
+            return &createCloneApplier;
+        default:LOG(ERROR) << "Unknown chunk op";
+            return nullptr;
+    }
+}
+
 void DeleteChunkRequest::OnApply(uint64_t index,
                                  ::google::protobuf::Closure *done) {
     brpc::ClosureGuard doneGuard(done);
@@ -234,23 +297,41 @@ ReadChunkRequest::ReadChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
     ChunkOpRequest(nodePtr, cntl, request, response, done),
     cloneMgr_(cloneMgr),
     concurrentApplyModule_(nodePtr->GetConcurrentApplyModule()),
-    applyIndex(0) {
+    applyIndex(0),
+    followerRead_(false) {
 }
 
 void ReadChunkRequest::Process() {
     brpc::ClosureGuard doneGuard(done_);
+    MarkStage(kOpStageThrottled);
 
-    if (!node_->IsLeaderTerm()) {
+    followerRead_ = !node_->IsLeaderTerm();
+    if (followerRead_ && !CanFollowerRead()) {
         RedirectChunkRequest();
         return;
     }
 
+    /**
+     * 延迟激活的copyset在datastore加载之前不能直接读，否则还没加载的chunk
+     * 会被当作不存在返回。follower转发给leader；leader走raft一致性协议读，
+     * on_apply在apply之前会先加载datastore，加载失败时请求会被转发
+     */
+    if (!node_->IsActivated()) {
+        if (followerRead_) {
+            RedirectChunkRequest();
+        } else if (0 == Propose(request_, nullptr)) {
+            doneGuard.release();
+        }
+        return;
+    }
+
     /**
      * 如果携带了applied index，且小于当前copyset node
      * 的最新applied index，或者 op类型为CHUNK_OP_RECOVER
-     * 那么不需要走一致性协议
+     * 那么不需要走一致性协议，follower read同样如此
      */
-    if ((request_->has_appliedindex()
+    if (followerRead_
+        || (request_->has_appliedindex()
         && node_->GetAppliedIndex() >= request_->appliedindex())
         || request_->optype() == CHUNK_OP_TYPE::CHUNK_OP_RECOVER) {
         /**
@@ -295,8 +376,26 @@ void ReadChunkRequest::Process() {
     }
 }
 
+bool ReadChunkRequest::CanFollowerRead() const {
+    /**
+     * follower read需要满足以下条件：
+     *  (1). client允许follower处理，并且携带了applied index
+     *  (2). follower跟随着有效的leader，失去leader的follower可能已经被
+     *  隔离，不再处理读请求
+     *  (3). follower的applied index不小于携带的applied index，说明client
+     *  之前写入的数据都已经在follower上apply了，之后read进入并发层排队，
+     *  与leader上的applied index read一样保证不会读到旧数据
+     */
+    return request_->followerread()
+        && request_->optype() == CHUNK_OP_TYPE::CHUNK_OP_READ
+        && request_->has_appliedindex()
+        && node_->IsFollowingLeader()
+        && node_->GetAppliedIndex() >= request_->appliedindex();
+}
+
 void ReadChunkRequest::OnApply(uint64_t index,
                                ::google::protobuf::Closure *done) {
+    MarkStage(kOpStageApplyBegin);
     // 先清除response中的status，以保证CheckForward后的判断的正确性
     response_->clear_status();
 
@@ -325,6 +424,11 @@ void ReadChunkRequest::OnApply(uint64_t index,
         }
         // 如果需要从源端拷贝数据，需要将请求转发给clone manager处理
         if ( needLazyClone || NeedClone(chunkInfo) ) {
+            // 拷贝的数据需要通过raft写入，follower无法处理，交给leader处理
+            if (followerRead_) {
+                RedirectChunkRequest();
+                break;
+            }
             applyIndex = index;
             std::shared_ptr<CloneTask> cloneTask =
             cloneMgr_->GenerateCloneTask(
@@ -405,10 +509,12 @@ void ReadChunkRequest::ReadChunk() {
                                      readBuffer,
                                      request_->offset(),
                                      size);
+    MarkStage(kOpStageIODone);
     butil::IOBuf wrapper;
     wrapper.append_user_data(readBuffer, size, ReadBufferDeleter);
     if (CSErrorCode::Success == ret) {
         cntl_->response_attachment().append(wrapper);
+        SetResponseCrc();
         response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
     } else if (CSErrorCode::ChunkNotExistError == ret) {
         response_->set_status(
@@ -426,10 +532,39 @@ void ReadChunkRequest::ReadChunk() {
     }
 }
 
+void ReadChunkRequest::SetResponseCrc() {
+    if (!request_->returncrc() || cntl_ == nullptr) {
+        return;
+    }
+    response_->set_crc(
+        curve::common::CRC32(0, cntl_->response_attachment()));
+}
+
+bool WriteChunkRequest::CheckDataCrc(const ChunkRequest &request,
+                                     const butil::IOBuf &data) {
+    if (!request.has_crc()) {
+        return true;
+    }
+    return curve::common::CRC32(0, data) == request.crc();
+}
+
 void WriteChunkRequest::OnApply(uint64_t index,
                                 ::google::protobuf::Closure *done) {
     brpc::ClosureGuard doneGuard(done);
     uint32_t cost;
+    MarkStage(kOpStageApplyBegin);
+
+    /**
+     * propose之前已经校验过数据，apply时数据不一致说明内存中的数据被破坏，
+     * 写入后副本之间的数据将不一致，与磁盘错误一样让进程退出
+     */
+    if (!CheckDataCrc(*request_, cntl_->request_attachment())) {
+        LOG(FATAL) << "write failed, crc mismatch: "
+                   << " logic pool id: " << request_->logicpoolid()
+                   << " copyset id: " << request_->copysetid()
+                   << " chunkid: " << request_->chunkid()
+                   << " data size: " << request_->size();
+    }
 
     std::string  cloneSourceLocation;
     if (existCloneInfo(request_)) {
@@ -445,6 +580,7 @@ void WriteChunkRequest::OnApply(uint64_t index,
                                       request_->size(),
                                       &cost,
                                       cloneSourceLocation);
+    MarkStage(kOpStageIODone);
 
     if (CSErrorCode::Success == ret) {
         response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
@@ -494,6 +630,14 @@ void WriteChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
                                        const butil::IOBuf &data) {
     // NOTE: 处理过程中优先使用参数传入的datastore/request
     uint32_t cost;
+    // 日志中的数据在复制或者落盘过程中被破坏，不能写入chunk
+    if (!CheckDataCrc(request, data)) {
+        LOG(FATAL) << "write failed, crc mismatch: "
+                   << " logic pool id: " << request.logicpoolid()
+                   << " copyset id: " << request.copysetid()
+                   << " chunkid: " << request.chunkid()
+                   << " data size: " << request.size();
+    }
     std::string  cloneSourceLocation;
     if (existCloneInfo(&request)) {
         auto func = ::curve::common::LocationOperator::GenerateCurveLocation;
@@ -775,15 +919,31 @@ void PasteChunkInternalRequest::Process() {
      * 如果propose成功，说明request成功交给了raft处理，
      * 那么done_就不能被调用，只有propose失败了才需要提前返回
      */
-    if (0 == Propose(request_, &data_)) {
+    const butil::IOBuf *data = request_->has_location() ? nullptr : &data_;
+    if (0 == Propose(request_, data)) {
         doneGuard.release();
     }
 }
 
+bool PasteChunkInternalRequest::IsLocationOnly(const ChunkRequest &request,
+                                               const butil::IOBuf &data) {
+    return CHUNK_OP_TYPE::CHUNK_OP_PASTE == request.optype()
+           && request.has_location()
+           && data.empty();
+}
+
 void PasteChunkInternalRequest::OnApply(uint64_t index,
                                         ::google::protobuf::Closure *done) {
     brpc::ClosureGuard doneGuard(done);
 
+    // leader上的请求在内存中保留了数据，只有数据为空时才需要从源端拷贝；
+    // 拷贝失败时copyset会进入错误状态，让client重试到新的leader
+    if (IsLocationOnly(*request_, data_) &&
+        0 != node_->FetchCloneData(*request_, &data_)) {
+        RedirectChunkRequest();
+        return;
+    }
+
     auto ret = datastore_->PasteChunk(request_->chunkid(),
                                       data_.to_string().c_str(),  //NOLINT
                                       request_->offset(),
@@ -33,6 +33,7 @@
 #include "include/chunkserver/chunkserver_common.h"
 #include "src/chunkserver/concurrent_apply.h"
 #include "src/chunkserver/datastore/define.h"
+#include "src/chunkserver/op_trace.h"
 
 namespace curve {
 namespace chunkserver {
@@ -120,6 +121,15 @@ class ChunkOpRequest : public std::enable_shared_from_this<ChunkOpRequest> {
      */
     virtual void RedirectChunkRequest();
 
+    /**
+     * 请求被采样时记录到达stage的时间，需要在done被调用之前执行
+     */
+    void MarkStage(OpStage stage) {
+        if (trace_ != nullptr) {
+            trace_->Mark(stage);
+        }
+    }
+
  public:
     /**
      * Op序列化工具函数
@@ -152,6 +162,26 @@ class ChunkOpRequest : public std::enable_shared_from_this<ChunkOpRequest> {
                                                   ChunkRequest *request,
                                                   butil::IOBuf *data);
 
+    /**
+     * 从log entry中原地解析出ChunkRequest和data，不会拷贝log中的数据，
+     * follower apply和日志回放使用
+     * @param log:op log entry
+     * @param request: 出参，存放反序列上下文
+     * @param data:出参，op操作的数据，和log共享底层的block
+     * @return 0成功，-1失败
+     */
+    static int DecodeLogEntry(const butil::IOBuf &log,
+                              ChunkRequest *request,
+                              butil::IOBuf *data);
+
+    /**
+     * 获取apply日志时使用的ChunkOpRequest，OnApplyFromLog只依赖传入的参数，
+     * 所以每种op类型共用一个对象，不需要为每条日志创建
+     * @param opType: op类型
+     * @return nullptr,未知的op类型，否则返回相应的ChunkOpRequest
+     */
+    static ChunkOpRequest* GetLogApplier(CHUNK_OP_TYPE opType);
+
  protected:
     /**
      * 打包request为braft::task，propose给相应的复制组
@@ -175,6 +205,8 @@ class ChunkOpRequest : public std::enable_shared_from_this<ChunkOpRequest> {
     ChunkResponse *response_;
     // rpc done closure
     ::google::protobuf::Closure *done_;
+    // 请求各阶段的时间，请求没有被采样时为nullptr
+    OpTrace *trace_;
 };
 
 class DeleteChunkRequest : public ChunkOpRequest {
@@ -205,7 +237,8 @@ class ReadChunkRequest : public ChunkOpRequest {
 
  public:
     ReadChunkRequest() :
-        ChunkOpRequest() {}
+        ChunkOpRequest(),
+        followerRead_(false) {}
     ReadChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
                      CloneManager* cloneMgr,
                      RpcController *cntl,
@@ -225,11 +258,16 @@ class ReadChunkRequest : public ChunkOpRequest {
         return request_;
     }
 
+    // 请求要求返回校验码时，计算response中数据的crc
+    void SetResponseCrc();
+
  private:
     // 根据chunk信息判断是否需要拷贝数据
     bool NeedClone(const CSChunkInfo& chunkInfo);
     // 从chunk文件中读数据
     void ReadChunk();
+    // 当前副本不是leader时，判断能否由当前副本处理读请求
+    bool CanFollowerRead() const;
 
  private:
     CloneManager* cloneMgr_;
@@ -237,6 +275,8 @@ class ReadChunkRequest : public ChunkOpRequest {
     ConcurrentApplyModule* concurrentApplyModule_;
     // 保存 apply index
     uint64_t applyIndex;
+    // 是否由follower处理的读请求
+    bool followerRead_;
 };
 
 class WriteChunkRequest : public ChunkOpRequest {
@@ -259,6 +299,15 @@ class WriteChunkRequest : public ChunkOpRequest {
     void OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
                         const ChunkRequest &request,
                         const butil::IOBuf &data) override;
+
+    /**
+     * 校验写请求数据的crc，请求没有携带crc时不校验
+     * @param request: 写请求
+     * @param data: 写请求的数据
+     * @return 校验通过或者不需要校验返回true，否则返回false
+     */
+    static bool CheckDataCrc(const ChunkRequest &request,
+                             const butil::IOBuf &data);
 };
 
 class ReadSnapshotRequest : public ChunkOpRequest {
@@ -353,6 +402,16 @@ class PasteChunkInternalRequest : public ChunkOpRequest {
                         const ChunkRequest &request,
                         const butil::IOBuf &data) override;
 
+    /**
+     * 请求中带了源端位置时，日志中只记录源端位置和范围，不记录数据，
+     * 各副本apply时自己从源端拷贝数据
+     * @param request: 从日志中解析出的请求
+     * @param data: 从日志中解析出的数据
+     * @return 日志中只有源端位置时返回true
+     */
+    static bool IsLocationOnly(const ChunkRequest &request,
+                               const butil::IOBuf &data);
+
  private:
     butil::IOBuf data_;
 };
@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <glog/logging.h>
+
+#include <sstream>
+
+#include "src/chunkserver/op_trace.h"
+#include "src/common/timeutility.h"
+
+namespace curve {
+namespace chunkserver {
+
+namespace {
+// 以各个stage结束的处理阶段的名字
+const char* const kOpStageNames[kOpStageNum] = {
+    "received",
+    "throttle",
+    "propose",
+    "replicate",
+    "apply_queue",
+    "io",
+    "reply",
+};
+}  // namespace
+
+const char* OpStageName(OpStage stage) {
+    if (stage < 0 || stage >= kOpStageNum) {
+        return "unknown";
+    }
+    return kOpStageNames[stage];
+}
+
+int64_t OpTrace::StageLatency(OpStage stage) const {
+    if (stage <= kOpStageReceived || stage >= kOpStageNum ||
+        timeUs[stage] == 0) {
+        return -1;
+    }
+    for (int prev = stage - 1; prev >= kOpStageReceived; --prev) {
+        if (timeUs[prev] != 0) {
+            return timeUs[stage] - timeUs[prev];
+        }
+    }
+    return -1;
+}
+
+OpTracer* OpTracer::GetInstance() {
+    static OpTracer tracer;
+    return &tracer;
+}
+
+OpTracer::OpTracer() : counter_(0) {}
+
+void OpTracer::Init(const OpTracerOptions& options) {
+    options_ = options;
+    if (slowRequestStatus_ == nullptr) {
+        slowRequestStatus_.reset(new bvar::PassiveStatus<std::string>(
+            "chunkserver_slow_requests", PrintSlowRequests, this));
+    }
+    LOG(INFO) << "Init op tracer, sample interval: "
+              << options_.sampleInterval
+              << ", slow request us: " << options_.slowRequestUs
+              << ", slow request num: " << options_.slowRequestNum;
+}
+
+void OpTracer::OnFinish(const ChunkRequest& request,
+                        const ChunkResponse& response,
+                        const OpTrace& trace) {
+    if (options_.slowRequestUs == 0 ||
+        trace.TotalLatency() < static_cast<int64_t>(options_.slowRequestUs)) {
+        return;
+    }
+
+    std::ostringstream oss;
+    oss << common::TimeUtility::GetTimeofDayMs()
+        << " " << CHUNK_OP_TYPE_Name(request.optype())
+        << " copyset: " << request.logicpoolid()
+        << "," << request.copysetid()
+        << " chunkid: " << request.chunkid()
+        << " offset: " << request.offset()
+        << " size: " << request.size()
+        << " status: " << CHUNK_OP_STATUS_Name(response.status())
+        << " total: " << trace.TotalLatency() << "us";
+    for (int stage = kOpStageThrottled; stage < kOpStageNum; ++stage) {
+        int64_t latency = trace.StageLatency(static_cast<OpStage>(stage));
+        if (latency >= 0) {
+            oss << " " << OpStageName(static_cast<OpStage>(stage))
+                << ": " << latency << "us";
+        }
+    }
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    slowRequests_.push_front(oss.str());
+    while (slowRequests_.size() > options_.slowRequestNum) {
+        slowRequests_.pop_back();
+    }
+}
+
+std::string OpTracer::DumpSlowRequests() {
+    std::ostringstream oss;
+    PrintSlowRequests(oss, this);
+    return oss.str();
+}
+
+void OpTracer::PrintSlowRequests(std::ostream& os, void* arg) {
+    OpTracer* tracer = static_cast<OpTracer*>(arg);
+    std::lock_guard<std::mutex> lk(tracer->mtx_);
+    for (const auto& record : tracer->slowRequests_) {
+        os << record << "\n";
+    }
+}
+
+}  // namespace chunkserver
+}  // namespace curve
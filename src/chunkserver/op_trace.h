@@ -0,0 +1,164 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef SRC_CHUNKSERVER_OP_TRACE_H_
+#define SRC_CHUNKSERVER_OP_TRACE_H_
+
+#include <butil/time.h>
+#include <bvar/bvar.h>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <ostream>
+#include <string>
+
+#include "proto/chunk.pb.h"
+#include "src/common/uncopyable.h"
+
+namespace curve {
+namespace chunkserver {
+
+/**
+ * 读写请求在chunkserver内部经过的各个阶段，按照处理顺序排列
+ */
+enum OpStage {
+    // chunk service收到请求
+    kOpStageReceived = 0,
+    // QoS限流结束，开始处理请求
+    kOpStageThrottled,
+    // 请求已经提交给raft
+    kOpStageProposed,
+    // raft日志已经提交，请求进入并发apply队列
+    kOpStageCommitted,
+    // 并发apply模块开始执行请求
+    kOpStageApplyBegin,
+    // datastore读写结束
+    kOpStageIODone,
+    // 返回response
+    kOpStageResponded,
+    kOpStageNum,
+};
+
+/**
+ * 获取以stage结束的处理阶段的名字，例如kOpStageIODone对应"io"
+ */
+const char* OpStageName(OpStage stage);
+
+/**
+ * 记录请求到达各个阶段的时间，没有经过的阶段时间为0，
+ * 例如走applied index的读请求不会经过propose和commit阶段
+ */
+struct OpTrace {
+    int64_t timeUs[kOpStageNum] = {0};
+
+    void Mark(OpStage stage) {
+        timeUs[stage] = butil::cpuwide_time_us();
+    }
+
+    bool Started() const {
+        return timeUs[kOpStageReceived] != 0;
+    }
+
+    /**
+     * 获取以stage结束的阶段的耗时，即stage与之前最近一个经过的阶段的时间差
+     * @return stage没有经过时返回-1
+     */
+    int64_t StageLatency(OpStage stage) const;
+
+    // 请求从收到到返回的总耗时
+    int64_t TotalLatency() const {
+        return timeUs[kOpStageResponded] - timeUs[kOpStageReceived];
+    }
+};
+
+struct OpTracerOptions {
+    // 每sampleInterval个读写请求记录一次各阶段耗时，0表示关闭
+    uint32_t sampleInterval;
+    // 被采样的请求总耗时超过该值时记录为慢请求，0表示不记录
+    uint64_t slowRequestUs;
+    // 保留最近的慢请求个数
+    uint32_t slowRequestNum;
+
+    OpTracerOptions()
+        : sampleInterval(0),
+          slowRequestUs(0),
+          slowRequestNum(100) {}
+};
+
+/**
+ * 请求阶段耗时的采样和慢请求记录：
+ * 1. 关闭采样时请求不记录任何时间戳，只多一次判断
+ * 2. 慢请求按照各阶段耗时格式化后保存最近的若干条，通过内置http服务的
+ *    /vars/chunkserver_slow_requests查看
+ */
+class OpTracer : public curve::common::Uncopyable {
+ public:
+    static OpTracer* GetInstance();
+
+    void Init(const OpTracerOptions& options);
+
+    /**
+     * 判断当前请求是否需要采样
+     */
+    bool ShouldSample() {
+        uint32_t interval = options_.sampleInterval;
+        if (interval == 0) {
+            return false;
+        }
+        return counter_.fetch_add(1, std::memory_order_relaxed)
+               % interval == 0;
+    }
+
+    bool Enabled() const {
+        return options_.sampleInterval > 0;
+    }
+
+    /**
+     * 采样的请求结束时调用，超过阈值时记录为慢请求
+     */
+    void OnFinish(const ChunkRequest& request,
+                  const ChunkResponse& response,
+                  const OpTrace& trace);
+
+    // 按照从新到旧的顺序输出记录的慢请求
+    std::string DumpSlowRequests();
+
+ private:
+    OpTracer();
+
+    static void PrintSlowRequests(std::ostream& os, void* arg);
+
+ private:
+    OpTracerOptions options_;
+    std::atomic<uint64_t> counter_;
+
+    std::mutex mtx_;
+    std::deque<std::string> slowRequests_;
+    std::unique_ptr<bvar::PassiveStatus<std::string>> slowRequestStatus_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_OP_TRACE_H_
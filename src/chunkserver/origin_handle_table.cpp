@@ -0,0 +1,195 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <glog/logging.h>
+#include <bthread/bthread.h>
+#include <bvar/bvar.h>
+
+#include <algorithm>
+
+#include "src/chunkserver/origin_handle_table.h"
+
+namespace curve {
+namespace chunkserver {
+
+namespace {
+bvar::Adder<int64_t> g_origin_handles("chunkserver_clone_origin_handles");
+bvar::Adder<uint64_t> g_origin_open_failures(
+    "chunkserver_clone_origin_open_failures");
+}  // namespace
+
+OriginHandleTable::OriginHandleTable(uint32_t shardNum, uint32_t capacity,
+                                     OpenFunc opener, CloseFunc closer)
+    : opener_(opener),
+      closer_(closer),
+      openingCount_(0) {
+    shardNum = std::max<uint32_t>(shardNum, 1);
+    shardCapacity_ = std::max<uint32_t>(capacity / shardNum, 1);
+    for (uint32_t i = 0; i < shardNum; ++i) {
+        shards_.emplace_back(new Shard());
+    }
+}
+
+OriginHandleTable::~OriginHandleTable() {
+    CloseAll();
+}
+
+void OriginHandleTable::Get(const std::string& fileName,
+                            const HandleCallback& cb) {
+    FlushPendingClose();
+
+    Shard* shard = GetShard(fileName);
+    std::unique_lock<std::mutex> lk(shard->mtx);
+    auto iter = shard->entries.find(fileName);
+    if (iter != shard->entries.end()) {
+        Entry& entry = iter->second;
+        if (entry.opening) {
+            entry.waiters.push_back(cb);
+            return;
+        }
+        shard->lru.splice(shard->lru.begin(), shard->lru, entry.lruIter);
+        scoped_refptr<OriginHandle> handle = entry.handle;
+        lk.unlock();
+        cb(handle);
+        return;
+    }
+
+    Entry& entry = shard->entries[fileName];
+    entry.opening = true;
+    entry.waiters.push_back(cb);
+    lk.unlock();
+
+    {
+        std::lock_guard<std::mutex> openLk(openMtx_);
+        ++openingCount_;
+    }
+    OpenTask* task = new OpenTask{this, fileName};
+    bthread_t tid;
+    if (bthread_start_background(&tid, nullptr, RunOpen, task) != 0) {
+        LOG(WARNING) << "Start bthread to open " << fileName
+                     << " failed, open it in current thread";
+        RunOpen(task);
+    }
+}
+
+void* OriginHandleTable::RunOpen(void* arg) {
+    std::unique_ptr<OpenTask> task(static_cast<OpenTask*>(arg));
+    int fd = task->table->opener_(task->fileName);
+    task->table->OnOpened(task->fileName, fd);
+    return nullptr;
+}
+
+void OriginHandleTable::OnOpened(const std::string& fileName, int fd) {
+    scoped_refptr<OriginHandle> handle;
+    std::vector<HandleCallback> waiters;
+    Shard* shard = GetShard(fileName);
+    {
+        std::lock_guard<std::mutex> lk(shard->mtx);
+        auto iter = shard->entries.find(fileName);
+        CHECK(iter != shard->entries.end());
+        waiters.swap(iter->second.waiters);
+        if (fd < 0) {
+            // 打开失败不缓存，下一次请求重新打开
+            shard->entries.erase(iter);
+            g_origin_open_failures << 1;
+        } else {
+            handle = new OriginHandle(
+                fd, std::bind(&OriginHandleTable::DeferClose, this,
+                              std::placeholders::_1));
+            g_origin_handles << 1;
+            Entry& entry = iter->second;
+            entry.handle = handle;
+            entry.opening = false;
+            shard->lru.push_front(fileName);
+            entry.lruIter = shard->lru.begin();
+            EvictLocked(shard);
+        }
+    }
+
+    for (const auto& cb : waiters) {
+        cb(handle);
+    }
+
+    std::lock_guard<std::mutex> openLk(openMtx_);
+    --openingCount_;
+    openCond_.notify_all();
+}
+
+void OriginHandleTable::EvictLocked(Shard* shard) {
+    while (shard->lru.size() > shardCapacity_) {
+        const std::string& victim = shard->lru.back();
+        // 句柄上还有读请求时，等最后一个引用释放后再关闭
+        shard->entries.erase(victim);
+        shard->lru.pop_back();
+    }
+}
+
+void OriginHandleTable::CloseAll() {
+    {
+        std::unique_lock<std::mutex> openLk(openMtx_);
+        openCond_.wait(openLk, [this] { return openingCount_ == 0; });
+    }
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lk(shard->mtx);
+        shard->entries.clear();
+        shard->lru.clear();
+    }
+    FlushPendingClose();
+}
+
+size_t OriginHandleTable::Size() {
+    size_t size = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lk(shard->mtx);
+        size += shard->lru.size();
+    }
+    return size;
+}
+
+OriginHandleTable::Shard* OriginHandleTable::GetShard(
+    const std::string& fileName) {
+    size_t index = std::hash<std::string>()(fileName) % shards_.size();
+    return shards_[index].get();
+}
+
+void OriginHandleTable::DeferClose(int fd) {
+    std::lock_guard<std::mutex> lk(closeMtx_);
+    pendingClose_.push_back(fd);
+}
+
+void OriginHandleTable::FlushPendingClose() {
+    std::vector<int> fds;
+    {
+        std::lock_guard<std::mutex> lk(closeMtx_);
+        if (pendingClose_.empty()) {
+            return;
+        }
+        fds.swap(pendingClose_);
+    }
+    for (int fd : fds) {
+        closer_(fd);
+        g_origin_handles << -1;
+    }
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,157 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef SRC_CHUNKSERVER_ORIGIN_HANDLE_TABLE_H_
+#define SRC_CHUNKSERVER_ORIGIN_HANDLE_TABLE_H_
+
+#include <butil/memory/ref_counted.h>
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace curve {
+namespace chunkserver {
+
+/**
+ * 已经打开的源文件句柄，最后一个引用释放时关闭文件
+ */
+class OriginHandle : public butil::RefCountedThreadSafe<OriginHandle> {
+ public:
+    OriginHandle(int fd, std::function<void(int)> closer)
+        : fd_(fd), closer_(closer) {}
+
+    int Fd() const {
+        return fd_;
+    }
+
+ private:
+    friend class butil::RefCountedThreadSafe<OriginHandle>;
+    ~OriginHandle() {
+        closer_(fd_);
+    }
+
+    int fd_;
+    std::function<void(int)> closer_;
+};
+
+/**
+ * 源文件句柄表，按照文件名分片加锁:
+ * 1. 句柄不存在时在后台bthread中打开文件，打开期间同一文件的其他请求
+ *    等待同一次打开，不会阻塞其他文件的请求
+ * 2. 每个分片按照LRU保留最近使用的句柄，超过容量时淘汰最久未使用的句柄，
+ *    句柄上还有未完成的读请求时等读请求结束后再关闭
+ * 3. 关闭文件可能阻塞，所以不在释放引用的线程中执行，而是由下一次Get或者
+ *    CloseAll统一关闭
+ */
+class OriginHandleTable {
+ public:
+    // 打开文件，成功返回fd，失败返回负数
+    using OpenFunc = std::function<int(const std::string&)>;
+    using CloseFunc = std::function<void(int)>;
+    // 打开失败时handle为nullptr
+    using HandleCallback =
+        std::function<void(const scoped_refptr<OriginHandle>& handle)>;
+
+    /**
+     * @param shardNum: 分片的个数
+     * @param capacity: 所有分片保留的句柄总数
+     * @param opener: 打开文件的函数
+     * @param closer: 关闭文件的函数
+     */
+    OriginHandleTable(uint32_t shardNum, uint32_t capacity,
+                      OpenFunc opener, CloseFunc closer);
+    ~OriginHandleTable();
+
+    /**
+     * 获取文件句柄，句柄已经打开时在当前线程回调，否则在打开文件的bthread中回调
+     * @param fileName: 文件名
+     * @param cb: 获取到句柄之后执行的回调
+     */
+    void Get(const std::string& fileName, const HandleCallback& cb);
+
+    /**
+     * 等待正在进行的打开结束，并关闭所有句柄
+     */
+    void CloseAll();
+
+    // 当前缓存的句柄个数
+    size_t Size();
+
+ private:
+    struct Entry {
+        scoped_refptr<OriginHandle> handle;
+        // 正在打开时等待的请求
+        std::vector<HandleCallback> waiters;
+        // 在lru中的位置，打开完成之后才会加入lru
+        std::list<std::string>::iterator lruIter;
+        bool opening;
+    };
+
+    struct Shard {
+        std::mutex mtx;
+        std::unordered_map<std::string, Entry> entries;
+        // 头部为最近使用的文件
+        std::list<std::string> lru;
+    };
+
+    struct OpenTask {
+        OriginHandleTable* table;
+        std::string fileName;
+    };
+
+    static void* RunOpen(void* arg);
+    void OnOpened(const std::string& fileName, int fd);
+
+    Shard* GetShard(const std::string& fileName);
+    // 淘汰超出容量的句柄，调用者需要持有shard的锁
+    void EvictLocked(Shard* shard);
+
+    void DeferClose(int fd);
+    void FlushPendingClose();
+
+ private:
+    std::vector<std::unique_ptr<Shard>> shards_;
+    uint32_t shardCapacity_;
+    OpenFunc opener_;
+    CloseFunc closer_;
+
+    // 等待关闭的fd
+    std::mutex closeMtx_;
+    std::vector<int> pendingClose_;
+
+    // 正在打开的文件个数，CloseAll时需要等待打开结束
+    std::mutex openMtx_;
+    std::condition_variable openCond_;
+    uint32_t openingCount_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_ORIGIN_HANDLE_TABLE_H_
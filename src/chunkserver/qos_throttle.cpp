@@ -0,0 +1,310 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include "src/chunkserver/qos_throttle.h"
+
+#include <glog/logging.h>
+#include <bthread/bthread.h>
+
+#include <algorithm>
+
+#include "src/common/timeutility.h"
+#include "src/chunkserver/chunkserver_metrics.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::common::ReadLockGuard;
+using curve::common::WriteLockGuard;
+using curve::common::TimeUtility;
+
+TokenBucket::TokenBucket(uint64_t rate, uint64_t burst)
+    : rate_(rate),
+      burst_(burst == 0 ? rate : burst),
+      tokens_(static_cast<double>(burst == 0 ? rate : burst)),
+      lastRefillUs_(TimeUtility::GetTimeofDayUs()) {}
+
+void TokenBucket::Refill(uint64_t nowUs) {
+    if (nowUs <= lastRefillUs_) {
+        return;
+    }
+    double delta =
+        static_cast<double>(nowUs - lastRefillUs_) * rate_ / 1000000;
+    tokens_ = std::min(tokens_ + delta, static_cast<double>(burst_));
+    lastRefillUs_ = nowUs;
+}
+
+bool TokenBucket::Reserve(uint64_t tokens, uint64_t nowUs,
+                          uint64_t maxWaitUs, uint64_t* waitUs) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    *waitUs = 0;
+    if (rate_ == 0) {
+        return true;
+    }
+
+    Refill(nowUs);
+    double left = tokens_ - tokens;
+    if (left >= 0) {
+        tokens_ = left;
+        return true;
+    }
+    // 透支的令牌需要按照速率补齐之后请求才能下发
+    uint64_t wait = static_cast<uint64_t>(-left * 1000000 / rate_);
+    if (wait > maxWaitUs && tokens_ < 0) {
+        return false;
+    }
+    tokens_ = left;
+    *waitUs = wait;
+    return true;
+}
+
+void TokenBucket::Cancel(uint64_t tokens) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (rate_ == 0) {
+        return;
+    }
+    tokens_ = std::min(tokens_ + tokens, static_cast<double>(burst_));
+}
+
+void TokenBucket::Reset(uint64_t rate, uint64_t burst) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    Refill(TimeUtility::GetTimeofDayUs());
+    rate_ = rate;
+    burst_ = (burst == 0 ? rate : burst);
+    tokens_ = std::min(tokens_, static_cast<double>(burst_));
+}
+
+QosBucket::QosBucket(const QosLimit& limit, bool custom)
+    : iopsBucket_(limit.iopsLimit, limit.iopsBurst),
+      bpsBucket_(limit.bpsLimit, limit.bpsBurst),
+      custom_(custom),
+      lastUsedUs_(TimeUtility::GetTimeofDayUs()) {}
+
+bool QosBucket::Reserve(uint64_t bytes, uint64_t nowUs,
+                        uint64_t maxWaitUs, uint64_t* waitUs) {
+    lastUsedUs_.store(nowUs, std::memory_order_relaxed);
+    uint64_t iopsWait = 0;
+    uint64_t bpsWait = 0;
+    if (!iopsBucket_.Reserve(1, nowUs, maxWaitUs, &iopsWait)) {
+        return false;
+    }
+    if (!bpsBucket_.Reserve(bytes, nowUs, maxWaitUs, &bpsWait)) {
+        iopsBucket_.Cancel(1);
+        return false;
+    }
+    *waitUs = std::max(iopsWait, bpsWait);
+    return true;
+}
+
+void QosBucket::Cancel(uint64_t bytes) {
+    iopsBucket_.Cancel(1);
+    bpsBucket_.Cancel(bytes);
+}
+
+void QosBucket::Update(const QosLimit& limit) {
+    iopsBucket_.Reset(limit.iopsLimit, limit.iopsBurst);
+    bpsBucket_.Reset(limit.bpsLimit, limit.bpsBurst);
+    custom_.store(true, std::memory_order_relaxed);
+}
+
+QosLimit QosBucket::GetLimit() const {
+    QosLimit limit;
+    limit.iopsLimit = iopsBucket_.Rate();
+    limit.iopsBurst = iopsBucket_.Burst();
+    limit.bpsLimit = bpsBucket_.Rate();
+    limit.bpsBurst = bpsBucket_.Burst();
+    return limit;
+}
+
+QosThrottle::QosThrottle(const QosOptions& options)
+    : options_(options),
+      lastRecycleUs_(TimeUtility::GetTimeofDayUs()) {}
+
+std::shared_ptr<QosBucket> QosThrottle::GetOrCreateBucket(
+    std::unordered_map<uint64_t, std::shared_ptr<QosBucket>>* buckets,
+    uint64_t key, const QosLimit& defaultLimit) {
+    {
+        ReadLockGuard lockGuard(rwLock_);
+        auto it = buckets->find(key);
+        if (it != buckets->end()) {
+            return it->second;
+        }
+    }
+
+    // 默认不限流时不需要为其创建令牌桶
+    if (defaultLimit.IsUnlimited()) {
+        return nullptr;
+    }
+
+    WriteLockGuard lockGuard(rwLock_);
+    auto it = buckets->find(key);
+    if (it != buckets->end()) {
+        return it->second;
+    }
+    auto bucket = std::make_shared<QosBucket>(defaultLimit);
+    buckets->emplace(key, bucket);
+    return bucket;
+}
+
+bool QosThrottle::Reserve(LogicPoolID logicPoolId,
+                          CopysetID copysetId,
+                          uint64_t fileId,
+                          uint64_t bytes,
+                          uint64_t* waitUs) {
+    *waitUs = 0;
+    if (!options_.enable) {
+        return true;
+    }
+
+    uint64_t nowUs = TimeUtility::GetTimeofDayUs();
+    auto copysetBucket = GetOrCreateBucket(&copysetBuckets_,
+        ToGroupNid(logicPoolId, copysetId), options_.copysetLimit);
+    if (copysetBucket != nullptr &&
+        !copysetBucket->Reserve(bytes, nowUs, options_.maxWaitUs, waitUs)) {
+        return false;
+    }
+
+    if (fileId != 0) {
+        RecycleIdleFileBuckets(nowUs);
+        auto fileBucket = GetOrCreateBucket(&fileBuckets_,
+                                            fileId, options_.fileLimit);
+        uint64_t fileWaitUs = 0;
+        if (fileBucket != nullptr && !fileBucket->Reserve(
+                bytes, nowUs, options_.maxWaitUs, &fileWaitUs)) {
+            // 请求不会下发，归还在copyset上预留的令牌
+            if (copysetBucket != nullptr) {
+                copysetBucket->Cancel(bytes);
+            }
+            return false;
+        }
+        *waitUs = std::max(*waitUs, fileWaitUs);
+    }
+
+    // 桶中没有透支时预留的大请求等待时间可能超过上限，此时只等待上限时间
+    *waitUs = std::min(*waitUs, options_.maxWaitUs);
+    return true;
+}
+
+bool QosThrottle::Throttle(LogicPoolID logicPoolId,
+                           CopysetID copysetId,
+                           uint64_t fileId,
+                           uint64_t bytes) {
+    uint64_t waitUs = 0;
+    if (!Reserve(logicPoolId, copysetId, fileId, bytes, &waitUs)) {
+        return false;
+    }
+    if (waitUs == 0) {
+        return true;
+    }
+
+    bthread_usleep(waitUs);
+    ChunkServerMetric::GetInstance()->OnThrottle(logicPoolId,
+                                                 copysetId,
+                                                 waitUs);
+    return true;
+}
+
+void QosThrottle::RecycleIdleFileBuckets(uint64_t nowUs) {
+    uint64_t idleUs = options_.fileBucketIdleS * 1000000;
+    uint64_t lastRecycleUs = lastRecycleUs_.load(std::memory_order_relaxed);
+    if (nowUs < lastRecycleUs + idleUs) {
+        return;
+    }
+    // 只让一个请求执行回收
+    if (!lastRecycleUs_.compare_exchange_strong(lastRecycleUs, nowUs)) {
+        return;
+    }
+
+    WriteLockGuard lockGuard(rwLock_);
+    for (auto it = fileBuckets_.begin(); it != fileBuckets_.end();) {
+        if (!it->second->IsCustom() &&
+            nowUs >= it->second->LastUsedUs() + idleUs) {
+            it = fileBuckets_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void QosThrottle::UpdateCopysetLimit(LogicPoolID logicPoolId,
+                                     CopysetID copysetId,
+                                     const QosLimit& limit) {
+    uint64_t key = ToGroupNid(logicPoolId, copysetId);
+    WriteLockGuard lockGuard(rwLock_);
+    auto it = copysetBuckets_.find(key);
+    if (it != copysetBuckets_.end()) {
+        it->second->Update(limit);
+    } else {
+        copysetBuckets_.emplace(key,
+                                std::make_shared<QosBucket>(limit, true));
+    }
+    LOG(INFO) << "Update qos limit of copyset "
+              << ToGroupIdString(logicPoolId, copysetId)
+              << ", iops limit: " << limit.iopsLimit
+              << ", iops burst: " << limit.iopsBurst
+              << ", bps limit: " << limit.bpsLimit
+              << ", bps burst: " << limit.bpsBurst;
+}
+
+void QosThrottle::UpdateFileLimit(uint64_t fileId, const QosLimit& limit) {
+    WriteLockGuard lockGuard(rwLock_);
+    auto it = fileBuckets_.find(fileId);
+    if (it != fileBuckets_.end()) {
+        it->second->Update(limit);
+    } else {
+        fileBuckets_.emplace(fileId,
+                             std::make_shared<QosBucket>(limit, true));
+    }
+    LOG(INFO) << "Update qos limit of file " << fileId
+              << ", iops limit: " << limit.iopsLimit
+              << ", iops burst: " << limit.iopsBurst
+              << ", bps limit: " << limit.bpsLimit
+              << ", bps burst: " << limit.bpsBurst;
+}
+
+void QosThrottle::RemoveCopyset(LogicPoolID logicPoolId,
+                                CopysetID copysetId) {
+    WriteLockGuard lockGuard(rwLock_);
+    copysetBuckets_.erase(ToGroupNid(logicPoolId, copysetId));
+}
+
+QosLimit QosThrottle::GetCopysetLimit(LogicPoolID logicPoolId,
+                                      CopysetID copysetId) {
+    ReadLockGuard lockGuard(rwLock_);
+    auto it = copysetBuckets_.find(ToGroupNid(logicPoolId, copysetId));
+    if (it == copysetBuckets_.end()) {
+        return options_.copysetLimit;
+    }
+    return it->second->GetLimit();
+}
+
+QosLimit QosThrottle::GetFileLimit(uint64_t fileId) {
+    ReadLockGuard lockGuard(rwLock_);
+    auto it = fileBuckets_.find(fileId);
+    if (it == fileBuckets_.end()) {
+        return options_.fileLimit;
+    }
+    return it->second->GetLimit();
+}
+
+}  // namespace chunkserver
+}  // namespace curve
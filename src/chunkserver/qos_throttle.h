@@ -0,0 +1,255 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef SRC_CHUNKSERVER_QOS_THROTTLE_H_
+#define SRC_CHUNKSERVER_QOS_THROTTLE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>    // NOLINT
+#include <unordered_map>
+
+#include "include/chunkserver/chunkserver_common.h"
+#include "src/common/concurrent/rw_lock.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::common::RWLock;
+
+/**
+ * 限流参数，limit为每秒的速率，burst为桶的容量
+ * limit为0表示不限制，burst为0时取值为limit
+ */
+struct QosLimit {
+    uint64_t iopsLimit = 0;
+    uint64_t iopsBurst = 0;
+    uint64_t bpsLimit = 0;
+    uint64_t bpsBurst = 0;
+
+    bool IsUnlimited() const {
+        return iopsLimit == 0 && bpsLimit == 0;
+    }
+};
+
+/**
+ * 令牌桶，采用预留的方式：令牌不足时允许透支，并返回调用者需要等待的时间，
+ * 这样先到的请求先拿到令牌，后到的请求依次排在后面等待。
+ * 透支的令牌在最长等待时间内必须能够补齐，超出的请求不再预留，
+ * 否则持续超限时透支会无限增长
+ */
+class TokenBucket {
+ public:
+    TokenBucket(uint64_t rate, uint64_t burst);
+
+    /**
+     * 预留指定数量的令牌。桶中没有透支时总是可以预留，保证超过桶容量的
+     * 大请求也能下发；已经透支时，补齐透支的时间超过maxWaitUs则不预留
+     * @param tokens: 需要的令牌数量
+     * @param nowUs: 当前时间，单位us
+     * @param maxWaitUs: 最长等待时间，单位us
+     * @param[out] waitUs: 需要等待的时间，单位us，0表示不需要等待
+     * @return 预留成功返回true，令牌不足且等待时间超过maxWaitUs返回false
+     */
+    bool Reserve(uint64_t tokens, uint64_t nowUs, uint64_t maxWaitUs,
+                 uint64_t* waitUs);
+
+    /**
+     * 归还预留的令牌，同一个请求在其他桶中预留失败时调用
+     */
+    void Cancel(uint64_t tokens);
+
+    /**
+     * 运行时修改速率和桶的容量，已透支的令牌保留
+     */
+    void Reset(uint64_t rate, uint64_t burst);
+
+    uint64_t Rate() const {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return rate_;
+    }
+
+    uint64_t Burst() const {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return burst_;
+    }
+
+ private:
+    void Refill(uint64_t nowUs);
+
+ private:
+    mutable std::mutex mtx_;
+    // 每秒产生的令牌数，0表示不限制
+    uint64_t rate_;
+    // 桶的容量
+    uint64_t burst_;
+    // 当前桶中的令牌数，为负数时表示已经透支
+    double tokens_;
+    // 上次补充令牌的时间
+    uint64_t lastRefillUs_;
+};
+
+/**
+ * 一组iops和bps令牌桶，用于对copyset或者卷进行限流
+ */
+class QosBucket {
+ public:
+    /**
+     * @param limit: 限流参数
+     * @param custom: 是否为运行时单独设置的限流参数，单独设置的不会被回收
+     */
+    explicit QosBucket(const QosLimit& limit, bool custom = false);
+
+    /**
+     * 一个请求消耗1个iops令牌和bytes个bps令牌，两个桶都预留成功才算成功
+     * @param[out] waitUs: 需要等待的时间，单位us
+     * @return 预留成功返回true，等待时间超过maxWaitUs返回false
+     */
+    bool Reserve(uint64_t bytes, uint64_t nowUs, uint64_t maxWaitUs,
+                 uint64_t* waitUs);
+
+    /**
+     * 归还一个请求预留的令牌
+     */
+    void Cancel(uint64_t bytes);
+
+    void Update(const QosLimit& limit);
+
+    QosLimit GetLimit() const;
+
+    bool IsCustom() const {
+        return custom_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t LastUsedUs() const {
+        return lastUsedUs_.load(std::memory_order_relaxed);
+    }
+
+ private:
+    TokenBucket iopsBucket_;
+    TokenBucket bpsBucket_;
+    std::atomic<bool> custom_;
+    // 最近一次预留令牌的时间，用于回收长时间没有io的卷的令牌桶
+    std::atomic<uint64_t> lastUsedUs_;
+};
+
+struct QosOptions {
+    // 是否开启QoS
+    bool enable = false;
+    // 每个copyset默认的限流参数
+    QosLimit copysetLimit;
+    // 每个卷(file id)默认的限流参数
+    QosLimit fileLimit;
+    // 单个请求最长排队时间，需要排队更久的请求被拒绝，单位us
+    uint64_t maxWaitUs = 1000000;
+    // 卷的令牌桶超过该时间没有io时回收，单独设置过限流参数的除外，单位s
+    uint64_t fileBucketIdleS = 600;
+};
+
+/**
+ * chunkserver端的QoS，分别在copyset粒度和卷粒度上对读写请求做iops和bps限流，
+ * 超过限额的请求在service层排队等待，而不是返回OVERLOAD让client重试；
+ * 只有排队时间超过maxWaitUs的请求才返回OVERLOAD
+ */
+class QosThrottle {
+ public:
+    explicit QosThrottle(const QosOptions& options);
+    virtual ~QosThrottle() = default;
+
+    /**
+     * 计算请求需要等待的时间，并预留令牌
+     * @param logicPoolId/copysetId: 请求所在的copyset
+     * @param fileId: 请求所属的卷，0表示请求中没有携带
+     * @param bytes: 请求的数据量
+     * @param[out] waitUs: 需要等待的时间，单位us
+     * @return 预留成功返回true，需要等待超过maxWaitUs时不预留并返回false
+     */
+    virtual bool Reserve(LogicPoolID logicPoolId,
+                         CopysetID copysetId,
+                         uint64_t fileId,
+                         uint64_t bytes,
+                         uint64_t* waitUs);
+
+    /**
+     * 对请求进行限流，需要等待时在当前bthread中睡眠，不阻塞worker线程
+     * @return 请求可以下发返回true，需要拒绝返回false
+     */
+    virtual bool Throttle(LogicPoolID logicPoolId,
+                          CopysetID copysetId,
+                          uint64_t fileId,
+                          uint64_t bytes);
+
+    /**
+     * 运行时修改指定copyset的限流参数
+     */
+    void UpdateCopysetLimit(LogicPoolID logicPoolId,
+                            CopysetID copysetId,
+                            const QosLimit& limit);
+
+    /**
+     * 运行时修改指定卷的限流参数
+     */
+    void UpdateFileLimit(uint64_t fileId, const QosLimit& limit);
+
+    /**
+     * 删除copyset的限流状态，copyset从chunkserver上删除时调用
+     */
+    void RemoveCopyset(LogicPoolID logicPoolId, CopysetID copysetId);
+
+    /**
+     * 获取指定copyset/卷当前生效的限流参数
+     */
+    QosLimit GetCopysetLimit(LogicPoolID logicPoolId, CopysetID copysetId);
+    QosLimit GetFileLimit(uint64_t fileId);
+
+    bool Enabled() const {
+        return options_.enable;
+    }
+
+ private:
+    std::shared_ptr<QosBucket> GetOrCreateBucket(
+        std::unordered_map<uint64_t, std::shared_ptr<QosBucket>>* buckets,
+        uint64_t key, const QosLimit& defaultLimit);
+
+    /**
+     * 回收长时间没有io且使用默认限流参数的卷的令牌桶，
+     * 每隔fileBucketIdleS最多执行一次
+     */
+    void RecycleIdleFileBuckets(uint64_t nowUs);
+
+ private:
+    QosOptions options_;
+    // 上次回收卷令牌桶的时间
+    std::atomic<uint64_t> lastRecycleUs_;
+    // 保护下面两个map
+    RWLock rwLock_;
+    // copyset的令牌桶，key为GroupNid
+    std::unordered_map<uint64_t, std::shared_ptr<QosBucket>> copysetBuckets_;
+    // 卷的令牌桶，key为file id
+    std::unordered_map<uint64_t, std::shared_ptr<QosBucket>> fileBuckets_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_QOS_THROTTLE_H_
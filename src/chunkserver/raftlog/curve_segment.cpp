@@ -0,0 +1,579 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+// Copyright (c) 2015 Baidu.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Authors: Wang,Yao(wangyao02@baidu.com)
+//          Zhangyi Chen(chenzhangyi01@baidu.com)
+//          Xiong,Kai(xiongkai@baidu.com)
+
+#include "src/chunkserver/raftlog/curve_segment.h"
+
+#include <glog/logging.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <butil/raw_pack.h>
+#include <butil/fd_utility.h>
+#include <butil/fast_rand.h>
+#include <butil/string_printf.h>
+#include <braft/util.h>
+
+#include <cinttypes>
+#include <mutex>  // NOLINT
+
+#include "src/common/crc32.h"
+#include "src/chunkserver/raftlog/util.h"
+
+namespace curve {
+namespace chunkserver {
+
+using ::butil::RawPacker;
+using ::butil::RawUnpacker;
+
+namespace {
+
+// 当前只支持crc32c一种校验方式，保留该字段以便以后扩展
+const int kChecksumCRC32C = 1;
+
+}  // namespace
+
+CurveSegment::CurveSegment(const std::string& path, int64_t firstIndex,
+                           std::shared_ptr<ChunkfilePool> walFilePool)
+    : path_(path),
+      walFilePool_(walFilePool),
+      fd_(-1),
+      isOpen_(true),
+      firstIndex_(firstIndex),
+      lastIndex_(firstIndex - 1),
+      nonce_(0) {
+    ChunkfilePoolOptions opt = walFilePool_->GetChunkFilePoolOpt();
+    dataOffset_ = opt.metaPageSize;
+    capacity_ = opt.chunkSize + opt.metaPageSize;
+    bytes_ = dataOffset_;
+}
+
+CurveSegment::CurveSegment(const std::string& path, int64_t firstIndex,
+                           int64_t lastIndex,
+                           std::shared_ptr<ChunkfilePool> walFilePool)
+    : path_(path),
+      walFilePool_(walFilePool),
+      fd_(-1),
+      isOpen_(false),
+      firstIndex_(firstIndex),
+      lastIndex_(lastIndex),
+      nonce_(0) {
+    ChunkfilePoolOptions opt = walFilePool_->GetChunkFilePoolOpt();
+    dataOffset_ = opt.metaPageSize;
+    capacity_ = opt.chunkSize + opt.metaPageSize;
+    bytes_ = dataOffset_;
+}
+
+CurveSegment::~CurveSegment() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+std::string CurveSegment::FileName() const {
+    std::string path(path_);
+    if (isOpen_) {
+        butil::string_appendf(&path, "/" CURVE_SEGMENT_OPEN_PATTERN,
+                              firstIndex_);
+    } else {
+        butil::string_appendf(&path, "/" CURVE_SEGMENT_CLOSED_PATTERN,
+                              firstIndex_, lastIndex_.load());
+    }
+    return path;
+}
+
+void CurveSegment::EncodeSegmentHeader(char* buf) const {
+    ::memcpy(buf, kCurveSegmentMagic, 8);
+    RawPacker packer(buf + 8);
+    packer.pack64(firstIndex_).pack32(nonce_);
+    uint32_t crc = curve::common::CRC32(buf, kCurveSegmentHeaderSize - 4);
+    RawPacker(buf + kCurveSegmentHeaderSize - 4).pack32(crc);
+}
+
+int CurveSegment::Create() {
+    if (!isOpen_) {
+        CHECK(false) << "Create on a closed segment at first_index="
+                     << firstIndex_ << " in " << path_;
+        return -1;
+    }
+    if (dataOffset_ < kCurveSegmentHeaderSize || capacity_ <= dataOffset_) {
+        LOG(ERROR) << "Invalid wal file pool option, meta page size: "
+                   << dataOffset_ << ", file size: " << capacity_;
+        return -1;
+    }
+
+    nonce_ = static_cast<uint32_t>(butil::fast_rand());
+    std::unique_ptr<char[]> metaPage(new char[dataOffset_]);
+    ::memset(metaPage.get(), 0, dataOffset_);
+    EncodeSegmentHeader(metaPage.get());
+
+    std::string path = FileName();
+    int ret = walFilePool_->GetChunk(path, metaPage.get());
+    if (ret < 0) {
+        LOG(ERROR) << "Fail to get segment file from wal file pool, path: "
+                   << path << ", ret: " << ret;
+        return -1;
+    }
+
+    fd_ = ::open(path.c_str(), O_RDWR);
+    if (fd_ < 0) {
+        PLOG(ERROR) << "Fail to open " << path;
+        return -1;
+    }
+    butil::make_close_on_exec(fd_);
+    bytes_ = dataOffset_;
+    LOG(INFO) << "Created new segment `" << path << "' with fd=" << fd_;
+    return 0;
+}
+
+int CurveSegment::LoadSegmentHeader() {
+    char buf[kCurveSegmentHeaderSize];
+    ssize_t n = ::pread(fd_, buf, kCurveSegmentHeaderSize, 0);
+    if (n != kCurveSegmentHeaderSize) {
+        PLOG(ERROR) << "Fail to read segment header, path: " << FileName();
+        return -1;
+    }
+    if (::memcmp(buf, kCurveSegmentMagic, 8) != 0) {
+        LOG(ERROR) << "Invalid segment magic, path: " << FileName();
+        return -1;
+    }
+    int64_t firstIndex = 0;
+    uint32_t nonce = 0;
+    uint32_t crc = 0;
+    RawUnpacker(buf + 8).unpack64((uint64_t&)firstIndex)  // NOLINT
+                        .unpack32(nonce)
+                        .unpack32(crc);
+    if (crc != curve::common::CRC32(buf, kCurveSegmentHeaderSize - 4)) {
+        LOG(ERROR) << "Found corrupted segment header, path: " << FileName();
+        return -1;
+    }
+    if (firstIndex != firstIndex_) {
+        LOG(ERROR) << "First index in segment header mismatch, path: "
+                   << FileName() << ", header first index: " << firstIndex;
+        return -1;
+    }
+    nonce_ = nonce;
+    return 0;
+}
+
+int CurveSegment::LoadEntry(uint64_t offset, EntryHeader* head,
+                            butil::IOBuf* data) const {
+    if (offset + kCurveEntryHeaderSize > capacity_) {
+        return -1;
+    }
+    char buf[kCurveEntryHeaderSize];
+    ssize_t n = ::pread(fd_, buf, kCurveEntryHeaderSize, offset);
+    if (n != kCurveEntryHeaderSize) {
+        return -1;
+    }
+
+    int64_t term = 0;
+    int64_t index = 0;
+    uint32_t metaField = 0;
+    uint32_t dataLen = 0;
+    uint32_t dataChecksum = 0;
+    uint32_t nonce = 0;
+    uint32_t headerChecksum = 0;
+    RawUnpacker(buf).unpack64((uint64_t&)term)  // NOLINT
+                    .unpack64((uint64_t&)index)  // NOLINT
+                    .unpack32(metaField)
+                    .unpack32(dataLen)
+                    .unpack32(dataChecksum)
+                    .unpack32(nonce)
+                    .unpack32(headerChecksum);
+    if (headerChecksum !=
+        curve::common::CRC32(buf, kCurveEntryHeaderSize - 4)) {
+        return -1;
+    }
+    if (offset + kCurveEntryHeaderSize + dataLen > capacity_) {
+        return -1;
+    }
+
+    head->term = term;
+    head->index = index;
+    head->type = metaField >> 24;
+    head->checksumType = (metaField << 8) >> 24;
+    head->dataLen = dataLen;
+    head->dataChecksum = dataChecksum;
+    head->nonce = nonce;
+
+    if (data != nullptr) {
+        butil::IOPortal portal;
+        n = braft::file_pread(&portal, fd_,
+                              offset + kCurveEntryHeaderSize, dataLen);
+        if (n != static_cast<ssize_t>(dataLen)) {
+            LOG(ERROR) << "Fail to read entry data at offset=" << offset
+                       << ", path: " << FileName();
+            return -1;
+        }
+        if (IOBufCRC32(portal) != dataChecksum) {
+            LOG(ERROR) << "Found corrupted data at offset="
+                       << offset + kCurveEntryHeaderSize
+                       << ", path: " << FileName();
+            return -1;
+        }
+        data->swap(portal);
+    }
+    return 0;
+}
+
+int CurveSegment::Load(braft::ConfigurationManager* configurationManager) {
+    std::string path = FileName();
+    fd_ = ::open(path.c_str(), O_RDWR);
+    if (fd_ < 0) {
+        PLOG(ERROR) << "Fail to open " << path;
+        return -1;
+    }
+    butil::make_close_on_exec(fd_);
+
+    if (LoadSegmentHeader() != 0) {
+        return -1;
+    }
+
+    // 依次加载entry，遇到头部不合法、nonce或者index不匹配的entry时即认为
+    // 到达了segment的结尾，open segment还需要校验数据部分，防止最后一条
+    // entry只写了一半
+    int ret = 0;
+    int64_t expectIndex = firstIndex_;
+    uint64_t offset = dataOffset_;
+    offsetAndTerm_.clear();
+    while (true) {
+        if (!isOpen_ && expectIndex > lastIndex_.load()) {
+            break;
+        }
+        EntryHeader header;
+        if (LoadEntry(offset, &header, nullptr) != 0
+            || header.nonce != nonce_
+            || header.index != expectIndex) {
+            break;
+        }
+        butil::IOBuf data;
+        if (isOpen_ || header.type == braft::ENTRY_TYPE_CONFIGURATION) {
+            if (LoadEntry(offset, &header, &data) != 0) {
+                break;
+            }
+        }
+        if (header.type == braft::ENTRY_TYPE_CONFIGURATION) {
+            scoped_refptr<braft::LogEntry> entry = new braft::LogEntry();
+            entry->id.index = expectIndex;
+            entry->id.term = header.term;
+            butil::Status status =
+                braft::parse_configuration_meta(data, entry);
+            if (status.ok()) {
+                braft::ConfigurationEntry confEntry(*entry);
+                configurationManager->add(confEntry);
+            } else {
+                LOG(ERROR) << "fail to parse configuration meta, path: "
+                           << path << " entry_off " << offset;
+                ret = -1;
+                break;
+            }
+        }
+        offsetAndTerm_.push_back(std::make_pair(offset, header.term));
+        ++expectIndex;
+        offset += kCurveEntryHeaderSize + header.dataLen;
+    }
+    if (ret != 0) {
+        return ret;
+    }
+
+    const int64_t lastIndex = expectIndex - 1;
+    if (!isOpen_ && lastIndex != lastIndex_.load()) {
+        LOG(ERROR) << "closed segment is corrupted, path: " << path
+                   << " first_index: " << firstIndex_
+                   << " expect_last_index: " << lastIndex_.load()
+                   << " loaded_last_index: " << lastIndex;
+        return -1;
+    }
+    lastIndex_.store(lastIndex);
+    bytes_ = offset;
+    return 0;
+}
+
+int CurveSegment::SerializeEntry(const braft::LogEntry* entry,
+                                 butil::IOBuf* data) {
+    switch (entry->type) {
+    case braft::ENTRY_TYPE_DATA:
+        data->append(entry->data);
+        break;
+    case braft::ENTRY_TYPE_NO_OP:
+        break;
+    case braft::ENTRY_TYPE_CONFIGURATION:
+        {
+            butil::Status status =
+                braft::serialize_configuration_meta(entry, *data);
+            if (!status.ok()) {
+                LOG(ERROR) << "Fail to serialize ConfigurationPBMeta";
+                return -1;
+            }
+        }
+        break;
+    default:
+        LOG(FATAL) << "unknow entry type: " << entry->type;
+        return -1;
+    }
+    return 0;
+}
+
+int CurveSegment::DeserializeEntry(int type, butil::IOBuf* data,
+                                   braft::LogEntry* entry) {
+    switch (type) {
+    case braft::ENTRY_TYPE_DATA:
+        entry->data.swap(*data);
+        break;
+    case braft::ENTRY_TYPE_NO_OP:
+        if (!data->empty()) {
+            LOG(ERROR) << "Data of NO_OP must be empty";
+            return -1;
+        }
+        break;
+    case braft::ENTRY_TYPE_CONFIGURATION:
+        {
+            butil::Status status =
+                braft::parse_configuration_meta(*data, entry);
+            if (!status.ok()) {
+                LOG(ERROR) << "Fail to parse ConfigurationPBMeta";
+                return -1;
+            }
+        }
+        break;
+    default:
+        LOG(ERROR) << "Unknown entry type: " << type;
+        return -1;
+    }
+    return 0;
+}
+
+int CurveSegment::Append(const braft::LogEntry* entry,
+                         const butil::IOBuf& data) {
+    if (BAIDU_UNLIKELY(!entry || !isOpen_)) {
+        return EINVAL;
+    } else if (entry->id.index !=
+                    lastIndex_.load(butil::memory_order_consume) + 1) {
+        CHECK(false) << "entry->index=" << entry->id.index
+                     << " _last_index=" << lastIndex_
+                     << " _first_index=" << firstIndex_;
+        return ERANGE;
+    }
+
+    const uint64_t size = kCurveEntryHeaderSize + data.length();
+    if (!HasSpace(size)) {
+        LOG(ERROR) << "No space left in segment " << FileName()
+                   << ", bytes: " << bytes_ << ", entry size: " << size;
+        return -1;
+    }
+
+    char headerBuf[kCurveEntryHeaderSize];
+    const uint32_t metaField = (entry->type << 24) | (kChecksumCRC32C << 16);
+    RawPacker packer(headerBuf);
+    packer.pack64(entry->id.term)
+          .pack64(entry->id.index)
+          .pack32(metaField)
+          .pack32(static_cast<uint32_t>(data.length()))
+          .pack32(IOBufCRC32(data))
+          .pack32(nonce_);
+    packer.pack32(curve::common::CRC32(headerBuf, kCurveEntryHeaderSize - 4));
+
+    butil::IOBuf buf;
+    buf.append(headerBuf, kCurveEntryHeaderSize);
+    buf.append(data);
+    // 文件已经预分配，这里只是覆盖写，不会修改文件的元数据
+    ssize_t n = braft::file_pwrite(buf, fd_, bytes_);
+    if (n != static_cast<ssize_t>(size)) {
+        LOG(ERROR) << "Fail to write to fd=" << fd_
+                   << ", path: " << FileName() << berror();
+        return -1;
+    }
+
+    std::lock_guard<bthread::Mutex> lk(mutex_);
+    offsetAndTerm_.push_back(std::make_pair(bytes_, entry->id.term));
+    lastIndex_.fetch_add(1, butil::memory_order_relaxed);
+    bytes_ += size;
+    return 0;
+}
+
+int CurveSegment::GetMeta(int64_t index,
+                          std::pair<int64_t, int64_t>* meta) const {
+    std::lock_guard<bthread::Mutex> lk(mutex_);
+    if (index > lastIndex_.load(butil::memory_order_relaxed)
+                    || index < firstIndex_) {
+        return -1;
+    }
+    *meta = offsetAndTerm_[index - firstIndex_];
+    return 0;
+}
+
+braft::LogEntry* CurveSegment::Get(int64_t index) const {
+    std::pair<int64_t, int64_t> meta;
+    if (GetMeta(index, &meta) != 0) {
+        return nullptr;
+    }
+
+    EntryHeader header;
+    butil::IOBuf data;
+    if (LoadEntry(meta.first, &header, &data) != 0) {
+        return nullptr;
+    }
+    CHECK_EQ(meta.second, header.term);
+
+    braft::LogEntry* entry = new braft::LogEntry();
+    entry->AddRef();
+    if (DeserializeEntry(header.type, &data, entry) != 0) {
+        LOG(WARNING) << "Fail to parse entry " << index
+                     << ", path: " << FileName();
+        entry->Release();
+        return nullptr;
+    }
+    entry->id.index = index;
+    entry->id.term = header.term;
+    entry->type = (braft::EntryType)header.type;
+    return entry;
+}
+
+int64_t CurveSegment::GetTerm(int64_t index) const {
+    std::pair<int64_t, int64_t> meta;
+    if (GetMeta(index, &meta) != 0) {
+        return 0;
+    }
+    return meta.second;
+}
+
+int CurveSegment::Close(bool willSync) {
+    CHECK(isOpen_);
+
+    std::string oldPath = FileName();
+    std::string newPath(path_);
+    butil::string_appendf(&newPath, "/" CURVE_SEGMENT_CLOSED_PATTERN,
+                          firstIndex_, lastIndex_.load());
+
+    LOG(INFO) << "close a full segment. Current first_index: " << firstIndex_
+              << " last_index: " << lastIndex_
+              << " will_sync: " << willSync
+              << " path: " << newPath;
+    int ret = Sync(willSync);
+    if (ret == 0) {
+        isOpen_ = false;
+        ret = ::rename(oldPath.c_str(), newPath.c_str());
+        LOG_IF(INFO, ret == 0) << "Renamed `" << oldPath
+                               << "' to `" << newPath <<'\'';
+        LOG_IF(ERROR, ret != 0) << "Fail to rename `" << oldPath
+                                << "' to `" << newPath <<"\', " << berror();
+        if (ret != 0) {
+            isOpen_ = true;
+        }
+    }
+    return ret;
+}
+
+int CurveSegment::Sync(bool willSync) {
+    if (!willSync || lastIndex_.load() < firstIndex_) {
+        return 0;
+    }
+    // 文件大小不会变化，fdatasync不需要刷文件的元数据
+    return ::fdatasync(fd_);
+}
+
+int CurveSegment::Unlink() {
+    std::string path = FileName();
+    int ret = walFilePool_->RecycleChunk(path);
+    if (ret != 0) {
+        LOG(ERROR) << "Fail to recycle segment " << path
+                   << " to wal file pool";
+        return ret;
+    }
+    LOG(INFO) << "Recycled segment `" << path << '\'';
+    return 0;
+}
+
+int CurveSegment::Truncate(int64_t lastIndexKept) {
+    std::unique_lock<bthread::Mutex> lk(mutex_);
+    if (lastIndexKept >= lastIndex_) {
+        return 0;
+    }
+    const int64_t firstTruncateInOffset = lastIndexKept + 1 - firstIndex_;
+    const uint64_t truncateSize = offsetAndTerm_[firstTruncateInOffset].first;
+    std::vector<int64_t> truncatedOffsets;
+    for (size_t i = firstTruncateInOffset; i < offsetAndTerm_.size(); ++i) {
+        truncatedOffsets.push_back(offsetAndTerm_[i].first);
+    }
+    lk.unlock();
+
+    // closed segment被truncate之后需要重新变回open segment
+    if (!isOpen_) {
+        std::string oldPath = FileName();
+        std::string newPath(path_);
+        butil::string_appendf(&newPath, "/" CURVE_SEGMENT_OPEN_PATTERN,
+                              firstIndex_);
+        int ret = ::rename(oldPath.c_str(), newPath.c_str());
+        LOG_IF(INFO, ret == 0) << "Renamed `" << oldPath << "' to `"
+                               << newPath << '\'';
+        LOG_IF(ERROR, ret != 0) << "Fail to rename `" << oldPath << "' to `"
+                                << newPath << "', " << berror();
+        if (ret != 0) {
+            return ret;
+        }
+        isOpen_ = true;
+    }
+
+    // 文件长度固定，不能通过ftruncate截断，这里将被删除的entry的头部清零，
+    // 保证重新加载的时候这些entry不会再出现
+    char zeros[kCurveEntryHeaderSize] = {0};
+    for (auto offset : truncatedOffsets) {
+        ssize_t n = ::pwrite(fd_, zeros, kCurveEntryHeaderSize, offset);
+        if (n != kCurveEntryHeaderSize) {
+            PLOG(ERROR) << "Fail to truncate segment " << FileName()
+                        << " at offset " << offset;
+            return -1;
+        }
+    }
+    int ret = ::fdatasync(fd_);
+    if (ret != 0) {
+        PLOG(ERROR) << "Fail to sync segment " << FileName();
+        return ret;
+    }
+
+    lk.lock();
+    offsetAndTerm_.resize(firstTruncateInOffset);
+    lastIndex_.store(lastIndexKept, butil::memory_order_relaxed);
+    bytes_ = truncateSize;
+    return 0;
+}
+
+}  // namespace chunkserver
+}  // namespace curve
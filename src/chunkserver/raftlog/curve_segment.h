@@ -0,0 +1,223 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+// Copyright (c) 2015 Baidu.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Authors: Wang,Yao(wangyao02@baidu.com)
+//          Zhangyi Chen(chenzhangyi01@baidu.com)
+//          Xiong,Kai(xiongkai@baidu.com)
+
+#ifndef SRC_CHUNKSERVER_RAFTLOG_CURVE_SEGMENT_H_
+#define SRC_CHUNKSERVER_RAFTLOG_CURVE_SEGMENT_H_
+
+#include <butil/memory/ref_counted.h>
+#include <butil/iobuf.h>
+#include <butil/atomicops.h>
+#include <bthread/mutex.h>
+#include <braft/log_entry.h>
+#include <braft/configuration_manager.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+
+#include "src/chunkserver/datastore/chunkfile_pool.h"
+#include "src/chunkserver/raftlog/define.h"
+
+namespace curve {
+namespace chunkserver {
+
+/**
+ * 基于wal文件池的segment，与braft的Segment相比：
+ * 1. segment文件从wal文件池中获取，文件已经预先分配并格式化，
+ *    append只是覆盖写，不会触发文件系统的空间分配和元数据修改
+ * 2. segment文件被删除时回收到wal文件池中，而不是unlink
+ * 3. 文件大小固定，不能通过文件长度判断segment的结尾，因此每条entry
+ *    的头部带有index和segment的nonce，加载时遇到不匹配的entry即认为到达结尾
+ */
+class CurveSegment : public butil::RefCountedThreadSafe<CurveSegment> {
+ public:
+    // 新建open segment
+    CurveSegment(const std::string& path, int64_t firstIndex,
+                 std::shared_ptr<ChunkfilePool> walFilePool);
+    // 加载已经存在的closed segment
+    CurveSegment(const std::string& path, int64_t firstIndex,
+                 int64_t lastIndex,
+                 std::shared_ptr<ChunkfilePool> walFilePool);
+
+    /**
+     * 从wal文件池中获取文件创建segment，仅用于open segment
+     * @return 成功返回0，失败返回-1
+     */
+    int Create();
+
+    /**
+     * 加载segment中的entry，配置变更的entry会加入到configurationManager中
+     * @return 成功返回0，失败返回-1
+     */
+    int Load(braft::ConfigurationManager* configurationManager);
+
+    /**
+     * 序列化entry的数据部分
+     * @param entry: 需要序列化的entry
+     * @param data[out]: 序列化之后的数据
+     * @return 成功返回0，失败返回-1
+     */
+    static int SerializeEntry(const braft::LogEntry* entry,
+                              butil::IOBuf* data);
+
+    /**
+     * 将SerializeEntry序列化的数据解析到entry中
+     * @param type: entry的类型
+     * @param data: 序列化之后的数据，DATA类型的entry会直接swap走
+     * @param entry[out]: 解析的结果
+     * @return 成功返回0，失败返回-1
+     */
+    static int DeserializeEntry(int type, butil::IOBuf* data,
+                                braft::LogEntry* entry);
+
+    /**
+     * 追加一条entry，data为SerializeEntry的结果
+     * @return 成功返回0，失败返回-1
+     */
+    int Append(const braft::LogEntry* entry, const butil::IOBuf& data);
+
+    /**
+     * 获取指定index的entry，返回的entry需要调用者释放
+     */
+    braft::LogEntry* Get(int64_t index) const;
+
+    /**
+     * 获取指定index的entry的term，不存在返回0
+     */
+    int64_t GetTerm(int64_t index) const;
+
+    /**
+     * 关闭open segment，将其重命名为closed segment
+     * @param willSync: 是否需要sync
+     */
+    int Close(bool willSync = true);
+
+    /**
+     * 将已经写入的entry持久化
+     */
+    int Sync(bool willSync);
+
+    /**
+     * 删除segment，文件回收到wal文件池中
+     */
+    int Unlink();
+
+    /**
+     * 删除lastIndexKept之后的所有entry
+     */
+    int Truncate(int64_t lastIndexKept);
+
+    /**
+     * segment是否还能容纳size字节的entry
+     */
+    bool HasSpace(uint64_t size) const {
+        return bytes_ + size <= capacity_;
+    }
+
+    /**
+     * 一个segment最多能够容纳的entry的大小
+     */
+    uint64_t MaxEntrySize() const {
+        return capacity_ - dataOffset_;
+    }
+
+    bool IsOpen() const {
+        return isOpen_;
+    }
+
+    int64_t Bytes() const {
+        return bytes_;
+    }
+
+    int64_t FirstIndex() const {
+        return firstIndex_;
+    }
+
+    int64_t LastIndex() const {
+        return lastIndex_.load(butil::memory_order_consume);
+    }
+
+    std::string FileName() const;
+
+ private:
+    friend class butil::RefCountedThreadSafe<CurveSegment>;
+    ~CurveSegment();
+
+    struct EntryHeader {
+        int64_t term;
+        int64_t index;
+        int type;
+        int checksumType;
+        uint32_t dataLen;
+        uint32_t dataChecksum;
+        uint32_t nonce;
+    };
+
+    void EncodeSegmentHeader(char* buf) const;
+    int LoadSegmentHeader();
+    int LoadEntry(uint64_t offset, EntryHeader* head,
+                  butil::IOBuf* data) const;
+    int GetMeta(int64_t index, std::pair<int64_t, int64_t>* meta) const;
+
+ private:
+    std::string path_;
+    std::shared_ptr<ChunkfilePool> walFilePool_;
+    // 当前segment已经使用的字节数，包括文件头部的metapage
+    uint64_t bytes_;
+    // entry写入的起始位置，即metapage的大小
+    uint64_t dataOffset_;
+    // 文件的总大小
+    uint64_t capacity_;
+    mutable bthread::Mutex mutex_;
+    int fd_;
+    bool isOpen_;
+    const int64_t firstIndex_;
+    butil::atomic<int64_t> lastIndex_;
+    // segment被创建时随机生成，写入每条entry的头部，用于识别文件中残留的旧数据
+    uint32_t nonce_;
+    // 每条entry的offset和term
+    std::vector<std::pair<int64_t, int64_t>> offsetAndTerm_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_RAFTLOG_CURVE_SEGMENT_H_
@@ -0,0 +1,695 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+// Copyright (c) 2015 Baidu.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Authors: Wang,Yao(wangyao02@baidu.com)
+//          Zhangyi Chen(chenzhangyi01@baidu.com)
+//          Xiong,Kai(xiongkai@baidu.com)
+
+#include "src/chunkserver/raftlog/curve_segment_log_storage.h"
+
+#include <glog/logging.h>
+#include <butil/files/dir_reader_posix.h>
+#include <butil/files/file_path.h>
+#include <butil/file_util.h>
+#include <butil/time.h>
+#include <bvar/bvar.h>
+#include <braft/protobuf_file.h>
+#include <braft/local_storage.pb.h>
+
+#include <cinttypes>
+#include <mutex>  // NOLINT
+
+#include "src/chunkserver/raftlog/define.h"
+
+namespace curve {
+namespace chunkserver {
+
+// 所有copyset共享的wal相关metric
+static bvar::LatencyRecorder g_append_entries_latency(
+    "chunkserver_raft_log_append_entries");
+static bvar::LatencyRecorder g_sync_segment_latency(
+    "chunkserver_raft_log_sync_segment");
+static bvar::LatencyRecorder g_open_segment_latency(
+    "chunkserver_raft_log_open_segment");
+static bvar::Adder<uint64_t> g_segment_created(
+    "chunkserver_raft_log_segment_created");
+static bvar::Adder<uint64_t> g_segment_recycled(
+    "chunkserver_raft_log_segment_recycled");
+
+int CurveSegmentLogStorage::init(
+    braft::ConfigurationManager* configurationManager) {
+    if (walFilePool_ == nullptr) {
+        LOG(ERROR) << "wal file pool is not set, path: " << path_;
+        return -1;
+    }
+
+    butil::FilePath dirPath(path_);
+    butil::File::Error e;
+    if (!butil::CreateDirectoryAndGetError(
+            dirPath, &e, braft::FLAGS_raft_create_parent_directories)) {
+        LOG(ERROR) << "Fail to create " << dirPath.value() << " : " << e;
+        return -1;
+    }
+
+    int ret = 0;
+    bool isEmpty = false;
+    do {
+        ret = LoadMeta();
+        if (ret != 0 && errno == ENOENT) {
+            LOG(WARNING) << path_ << " is empty";
+            isEmpty = true;
+        } else if (ret != 0) {
+            break;
+        }
+
+        ret = ListSegments(isEmpty);
+        if (ret != 0) {
+            break;
+        }
+
+        ret = LoadSegments(configurationManager);
+        if (ret != 0) {
+            break;
+        }
+    } while (0);
+
+    if (isEmpty) {
+        firstLogIndex_.store(1);
+        lastLogIndex_.store(0);
+        ret = SaveMeta(1);
+    }
+    return ret;
+}
+
+int64_t CurveSegmentLogStorage::last_log_index() {
+    return lastLogIndex_.load(butil::memory_order_acquire);
+}
+
+int CurveSegmentLogStorage::LoadMeta() {
+    butil::Timer timer;
+    timer.start();
+
+    std::string metaPath(path_);
+    metaPath.append("/" CURVE_SEGMENT_META_FILE);
+
+    braft::ProtoBufFile pbFile(metaPath);
+    braft::LogPBMeta meta;
+    if (0 != pbFile.load(&meta)) {
+        PLOG_IF(ERROR, errno != ENOENT)
+            << "Fail to load meta from " << metaPath;
+        return -1;
+    }
+
+    firstLogIndex_.store(meta.first_log_index());
+
+    timer.stop();
+    LOG(INFO) << "log load_meta " << metaPath
+              << " first_log_index: " << meta.first_log_index()
+              << " time: " << timer.u_elapsed();
+    return 0;
+}
+
+int CurveSegmentLogStorage::SaveMeta(const int64_t logIndex) {
+    butil::Timer timer;
+    timer.start();
+
+    std::string metaPath(path_);
+    metaPath.append("/" CURVE_SEGMENT_META_FILE);
+
+    braft::LogPBMeta meta;
+    meta.set_first_log_index(logIndex);
+    braft::ProtoBufFile pbFile(metaPath);
+    int ret = pbFile.save(&meta, true);
+
+    timer.stop();
+    PLOG_IF(ERROR, ret != 0) << "Fail to save meta to " << metaPath;
+    LOG(INFO) << "log save_meta " << metaPath << " first_log_index: "
+              << logIndex << " time: " << timer.u_elapsed();
+    return ret;
+}
+
+int CurveSegmentLogStorage::ListSegments(bool isEmpty) {
+    butil::DirReaderPosix dirReader(path_.c_str());
+    if (!dirReader.IsValid()) {
+        LOG(WARNING) << "directory reader failed, maybe NOEXIST or PERMISSION."
+                     << " path: " << path_;
+        return -1;
+    }
+
+    // restore segment meta
+    while (dirReader.Next()) {
+        int match = 0;
+        int64_t firstIndex = 0;
+        int64_t lastIndex = 0;
+        std::string segmentPath(path_);
+        segmentPath.append("/");
+        segmentPath.append(dirReader.name());
+
+        match = sscanf(dirReader.name(), CURVE_SEGMENT_CLOSED_PATTERN,
+                       &firstIndex, &lastIndex);
+        if (match == 2) {
+            if (isEmpty) {
+                // meta文件不存在时，残留的segment直接回收
+                walFilePool_->RecycleChunk(segmentPath);
+                LOG(WARNING) << "recycle unused segment, path: "
+                             << segmentPath;
+                continue;
+            }
+            LOG(INFO) << "restore closed segment, path: " << path_
+                      << " first_index: " << firstIndex
+                      << " last_index: " << lastIndex;
+            CurveSegment* segment = new CurveSegment(path_, firstIndex,
+                                                     lastIndex, walFilePool_);
+            segments_[firstIndex] = segment;
+            continue;
+        }
+
+        match = sscanf(dirReader.name(), CURVE_SEGMENT_OPEN_PATTERN,
+                       &firstIndex);
+        if (match == 1) {
+            if (isEmpty) {
+                walFilePool_->RecycleChunk(segmentPath);
+                LOG(WARNING) << "recycle unused segment, path: "
+                             << segmentPath;
+                continue;
+            }
+            if (!openSegment_) {
+                openSegment_ = new CurveSegment(path_, firstIndex,
+                                                walFilePool_);
+                continue;
+            } else {
+                LOG(WARNING) << "open segment conflict, path: " << path_
+                             << " first_index: " << firstIndex;
+                return -1;
+            }
+        }
+    }
+
+    // check segment
+    int64_t lastLogIndex = -1;
+    SegmentMap::iterator it;
+    for (it = segments_.begin(); it != segments_.end(); ) {
+        CurveSegment* segment = it->second.get();
+        if (segment->FirstIndex() > segment->LastIndex()) {
+            LOG(WARNING) << "closed segment is bad, path: " << path_
+                         << " first_index: " << segment->FirstIndex()
+                         << " last_index: " << segment->LastIndex();
+            return -1;
+        } else if (lastLogIndex != -1 &&
+                   segment->FirstIndex() != lastLogIndex + 1) {
+            LOG(WARNING) << "closed segment not in order, path: " << path_
+                         << " first_index: " << segment->FirstIndex()
+                         << " last_log_index: " << lastLogIndex;
+            return -1;
+        } else if (lastLogIndex == -1 &&
+                   firstLogIndex_.load(butil::memory_order_acquire)
+                   < segment->FirstIndex()) {
+            LOG(WARNING) << "closed segment has hole, path: " << path_
+                         << " first_log_index: " << firstLogIndex_.load()
+                         << " first_index: " << segment->FirstIndex()
+                         << " last_index: " << segment->LastIndex();
+            return -1;
+        } else if (lastLogIndex == -1 &&
+                   firstLogIndex_ > segment->LastIndex()) {
+            LOG(WARNING) << "closed segment need discard, path: " << path_
+                         << " first_log_index: " << firstLogIndex_.load()
+                         << " first_index: " << segment->FirstIndex()
+                         << " last_index: " << segment->LastIndex();
+            segment->Unlink();
+            segments_.erase(it++);
+            continue;
+        }
+
+        lastLogIndex = segment->LastIndex();
+        ++it;
+    }
+    if (openSegment_) {
+        if (lastLogIndex == -1 &&
+                firstLogIndex_.load() < openSegment_->FirstIndex()) {
+            LOG(WARNING) << "open segment has hole, path: " << path_
+                         << " first_log_index: " << firstLogIndex_.load()
+                         << " first_index: " << openSegment_->FirstIndex();
+        } else if (lastLogIndex != -1 &&
+                   openSegment_->FirstIndex() != lastLogIndex + 1) {
+            LOG(WARNING) << "open segment has hole, path: " << path_
+                         << " first_log_index: " << firstLogIndex_.load()
+                         << " first_index: " << openSegment_->FirstIndex();
+        }
+        CHECK_LE(lastLogIndex, openSegment_->LastIndex());
+    }
+
+    return 0;
+}
+
+int CurveSegmentLogStorage::LoadSegments(
+    braft::ConfigurationManager* configurationManager) {
+    int ret = 0;
+
+    // closed segments
+    SegmentMap::iterator it;
+    for (it = segments_.begin(); it != segments_.end(); ++it) {
+        CurveSegment* segment = it->second.get();
+        LOG(INFO) << "load closed segment, path: " << path_
+                  << " first_index: " << segment->FirstIndex()
+                  << " last_index: " << segment->LastIndex();
+        ret = segment->Load(configurationManager);
+        if (ret != 0) {
+            return ret;
+        }
+        lastLogIndex_.store(segment->LastIndex(), butil::memory_order_release);
+    }
+
+    // open segment
+    if (openSegment_) {
+        LOG(INFO) << "load open segment, path: " << path_
+                  << " first_index: " << openSegment_->FirstIndex();
+        ret = openSegment_->Load(configurationManager);
+        if (ret != 0) {
+            return ret;
+        }
+        if (firstLogIndex_.load() > openSegment_->LastIndex()) {
+            LOG(WARNING) << "open segment need discard, path: " << path_
+                         << " first_log_index: " << firstLogIndex_.load()
+                         << " first_index: " << openSegment_->FirstIndex()
+                         << " last_index: " << openSegment_->LastIndex();
+            openSegment_->Unlink();
+            openSegment_ = nullptr;
+        } else {
+            lastLogIndex_.store(openSegment_->LastIndex(),
+                                butil::memory_order_release);
+            // 上次进程退出时open segment的结尾可能残留只写了一部分的entry，
+            // 为了避免这些数据之后被误识别，重启之后不再往该segment中追加，
+            // 直接关闭，后续的entry写入新的segment
+            if (openSegment_->LastIndex() < openSegment_->FirstIndex()) {
+                openSegment_->Unlink();
+            } else {
+                ret = openSegment_->Close(enableSync_);
+                if (ret != 0) {
+                    return ret;
+                }
+                segments_[openSegment_->FirstIndex()] = openSegment_;
+            }
+            openSegment_ = nullptr;
+        }
+    }
+
+    if (lastLogIndex_ == 0) {
+        lastLogIndex_ = firstLogIndex_ - 1;
+    }
+    return 0;
+}
+
+scoped_refptr<CurveSegment> CurveSegmentLogStorage::OpenSegment(
+    uint64_t entrySize) {
+    butil::Timer timer;
+    timer.start();
+    scoped_refptr<CurveSegment> prevOpenSegment;
+    {
+        std::lock_guard<bthread::Mutex> lk(mutex_);
+        if (!openSegment_) {
+            openSegment_ = new CurveSegment(path_, last_log_index() + 1,
+                                            walFilePool_);
+            if (openSegment_->Create() != 0) {
+                openSegment_ = nullptr;
+                return nullptr;
+            }
+            g_segment_created << 1;
+        }
+        if (entrySize > openSegment_->MaxEntrySize()) {
+            LOG(ERROR) << "Entry size " << entrySize
+                       << " exceeds the max size of a segment "
+                       << openSegment_->MaxEntrySize()
+                       << ", path: " << path_;
+            return nullptr;
+        }
+        // segment文件大小固定，放不下当前entry时切换到新的segment
+        if (!openSegment_->HasSpace(entrySize)) {
+            segments_[openSegment_->FirstIndex()] = openSegment_;
+            prevOpenSegment.swap(openSegment_);
+        }
+    }
+    do {
+        if (prevOpenSegment) {
+            if (prevOpenSegment->Close(enableSync_) == 0) {
+                std::lock_guard<bthread::Mutex> lk(mutex_);
+                openSegment_ = new CurveSegment(path_, last_log_index() + 1,
+                                                walFilePool_);
+                if (openSegment_->Create() == 0) {
+                    g_segment_created << 1;
+                    timer.stop();
+                    g_open_segment_latency << timer.u_elapsed();
+                    break;
+                }
+            }
+            PLOG(ERROR) << "Fail to close old open_segment or "
+                           "create new open_segment path: " << path_;
+            // Failed, revert former changes
+            std::lock_guard<bthread::Mutex> lk(mutex_);
+            segments_.erase(prevOpenSegment->FirstIndex());
+            openSegment_.swap(prevOpenSegment);
+            return nullptr;
+        }
+    } while (0);
+    return openSegment_;
+}
+
+int CurveSegmentLogStorage::append_entry(const braft::LogEntry* entry) {
+    butil::IOBuf data;
+    if (CurveSegment::SerializeEntry(entry, &data) != 0) {
+        return -1;
+    }
+    scoped_refptr<CurveSegment> segment =
+        OpenSegment(kCurveEntryHeaderSize + data.length());
+    if (nullptr == segment) {
+        return EIO;
+    }
+    int ret = segment->Append(entry, data);
+    if (ret != 0 && ret != EEXIST) {
+        return ret;
+    }
+    if (EEXIST == ret && entry->id.term != get_term(entry->id.index)) {
+        return EINVAL;
+    }
+    lastLogIndex_.fetch_add(1, butil::memory_order_release);
+
+    return segment->Sync(enableSync_);
+}
+
+int CurveSegmentLogStorage::append_entries(
+    const std::vector<braft::LogEntry*>& entries,
+    braft::IOMetric* metric) {
+    if (entries.empty()) {
+        return 0;
+    }
+    if (lastLogIndex_.load(butil::memory_order_relaxed) + 1
+            != entries.front()->id.index) {
+        LOG(FATAL) << "There's gap between appending entries and"
+                   << " _last_log_index path: " << path_;
+        return -1;
+    }
+
+    butil::Timer timer;
+    timer.start();
+    scoped_refptr<CurveSegment> lastSegment = nullptr;
+    for (size_t i = 0; i < entries.size(); i++) {
+        braft::LogEntry* entry = entries[i];
+        butil::IOBuf data;
+        if (CurveSegment::SerializeEntry(entry, &data) != 0) {
+            return i;
+        }
+        scoped_refptr<CurveSegment> segment =
+            OpenSegment(kCurveEntryHeaderSize + data.length());
+        if (nullptr == segment) {
+            return i;
+        }
+        int ret = segment->Append(entry, data);
+        if (0 != ret) {
+            return i;
+        }
+        lastLogIndex_.fetch_add(1, butil::memory_order_release);
+        lastSegment = segment;
+    }
+
+    butil::Timer syncTimer;
+    syncTimer.start();
+    lastSegment->Sync(enableSync_);
+    syncTimer.stop();
+    timer.stop();
+    g_sync_segment_latency << syncTimer.u_elapsed();
+    g_append_entries_latency << timer.u_elapsed();
+    return entries.size();
+}
+
+int CurveSegmentLogStorage::GetSegment(int64_t index,
+                                       scoped_refptr<CurveSegment>* ptr) {
+    std::lock_guard<bthread::Mutex> lk(mutex_);
+    int64_t firstIndex = first_log_index();
+    int64_t lastIndex = last_log_index();
+    if (firstIndex == lastIndex + 1) {
+        return -1;
+    }
+    if (index < firstIndex || index > lastIndex + 1) {
+        LOG_IF(WARNING, index > lastIndex) << "Attempted to access entry "
+                                           << index << " outside of log, "
+                                           << " first_log_index: "
+                                           << firstIndex
+                                           << " last_log_index: "
+                                           << lastIndex;
+        return -1;
+    } else if (index == lastIndex + 1) {
+        return -1;
+    }
+
+    if (openSegment_ && index >= openSegment_->FirstIndex()) {
+        *ptr = openSegment_;
+        CHECK(ptr->get() != nullptr);
+    } else {
+        CHECK(!segments_.empty());
+        SegmentMap::iterator it = segments_.upper_bound(index);
+        SegmentMap::iterator savedIt = it;
+        --it;
+        CHECK(it != savedIt);
+        *ptr = it->second;
+    }
+    return 0;
+}
+
+braft::LogEntry* CurveSegmentLogStorage::get_entry(const int64_t index) {
+    scoped_refptr<CurveSegment> ptr;
+    if (GetSegment(index, &ptr) != 0) {
+        return nullptr;
+    }
+    return ptr->Get(index);
+}
+
+int64_t CurveSegmentLogStorage::get_term(const int64_t index) {
+    scoped_refptr<CurveSegment> ptr;
+    if (GetSegment(index, &ptr) != 0) {
+        return 0;
+    }
+    return ptr->GetTerm(index);
+}
+
+void CurveSegmentLogStorage::PopSegments(
+    const int64_t firstIndexKept,
+    std::vector<scoped_refptr<CurveSegment>>* popped) {
+    popped->clear();
+    popped->reserve(32);
+    std::lock_guard<bthread::Mutex> lk(mutex_);
+    firstLogIndex_.store(firstIndexKept, butil::memory_order_release);
+    for (SegmentMap::iterator it = segments_.begin(); it != segments_.end();) {
+        scoped_refptr<CurveSegment>& segment = it->second;
+        if (segment->LastIndex() < firstIndexKept) {
+            popped->push_back(segment);
+            segments_.erase(it++);
+        } else {
+            return;
+        }
+    }
+    if (openSegment_) {
+        if (openSegment_->LastIndex() < firstIndexKept) {
+            popped->push_back(openSegment_);
+            openSegment_ = nullptr;
+            // _log_storage is empty
+            lastLogIndex_.store(firstIndexKept - 1);
+        } else {
+            CHECK(openSegment_->FirstIndex() <= firstIndexKept);
+        }
+    } else {
+        // _log_storage is empty
+        lastLogIndex_.store(firstIndexKept - 1);
+    }
+}
+
+int CurveSegmentLogStorage::truncate_prefix(const int64_t firstIndexKept) {
+    // segment files
+    if (firstLogIndex_.load(butil::memory_order_acquire) >= firstIndexKept) {
+        return 0;
+    }
+    // NOTE: truncate_prefix is not important, as it has nothing to do with
+    // consensus. We try to save meta on the disk first to make sure even if
+    // the deleting fails or the process crashes (which is unlikely to happen).
+    // The new process would see the latest `first_log_index'
+    if (SaveMeta(firstIndexKept) != 0) {  // NOTE
+        PLOG(ERROR) << "Fail to save meta, path: " << path_;
+        return -1;
+    }
+    std::vector<scoped_refptr<CurveSegment>> popped;
+    PopSegments(firstIndexKept, &popped);
+    for (size_t i = 0; i < popped.size(); ++i) {
+        if (popped[i]->Unlink() == 0) {
+            g_segment_recycled << 1;
+        }
+        popped[i] = nullptr;
+    }
+    return 0;
+}
+
+void CurveSegmentLogStorage::PopSegmentsFromBack(
+    const int64_t lastIndexKept,
+    std::vector<scoped_refptr<CurveSegment>>* popped,
+    scoped_refptr<CurveSegment>* lastSegment) {
+    popped->clear();
+    popped->reserve(32);
+    *lastSegment = nullptr;
+    std::lock_guard<bthread::Mutex> lk(mutex_);
+    lastLogIndex_.store(lastIndexKept, butil::memory_order_release);
+    if (openSegment_) {
+        if (openSegment_->FirstIndex() <= lastIndexKept) {
+            *lastSegment = openSegment_;
+            return;
+        }
+        popped->push_back(openSegment_);
+        openSegment_ = nullptr;
+    }
+    for (SegmentMap::reverse_iterator it = segments_.rbegin();
+            it != segments_.rend(); ++it) {
+        if (it->second->FirstIndex() <= lastIndexKept) {
+            // Not return as we need to maintain segments_ at the end of this
+            // routine
+            break;
+        }
+        popped->push_back(it->second);
+    }
+    for (size_t i = 0; i < popped->size(); i++) {
+        segments_.erase((*popped)[i]->FirstIndex());
+    }
+    if (segments_.rbegin() != segments_.rend()) {
+        *lastSegment = segments_.rbegin()->second;
+    } else {
+        // all the logs have been cleared, the we move firstLogIndex_ to the
+        // next index
+        firstLogIndex_.store(lastIndexKept + 1, butil::memory_order_release);
+    }
+}
+
+int CurveSegmentLogStorage::truncate_suffix(const int64_t lastIndexKept) {
+    // segment files
+    std::vector<scoped_refptr<CurveSegment>> popped;
+    scoped_refptr<CurveSegment> lastSegment;
+    PopSegmentsFromBack(lastIndexKept, &popped, &lastSegment);
+    bool truncateLastSegment = false;
+    int ret = -1;
+
+    if (lastSegment) {
+        if (firstLogIndex_.load(butil::memory_order_relaxed) <=
+            lastLogIndex_.load(butil::memory_order_relaxed)) {
+            truncateLastSegment = true;
+        } else {
+            // trucate_prefix() and truncate_suffix() to discard entire logs
+            std::lock_guard<bthread::Mutex> lk(mutex_);
+            popped.push_back(lastSegment);
+            segments_.erase(lastSegment->FirstIndex());
+            if (openSegment_) {
+                CHECK(openSegment_.get() == lastSegment.get());
+                openSegment_ = nullptr;
+            }
+        }
+    }
+
+    // The truncate suffix order is crucial to satisfy log matching property
+    // of raft log must be truncated from back to front.
+    for (size_t i = 0; i < popped.size(); ++i) {
+        ret = popped[i]->Unlink();
+        if (ret != 0) {
+            return ret;
+        }
+        g_segment_recycled << 1;
+        popped[i] = nullptr;
+    }
+    if (truncateLastSegment) {
+        bool closed = !lastSegment->IsOpen();
+        ret = lastSegment->Truncate(lastIndexKept);
+        if (ret == 0 && closed && lastSegment->IsOpen()) {
+            std::lock_guard<bthread::Mutex> lk(mutex_);
+            CHECK(!openSegment_);
+            segments_.erase(lastSegment->FirstIndex());
+            openSegment_.swap(lastSegment);
+        }
+    }
+
+    return ret;
+}
+
+int CurveSegmentLogStorage::reset(const int64_t nextLogIndex) {
+    if (nextLogIndex <= 0) {
+        LOG(ERROR) << "Invalid next_log_index=" << nextLogIndex
+                   << " path: " << path_;
+        return EINVAL;
+    }
+    std::vector<scoped_refptr<CurveSegment>> popped;
+    std::unique_lock<bthread::Mutex> lck(mutex_);
+    popped.reserve(segments_.size());
+    for (SegmentMap::const_iterator
+            it = segments_.begin(); it != segments_.end(); ++it) {
+        popped.push_back(it->second);
+    }
+    segments_.clear();
+    if (openSegment_) {
+        popped.push_back(openSegment_);
+        openSegment_ = nullptr;
+    }
+    firstLogIndex_.store(nextLogIndex, butil::memory_order_relaxed);
+    lastLogIndex_.store(nextLogIndex - 1, butil::memory_order_relaxed);
+    lck.unlock();
+    // NOTE: see the comments in truncate_prefix
+    if (SaveMeta(nextLogIndex) != 0) {
+        PLOG(ERROR) << "Fail to save meta, path: " << path_;
+        return -1;
+    }
+    for (size_t i = 0; i < popped.size(); ++i) {
+        if (popped[i]->Unlink() == 0) {
+            g_segment_recycled << 1;
+        }
+        popped[i] = nullptr;
+    }
+    return 0;
+}
+
+braft::LogStorage* CurveSegmentLogStorage::new_instance(
+    const std::string& uri) const {
+    return new CurveSegmentLogStorage(uri, walFilePool_, enableSync_);
+}
+
+void RegisterCurveSegmentLogStorageOrDie(
+    std::shared_ptr<ChunkfilePool> walFilePool) {
+    static CurveSegmentLogStorage logStorage("", walFilePool);
+    braft::log_storage_extension()->RegisterOrDie(
+        kCurveLogStorageProtocol, &logStorage);
+}
+
+}  // namespace chunkserver
+}  // namespace curve
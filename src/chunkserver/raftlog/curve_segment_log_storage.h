@@ -0,0 +1,152 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+// Copyright (c) 2015 Baidu.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Authors: Wang,Yao(wangyao02@baidu.com)
+//          Zhangyi Chen(chenzhangyi01@baidu.com)
+//          Xiong,Kai(xiongkai@baidu.com)
+
+#ifndef SRC_CHUNKSERVER_RAFTLOG_CURVE_SEGMENT_LOG_STORAGE_H_
+#define SRC_CHUNKSERVER_RAFTLOG_CURVE_SEGMENT_LOG_STORAGE_H_
+
+#include <braft/log_entry.h>
+#include <braft/storage.h>
+#include <bthread/mutex.h>
+
+#include <map>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "src/chunkserver/raftlog/curve_segment.h"
+#include "src/chunkserver/datastore/chunkfile_pool.h"
+
+namespace curve {
+namespace chunkserver {
+
+/**
+ * 基于wal文件池的braft LogStorage，使用方式是将copyset的log_uri配置为
+ * curve://path，实现参考了braft的SegmentLogStorage
+ */
+class CurveSegmentLogStorage : public braft::LogStorage {
+ public:
+    typedef std::map<int64_t, scoped_refptr<CurveSegment>> SegmentMap;
+
+    CurveSegmentLogStorage(const std::string& path,
+                           std::shared_ptr<ChunkfilePool> walFilePool,
+                           bool enableSync = true)
+        : path_(path),
+          walFilePool_(walFilePool),
+          firstLogIndex_(1),
+          lastLogIndex_(0),
+          enableSync_(enableSync) {}
+
+    virtual ~CurveSegmentLogStorage() {}
+
+    // init logstorage, check consistency and integrity
+    int init(braft::ConfigurationManager* configurationManager) override;
+
+    // first log index in log
+    int64_t first_log_index() override {
+        return firstLogIndex_.load(butil::memory_order_acquire);
+    }
+
+    // last log index in log
+    int64_t last_log_index() override;
+
+    // get logentry by index
+    braft::LogEntry* get_entry(const int64_t index) override;
+
+    // get logentry's term by index
+    int64_t get_term(const int64_t index) override;
+
+    // append entry to log
+    int append_entry(const braft::LogEntry* entry) override;
+
+    // append entries to log and update IOMetric, return success append number
+    int append_entries(const std::vector<braft::LogEntry*>& entries,
+                       braft::IOMetric* metric) override;
+
+    // delete logs from storage's head, [1, first_index_kept) will be discarded
+    int truncate_prefix(const int64_t firstIndexKept) override;
+
+    // delete uncommitted logs from storage's tail,
+    // (last_index_kept, infinity) will be discarded
+    int truncate_suffix(const int64_t lastIndexKept) override;
+
+    int reset(const int64_t nextLogIndex) override;
+
+    LogStorage* new_instance(const std::string& uri) const override;
+
+    SegmentMap Segments() {
+        std::lock_guard<bthread::Mutex> lk(mutex_);
+        return segments_;
+    }
+
+ private:
+    scoped_refptr<CurveSegment> OpenSegment(uint64_t entrySize);
+    int SaveMeta(const int64_t logIndex);
+    int LoadMeta();
+    int ListSegments(bool isEmpty);
+    int LoadSegments(braft::ConfigurationManager* configurationManager);
+    int GetSegment(int64_t logIndex, scoped_refptr<CurveSegment>* ptr);
+    void PopSegments(int64_t firstIndexKept,
+                     std::vector<scoped_refptr<CurveSegment>>* poped);
+    void PopSegmentsFromBack(
+        const int64_t lastIndexKept,
+        std::vector<scoped_refptr<CurveSegment>>* popped,
+        scoped_refptr<CurveSegment>* lastSegment);
+
+ private:
+    std::string path_;
+    std::shared_ptr<ChunkfilePool> walFilePool_;
+    butil::atomic<int64_t> firstLogIndex_;
+    butil::atomic<int64_t> lastLogIndex_;
+    bthread::Mutex mutex_;
+    SegmentMap segments_;
+    scoped_refptr<CurveSegment> openSegment_;
+    bool enableSync_;
+};
+
+/**
+ * 将CurveSegmentLogStorage注册到braft，walFilePool为segment文件使用的文件池
+ */
+void RegisterCurveSegmentLogStorageOrDie(
+    std::shared_ptr<ChunkfilePool> walFilePool);
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_RAFTLOG_CURVE_SEGMENT_LOG_STORAGE_H_
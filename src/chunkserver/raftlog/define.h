@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef SRC_CHUNKSERVER_RAFTLOG_DEFINE_H_
+#define SRC_CHUNKSERVER_RAFTLOG_DEFINE_H_
+
+#include <cinttypes>
+#include <cstdint>
+
+namespace curve {
+namespace chunkserver {
+
+// segment文件名与braft自带的segment区分开，避免两种格式的文件混用
+#define CURVE_SEGMENT_OPEN_PATTERN "curve_log_inprogress_%020" PRId64
+#define CURVE_SEGMENT_CLOSED_PATTERN "curve_log_%020" PRId64 "_%020" PRId64
+#define CURVE_SEGMENT_META_FILE  "log_meta"
+
+// 注册到braft的log storage的协议名，log_uri形如curve://path
+const char kCurveLogStorageProtocol[] = "curve";
+
+// segment文件头(即从wal文件池中取出时写入的metapage)的magic
+const char kCurveSegmentMagic[] = "CURVESEG";
+// segment文件头中有效数据的长度：magic(8) + first index(8) + nonce(4) + crc(4)
+const uint32_t kCurveSegmentHeaderSize = 24;
+
+// 每条entry的头部长度:
+// term(8) + index(8) + type(1) + checksum type(1) + reserved(2)
+// + data len(4) + data checksum(4) + nonce(4) + header checksum(4)
+const uint32_t kCurveEntryHeaderSize = 36;
+
+// 共享日志的segment文件名，id单调递增
+#define SHARED_LOG_SEGMENT_PATTERN "shared_log_%020" PRIu64
+
+// 注册到braft的共享日志log storage的协议名，log_uri形如shared://path
+const char kSharedLogStorageProtocol[] = "shared";
+
+// 共享日志中每条记录的magic
+const uint32_t kSharedLogRecordMagic = 0x53484c47;  // "SHLG"
+
+// 共享日志中每条记录的头部长度:
+// magic(4) + record type(1) + entry type(1) + reserved(2) + group id(8)
+// + lsn(8) + term(8) + index(8) + data len(4) + data checksum(4)
+// + header checksum(4)
+const uint32_t kSharedLogRecordHeaderSize = 52;
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_RAFTLOG_DEFINE_H_
@@ -0,0 +1,831 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include "src/chunkserver/raftlog/shared_log.h"
+
+#include <glog/logging.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <butil/raw_pack.h>
+#include <butil/fd_utility.h>
+#include <butil/file_util.h>
+#include <butil/files/dir_reader_posix.h>
+#include <butil/string_printf.h>
+#include <butil/time.h>
+#include <bvar/bvar.h>
+#include <braft/util.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <mutex>  // NOLINT
+#include <utility>
+
+#include "src/common/crc32.h"
+#include "src/chunkserver/raftlog/define.h"
+#include "src/chunkserver/raftlog/curve_segment.h"
+#include "src/chunkserver/raftlog/util.h"
+
+namespace curve {
+namespace chunkserver {
+
+using ::butil::RawPacker;
+using ::butil::RawUnpacker;
+
+// 一次group commit的写入和sync的耗时
+static bvar::LatencyRecorder g_shared_log_write_latency(
+    "chunkserver_shared_log_write");
+// 一次group commit合并的写请求个数
+static bvar::IntRecorder g_shared_log_batch_size(
+    "chunkserver_shared_log_batch_size");
+static bvar::Adder<uint64_t> g_shared_log_segment_recycled(
+    "chunkserver_shared_log_segment_recycled");
+static bvar::Adder<uint64_t> g_shared_log_entry_moved(
+    "chunkserver_shared_log_entry_moved");
+
+SharedLog::Segment::~Segment() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+SharedLog::SharedLog(const SharedLogOptions& options)
+    : options_(options),
+      nextLsn_(1),
+      needRoll_(false),
+      writing_(false) {
+    isStop_.store(true);
+}
+
+SharedLog::~SharedLog() {
+    Fini();
+}
+
+int SharedLog::Init() {
+    butil::FilePath dirPath(options_.path);
+    butil::File::Error e;
+    if (!butil::CreateDirectoryAndGetError(dirPath, &e, true)) {
+        LOG(ERROR) << "Fail to create " << options_.path << " : " << e;
+        return -1;
+    }
+
+    // 列出所有的segment
+    butil::DirReaderPosix dirReader(options_.path.c_str());
+    if (!dirReader.IsValid()) {
+        LOG(ERROR) << "Fail to open dir " << options_.path;
+        return -1;
+    }
+    std::vector<uint64_t> ids;
+    while (dirReader.Next()) {
+        uint64_t id = 0;
+        if (sscanf(dirReader.name(), SHARED_LOG_SEGMENT_PATTERN, &id) == 1) {
+            ids.push_back(id);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+
+    // 加载所有记录，按照lsn的顺序重放
+    std::vector<std::pair<Record, Location>> records;
+    uint64_t maxId = 0;
+    for (auto id : ids) {
+        std::shared_ptr<Segment> segment = std::make_shared<Segment>();
+        segment->id = id;
+        segment->path = options_.path;
+        butil::string_appendf(&segment->path,
+                              "/" SHARED_LOG_SEGMENT_PATTERN, id);
+        segment->fd = ::open(segment->path.c_str(), O_RDWR);
+        if (segment->fd < 0) {
+            PLOG(ERROR) << "Fail to open " << segment->path;
+            return -1;
+        }
+        butil::make_close_on_exec(segment->fd);
+        if (LoadSegment(segment, &records) != 0) {
+            return -1;
+        }
+        segments_[id] = segment;
+        maxId = std::max(maxId, id);
+    }
+    std::stable_sort(records.begin(), records.end(),
+        [](const std::pair<Record, Location>& a,
+           const std::pair<Record, Location>& b) {
+            return a.first.lsn < b.first.lsn;
+        });
+
+    {
+        std::lock_guard<bthread::Mutex> lk(mutex_);
+        for (auto& record : records) {
+            ApplyRecord(record.first, record.second, true);
+            nextLsn_ = std::max(nextLsn_, record.first.lsn + 1);
+        }
+    }
+    LOG(INFO) << "Load shared log " << options_.path
+              << ", segments: " << segments_.size()
+              << ", records: " << records.size()
+              << ", groups: " << groups_.size()
+              << ", next lsn: " << nextLsn_;
+
+    // 最后一个segment的结尾可能有只写了一半的记录，不再往里面追加
+    activeSegment_ = CreateSegment(maxId + 1);
+    if (activeSegment_ == nullptr) {
+        return -1;
+    }
+    std::lock_guard<bthread::Mutex> lk(mutex_);
+    segments_[activeSegment_->id] = activeSegment_;
+    return 0;
+}
+
+int SharedLog::Run() {
+    if (isStop_.exchange(false)) {
+        compactThread_ = Thread(&SharedLog::CompactInterval, this);
+        LOG(INFO) << "Start shared log compaction thread, path: "
+                  << options_.path;
+    }
+    return 0;
+}
+
+int SharedLog::Fini() {
+    if (!isStop_.exchange(true)) {
+        sleeper_.interrupt();
+        compactThread_.join();
+        LOG(INFO) << "Stop shared log compaction thread, path: "
+                  << options_.path;
+    }
+    std::lock_guard<bthread::Mutex> lk(mutex_);
+    activeSegment_ = nullptr;
+    segments_.clear();
+    groups_.clear();
+    return 0;
+}
+
+void SharedLog::CompactInterval() {
+    while (sleeper_.wait_for(
+        std::chrono::milliseconds(options_.compactIntervalMs))) {
+        Compact();
+    }
+}
+
+std::shared_ptr<SharedLog::Segment> SharedLog::CreateSegment(uint64_t id) {
+    std::shared_ptr<Segment> segment = std::make_shared<Segment>();
+    segment->id = id;
+    segment->path = options_.path;
+    butil::string_appendf(&segment->path, "/" SHARED_LOG_SEGMENT_PATTERN, id);
+    segment->fd = ::open(segment->path.c_str(), O_RDWR | O_CREAT | O_EXCL,
+                         0644);
+    if (segment->fd < 0) {
+        PLOG(ERROR) << "Fail to create " << segment->path;
+        return nullptr;
+    }
+    butil::make_close_on_exec(segment->fd);
+    // 预先分配空间，避免追加写时分配空间，失败不影响正确性
+    if (::fallocate(segment->fd, 0, 0, options_.segmentSize) != 0) {
+        PLOG(WARNING) << "Fail to fallocate " << segment->path;
+    }
+    LOG(INFO) << "Created shared log segment " << segment->path;
+    return segment;
+}
+
+void SharedLog::EncodeHeader(const Record& record, char* buf) {
+    const uint32_t metaField = (record.type << 24) | (record.entryType << 16);
+    RawPacker packer(buf);
+    packer.pack32(kSharedLogRecordMagic)
+          .pack32(metaField)
+          .pack64(record.groupId)
+          .pack64(record.lsn)
+          .pack64(record.term)
+          .pack64(record.index)
+          .pack32(static_cast<uint32_t>(record.data.length()))
+          .pack32(IOBufCRC32(record.data));
+    packer.pack32(
+        curve::common::CRC32(buf, kSharedLogRecordHeaderSize - 4));
+}
+
+int SharedLog::ReadRecord(const std::shared_ptr<Segment>& segment,
+                          uint64_t offset, Record* record) const {
+    char buf[kSharedLogRecordHeaderSize];
+    ssize_t n = ::pread(segment->fd, buf, kSharedLogRecordHeaderSize, offset);
+    if (n != kSharedLogRecordHeaderSize) {
+        return -1;
+    }
+    uint32_t magic = 0;
+    uint32_t metaField = 0;
+    uint32_t dataLen = 0;
+    uint32_t dataChecksum = 0;
+    uint32_t headerChecksum = 0;
+    RawUnpacker(buf).unpack32(magic)
+                    .unpack32(metaField)
+                    .unpack64(record->groupId)
+                    .unpack64(record->lsn)
+                    .unpack64((uint64_t&)record->term)  // NOLINT
+                    .unpack64((uint64_t&)record->index)  // NOLINT
+                    .unpack32(dataLen)
+                    .unpack32(dataChecksum)
+                    .unpack32(headerChecksum);
+    if (magic != kSharedLogRecordMagic || headerChecksum !=
+        curve::common::CRC32(buf, kSharedLogRecordHeaderSize - 4)) {
+        return -1;
+    }
+    record->type = metaField >> 24;
+    record->entryType = (metaField >> 16) & 0xff;
+
+    butil::IOPortal portal;
+    n = braft::file_pread(&portal, segment->fd,
+                          offset + kSharedLogRecordHeaderSize, dataLen);
+    if (n != static_cast<ssize_t>(dataLen)) {
+        return -1;
+    }
+    if (IOBufCRC32(portal) != dataChecksum) {
+        LOG(WARNING) << "Found corrupted data at offset=" << offset
+                     << ", path: " << segment->path;
+        return -1;
+    }
+    record->data.swap(portal);
+    return 0;
+}
+
+int SharedLog::LoadSegment(const std::shared_ptr<Segment>& segment,
+    std::vector<std::pair<Record, Location>>* records) {
+    // 依次读取记录，遇到不合法的记录即认为到达了segment的结尾
+    uint64_t offset = 0;
+    while (true) {
+        Record record;
+        if (ReadRecord(segment, offset, &record) != 0) {
+            break;
+        }
+        Location location;
+        location.segmentId = segment->id;
+        location.offset = offset;
+        location.length = kSharedLogRecordHeaderSize + record.data.length();
+        location.entryType = record.entryType;
+        location.term = record.term;
+        location.lsn = record.lsn;
+        offset += location.length;
+        // 重放时不需要数据
+        record.data.clear();
+        records->emplace_back(std::move(record), location);
+    }
+    segment->bytes = offset;
+    LOG(INFO) << "Load shared log segment " << segment->path
+              << ", bytes: " << offset;
+    return 0;
+}
+
+void SharedLog::ReleaseLocation(const Location& location) {
+    auto it = segments_.find(location.segmentId);
+    if (it != segments_.end()) {
+        CHECK_GT(it->second->liveEntries, 0);
+        --it->second->liveEntries;
+    }
+}
+
+void SharedLog::ClearGroup(GroupLog* group) {
+    for (auto& location : group->entries) {
+        ReleaseLocation(location);
+    }
+    group->entries.clear();
+}
+
+void SharedLog::ApplyAppend(GroupLog* group, int64_t index,
+                            const Location& location) {
+    if (index < group->firstIndex) {
+        // 已经被truncate prefix的entry
+        return;
+    }
+    if (index > group->LastIndex() + 1) {
+        // 之前的记录已经被回收，从当前entry开始
+        ClearGroup(group);
+        group->firstIndex = index;
+    }
+    while (group->LastIndex() >= index) {
+        ReleaseLocation(group->entries.back());
+        group->entries.pop_back();
+    }
+    group->entries.push_back(location);
+    ++segments_[location.segmentId]->liveEntries;
+}
+
+void SharedLog::ApplyMove(GroupLog* group, int64_t index,
+                          const Location& from, const Location& to) {
+    // 搬移期间entry可能已经被truncate，此时新的记录直接作废
+    if (index < group->firstIndex || index > group->LastIndex()) {
+        return;
+    }
+    Location& current = group->entries[index - group->firstIndex];
+    if (current.segmentId != from.segmentId ||
+        current.offset != from.offset) {
+        return;
+    }
+    ReleaseLocation(current);
+    current = to;
+    ++segments_[to.segmentId]->liveEntries;
+}
+
+void SharedLog::ApplyTruncatePrefix(GroupLog* group, int64_t firstIndexKept) {
+    if (firstIndexKept <= group->firstIndex) {
+        return;
+    }
+    if (firstIndexKept > group->LastIndex() + 1) {
+        ClearGroup(group);
+    } else {
+        while (group->firstIndex < firstIndexKept) {
+            ReleaseLocation(group->entries.front());
+            group->entries.pop_front();
+            ++group->firstIndex;
+        }
+    }
+    group->firstIndex = firstIndexKept;
+}
+
+void SharedLog::ApplyTruncateSuffix(GroupLog* group, int64_t lastIndexKept) {
+    while (!group->entries.empty() && group->LastIndex() > lastIndexKept) {
+        ReleaseLocation(group->entries.back());
+        group->entries.pop_back();
+    }
+    // 与braft的SegmentLogStorage保持一致，日志被全部删除时first移动到
+    // lastIndexKept + 1
+    if (group->firstIndex > lastIndexKept + 1) {
+        group->firstIndex = lastIndexKept + 1;
+    }
+}
+
+void SharedLog::ApplyRecord(const Record& record, const Location& location,
+                            bool replay) {
+    if (record.type == RECORD_REMOVE) {
+        auto it = groups_.find(record.groupId);
+        if (it != groups_.end()) {
+            ClearGroup(&it->second);
+            groups_.erase(it);
+        }
+        return;
+    }
+
+    GroupLog* group = &groups_[record.groupId];
+    switch (record.type) {
+    case RECORD_APPEND:
+        ApplyAppend(group, record.index, location);
+        break;
+    case RECORD_MOVE:
+        // 重放时按照lsn排序，搬移的记录等同于原来的记录
+        if (replay) {
+            ApplyAppend(group, record.index, location);
+        } else {
+            ApplyMove(group, record.index, record.from, location);
+        }
+        break;
+    case RECORD_TRUNCATE_PREFIX:
+        ApplyTruncatePrefix(group, record.index);
+        break;
+    case RECORD_TRUNCATE_SUFFIX:
+        ApplyTruncateSuffix(group, record.index);
+        break;
+    case RECORD_RESET:
+        ClearGroup(group);
+        group->firstIndex = record.index;
+        break;
+    case RECORD_STATE:
+        ApplyTruncatePrefix(group, record.index);
+        ApplyTruncateSuffix(group, record.term);
+        break;
+    default:
+        LOG(ERROR) << "Unknown shared log record type: "
+                   << static_cast<int>(record.type)
+                   << ", lsn: " << record.lsn;
+        break;
+    }
+}
+
+int SharedLog::Submit(WriteTask* task) {
+    std::unique_lock<bthread::Mutex> lk(queueMutex_);
+    pending_.push_back(task);
+    // group commit: 没有正在写的请求时，当前请求负责把队列中所有的请求
+    // 一起写入，否则等待其他请求把自己写完
+    while (!task->done) {
+        if (writing_) {
+            queueCond_.wait(lk);
+            continue;
+        }
+        writing_ = true;
+        std::vector<WriteTask*> batch;
+        while (!pending_.empty() && batch.size() < options_.maxBatchSize) {
+            WriteTask* t = pending_.front();
+            if (t->compaction && !batch.empty()) {
+                break;
+            }
+            batch.push_back(t);
+            pending_.pop_front();
+            if (t->compaction) {
+                break;
+            }
+        }
+        lk.unlock();
+        int ret = WriteTasks(batch);
+        lk.lock();
+        for (auto t : batch) {
+            t->ret = ret;
+            t->done = true;
+        }
+        writing_ = false;
+        queueCond_.notify_all();
+    }
+    return task->ret;
+}
+
+int SharedLog::RollSegment() {
+    uint64_t id = activeSegment_->id + 1;
+    std::shared_ptr<Segment> segment = CreateSegment(id);
+    if (segment == nullptr) {
+        return -1;
+    }
+    std::lock_guard<bthread::Mutex> lk(mutex_);
+    segments_[id] = segment;
+    activeSegment_ = segment;
+    needRoll_ = false;
+    return 0;
+}
+
+int SharedLog::FlushBatch(butil::IOBuf* batch, bool sync) {
+    if (!batch->empty()) {
+        size_t size = batch->length();
+        ssize_t n = braft::file_pwrite(*batch, activeSegment_->fd,
+                                       activeSegment_->bytes);
+        if (n != static_cast<ssize_t>(size)) {
+            PLOG(ERROR) << "Fail to write shared log segment "
+                        << activeSegment_->path;
+            needRoll_ = true;
+            return -1;
+        }
+        activeSegment_->bytes += size;
+        batch->clear();
+    }
+    if (sync && options_.enableSync &&
+        ::fdatasync(activeSegment_->fd) != 0) {
+        PLOG(ERROR) << "Fail to sync shared log segment "
+                    << activeSegment_->path;
+        needRoll_ = true;
+        return -1;
+    }
+    return 0;
+}
+
+void SharedLog::BuildStateRecords(WriteTask* task) {
+    std::vector<GroupNid> groupIds;
+    {
+        std::lock_guard<bthread::Mutex> lk(mutex_);
+        for (auto& group : groups_) {
+            groupIds.push_back(group.first);
+        }
+    }
+    // 已经被删除的copyset不再保留日志
+    std::vector<GroupNid> removed;
+    for (auto groupId : groupIds) {
+        if (!CopysetExists(groupId)) {
+            removed.push_back(groupId);
+        }
+    }
+
+    std::lock_guard<bthread::Mutex> lk(mutex_);
+    for (auto groupId : removed) {
+        Record record;
+        record.type = RECORD_REMOVE;
+        record.groupId = groupId;
+        task->records.push_back(record);
+        LOG(INFO) << "Remove log of deleted copyset " << groupId
+                  << " from shared log";
+    }
+    for (auto& group : groups_) {
+        if (std::find(removed.begin(), removed.end(), group.first)
+            != removed.end()) {
+            continue;
+        }
+        Record record;
+        record.type = RECORD_STATE;
+        record.groupId = group.first;
+        record.index = group.second.firstIndex;
+        record.term = group.second.LastIndex();
+        task->records.push_back(record);
+    }
+}
+
+int SharedLog::WriteTasks(const std::vector<WriteTask*>& tasks) {
+    butil::Timer timer;
+    timer.start();
+
+    if (needRoll_ && RollSegment() != 0) {
+        return -1;
+    }
+
+    // 计算每条记录的位置，segment写满时切换到新的segment
+    std::vector<std::pair<const Record*, Location>> applied;
+    butil::IOBuf batch;
+    uint64_t offset = activeSegment_->bytes;
+    for (auto task : tasks) {
+        if (task->compaction) {
+            // compaction任务单独写，此时之前的记录都已经生效
+            BuildStateRecords(task);
+        }
+        for (auto& record : task->records) {
+            if (record.lsn == 0) {
+                record.lsn = nextLsn_++;
+            }
+            const uint64_t size =
+                kSharedLogRecordHeaderSize + record.data.length();
+            if (offset + size > options_.segmentSize && offset > 0) {
+                if (FlushBatch(&batch, true) != 0 || RollSegment() != 0) {
+                    return -1;
+                }
+                offset = 0;
+            }
+            char header[kSharedLogRecordHeaderSize];
+            EncodeHeader(record, header);
+            batch.append(header, kSharedLogRecordHeaderSize);
+            batch.append(record.data);
+
+            Location location;
+            location.segmentId = activeSegment_->id;
+            location.offset = offset;
+            location.length = size;
+            location.entryType = record.entryType;
+            location.term = record.term;
+            location.lsn = record.lsn;
+            applied.emplace_back(&record, location);
+            offset += size;
+        }
+    }
+    if (FlushBatch(&batch, true) != 0) {
+        return -1;
+    }
+
+    {
+        std::lock_guard<bthread::Mutex> lk(mutex_);
+        for (auto& item : applied) {
+            ApplyRecord(*item.first, item.second, false);
+        }
+    }
+
+    timer.stop();
+    g_shared_log_write_latency << timer.u_elapsed();
+    g_shared_log_batch_size << tasks.size();
+    return 0;
+}
+
+int SharedLog::OpenGroup(GroupNid groupId,
+                         braft::ConfigurationManager* configurationManager) {
+    std::vector<int64_t> confIndexes;
+    {
+        std::lock_guard<bthread::Mutex> lk(mutex_);
+        GroupLog& group = groups_[groupId];
+        for (size_t i = 0; i < group.entries.size(); ++i) {
+            if (group.entries[i].entryType ==
+                braft::ENTRY_TYPE_CONFIGURATION) {
+                confIndexes.push_back(group.firstIndex + i);
+            }
+        }
+    }
+    for (auto index : confIndexes) {
+        braft::LogEntry* entry = GetEntry(groupId, index);
+        if (entry == nullptr) {
+            LOG(ERROR) << "Fail to load configuration entry " << index
+                       << " of copyset " << groupId;
+            return -1;
+        }
+        braft::ConfigurationEntry confEntry(*entry);
+        configurationManager->add(confEntry);
+        entry->Release();
+    }
+    return 0;
+}
+
+int64_t SharedLog::FirstLogIndex(GroupNid groupId) {
+    std::lock_guard<bthread::Mutex> lk(mutex_);
+    auto it = groups_.find(groupId);
+    return it == groups_.end() ? 1 : it->second.firstIndex;
+}
+
+int64_t SharedLog::LastLogIndex(GroupNid groupId) {
+    std::lock_guard<bthread::Mutex> lk(mutex_);
+    auto it = groups_.find(groupId);
+    return it == groups_.end() ? 0 : it->second.LastIndex();
+}
+
+braft::LogEntry* SharedLog::GetEntry(GroupNid groupId, int64_t index) {
+    Location location;
+    std::shared_ptr<Segment> segment;
+    {
+        std::lock_guard<bthread::Mutex> lk(mutex_);
+        auto it = groups_.find(groupId);
+        if (it == groups_.end() || index < it->second.firstIndex ||
+            index > it->second.LastIndex()) {
+            return nullptr;
+        }
+        location = it->second.entries[index - it->second.firstIndex];
+        segment = segments_[location.segmentId];
+    }
+
+    Record record;
+    if (ReadRecord(segment, location.offset, &record) != 0 ||
+        record.groupId != groupId || record.index != index) {
+        LOG(ERROR) << "Fail to read entry " << index << " of copyset "
+                   << groupId << " at offset " << location.offset
+                   << ", path: " << segment->path;
+        return nullptr;
+    }
+
+    braft::LogEntry* entry = new braft::LogEntry();
+    entry->AddRef();
+    if (CurveSegment::DeserializeEntry(record.entryType, &record.data,
+                                       entry) != 0) {
+        entry->Release();
+        return nullptr;
+    }
+    entry->id.index = index;
+    entry->id.term = record.term;
+    entry->type = (braft::EntryType)record.entryType;
+    return entry;
+}
+
+int64_t SharedLog::GetTerm(GroupNid groupId, int64_t index) {
+    std::lock_guard<bthread::Mutex> lk(mutex_);
+    auto it = groups_.find(groupId);
+    if (it == groups_.end() || index < it->second.firstIndex ||
+        index > it->second.LastIndex()) {
+        return 0;
+    }
+    return it->second.entries[index - it->second.firstIndex].term;
+}
+
+int SharedLog::AppendEntries(GroupNid groupId,
+                             const std::vector<braft::LogEntry*>& entries) {
+    WriteTask task;
+    task.records.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        Record& record = task.records[i];
+        record.type = RECORD_APPEND;
+        record.entryType = entries[i]->type;
+        record.groupId = groupId;
+        record.term = entries[i]->id.term;
+        record.index = entries[i]->id.index;
+        if (CurveSegment::SerializeEntry(entries[i], &record.data) != 0) {
+            return -1;
+        }
+    }
+    if (Submit(&task) != 0) {
+        return -1;
+    }
+    return entries.size();
+}
+
+int SharedLog::TruncatePrefix(GroupNid groupId, int64_t firstIndexKept) {
+    WriteTask task;
+    task.records.resize(1);
+    task.records[0].type = RECORD_TRUNCATE_PREFIX;
+    task.records[0].groupId = groupId;
+    task.records[0].index = firstIndexKept;
+    return Submit(&task);
+}
+
+int SharedLog::TruncateSuffix(GroupNid groupId, int64_t lastIndexKept) {
+    WriteTask task;
+    task.records.resize(1);
+    task.records[0].type = RECORD_TRUNCATE_SUFFIX;
+    task.records[0].groupId = groupId;
+    task.records[0].index = lastIndexKept;
+    return Submit(&task);
+}
+
+int SharedLog::Reset(GroupNid groupId, int64_t nextLogIndex) {
+    WriteTask task;
+    task.records.resize(1);
+    task.records[0].type = RECORD_RESET;
+    task.records[0].groupId = groupId;
+    task.records[0].index = nextLogIndex;
+    return Submit(&task);
+}
+
+bool SharedLog::CopysetExists(GroupNid groupId) const {
+    if (options_.copysetsDir.empty()) {
+        return true;
+    }
+    std::string path = options_.copysetsDir + "/" + std::to_string(groupId);
+    struct stat st;
+    if (::stat(path.c_str(), &st) == 0) {
+        return true;
+    }
+    return errno != ENOENT;
+}
+
+int SharedLog::Compact() {
+    int recycled = 0;
+    while (true) {
+        std::shared_ptr<Segment> oldest;
+        WriteTask task;
+        task.compaction = true;
+        {
+            std::lock_guard<bthread::Mutex> lk(mutex_);
+            if (segments_.size() <= 1) {
+                break;
+            }
+            // 只能从最老的segment开始回收，否则被回收的segment中的truncate
+            // 记录丢失之后，重放时更老的segment中已经被删除的entry会重新出现
+            oldest = segments_.begin()->second;
+            if (oldest == activeSegment_) {
+                break;
+            }
+            if (oldest->liveEntries != 0 &&
+                segments_.size() <= options_.maxSegments) {
+                break;
+            }
+            // 收集最老的segment中的有效entry
+            for (auto& group : groups_) {
+                if (oldest->liveEntries == 0) {
+                    break;
+                }
+                for (size_t i = 0; i < group.second.entries.size(); ++i) {
+                    const Location& location = group.second.entries[i];
+                    if (location.segmentId != oldest->id) {
+                        continue;
+                    }
+                    Record record;
+                    record.type = RECORD_MOVE;
+                    record.groupId = group.first;
+                    record.index = group.second.firstIndex + i;
+                    record.from = location;
+                    task.records.push_back(record);
+                }
+            }
+        }
+
+        // 读取有效entry的数据，保持原来的lsn搬移到最新的segment
+        for (auto& record : task.records) {
+            Record origin;
+            if (ReadRecord(oldest, record.from.offset, &origin) != 0) {
+                LOG(ERROR) << "Fail to read record at offset "
+                           << record.from.offset << ", path: "
+                           << oldest->path;
+                return recycled;
+            }
+            record.entryType = origin.entryType;
+            record.term = origin.term;
+            record.lsn = origin.lsn;
+            record.data.swap(origin.data);
+        }
+        // 即使没有需要搬移的entry，也需要写入每个copyset当前的状态，
+        // 使得被回收的segment中的truncate记录不再被需要
+        size_t moved = task.records.size();
+        if (Submit(&task) != 0) {
+            LOG(ERROR) << "Fail to compact " << oldest->path;
+            return recycled;
+        }
+        g_shared_log_entry_moved << moved;
+
+        {
+            std::lock_guard<bthread::Mutex> lk(mutex_);
+            if (oldest->liveEntries != 0) {
+                LOG(WARNING) << "Segment " << oldest->path << " still has "
+                             << oldest->liveEntries << " live entries"
+                             << " after compaction";
+                break;
+            }
+            segments_.erase(oldest->id);
+        }
+        if (::unlink(oldest->path.c_str()) != 0) {
+            PLOG(ERROR) << "Fail to unlink " << oldest->path;
+        }
+        LOG(INFO) << "Recycled shared log segment " << oldest->path
+                  << ", moved entries: " << moved;
+        g_shared_log_segment_recycled << 1;
+        ++recycled;
+    }
+    return recycled;
+}
+
+size_t SharedLog::SegmentCount() {
+    std::lock_guard<bthread::Mutex> lk(mutex_);
+    return segments_.size();
+}
+
+size_t SharedLog::GroupCount() {
+    std::lock_guard<bthread::Mutex> lk(mutex_);
+    return groups_.size();
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,286 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef SRC_CHUNKSERVER_RAFTLOG_SHARED_LOG_H_
+#define SRC_CHUNKSERVER_RAFTLOG_SHARED_LOG_H_
+
+#include <braft/log_entry.h>
+#include <braft/configuration_manager.h>
+#include <bthread/mutex.h>
+#include <bthread/condition_variable.h>
+#include <butil/iobuf.h>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "include/chunkserver/chunkserver_common.h"
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/interruptible_sleeper.h"
+
+namespace curve {
+namespace chunkserver {
+
+using ::curve::common::Thread;
+using ::curve::common::Atomic;
+using ::curve::common::InterruptibleSleeper;
+
+struct SharedLogOptions {
+    // 共享日志的目录，一块盘一个
+    std::string path;
+    // copyset的根目录，compaction时根据copyset目录是否存在判断copyset是否
+    // 已经被删除，为空时不回收被删除的copyset的日志
+    std::string copysetsDir;
+    // 单个segment文件的大小上限
+    uint64_t segmentSize;
+    // 一次group commit最多合并的写请求个数
+    uint32_t maxBatchSize;
+    // segment个数超过该值时，对最老的segment进行compaction
+    uint32_t maxSegments;
+    // 后台compaction的检查周期
+    uint32_t compactIntervalMs;
+    // 写入之后是否需要sync
+    bool enableSync;
+
+    SharedLogOptions()
+        : segmentSize(64 * 1024 * 1024),
+          maxBatchSize(256),
+          maxSegments(8),
+          compactIntervalMs(1000),
+          enableSync(true) {}
+};
+
+/**
+ * 一块盘上所有copyset共享的raft日志：
+ * 1. 所有copyset的entry追加写到同一组segment文件中，多个copyset的写请求
+ *    合并之后只需要一次fdatasync(group commit)
+ * 2. 内存中为每个copyset维护index到文件位置的映射，用于读取和truncate
+ * 3. truncate等操作同样以记录的形式追加写入，重启时按照lsn顺序重放所有
+ *    记录恢复每个copyset的日志
+ * 4. segment按照从老到新的顺序回收，最老的segment中还有有效entry时，将
+ *    有效entry搬移到最新的segment中(compaction)
+ */
+class SharedLog {
+ public:
+    explicit SharedLog(const SharedLogOptions& options);
+    ~SharedLog();
+
+    /**
+     * 加载已有的segment，重放日志恢复所有copyset的日志
+     * @return 成功返回0，失败返回-1
+     */
+    int Init();
+
+    /**
+     * 启动后台compaction线程
+     */
+    int Run();
+
+    /**
+     * 停止后台compaction线程，关闭所有segment
+     */
+    int Fini();
+
+    /**
+     * 打开copyset的日志，copyset的日志不存在时创建一个空的日志，
+     * 日志中的配置变更entry会加入到configurationManager中
+     * @return 成功返回0，失败返回-1
+     */
+    int OpenGroup(GroupNid groupId,
+                  braft::ConfigurationManager* configurationManager);
+
+    int64_t FirstLogIndex(GroupNid groupId);
+
+    int64_t LastLogIndex(GroupNid groupId);
+
+    /**
+     * 获取指定index的entry，返回的entry需要调用者释放
+     */
+    braft::LogEntry* GetEntry(GroupNid groupId, int64_t index);
+
+    /**
+     * 获取指定index的entry的term，不存在返回0
+     */
+    int64_t GetTerm(GroupNid groupId, int64_t index);
+
+    /**
+     * 追加entry，与其他copyset的写请求合并写入
+     * @return 成功返回追加的entry个数，失败返回-1
+     */
+    int AppendEntries(GroupNid groupId,
+                      const std::vector<braft::LogEntry*>& entries);
+
+    // 删除[first_log_index, firstIndexKept)的entry
+    int TruncatePrefix(GroupNid groupId, int64_t firstIndexKept);
+
+    // 删除(lastIndexKept, last_log_index]的entry
+    int TruncateSuffix(GroupNid groupId, int64_t lastIndexKept);
+
+    // 删除所有的entry，并将first_log_index设置为nextLogIndex
+    int Reset(GroupNid groupId, int64_t nextLogIndex);
+
+    /**
+     * 回收最老的segment，有效entry较多时搬移到最新的segment中
+     * @return 回收的segment个数
+     */
+    int Compact();
+
+    size_t SegmentCount();
+
+    size_t GroupCount();
+
+ private:
+    enum RecordType {
+        RECORD_APPEND = 1,
+        // compaction搬移的entry，lsn与原来的记录相同
+        RECORD_MOVE = 2,
+        RECORD_TRUNCATE_PREFIX = 3,
+        RECORD_TRUNCATE_SUFFIX = 4,
+        RECORD_RESET = 5,
+        // compaction时记录copyset当前的[first, last]，term字段为last index
+        RECORD_STATE = 6,
+        // copyset已经被删除
+        RECORD_REMOVE = 7,
+    };
+
+    struct Location {
+        uint64_t segmentId;
+        uint64_t offset;
+        // 记录的总长度，包括头部
+        uint32_t length;
+        uint8_t entryType;
+        int64_t term;
+        uint64_t lsn;
+    };
+
+    struct Segment {
+        uint64_t id;
+        std::string path;
+        int fd;
+        // 已经写入的字节数，只有写线程会修改
+        uint64_t bytes;
+        // segment中有效entry的个数
+        uint64_t liveEntries;
+
+        Segment() : id(0), fd(-1), bytes(0), liveEntries(0) {}
+        ~Segment();
+    };
+
+    struct GroupLog {
+        int64_t firstIndex;
+        std::deque<Location> entries;
+
+        GroupLog() : firstIndex(1) {}
+        int64_t LastIndex() const {
+            return firstIndex + static_cast<int64_t>(entries.size()) - 1;
+        }
+    };
+
+    struct Record {
+        uint8_t type;
+        uint8_t entryType;
+        GroupNid groupId;
+        // 为0时由写线程分配
+        uint64_t lsn;
+        int64_t term;
+        int64_t index;
+        butil::IOBuf data;
+        // RECORD_MOVE搬移前的位置
+        Location from;
+
+        Record() : type(0), entryType(0), groupId(0), lsn(0),
+                   term(0), index(0) {}
+    };
+
+    struct WriteTask {
+        std::vector<Record> records;
+        // compaction任务单独写入，写入时生成copyset的STATE记录
+        bool compaction;
+        bool done;
+        int ret;
+
+        WriteTask() : compaction(false), done(false), ret(0) {}
+    };
+
+    int Submit(WriteTask* task);
+    int WriteTasks(const std::vector<WriteTask*>& tasks);
+    void BuildStateRecords(WriteTask* task);
+    int FlushBatch(butil::IOBuf* batch, bool sync);
+    int RollSegment();
+    std::shared_ptr<Segment> CreateSegment(uint64_t id);
+
+    int LoadSegment(const std::shared_ptr<Segment>& segment,
+                    std::vector<std::pair<Record, Location>>* records);
+    int ReadRecord(const std::shared_ptr<Segment>& segment,
+                   uint64_t offset, Record* record) const;
+    static void EncodeHeader(const Record& record, char* buf);
+
+    // 以下函数需要持有mutex_
+    void ApplyRecord(const Record& record, const Location& location,
+                     bool replay);
+    void ApplyAppend(GroupLog* group, int64_t index,
+                     const Location& location);
+    void ApplyMove(GroupLog* group, int64_t index, const Location& from,
+                   const Location& to);
+    void ApplyTruncatePrefix(GroupLog* group, int64_t firstIndexKept);
+    void ApplyTruncateSuffix(GroupLog* group, int64_t lastIndexKept);
+    void ClearGroup(GroupLog* group);
+    void ReleaseLocation(const Location& location);
+
+    bool CopysetExists(GroupNid groupId) const;
+    void CompactInterval();
+
+ private:
+    SharedLogOptions options_;
+
+    // 保护groups_和segments_
+    bthread::Mutex mutex_;
+    std::unordered_map<GroupNid, GroupLog> groups_;
+    std::map<uint64_t, std::shared_ptr<Segment>> segments_;
+
+    // 当前写入的segment，只有写线程会修改
+    std::shared_ptr<Segment> activeSegment_;
+    // 下一条记录的lsn，只有写线程会修改
+    uint64_t nextLsn_;
+    // 写入失败之后需要切换到新的segment
+    bool needRoll_;
+
+    // group commit相关
+    bthread::Mutex queueMutex_;
+    bthread::ConditionVariable queueCond_;
+    std::deque<WriteTask*> pending_;
+    bool writing_;
+
+    // 后台compaction线程
+    Thread compactThread_;
+    Atomic<bool> isStop_;
+    InterruptibleSleeper sleeper_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_RAFTLOG_SHARED_LOG_H_
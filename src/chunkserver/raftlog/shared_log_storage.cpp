@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include "src/chunkserver/raftlog/shared_log_storage.h"
+
+#include <glog/logging.h>
+
+#include <cstdlib>
+
+#include "src/chunkserver/raftlog/define.h"
+
+namespace curve {
+namespace chunkserver {
+
+SharedLogStorage::SharedLogStorage(const std::string& path,
+                                   SharedLog* sharedLog)
+    : path_(path),
+      sharedLog_(sharedLog),
+      groupId_(0) {}
+
+int SharedLogStorage::ParseGroupId(const std::string& path,
+                                   GroupNid* groupId) {
+    // path形如${copysetsDir}/${groupId}/log
+    std::string dir = path;
+    while (!dir.empty() && dir.back() == '/') {
+        dir.pop_back();
+    }
+    size_t pos = dir.rfind('/');
+    if (pos == std::string::npos) {
+        return -1;
+    }
+    dir = dir.substr(0, pos);
+    pos = dir.rfind('/');
+    std::string name = (pos == std::string::npos) ? dir : dir.substr(pos + 1);
+    if (name.empty()) {
+        return -1;
+    }
+    char* end = nullptr;
+    *groupId = strtoull(name.c_str(), &end, 10);
+    return *end == '\0' ? 0 : -1;
+}
+
+int SharedLogStorage::init(
+    braft::ConfigurationManager* configurationManager) {
+    if (sharedLog_ == nullptr) {
+        LOG(ERROR) << "shared log is not set, path: " << path_;
+        return -1;
+    }
+    if (ParseGroupId(path_, &groupId_) != 0) {
+        LOG(ERROR) << "Fail to parse group id from " << path_;
+        return -1;
+    }
+    int ret = sharedLog_->OpenGroup(groupId_, configurationManager);
+    LOG(INFO) << "Open shared log of copyset " << groupId_
+              << ", first_log_index: " << first_log_index()
+              << ", last_log_index: " << last_log_index()
+              << ", ret: " << ret;
+    return ret;
+}
+
+int64_t SharedLogStorage::first_log_index() {
+    return sharedLog_->FirstLogIndex(groupId_);
+}
+
+int64_t SharedLogStorage::last_log_index() {
+    return sharedLog_->LastLogIndex(groupId_);
+}
+
+braft::LogEntry* SharedLogStorage::get_entry(const int64_t index) {
+    return sharedLog_->GetEntry(groupId_, index);
+}
+
+int64_t SharedLogStorage::get_term(const int64_t index) {
+    return sharedLog_->GetTerm(groupId_, index);
+}
+
+int SharedLogStorage::append_entry(const braft::LogEntry* entry) {
+    std::vector<braft::LogEntry*> entries(
+        1, const_cast<braft::LogEntry*>(entry));
+    return sharedLog_->AppendEntries(groupId_, entries) == 1 ? 0 : EIO;
+}
+
+int SharedLogStorage::append_entries(
+    const std::vector<braft::LogEntry*>& entries,
+    braft::IOMetric* metric) {
+    if (entries.empty()) {
+        return 0;
+    }
+    if (last_log_index() + 1 != entries.front()->id.index) {
+        LOG(FATAL) << "There's gap between appending entries and"
+                   << " last_log_index, path: " << path_;
+        return -1;
+    }
+    int ret = sharedLog_->AppendEntries(groupId_, entries);
+    return ret < 0 ? 0 : ret;
+}
+
+int SharedLogStorage::truncate_prefix(const int64_t firstIndexKept) {
+    if (first_log_index() >= firstIndexKept) {
+        return 0;
+    }
+    return sharedLog_->TruncatePrefix(groupId_, firstIndexKept);
+}
+
+int SharedLogStorage::truncate_suffix(const int64_t lastIndexKept) {
+    return sharedLog_->TruncateSuffix(groupId_, lastIndexKept);
+}
+
+int SharedLogStorage::reset(const int64_t nextLogIndex) {
+    if (nextLogIndex <= 0) {
+        LOG(ERROR) << "Invalid next_log_index=" << nextLogIndex
+                   << " path: " << path_;
+        return EINVAL;
+    }
+    return sharedLog_->Reset(groupId_, nextLogIndex);
+}
+
+braft::LogStorage* SharedLogStorage::new_instance(
+    const std::string& uri) const {
+    return new SharedLogStorage(uri, sharedLog_);
+}
+
+void RegisterSharedLogStorageOrDie(SharedLog* sharedLog) {
+    static SharedLogStorage logStorage("", sharedLog);
+    braft::log_storage_extension()->RegisterOrDie(
+        kSharedLogStorageProtocol, &logStorage);
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,92 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef SRC_CHUNKSERVER_RAFTLOG_SHARED_LOG_STORAGE_H_
+#define SRC_CHUNKSERVER_RAFTLOG_SHARED_LOG_STORAGE_H_
+
+#include <braft/storage.h>
+
+#include <string>
+#include <vector>
+
+#include "src/chunkserver/raftlog/shared_log.h"
+
+namespace curve {
+namespace chunkserver {
+
+/**
+ * 基于SharedLog的braft LogStorage，每个copyset一个实例，所有实例共享同
+ * 一个SharedLog。使用方式是将copyset的log_uri配置为shared://path，
+ * copyset的group id从log_uri中解析，log_uri形如
+ * shared://${copysetsDir}/${groupId}/log
+ */
+class SharedLogStorage : public braft::LogStorage {
+ public:
+    SharedLogStorage(const std::string& path, SharedLog* sharedLog);
+
+    virtual ~SharedLogStorage() {}
+
+    int init(braft::ConfigurationManager* configurationManager) override;
+
+    int64_t first_log_index() override;
+
+    int64_t last_log_index() override;
+
+    braft::LogEntry* get_entry(const int64_t index) override;
+
+    int64_t get_term(const int64_t index) override;
+
+    int append_entry(const braft::LogEntry* entry) override;
+
+    int append_entries(const std::vector<braft::LogEntry*>& entries,
+                       braft::IOMetric* metric) override;
+
+    int truncate_prefix(const int64_t firstIndexKept) override;
+
+    int truncate_suffix(const int64_t lastIndexKept) override;
+
+    int reset(const int64_t nextLogIndex) override;
+
+    LogStorage* new_instance(const std::string& uri) const override;
+
+    /**
+     * 从log_uri的路径中解析copyset的group id
+     * @return 成功返回0，失败返回-1
+     */
+    static int ParseGroupId(const std::string& path, GroupNid* groupId);
+
+ private:
+    std::string path_;
+    SharedLog* sharedLog_;
+    GroupNid groupId_;
+};
+
+/**
+ * 将SharedLogStorage注册到braft，sharedLog需要在所有copyset退出之后才能
+ * 释放
+ */
+void RegisterSharedLogStorageOrDie(SharedLog* sharedLog);
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_RAFTLOG_SHARED_LOG_STORAGE_H_
@@ -0,0 +1,49 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef SRC_CHUNKSERVER_RAFTLOG_UTIL_H_
+#define SRC_CHUNKSERVER_RAFTLOG_UTIL_H_
+
+#include <butil/iobuf.h>
+
+#include "src/common/crc32.h"
+
+namespace curve {
+namespace chunkserver {
+
+/**
+ * 计算IOBuf的crc32c，直接遍历底层的block，不需要拷贝数据
+ */
+inline uint32_t IOBufCRC32(const butil::IOBuf& data) {
+    uint32_t crc = 0;
+    const size_t n = data.backing_block_num();
+    for (size_t i = 0; i < n; ++i) {
+        butil::StringPiece sp = data.backing_block(i);
+        crc = curve::common::CRC32(crc, sp.data(), sp.size());
+    }
+    return crc;
+}
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_RAFTLOG_UTIL_H_
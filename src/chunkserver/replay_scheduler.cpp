@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include "src/chunkserver/replay_scheduler.h"
+
+#include <glog/logging.h>
+
+#include <mutex>    // NOLINT
+
+namespace curve {
+namespace chunkserver {
+
+ReplayScheduler::ReplayScheduler(uint32_t concurrency)
+    : concurrency_(concurrency),
+      running_(0),
+      sequence_(0) {
+    CHECK(concurrency_ > 0) << "replay concurrency should be positive";
+}
+
+uint64_t ReplayScheduler::Submit(int64_t remaining) {
+    std::unique_lock<bthread::Mutex> lock(mutex_);
+    uint64_t ticket = sequence_++;
+    waiters_.emplace(remaining, ticket);
+    tickets_.emplace(ticket, remaining);
+    return ticket;
+}
+
+bool ReplayScheduler::Wait(uint64_t ticket) {
+    std::unique_lock<bthread::Mutex> lock(mutex_);
+    while (true) {
+        auto iter = tickets_.find(ticket);
+        if (iter == tickets_.end()) {
+            return false;
+        }
+        auto waiter = std::make_pair(iter->second, ticket);
+        if (running_ < concurrency_ && *waiters_.begin() == waiter) {
+            tickets_.erase(iter);
+            break;
+        }
+        cond_.wait(lock);
+    }
+    waiters_.erase(waiters_.begin());
+    ++running_;
+    // 还有空闲名额时唤醒排在下一位的copyset
+    if (running_ < concurrency_ && !waiters_.empty()) {
+        cond_.notify_all();
+    }
+    return true;
+}
+
+bool ReplayScheduler::Cancel(uint64_t ticket) {
+    std::unique_lock<bthread::Mutex> lock(mutex_);
+    auto iter = tickets_.find(ticket);
+    if (iter == tickets_.end()) {
+        return false;
+    }
+    waiters_.erase(std::make_pair(iter->second, ticket));
+    tickets_.erase(iter);
+    // 被取消的可能是排在第一位的copyset，需要唤醒下一位
+    cond_.notify_all();
+    return true;
+}
+
+void ReplayScheduler::Release() {
+    std::unique_lock<bthread::Mutex> lock(mutex_);
+    CHECK(running_ > 0) << "release replay scheduler without acquire";
+    --running_;
+    cond_.notify_all();
+}
+
+uint32_t ReplayScheduler::Running() {
+    std::unique_lock<bthread::Mutex> lock(mutex_);
+    return running_;
+}
+
+uint32_t ReplayScheduler::Waiting() {
+    std::unique_lock<bthread::Mutex> lock(mutex_);
+    return waiters_.size();
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef SRC_CHUNKSERVER_REPLAY_SCHEDULER_H_
+#define SRC_CHUNKSERVER_REPLAY_SCHEDULER_H_
+
+#include <bthread/mutex.h>
+#include <bthread/condition_variable.h>
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+
+#include "src/common/uncopyable.h"
+
+namespace curve {
+namespace chunkserver {
+
+/**
+ * 控制chunkserver重启后同时回放raft日志的copyset数量:
+ * 1. copyset回放第一条日志时申请名额，回放完成后归还
+ * 2. 没有空闲名额时排队，剩余日志最少的copyset先获得名额，
+ *    使尽可能多的copyset尽早回放完成开始服务
+ * 一个chunkserver进程对应一块盘，所以这里的并发即为单盘上的回放并发
+ */
+class ReplayScheduler : public curve::common::Uncopyable {
+ public:
+    /**
+     * @param concurrency: 同时回放的copyset数量，必须大于0
+     */
+    explicit ReplayScheduler(uint32_t concurrency);
+
+    /**
+     * 申请回放名额，不会阻塞
+     * @param remaining: copyset剩余需要回放的日志数量
+     * @return: 申请的序号，用于Wait和Cancel
+     */
+    uint64_t Submit(int64_t remaining);
+
+    /**
+     * 等待申请的名额，没有空闲名额时等待，可以在bthread中调用
+     * @return: 获得名额返回true，申请被取消返回false
+     */
+    bool Wait(uint64_t ticket);
+
+    /**
+     * 取消还在排队的申请，并唤醒Wait
+     * @return: 申请还在排队返回true，已经获得名额返回false
+     */
+    bool Cancel(uint64_t ticket);
+
+    /**
+     * 回放完成后归还名额
+     */
+    void Release();
+
+    /**
+     * 当前正在回放的copyset数量
+     */
+    uint32_t Running();
+
+    /**
+     * 当前排队等待回放的copyset数量
+     */
+    uint32_t Waiting();
+
+ private:
+    // 同时回放的copyset数量上限
+    const uint32_t concurrency_;
+    // 当前正在回放的copyset数量
+    uint32_t running_;
+    // 等待的copyset，按照剩余日志数量、申请顺序排序
+    std::set<std::pair<int64_t, uint64_t>> waiters_;
+    // 还在排队的申请序号及其剩余日志数量
+    std::map<uint64_t, int64_t> tickets_;
+    // 申请的序号，剩余日志数量相同时先申请的先回放
+    uint64_t sequence_;
+    bthread::Mutex mutex_;
+    bthread::ConditionVariable cond_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_REPLAY_SCHEDULER_H_
@@ -0,0 +1,619 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <glog/logging.h>
+#include <brpc/channel.h>
+#include <brpc/controller.h>
+#include <bvar/bvar.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+
+#include "src/chunkserver/scrub_manager.h"
+#include "src/chunkserver/chunkserver_metrics.h"
+#include "src/chunkserver/datastore/filename_operator.h"
+#include "src/chunkserver/raftsnapshot/define.h"
+#include "src/common/timeutility.h"
+#include "proto/chunk.pb.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::common::TimeUtility;
+
+namespace {
+// ioprio_set的参数，见linux/ioprio.h
+const int kIoprioWhoProcess = 1;
+const int kIoprioClassShift = 13;
+const int kIoprioClassIdle = 3;
+// 每个任务最多记录的出错chunk个数
+const int kMaxBadChunks = 100;
+
+bvar::Adder<uint64_t> g_scrub_bytes("chunkserver_scrub_bytes");
+bvar::Adder<uint64_t> g_scrub_error_chunks("chunkserver_scrub_error_chunks");
+bvar::Adder<uint64_t> g_scrub_mismatch_chunks(
+    "chunkserver_scrub_mismatch_chunks");
+bvar::PerSecond<bvar::Adder<uint64_t>> g_scrub_bps(
+    "chunkserver_scrub_bps", &g_scrub_bytes);
+
+bool IsFinished(INTEGRITY_JOB_STATE state) {
+    return state == INTEGRITY_OP_STATE_CANCELED ||
+           state == INTEGRITY_OP_STATE_FINISHED ||
+           state == INTEGRITY_OP_STATE_FAILED;
+}
+}  // namespace
+
+ScrubManager::ScrubManager()
+    : nextJobId_(1),
+      lastAutoScheduleS_(0),
+      isStop_(true) {}
+
+ScrubManager::~ScrubManager() {
+    Fini();
+}
+
+int ScrubManager::Init(const ScrubOptions& options) {
+    if (options.copysetNodeManager == nullptr ||
+        options.localFileSystem == nullptr) {
+        LOG(ERROR) << "Invalid scrub options, copyset node manager or "
+                   << "local filesystem is null";
+        return -1;
+    }
+    // 与其他副本比较时GetChunkHash请求要求按照kOpRequestAlignSize对齐
+    if (options.readSize == 0 || options.readSize % kOpRequestAlignSize != 0) {
+        LOG(ERROR) << "Invalid scrub read size " << options.readSize
+                   << ", should be a multiple of " << kOpRequestAlignSize;
+        return -1;
+    }
+    options_ = options;
+    bandwidth_.reset(new TokenBucket(options_.bandwidthBytes, 0));
+    lastAutoScheduleS_ = TimeUtility::GetTimeofDaySec();
+    return 0;
+}
+
+int ScrubManager::Run() {
+    if (!options_.enable) {
+        LOG(INFO) << "Scrub is disabled.";
+        return 0;
+    }
+    if (isStop_.exchange(false)) {
+        scrubThread_ = Thread(&ScrubManager::ScrubInterval, this);
+        LOG(INFO) << "Start scrub thread ok.";
+        return 0;
+    }
+    return -1;
+}
+
+int ScrubManager::Fini() {
+    if (!isStop_.exchange(true)) {
+        LOG(INFO) << "stop scrub manager...";
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            cond_.notify_all();
+        }
+        sleeper_.interrupt();
+        scrubThread_.join();
+        LOG(INFO) << "stop scrub manager ok.";
+    }
+    return 0;
+}
+
+int ScrubManager::ScheduleJob(LogicPoolID logicPoolId, CopysetID copysetId,
+                              IntegrityJob* job) {
+    if (GetCopysetNode(logicPoolId, copysetId) == nullptr) {
+        LOG(WARNING) << "Schedule scrub job failed, copyset "
+                     << ToGroupIdString(logicPoolId, copysetId)
+                     << " not found";
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (HasActiveJob(logicPoolId, copysetId)) {
+        LOG(WARNING) << "Schedule scrub job failed, copyset "
+                     << ToGroupIdString(logicPoolId, copysetId)
+                     << " already has an unfinished job";
+        return -1;
+    }
+
+    IntegrityJob newJob;
+    newJob.set_id(nextJobId_++);
+    newJob.set_logicpoolid(logicPoolId);
+    newJob.set_copyset(copysetId);
+    newJob.set_state(INTEGRITY_OP_STATE_WAITING);
+    newJob.set_progress(0);
+    newJob.set_sched_time(TimeUtility::GetTimeofDaySec());
+    newJob.set_start_time(0);
+    jobs_[newJob.id()] = newJob;
+    waitingJobs_.push_back(newJob.id());
+    cond_.notify_all();
+    if (job != nullptr) {
+        *job = newJob;
+    }
+    LOG(INFO) << "Schedule scrub job " << newJob.id() << " for copyset "
+              << ToGroupIdString(logicPoolId, copysetId);
+    return 0;
+}
+
+int ScrubManager::CancelJob(int32_t jobId, IntegrityJob* job) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto it = jobs_.find(jobId);
+    if (it == jobs_.end() || IsFinished(it->second.state())) {
+        return -1;
+    }
+    it->second.set_state(INTEGRITY_OP_STATE_CANCELED);
+    cond_.notify_all();
+    if (job != nullptr) {
+        *job = it->second;
+    }
+    LOG(INFO) << "Cancel scrub job " << jobId;
+    return 0;
+}
+
+int ScrubManager::PauseJob(int32_t jobId, IntegrityJob* job) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto it = jobs_.find(jobId);
+    if (it == jobs_.end() ||
+        (it->second.state() != INTEGRITY_OP_STATE_WAITING &&
+         it->second.state() != INTEGRITY_OP_STATE_RUNNING)) {
+        return -1;
+    }
+    it->second.set_state(INTEGRITY_OP_STATE_PAUSED);
+    if (job != nullptr) {
+        *job = it->second;
+    }
+    LOG(INFO) << "Pause scrub job " << jobId;
+    return 0;
+}
+
+int ScrubManager::ResumeJob(int32_t jobId, IntegrityJob* job) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto it = jobs_.find(jobId);
+    if (it == jobs_.end() ||
+        it->second.state() != INTEGRITY_OP_STATE_PAUSED) {
+        return -1;
+    }
+    // 已经开始执行的任务恢复为running，否则重新等待调度
+    it->second.set_state(it->second.start_time() > 0 ?
+                         INTEGRITY_OP_STATE_RUNNING :
+                         INTEGRITY_OP_STATE_WAITING);
+    cond_.notify_all();
+    if (job != nullptr) {
+        *job = it->second;
+    }
+    LOG(INFO) << "Resume scrub job " << jobId;
+    return 0;
+}
+
+void ScrubManager::ListJobs(std::vector<IntegrityJob>* jobs) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    for (const auto& item : jobs_) {
+        jobs->push_back(item.second);
+    }
+}
+
+CopysetNodePtr ScrubManager::GetCopysetNode(LogicPoolID logicPoolId,
+                                            CopysetID copysetId) {
+    return options_.copysetNodeManager->GetCopysetNode(logicPoolId,
+                                                       copysetId);
+}
+
+int ScrubManager::ListChunks(const CopysetNodePtr& node,
+                             std::vector<ChunkID>* chunks) {
+    std::string dataDir = node->GetCopysetDir() + "/" + RAFT_DATA_DIR;
+    std::vector<std::string> files;
+    if (options_.localFileSystem->List(dataDir, &files) != 0) {
+        LOG(ERROR) << "List chunk files failed, dir: " << dataDir;
+        return -1;
+    }
+    for (const auto& file : files) {
+        FileNameOperator::FileInfo info =
+            FileNameOperator::ParseFileName(file);
+        if (info.type == FileNameOperator::FileType::CHUNK) {
+            chunks->push_back(info.id);
+        }
+    }
+    std::sort(chunks->begin(), chunks->end());
+    return 0;
+}
+
+uint64_t ScrubManager::ForegroundIops() {
+    return ChunkServerMetric::GetInstance()->GetForegroundIops();
+}
+
+int ScrubManager::GetPeerChunkHash(const CopysetNodePtr& node,
+                                   const Peer& peer,
+                                   ChunkID chunkId,
+                                   off_t offset,
+                                   size_t length,
+                                   std::string* hash) {
+    PeerId peerId;
+    if (peerId.parse(peer.address()) != 0) {
+        LOG(WARNING) << "Invalid peer address " << peer.address();
+        return -1;
+    }
+    brpc::Channel channel;
+    if (channel.Init(peerId.addr, nullptr) != 0) {
+        LOG(WARNING) << "can not create channel to " << peerId.addr
+                     << ", copyset " << node->GroupIdString();
+        return -1;
+    }
+
+    brpc::Controller cntl;
+    cntl.set_timeout_ms(options_.rpcTimeoutMs);
+    GetChunkHashRequest request;
+    GetChunkHashResponse response;
+    request.set_logicpoolid(node->GetLogicPoolId());
+    request.set_copysetid(node->GetCopysetId());
+    request.set_chunkid(chunkId);
+    request.set_offset(offset);
+    request.set_length(length);
+    ChunkService_Stub stub(&channel);
+    stub.GetChunkHash(&cntl, &request, &response, nullptr);
+    if (cntl.Failed()) {
+        LOG(WARNING) << "get chunk hash from " << peer.address()
+                     << " failed: " << cntl.ErrorText()
+                     << ", copyset " << node->GroupIdString();
+        return -1;
+    }
+    if (response.status() != CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS) {
+        LOG(WARNING) << "get chunk hash from " << peer.address()
+                     << " failed, status: " << response.status()
+                     << ", copyset " << node->GroupIdString();
+        return -1;
+    }
+    *hash = response.hash();
+    return 0;
+}
+
+void ScrubManager::ScrubInterval() {
+    // 扫描线程的读请求使用idle io优先级，只在磁盘空闲时被调度，
+    // 需要磁盘的io调度器为CFQ或BFQ，其他调度器下只依赖带宽和前台负载限速
+    if (syscall(SYS_ioprio_set, kIoprioWhoProcess, 0,
+                kIoprioClassIdle << kIoprioClassShift) != 0) {
+        LOG(WARNING) << "Set scrub thread io priority failed, errno: "
+                     << errno;
+    }
+
+    while (!isStop_.load()) {
+        if (options_.autoIntervalS > 0) {
+            uint64_t now = TimeUtility::GetTimeofDaySec();
+            if (now - lastAutoScheduleS_ >= options_.autoIntervalS) {
+                ScheduleAllCopysets();
+                lastAutoScheduleS_ = now;
+            }
+        }
+
+        int32_t jobId;
+        if (PopWaitingJob(&jobId)) {
+            RunJob(jobId);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lk(mtx_);
+        cond_.wait_for(lk, std::chrono::seconds(1));
+    }
+}
+
+bool ScrubManager::PopWaitingJob(int32_t* jobId) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    for (auto it = waitingJobs_.begin(); it != waitingJobs_.end();) {
+        auto job = jobs_.find(*it);
+        if (job == jobs_.end() ||
+            job->second.state() == INTEGRITY_OP_STATE_CANCELED) {
+            it = waitingJobs_.erase(it);
+            continue;
+        }
+        // 暂停的任务留在队列中，恢复之后再执行
+        if (job->second.state() == INTEGRITY_OP_STATE_WAITING) {
+            *jobId = *it;
+            waitingJobs_.erase(it);
+            job->second.set_state(INTEGRITY_OP_STATE_RUNNING);
+            job->second.set_start_time(TimeUtility::GetTimeofDaySec());
+            return true;
+        }
+        ++it;
+    }
+    TrimFinishedJobs();
+    return false;
+}
+
+void ScrubManager::RunJob(int32_t jobId) {
+    LogicPoolID logicPoolId;
+    CopysetID copysetId;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        const IntegrityJob& job = jobs_[jobId];
+        logicPoolId = job.logicpoolid();
+        copysetId = job.copyset();
+    }
+
+    LOG(INFO) << "Start scrub job " << jobId << " for copyset "
+              << ToGroupIdString(logicPoolId, copysetId);
+    CopysetNodePtr node = GetCopysetNode(logicPoolId, copysetId);
+    if (node == nullptr) {
+        LOG(WARNING) << "Scrub job " << jobId << " failed, copyset "
+                     << ToGroupIdString(logicPoolId, copysetId)
+                     << " not found";
+        FinishJob(jobId, INTEGRITY_OP_STATE_FAILED);
+        return;
+    }
+    // datastore还没加载时读不到chunk，不能把chunk当作已删除
+    if (!node->IsActivated()) {
+        LOG(WARNING) << "Scrub job " << jobId << " failed, copyset "
+                     << ToGroupIdString(logicPoolId, copysetId)
+                     << " is not activated";
+        FinishJob(jobId, INTEGRITY_OP_STATE_FAILED);
+        return;
+    }
+    std::vector<ChunkID> chunks;
+    if (ListChunks(node, &chunks) != 0) {
+        FinishJob(jobId, INTEGRITY_OP_STATE_FAILED);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        jobs_[jobId].set_totalchunks(chunks.size());
+    }
+
+    for (ChunkID chunkId : chunks) {
+        ScanResult result = ScanChunk(jobId, node, chunkId);
+        if (result == ScanResult::ABORTED) {
+            LOG(INFO) << "Scrub job " << jobId << " aborted";
+            return;
+        }
+        UpdateJob(jobId, result, chunkId);
+    }
+    FinishJob(jobId, INTEGRITY_OP_STATE_FINISHED);
+}
+
+ScrubManager::ScanResult ScrubManager::ScanChunk(int32_t jobId,
+                                                 const CopysetNodePtr& node,
+                                                 ChunkID chunkId) {
+    std::shared_ptr<CSDataStore> datastore = node->GetDataStore();
+    CSChunkInfo info;
+    CSErrorCode ret = datastore->GetChunkInfo(chunkId, &info);
+    if (ret == CSErrorCode::ChunkNotExistError) {
+        return ScanResult::DELETED;
+    } else if (ret != CSErrorCode::Success) {
+        LOG(ERROR) << "Scrub get chunk info failed, chunk id: " << chunkId
+                   << ", copyset " << node->GroupIdString()
+                   << ", ret: " << ret;
+        return ScanResult::ERROR;
+    }
+
+    for (uint32_t offset = 0; offset < info.chunkSize;
+         offset += options_.readSize) {
+        uint32_t length = std::min(options_.readSize,
+                                   info.chunkSize - offset);
+        if (!WaitForScan(jobId, length)) {
+            return ScanResult::ABORTED;
+        }
+
+        std::string hash;
+        ret = datastore->GetChunkHash(chunkId, offset, length, &hash);
+        if (ret == CSErrorCode::ChunkNotExistError) {
+            return ScanResult::DELETED;
+        } else if (ret != CSErrorCode::Success) {
+            LOG(ERROR) << "Scrub read chunk failed, chunk id: " << chunkId
+                       << ", offset: " << offset << ", length: " << length
+                       << ", copyset " << node->GroupIdString()
+                       << ", ret: " << ret;
+            return ScanResult::ERROR;
+        }
+        g_scrub_bytes << length;
+
+        // clone chunk未写过的page各副本的数据不保证一致，只做本地读校验
+        if (!options_.compareReplicas || info.isClone ||
+            !node->IsLeaderTerm()) {
+            continue;
+        }
+        if (!CompareWithPeers(node, chunkId, offset, length, hash)) {
+            return ScanResult::MISMATCH;
+        }
+    }
+    return ScanResult::OK;
+}
+
+bool ScrubManager::CompareWithPeers(const CopysetNodePtr& node,
+                                    ChunkID chunkId,
+                                    off_t offset,
+                                    size_t length,
+                                    const std::string& localHash) {
+    std::vector<Peer> peers;
+    node->ListPeers(&peers);
+    std::string self = node->GetLeaderId().to_string();
+
+    for (const auto& peer : peers) {
+        if (peer.address() == self) {
+            continue;
+        }
+        std::string local = localHash;
+        std::string remote;
+        bool consistent = false;
+        for (uint32_t i = 0; i <= options_.mismatchRetryTimes; ++i) {
+            // 不一致可能是因为写请求还没有在所有副本上apply，等待之后重新比较
+            if (i > 0) {
+                if (!sleeper_.wait_for(std::chrono::milliseconds(
+                        options_.mismatchRetryIntervalMs))) {
+                    return true;
+                }
+                CSErrorCode ret = node->GetDataStore()->GetChunkHash(
+                    chunkId, offset, length, &local);
+                if (ret != CSErrorCode::Success) {
+                    // chunk已被删除或读取失败，下一轮扫描时再检查
+                    return true;
+                }
+            }
+            // 无法获取副本的hash时跳过该副本
+            if (GetPeerChunkHash(node, peer, chunkId, offset,
+                                 length, &remote) != 0) {
+                consistent = true;
+                break;
+            }
+            if (remote == local) {
+                consistent = true;
+                break;
+            }
+        }
+        if (!consistent) {
+            LOG(ERROR) << "Scrub found inconsistent chunk, chunk id: "
+                       << chunkId << ", offset: " << offset
+                       << ", length: " << length
+                       << ", copyset " << node->GroupIdString()
+                       << ", local hash: " << local
+                       << ", peer " << peer.address()
+                       << " hash: " << remote;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ScrubManager::WaitForScan(int32_t jobId, uint64_t bytes) {
+    while (true) {
+        if (!CheckJobState(jobId)) {
+            return false;
+        }
+        if (options_.pauseIops == 0 ||
+            ForegroundIops() <= options_.pauseIops) {
+            break;
+        }
+        if (!sleeper_.wait_for(std::chrono::milliseconds(
+                options_.pauseCheckIntervalMs))) {
+            return false;
+        }
+    }
+
+    // 后台任务不设最长等待时间，透支多少就等待多少
+    uint64_t waitUs = 0;
+    bandwidth_->Reserve(bytes, TimeUtility::GetTimeofDayUs(), UINT64_MAX,
+                        &waitUs);
+    if (waitUs > 0 &&
+        !sleeper_.wait_for(std::chrono::microseconds(waitUs))) {
+        return false;
+    }
+    return true;
+}
+
+bool ScrubManager::CheckJobState(int32_t jobId) {
+    std::unique_lock<std::mutex> lk(mtx_);
+    cond_.wait(lk, [&] {
+        return isStop_.load() ||
+               jobs_[jobId].state() != INTEGRITY_OP_STATE_PAUSED;
+    });
+    return !isStop_.load() &&
+           jobs_[jobId].state() == INTEGRITY_OP_STATE_RUNNING;
+}
+
+void ScrubManager::UpdateJob(int32_t jobId, ScanResult result,
+                             ChunkID chunkId) {
+    if (result == ScanResult::ERROR) {
+        g_scrub_error_chunks << 1;
+    } else if (result == ScanResult::MISMATCH) {
+        g_scrub_mismatch_chunks << 1;
+    }
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    IntegrityJob& job = jobs_[jobId];
+    job.set_scannedchunks(job.scannedchunks() + 1);
+    if (job.totalchunks() > 0) {
+        job.set_progress(job.scannedchunks() * 100 / job.totalchunks());
+    }
+    if (result == ScanResult::ERROR) {
+        job.set_errorchunks(job.errorchunks() + 1);
+    } else if (result == ScanResult::MISMATCH) {
+        job.set_mismatchchunks(job.mismatchchunks() + 1);
+    }
+    if ((result == ScanResult::ERROR || result == ScanResult::MISMATCH) &&
+        job.badchunks_size() < kMaxBadChunks) {
+        job.add_badchunks(chunkId);
+    }
+}
+
+void ScrubManager::FinishJob(int32_t jobId, INTEGRITY_JOB_STATE state) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    IntegrityJob& job = jobs_[jobId];
+    // 任务在结束前被取消，保留取消状态
+    if (job.state() == INTEGRITY_OP_STATE_CANCELED) {
+        return;
+    }
+    job.set_state(state);
+    if (state == INTEGRITY_OP_STATE_FINISHED) {
+        job.set_progress(100);
+    }
+    LOG(INFO) << "Scrub job " << jobId << " finished, state: "
+              << INTEGRITY_JOB_STATE_Name(state)
+              << ", total chunks: " << job.totalchunks()
+              << ", error chunks: " << job.errorchunks()
+              << ", mismatch chunks: " << job.mismatchchunks();
+}
+
+void ScrubManager::ScheduleAllCopysets() {
+    std::vector<CopysetNodePtr> nodes;
+    options_.copysetNodeManager->GetAllCopysetNodes(&nodes);
+    for (const auto& node : nodes) {
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            if (HasActiveJob(node->GetLogicPoolId(), node->GetCopysetId())) {
+                continue;
+            }
+        }
+        ScheduleJob(node->GetLogicPoolId(), node->GetCopysetId(), nullptr);
+    }
+}
+
+bool ScrubManager::HasActiveJob(LogicPoolID logicPoolId,
+                                CopysetID copysetId) const {
+    for (const auto& item : jobs_) {
+        const IntegrityJob& job = item.second;
+        if (job.logicpoolid() == logicPoolId &&
+            static_cast<CopysetID>(job.copyset()) == copysetId &&
+            !IsFinished(job.state())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ScrubManager::TrimFinishedJobs() {
+    uint32_t finished = 0;
+    for (const auto& item : jobs_) {
+        if (IsFinished(item.second.state())) {
+            ++finished;
+        }
+    }
+    // jobs_按照id排序，优先删除最老的任务
+    for (auto it = jobs_.begin();
+         it != jobs_.end() && finished > options_.maxFinishedJobs;) {
+        if (IsFinished(it->second.state())) {
+            it = jobs_.erase(it);
+            --finished;
+        } else {
+            ++it;
+        }
+    }
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,202 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef SRC_CHUNKSERVER_SCRUB_MANAGER_H_
+#define SRC_CHUNKSERVER_SCRUB_MANAGER_H_
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "proto/integrity.pb.h"
+#include "src/chunkserver/copyset_node_manager.h"
+#include "src/chunkserver/qos_throttle.h"
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/interruptible_sleeper.h"
+#include "src/fs/local_filesystem.h"
+
+namespace curve {
+namespace chunkserver {
+
+using ::curve::common::Thread;
+using ::curve::common::Atomic;
+using ::curve::common::InterruptibleSleeper;
+using curve::fs::LocalFileSystem;
+
+struct ScrubOptions {
+    // 是否开启后台扫描
+    bool enable;
+    // 扫描的带宽上限，单位字节/秒，0表示不限制
+    uint64_t bandwidthBytes;
+    // 每次读取校验的数据大小
+    uint32_t readSize;
+    // 前台读写请求的rps超过该值时暂停扫描，0表示不暂停
+    uint64_t pauseIops;
+    // 因前台负载暂停时，每次检查的间隔
+    uint32_t pauseCheckIntervalMs;
+    // leader是否与其他副本比较数据的hash
+    bool compareReplicas;
+    // 获取其他副本hash的rpc超时时间
+    uint32_t rpcTimeoutMs;
+    // hash不一致时可能是有写请求正在apply，重试的次数和间隔
+    uint32_t mismatchRetryTimes;
+    uint32_t mismatchRetryIntervalMs;
+    // 周期性为所有copyset生成扫描任务的间隔，0表示只扫描手动下发的任务
+    uint32_t autoIntervalS;
+    // 保留的已结束任务的个数
+    uint32_t maxFinishedJobs;
+
+    CopysetNodeManager* copysetNodeManager;
+    std::shared_ptr<LocalFileSystem> localFileSystem;
+
+    ScrubOptions()
+        : enable(false),
+          bandwidthBytes(16 * 1024 * 1024),
+          readSize(1024 * 1024),
+          pauseIops(0),
+          pauseCheckIntervalMs(100),
+          compareReplicas(true),
+          rpcTimeoutMs(5000),
+          mismatchRetryTimes(3),
+          mismatchRetryIntervalMs(1000),
+          autoIntervalS(0),
+          maxFinishedJobs(1024),
+          copysetNodeManager(nullptr) {}
+};
+
+/**
+ * 后台数据扫描，以copyset为单位生成扫描任务:
+ * 1. 按照配置的带宽逐个读取copyset下的chunk，读取失败的chunk记为error
+ * 2. copyset的leader将每段数据的hash与其他副本比较，多次重试之后依然不一致
+ *    的chunk记为mismatch
+ * 3. 前台读写压力超过阈值时暂停扫描，扫描线程的io优先级设置为idle
+ * 任务串行执行，通过IntegrityService下发、暂停、恢复、取消和查询
+ */
+class ScrubManager {
+ public:
+    ScrubManager();
+    virtual ~ScrubManager();
+
+    int Init(const ScrubOptions& options);
+
+    int Run();
+
+    int Fini();
+
+    /**
+     * 为指定copyset生成扫描任务
+     * @param[out] job: 新生成的任务
+     * @return 成功返回0，copyset不存在或者已经有未结束的任务返回-1
+     */
+    int ScheduleJob(LogicPoolID logicPoolId, CopysetID copysetId,
+                    IntegrityJob* job);
+
+    // 以下接口成功返回0，任务不存在或者状态不允许时返回-1
+    int CancelJob(int32_t jobId, IntegrityJob* job);
+
+    int PauseJob(int32_t jobId, IntegrityJob* job);
+
+    int ResumeJob(int32_t jobId, IntegrityJob* job);
+
+    void ListJobs(std::vector<IntegrityJob>* jobs);
+
+    // 单元测试使用，同步扫描任务队列直到为空
+    void RunPendingJobs();
+
+ protected:
+    // 以下接口为虚函数，方便单元测试
+    virtual CopysetNodePtr GetCopysetNode(LogicPoolID logicPoolId,
+                                          CopysetID copysetId);
+
+    // 获取copyset下所有chunk的id，不包括快照
+    virtual int ListChunks(const CopysetNodePtr& node,
+                           std::vector<ChunkID>* chunks);
+
+    // 当前前台读写请求的rps
+    virtual uint64_t ForegroundIops();
+
+    virtual int GetPeerChunkHash(const CopysetNodePtr& node,
+                                 const Peer& peer,
+                                 ChunkID chunkId,
+                                 off_t offset,
+                                 size_t length,
+                                 std::string* hash);
+
+ private:
+    enum class ScanResult {
+        OK = 0,
+        ERROR = 1,
+        MISMATCH = 2,
+        // chunk在扫描过程中被删除
+        DELETED = 3,
+        // 任务被取消或者模块停止
+        ABORTED = 4,
+    };
+
+    void ScrubInterval();
+
+    // 取出下一个等待中的任务，没有任务时返回false
+    bool PopWaitingJob(int32_t* jobId);
+    void RunJob(int32_t jobId);
+    ScanResult ScanChunk(int32_t jobId, const CopysetNodePtr& node,
+                         ChunkID chunkId);
+    // 与其他副本比较hash，一致返回true
+    bool CompareWithPeers(const CopysetNodePtr& node, ChunkID chunkId,
+                          off_t offset, size_t length,
+                          const std::string& localHash);
+
+    // 任务暂停时阻塞，并按照带宽和前台负载限速；任务被取消或者模块停止返回false
+    bool WaitForScan(int32_t jobId, uint64_t bytes);
+    bool CheckJobState(int32_t jobId);
+
+    void UpdateJob(int32_t jobId, ScanResult result, ChunkID chunkId);
+    void FinishJob(int32_t jobId, INTEGRITY_JOB_STATE state);
+    void ScheduleAllCopysets();
+    bool HasActiveJob(LogicPoolID logicPoolId, CopysetID copysetId) const;
+    void TrimFinishedJobs();
+
+ private:
+    ScrubOptions options_;
+
+    // 保护jobs_和waitingJobs_
+    mutable std::mutex mtx_;
+    std::condition_variable cond_;
+    std::map<int32_t, IntegrityJob> jobs_;
+    std::deque<int32_t> waitingJobs_;
+    int32_t nextJobId_;
+
+    std::unique_ptr<TokenBucket> bandwidth_;
+    uint64_t lastAutoScheduleS_;
+
+    Thread scrubThread_;
+    Atomic<bool> isStop_;
+    InterruptibleSleeper sleeper_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_SCRUB_MANAGER_H_
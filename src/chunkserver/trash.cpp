@@ -29,6 +29,7 @@
 #include "src/chunkserver/copyset_node.h"
 #include "include/chunkserver/chunkserver_common.h"
 #include "src/chunkserver/uri_paser.h"
+#include "src/chunkserver/raftlog/define.h"
 
 using ::curve::chunkserver::RAFT_DATA_DIR;
 using ::curve::chunkserver::RAFT_META_DIR;
@@ -55,6 +56,7 @@ int Trash::Init(TrashOptions options) {
     scanPeriodSec_ = options.scanPeriodSec;
     localFileSystem_ = options.localFileSystem;
     chunkfilePool_ = options.chunkfilePool;
+    walPool_ = options.walPool;
     chunkNum_.store(0);
 
      // 读取trash目录下的所有目录
@@ -220,6 +222,17 @@ bool Trash::IsChunkOrSnapShotFile(const std::string &chunkName) {
         FileNameOperator::ParseFileName(chunkName).type;
 }
 
+bool Trash::IsWalSegmentFile(const std::string &fileName) {
+    int64_t firstIndex = 0;
+    int64_t lastIndex = 0;
+    if (2 == sscanf(fileName.c_str(), CURVE_SEGMENT_CLOSED_PATTERN,
+                    &firstIndex, &lastIndex)) {
+        return true;
+    }
+    return 1 == sscanf(fileName.c_str(), CURVE_SEGMENT_OPEN_PATTERN,
+                       &firstIndex);
+}
+
 bool Trash::RecycleChunksInDir(
     const std::string &copysetPath, const std::string &filename) {
     bool isDir = localFileSystem_->DirExists(copysetPath);
@@ -248,6 +261,16 @@ bool Trash::RecycleChunksInDir(
 
 bool Trash::RecycleIfChunkfile(
     const std::string &filepath, const std::string &filename) {
+    // curve log storage的segment文件, 回收到walpool中
+    if (walPool_ != nullptr && IsWalSegmentFile(filename)) {
+        if (0 != walPool_->RecycleChunk(filepath)) {
+            LOG(ERROR) << "Trash failed recycle wal segment " << filepath
+                       << " to walPool";
+            return false;
+        }
+        return true;
+    }
+
     // 不是chunkfile或者snapshotfile
     if (!IsChunkOrSnapShotFile(filename)) {
         return true;
@@ -46,6 +46,8 @@ struct TrashOptions{
 
     std::shared_ptr<LocalFileSystem> localFileSystem;
     std::shared_ptr<ChunkfilePool> chunkfilePool;
+    // wal文件池，用于回收curve log storage的segment文件，可以为空
+    std::shared_ptr<ChunkfilePool> walPool;
 };
 
 class Trash {
@@ -104,6 +106,15 @@ class Trash {
     */
     bool IsChunkOrSnapShotFile(const std::string &chunkName);
 
+    /*
+    * @brief IsWalSegmentFile 是否为curve log storage的segment文件
+    *
+    * @param[in] fileName 文件名
+    *
+    * @return true-符合segment文件命名规则
+    */
+    bool IsWalSegmentFile(const std::string &fileName);
+
     /*
     * @brief RecycleChunksInCopyset 回收指定文件下的chunk
     *
@@ -146,6 +157,9 @@ class Trash {
     // chunk池子
     std::shared_ptr<ChunkfilePool> chunkfilePool_;
 
+    // wal池子
+    std::shared_ptr<ChunkfilePool> walPool_;
+
     // 回收站全路径
     std::string trashPath_;
 
@@ -36,6 +36,8 @@
 #include "src/client/request_closure.h"
 #include "src/client/request_context.h"
 #include "src/client/io_tracker.h"
+#include "src/client/client_object_pool.h"
+#include "src/common/crc32.h"
 
 // TODO(tongguangxun) :优化重试逻辑，将重试逻辑与RPC返回逻辑拆开
 namespace curve {
@@ -43,6 +45,14 @@ namespace client {
 ClientClosure::BackoffParam  ClientClosure::backoffParam_;
 FailureRequestOption_t  ClientClosure::failReqOpt_;
 
+// rpc controller由RequestSender从对象池中获取，rpc结束后重置并归还
+struct PooledControllerDeleter {
+    void operator()(brpc::Controller* cntl) const {
+        cntl->Reset();
+        ClientObjectPool<brpc::Controller>::Return(cntl);
+    }
+};
+
 UnstableState UnstableHelper::GetCurrentUnstableState(
     ChunkServerID csId,
     const butil::EndPoint& csEndPoint) {
@@ -202,7 +212,8 @@ uint64_t ClientClosure::TimeoutBackOff(uint64_t currentRetryTimes) {
 // 各子类需要实现SendRetryRequest，进行重试请求
 void ClientClosure::Run() {
     std::unique_ptr<ClientClosure> selfGuard(this);
-    std::unique_ptr<brpc::Controller> cntlGuard(cntl_);
+    std::unique_ptr<brpc::Controller, PooledControllerDeleter>
+        cntlGuard(cntl_);
     brpc::ClosureGuard doneGuard(done_);
 
     metaCache_ = client_->GetMetaCache();
@@ -277,6 +288,17 @@ void ClientClosure::Run() {
             OnChunkExist();
             break;
 
+        // 2.7 数据在传输过程中被破坏，重试
+        case CHUNK_OP_STATUS::CHUNK_OP_STATUS_CRC_FAIL:
+            needRetry = true;
+            LOG(ERROR) << OpTypeToString(reqCtx_->optype_)
+                << " crc check failed, " << *reqCtx_
+                << ", retried times = " << reqDone_->GetRetriedTimes()
+                << ", IO id = " << reqDone_->GetIOTracker()->GetID()
+                << ", request id = " << reqCtx_->id_
+                << ", remote side = " << remoteAddress_;
+            break;
+
         default:
             needRetry = true;
             LOG_EVERY_N(ERROR, 10) << OpTypeToString(reqCtx_->optype_)
@@ -528,12 +550,33 @@ void ReadChunkClosure::SendRetryRequest() {
                        done_);
 }
 
+// 将rpc返回的数据拷贝到request对应的用户buffer，向量化IO时按片段依次拷贝
+// 读取到IOBuf的请求直接接管rpc返回的数据，不做拷贝
+static void CopyToReadBuffer(butil::IOBuf* data, RequestContext* ctx) {
+    if (ctx->readIOBuf_) {
+        ctx->readData_.clear();
+        ctx->readData_.swap(*data);
+        return;
+    }
+
+    if (ctx->iov_.empty()) {
+        data->copy_to(ctx->readBuffer_, data->size());
+        return;
+    }
+
+    size_t pos = 0;
+    for (const auto& piece : ctx->iov_) {
+        if (pos >= data->size()) {
+            break;
+        }
+        pos += data->copy_to(piece.iov_base, piece.iov_len, pos);
+    }
+}
+
 void ReadChunkClosure::OnSuccess() {
     ClientClosure::OnSuccess();
 
-    cntl_->response_attachment().copy_to(
-        reqCtx_->readBuffer_,
-        cntl_->response_attachment().size());
+    CopyToReadBuffer(&cntl_->response_attachment(), reqCtx_);
 
     metaCache_->UpdateAppliedIndex(
         reqCtx_->idinfo_.lpid_,
@@ -541,13 +584,172 @@ void ReadChunkClosure::OnSuccess() {
         response_->appliedindex());
 }
 
+// 返回数据的crc与response中的crc不一致时，按照CRC_FAIL处理
+static CHUNK_OP_STATUS GetReadResponseStatus(const ChunkResponse& response,
+                                             const butil::IOBuf& data) {
+    CHUNK_OP_STATUS status = response.status();
+    if (status == CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS &&
+        response.has_crc() &&
+        curve::common::CRC32(0, data) != response.crc()) {
+        return CHUNK_OP_STATUS::CHUNK_OP_STATUS_CRC_FAIL;
+    }
+    return status;
+}
+
+void ReadChunkClosure::Run() {
+    if (hedgedRead_ != nullptr && !hedgedRead_->ClaimByPrimary()) {
+        // 请求已经由备份读请求完成，done_及其request context可能已被回收
+        std::unique_ptr<ReadChunkClosure> selfGuard(this);
+        std::unique_ptr<brpc::Controller, PooledControllerDeleter>
+            cntlGuard(cntl_);
+        OnHedgeWon();
+        return;
+    }
+
+    ClientClosure::Run();
+}
+
+void ReadChunkClosure::OnHedgeWon() {
+    // 请求已经完成，文件可能已经关闭，client_和metaCache_随之析构，
+    // 这里只能访问进程级的UnstableHelper
+    if (!cntl_->Failed()) {
+        UnstableHelper::GetInstance().ClearTimeout(
+            chunkserverID_, chunkserverEndPoint_);
+        return;
+    }
+
+    // leader超时同样计入超时次数，否则备份读掩盖了leader的异常，
+    // 该chunkserver一直不会被标记为unstable；
+    // 是否标记为unstable由之后发往该chunkserver的请求判断
+    if (cntl_->ErrorCode() == brpc::ERPCTIMEDOUT) {
+        UnstableHelper::GetInstance().IncreTimeout(chunkserverID_);
+    }
+}
+
+CHUNK_OP_STATUS ReadChunkClosure::GetResponseStatus() const {
+    return GetReadResponseStatus(*response_, cntl_->response_attachment());
+}
+
 void ReadChunkClosure::OnChunkNotExist() {
     ClientClosure::OnChunkNotExist();
 
     reqDone_->SetFailed(0);
-    memset(reqCtx_->readBuffer_, 0, reqCtx_->rawlength_);
+    reqCtx_->ZeroReadBuffer();
     metaCache_->UpdateAppliedIndex(chunkIdInfo_.lpid_, chunkIdInfo_.cpid_,
                                    response_->appliedindex());
+
+    // follower可能落后于leader，只记录leader返回的chunk不存在
+    if (!reqCtx_->followerRead_) {
+        metaCache_->MarkZeroChunks(reqCtx_->chunkIdx_, 1,
+                                   reqCtx_->zeroChunkEpoch_);
+    }
+}
+
+void ReadChunkClosure::OnRedirected() {
+    // follower read被拒绝，说明follower的applied index落后或者follower当前
+    // 没有leader，leader信息不一定发生了变化，直接重试到leader上
+    if (reqCtx_->followerRead_) {
+        LOG(INFO) << "follower read rejected, retry on leader, " << *reqCtx_
+            << ", IO id = " << reqDone_->GetIOTracker()->GetID()
+            << ", request id = " << reqCtx_->id_
+            << ", remote side = " << remoteAddress_;
+        reqCtx_->leaderOnlyRead_ = true;
+        retryDirectly_ = true;
+        return;
+    }
+
+    ClientClosure::OnRedirected();
+}
+
+bool HedgedReadContext::ClaimByPrimary() {
+    while (true) {
+        int expected = state.load(std::memory_order_acquire);
+        switch (expected) {
+        case kHedgeSending:
+            // 备份读请求为异步发送，很快会结束
+            bthread_yield();
+            break;
+        case kHedgeWon:
+            return false;
+        case kPending:
+        case kHedgeInflight:
+            if (state.compare_exchange_weak(expected, kPrimaryDone)) {
+                if (expected == kPending &&
+                    timerArmed.load(std::memory_order_acquire) &&
+                    bthread_timer_del(timer) == 0) {
+                    delete timerRef;
+                    timerRef = nullptr;
+                }
+                return true;
+            }
+            break;
+        default:
+            return true;
+        }
+    }
+}
+
+bool HedgedReadContext::ClaimByHedge() {
+    while (true) {
+        int expected = state.load(std::memory_order_acquire);
+        if (expected != kHedgeSending && expected != kHedgeInflight) {
+            return false;
+        }
+        if (state.compare_exchange_weak(expected, kHedgeWon)) {
+            return true;
+        }
+    }
+}
+
+void HedgedReadClosure::Run() {
+    std::unique_ptr<HedgedReadClosure> selfGuard(this);
+    std::unique_ptr<brpc::Controller, PooledControllerDeleter>
+        cntlGuard(cntl_);
+
+    const ChunkIDInfo& idinfo = hedgedRead_->idinfo;
+    if (cntl_->Failed()) {
+        LOG_EVERY_N(WARNING, 100) << "hedged read rpc failed"
+            << ", logicpool id = " << idinfo.lpid_
+            << ", copyset id = " << idinfo.cpid_
+            << ", chunk id = " << idinfo.cid_
+            << ", error = " << cntl_->ErrorText()
+            << ", remote side = " << cntl_->remote_side();
+        return;
+    }
+
+    CHUNK_OP_STATUS status = GetReadResponseStatus(
+        *response_, cntl_->response_attachment());
+    if (status != CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS) {
+        // follower的applied index落后等情况下会拒绝请求，等待leader返回即可
+        VLOG(3) << "hedged read failed, status = "
+            << curve::chunkserver::CHUNK_OP_STATUS_Name(status)
+            << ", logicpool id = " << idinfo.lpid_
+            << ", copyset id = " << idinfo.cpid_
+            << ", chunk id = " << idinfo.cid_
+            << ", remote side = " << cntl_->remote_side();
+        return;
+    }
+
+    if (!hedgedRead_->ClaimByHedge()) {
+        return;
+    }
+
+    RequestClosure* reqDone = hedgedRead_->reqDone;
+    RequestContext* reqCtx = reqDone->GetReqCtx();
+    FileMetric* fileMetric = reqDone->GetMetric();
+
+    CopyToReadBuffer(&cntl_->response_attachment(), reqCtx);
+    hedgedRead_->client->GetMetaCache()->UpdateAppliedIndex(
+        idinfo.lpid_, idinfo.cpid_, response_->appliedindex());
+
+    auto duration = TimeUtility::GetTimeofDayUs() - reqDone->GetStartTime();
+    MetricHelper::LatencyRecord(fileMetric, duration, OpType::READ);
+    MetricHelper::IncremRPCQPSCount(fileMetric, reqCtx->rawlength_,
+                                    OpType::READ);
+    MetricHelper::IncremHedgedReadWinNum(fileMetric);
+
+    reqDone->SetFailed(0);
+    reqDone->Run();
 }
 
 void ReadChunkSnapClosure::SendRetryRequest() {
@@ -560,9 +762,7 @@ void ReadChunkSnapClosure::SendRetryRequest() {
 void ReadChunkSnapClosure::OnSuccess() {
     ClientClosure::OnSuccess();
 
-    cntl_->response_attachment().copy_to(
-        reqCtx_->readBuffer_,
-        cntl_->response_attachment().size());
+    CopyToReadBuffer(&cntl_->response_attachment(), reqCtx_);
 }
 
 void DeleteChunkSnapClosure::SendRetryRequest() {
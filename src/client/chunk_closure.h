@@ -29,8 +29,10 @@
 #include <brpc/errno.pb.h>
 #include <unordered_map>  // NOLINT
 #include <unordered_set>  // NOLINT
+#include <atomic>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "proto/chunk.pb.h"
 #include "src/client/client_config.h"
@@ -106,6 +108,14 @@ class UnstableHelper {
         serverUnstabledChunkservers_.clear();
     }
 
+    // 测试使用，获取chunkserver当前的超时次数
+    uint32_t GetTimeoutTimes(ChunkServerID csId) {
+        lock_.Lock();
+        uint32_t times = timeoutTimes_[csId];
+        lock_.UnLock();
+        return times;
+    }
+
  private:
     UnstableHelper() = default;
 
@@ -328,14 +338,117 @@ class WriteChunkClosure : public ClientClosure {
     void SendRetryRequest() override;
 };
 
+/**
+ * hedged read的共享状态，由leader上读请求的closure、定时器和follower上
+ * 备份读请求的closure共同持有，通过state决定由哪一方完成上层的请求
+ */
+struct HedgedReadContext {
+    enum State {
+        // leader上的读请求未返回，备份读请求未发送
+        kPending = 0,
+        // 正在发送备份读请求，leader的读请求返回时等待发送结束
+        kHedgeSending,
+        // 备份读请求已发送
+        kHedgeInflight,
+        // leader上的读请求先返回，由其closure完成请求
+        kPrimaryDone,
+        // 备份读请求先成功返回，由其closure完成请求
+        kHedgeWon
+    };
+
+    std::atomic<int> state{kPending};
+
+    // 发送备份读请求前的等待时间
+    uint64_t delayUS{0};
+    // 发送备份读请求的定时器，以及定时器回调持有的引用
+    // 定时器删除成功时，回调不会执行，由leader的closure释放该引用
+    std::atomic<bool> timerArmed{false};
+    bthread_timer_t timer;
+    std::shared_ptr<HedgedReadContext>* timerRef{nullptr};
+
+    CopysetClient* client{nullptr};
+    // 上层请求的closure，只有在未被leader的closure完成时才可以访问
+    RequestClosure* reqDone{nullptr};
+
+    ChunkIDInfo idinfo;
+    off_t offset{0};
+    size_t length{0};
+    uint64_t appliedindex{0};
+    uint64_t fileId{0};
+    // leader所在的chunkserver，备份读请求不会发往该chunkserver
+    ChunkServerID leaderId{0};
+
+    /**
+     * leader上的读请求返回时调用，成功后由leader的closure完成请求
+     * @return: 备份读请求已经完成了请求返回false，否则返回true
+     */
+    bool ClaimByPrimary();
+
+    /**
+     * 备份读请求成功返回时调用
+     * @return: leader的closure已经完成了请求返回false，否则返回true
+     */
+    bool ClaimByHedge();
+};
+
 class ReadChunkClosure : public ClientClosure {
  public:
     ReadChunkClosure(CopysetClient *client, Closure *done)
      : ClientClosure(client, done) {}
 
+    // 备份读请求先完成时，只释放本次rpc的资源
+    void Run() override;
+
     void OnSuccess() override;
     void OnChunkNotExist() override;
+    void OnRedirected() override;
     void SendRetryRequest() override;
+
+    // 返回数据的crc与response中的crc不一致时，按照CRC_FAIL处理
+    CHUNK_OP_STATUS GetResponseStatus() const override;
+
+    void SetHedgedRead(std::shared_ptr<HedgedReadContext> hedgedRead) {
+        hedgedRead_ = std::move(hedgedRead);
+    }
+
+ private:
+    /**
+     * 备份读请求先完成时，记录leader上rpc的结果用于判断chunkserver是否健康，
+     * 此时不能访问done_及其request context，也不能访问client_和metaCache_
+     */
+    void OnHedgeWon();
+
+ private:
+    std::shared_ptr<HedgedReadContext> hedgedRead_;
+};
+
+/**
+ * 发往follower的备份读请求的closure，请求失败时直接丢弃，
+ * 成功且先于leader返回时完成上层的请求
+ */
+class HedgedReadClosure : public Closure {
+ public:
+    explicit HedgedReadClosure(std::shared_ptr<HedgedReadContext> hedgedRead)
+        : hedgedRead_(std::move(hedgedRead)), cntl_(nullptr) {}
+
+    void SetCntl(brpc::Controller* cntl) {
+        cntl_ = cntl;
+    }
+
+    void SetResponse(ChunkResponse* response) {
+        response_.reset(response);
+    }
+
+    const HedgedReadContext& GetHedgedRead() const {
+        return *hedgedRead_;
+    }
+
+    void Run() override;
+
+ private:
+    std::shared_ptr<HedgedReadContext> hedgedRead_;
+    brpc::Controller* cntl_;
+    std::unique_ptr<ChunkResponse> response_;
 };
 
 class ReadChunkSnapClosure : public ClientClosure {
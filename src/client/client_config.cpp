@@ -59,6 +59,36 @@ int ClientConfig::Init(const char* configpath) {
     LOG_IF(ERROR, ret == false) << "config no chunkserver.enableAppliedIndexRead info";     // NOLINT
     RETURN_IF_FALSE(ret)
 
+    ret = conf_.GetBoolValue("chunkserver.enableFollowerRead",
+          &fileServiceOption_.ioOpt.ioSenderOpt.chunkserverEnableFollowerRead);        // NOLINT
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.enableFollowerRead info, using default value "
+        << fileServiceOption_.ioOpt.ioSenderOpt.chunkserverEnableFollowerRead;
+
+    ret = conf_.GetBoolValue("chunkserver.enableChecksum",
+          &fileServiceOption_.ioOpt.ioSenderOpt.chunkserverEnableChecksum);
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.enableChecksum info, using default value "
+        << fileServiceOption_.ioOpt.ioSenderOpt.chunkserverEnableChecksum;
+
+    ret = conf_.GetBoolValue("chunkserver.enableHedgedRead",
+          &fileServiceOption_.ioOpt.ioSenderOpt.chunkserverEnableHedgedRead);
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.enableHedgedRead info, using default value "
+        << fileServiceOption_.ioOpt.ioSenderOpt.chunkserverEnableHedgedRead;
+
+    ret = conf_.GetUInt32Value("chunkserver.hedgedReadPercentile",
+          &fileServiceOption_.ioOpt.ioSenderOpt.chunkserverHedgedReadPercentile);    // NOLINT
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.hedgedReadPercentile info, using default value "    // NOLINT
+        << fileServiceOption_.ioOpt.ioSenderOpt.chunkserverHedgedReadPercentile;
+
+    ret = conf_.GetUInt64Value("chunkserver.hedgedReadMinDelayUS",
+          &fileServiceOption_.ioOpt.ioSenderOpt.chunkserverHedgedReadMinDelayUS);    // NOLINT
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.hedgedReadMinDelayUS info, using default value "    // NOLINT
+        << fileServiceOption_.ioOpt.ioSenderOpt.chunkserverHedgedReadMinDelayUS;
+
     ret = conf_.GetUInt32Value("chunkserver.opMaxRetry",
           &fileServiceOption_.ioOpt.ioSenderOpt.failRequestOpt.chunkserverOPMaxRetry);    // NOLINT
     LOG_IF(ERROR, ret == false) << "config no chunkserver.opMaxRetry info";
@@ -127,6 +157,24 @@ int ClientConfig::Init(const char* configpath) {
     LOG_IF(ERROR, ret == false) << "config no metacache.getLeaderTimeOutMS info";   // NOLINT
     RETURN_IF_FALSE(ret)
 
+    ret = conf_.GetBoolValue("metacache.zeroChunkCacheEnable",
+        &fileServiceOption_.ioOpt.metaCacheOpt.metacacheZeroChunkCacheEnable);
+    LOG_IF(WARNING, ret == false)
+        << "config no metacache.zeroChunkCacheEnable info, using default value "   // NOLINT
+        << fileServiceOption_.ioOpt.metaCacheOpt.metacacheZeroChunkCacheEnable;
+
+    ret = conf_.GetBoolValue("metacache.warmupOnOpen",
+        &fileServiceOption_.ioOpt.metaCacheOpt.metacacheWarmupOnOpen);
+    LOG_IF(WARNING, ret == false)
+        << "config no metacache.warmupOnOpen info, using default value "
+        << fileServiceOption_.ioOpt.metaCacheOpt.metacacheWarmupOnOpen;
+
+    ret = conf_.GetUInt32Value("metacache.warmupSegmentsPerRPC",
+        &fileServiceOption_.ioOpt.metaCacheOpt.metacacheWarmupSegmentsPerRPC);
+    LOG_IF(WARNING, ret == false)
+        << "config no metacache.warmupSegmentsPerRPC info, using default value "   // NOLINT
+        << fileServiceOption_.ioOpt.metaCacheOpt.metacacheWarmupSegmentsPerRPC;
+
     ret = conf_.GetUInt32Value("schedule.queueCapacity",
         &fileServiceOption_.ioOpt.reqSchdulerOpt.scheduleQueueCapacity);
     LOG_IF(ERROR, ret == false) << "config no schedule.queueCapacity info";
@@ -137,6 +185,12 @@ int ClientConfig::Init(const char* configpath) {
     LOG_IF(ERROR, ret == false) << "config no schedule.threadpoolSize info";
     RETURN_IF_FALSE(ret)
 
+    ret = conf_.GetBoolValue("schedule.directDispatch",
+        &fileServiceOption_.ioOpt.reqSchdulerOpt.scheduleDirectDispatch);
+    LOG_IF(WARNING, ret == false)
+        << "config no schedule.directDispatch info, using default value "
+        << fileServiceOption_.ioOpt.reqSchdulerOpt.scheduleDirectDispatch;
+
     ret = conf_.GetUInt32Value("mds.refreshTimesPerLease",
         &fileServiceOption_.leaseOpt.mdsRefreshTimesPerLease);
     LOG_IF(ERROR, ret == false) << "config no mds.refreshTimesPerLease info";
@@ -156,6 +210,24 @@ int ClientConfig::Init(const char* configpath) {
     LOG_IF(ERROR, ret == false) << "config no isolation.taskThreadPoolSize info";   // NOLINT
     RETURN_IF_FALSE(ret)
 
+    ret = conf_.GetBoolValue("segment.prefetchEnable",
+        &fileServiceOption_.ioOpt.segmentPrefetchOpt.segmentPrefetchEnable);
+    LOG_IF(WARNING, ret == false)
+        << "config no segment.prefetchEnable info, using default value "
+        << fileServiceOption_.ioOpt.segmentPrefetchOpt.segmentPrefetchEnable;
+
+    ret = conf_.GetUInt32Value("segment.prefetchNum",
+        &fileServiceOption_.ioOpt.segmentPrefetchOpt.segmentPrefetchNum);
+    LOG_IF(WARNING, ret == false)
+        << "config no segment.prefetchNum info, using default value "
+        << fileServiceOption_.ioOpt.segmentPrefetchOpt.segmentPrefetchNum;
+
+    ret = conf_.GetUInt32Value("segment.prefetchTriggerDistanceMB",
+        &fileServiceOption_.ioOpt.segmentPrefetchOpt.segmentPrefetchTriggerDistanceMB);   // NOLINT
+    LOG_IF(WARNING, ret == false)
+        << "config no segment.prefetchTriggerDistanceMB info, using default value "   // NOLINT
+        << fileServiceOption_.ioOpt.segmentPrefetchOpt.segmentPrefetchTriggerDistanceMB;  // NOLINT
+
     std::string metaAddr;
     ret = conf_.GetStringValue("mds.listen.addr", &metaAddr);
     LOG_IF(ERROR, ret == false) << "config no mds.listen.addr info";
@@ -119,6 +119,24 @@ struct FileMetric {
     // 当前文件上的悬挂IO数量
     IOSuspendMetric suspendRPCMetric;
 
+    // request从提交给调度器到开始下发的时延
+    bvar::LatencyRecorder scheduleQueueLatency;
+
+    // IO因metacache中没有segment信息而同步等待segment分配的次数和时延
+    bvar::LatencyRecorder segmentAllocStall;
+    // 异步预分配的segment个数
+    bvar::Adder<uint64_t> segmentPrefetchNum;
+    // 已知读出全0而在本地直接返回的读请求个数
+    bvar::Adder<uint64_t> zeroReadNum;
+
+    // 打开文件时预加载metacache的耗时和加载的segment个数
+    bvar::LatencyRecorder metacacheWarmupLatency;
+    bvar::Adder<uint64_t> metacacheWarmupSegmentNum;
+
+    // 发往follower的备份读请求个数，以及其中先于leader返回的个数
+    bvar::Adder<uint64_t> hedgedReadNum;
+    bvar::Adder<uint64_t> hedgedReadWinNum;
+
     explicit FileMetric(const std::string& name)
         : filename(name),
           userRead(prefix, filename + "_read"),
@@ -129,7 +147,16 @@ struct FileMetric {
           getLeaderRetryQPS(prefix, filename + "_get_leader_retry_rpc"),
           writeSizeRecorder(prefix, filename + "_write_request_size_recoder"),
           readSizeRecorder(prefix, filename + "_read_request_size_recoder"),
-          suspendRPCMetric(prefix, filename + "_suspend_io_num") {}
+          suspendRPCMetric(prefix, filename + "_suspend_io_num"),
+          scheduleQueueLatency(prefix, filename + "_schedule_queue_lat"),
+          segmentAllocStall(prefix, filename + "_segment_alloc_stall"),
+          segmentPrefetchNum(prefix, filename + "_segment_prefetch_num"),
+          zeroReadNum(prefix, filename + "_zero_read_num"),
+          metacacheWarmupLatency(prefix, filename + "_metacache_warmup_lat"),
+          metacacheWarmupSegmentNum(prefix,
+                                    filename + "_metacache_warmup_segment_num"),
+          hedgedReadNum(prefix, filename + "_hedged_read_num"),
+          hedgedReadWinNum(prefix, filename + "_hedged_read_win_num") {}
 };
 
 // 用于全局mds接口统计信息调用信息统计
@@ -154,6 +181,8 @@ struct MDSClientMetric {
     InterfaceMetric getServerList;
     // GetOrAllocateSegment接口统计信息
     InterfaceMetric getOrAllocateSegment;
+    // GetOrAllocateSegments接口统计信息
+    InterfaceMetric getOrAllocateSegments;
     // RenameFile接口统计信息
     InterfaceMetric renameFile;
     // Extend接口统计信息
@@ -185,6 +214,7 @@ struct MDSClientMetric {
           refreshSession(prefix, "refreshSession"),
           getServerList(prefix, "getServerList"),
           getOrAllocateSegment(prefix, "getOrAllocateSegment"),
+          getOrAllocateSegments(prefix, "getOrAllocateSegments"),
           renameFile(prefix, "renameFile"),
           extendFile(prefix, "extendFile"),
           deleteFile(prefix, "deleteFile"),
@@ -433,6 +463,50 @@ class MetricHelper {
         }
     }
 
+    static void ScheduleLatencyRecord(FileMetric* fm, uint64_t duration) {
+        if (fm != nullptr) {
+            fm->scheduleQueueLatency << duration;
+        }
+    }
+
+    static void SegmentAllocStallRecord(FileMetric* fm, uint64_t duration) {
+        if (fm != nullptr) {
+            fm->segmentAllocStall << duration;
+        }
+    }
+
+    static void IncremSegmentPrefetchNum(FileMetric* fm, uint64_t num) {
+        if (fm != nullptr) {
+            fm->segmentPrefetchNum << num;
+        }
+    }
+
+    static void IncremZeroReadNum(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->zeroReadNum << 1;
+        }
+    }
+
+    static void MetaCacheWarmupRecord(FileMetric* fm, uint64_t duration,
+                                      uint64_t segmentNum) {
+        if (fm != nullptr) {
+            fm->metacacheWarmupLatency << duration;
+            fm->metacacheWarmupSegmentNum << segmentNum;
+        }
+    }
+
+    static void IncremHedgedReadNum(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->hedgedReadNum << 1;
+        }
+    }
+
+    static void IncremHedgedReadWinNum(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->hedgedReadWinNum << 1;
+        }
+    }
+
     static void IncremInflightRPC(FileMetric* fm) {
         if (fm != nullptr) {
             fm->inflightRPCNum << 1;
@@ -0,0 +1,140 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef SRC_CLIENT_CLIENT_OBJECT_POOL_H_
+#define SRC_CLIENT_CLIENT_OBJECT_POOL_H_
+
+#include <bvar/bvar.h>
+#include <butil/object_pool.h>
+
+#include <string>
+
+namespace brpc {
+class Controller;
+}   // namespace brpc
+
+namespace curve {
+namespace client {
+
+class RequestContext;
+class RequestClosure;
+class IOTracker;
+
+// 各类池化对象在bvar中的名字
+template <typename T>
+struct ObjectPoolName;
+
+template <>
+struct ObjectPoolName<RequestContext> {
+    static const char* Value() { return "request_context_pool"; }
+};
+
+template <>
+struct ObjectPoolName<RequestClosure> {
+    static const char* Value() { return "request_closure_pool"; }
+};
+
+template <>
+struct ObjectPoolName<IOTracker> {
+    static const char* Value() { return "io_tracker_pool"; }
+};
+
+template <>
+struct ObjectPoolName<brpc::Controller> {
+    static const char* Value() { return "rpc_controller_pool"; }
+};
+
+template <typename T>
+uint64_t GetPooledObjectNum(void* arg) {
+    return butil::describe_objects<T>().item_num;
+}
+
+// 对象池使用情况统计
+// in_use为当前从对象池中取出尚未归还的对象数量
+// created为对象池累计构造的对象数量，稳态下不再增长
+struct ObjectPoolMetric {
+    const std::string prefix = "curve client";
+
+    bvar::Adder<int64_t> inUse;
+    bvar::PassiveStatus<uint64_t> created;
+
+    ObjectPoolMetric(const std::string& name,
+                     uint64_t (*getCreated)(void*))
+        : inUse(prefix, name + "_in_use"),
+          created(prefix, name + "_created", getCreated, nullptr) {}
+};
+
+/**
+ * IO路径上每个请求都会用到的对象(RequestContext、RequestClosure、
+ * IOTracker、brpc::Controller)统一从butil::ObjectPool中获取。
+ * ObjectPool为每个线程维护本地空闲链表，稳态下获取和归还都不会调用new/delete。
+ * 注意：ObjectPool只在第一次构造对象时调用构造函数，
+ * 复用的对象需要由调用方自行重置。
+ */
+template <typename T>
+class ClientObjectPool {
+ public:
+    static T* Get() {
+        T* obj = butil::get_object<T>();
+        if (obj != nullptr) {
+            GetMetric().inUse << 1;
+        }
+        return obj;
+    }
+
+    template <typename A1>
+    static T* Get(const A1& arg1) {
+        T* obj = butil::get_object<T>(arg1);
+        if (obj != nullptr) {
+            GetMetric().inUse << 1;
+        }
+        return obj;
+    }
+
+    static void Return(T* obj) {
+        if (obj == nullptr) {
+            return;
+        }
+        GetMetric().inUse << -1;
+        butil::return_object(obj);
+    }
+
+    static int64_t InUse() {
+        return GetMetric().inUse.get_value();
+    }
+
+    static uint64_t Created() {
+        return GetPooledObjectNum<T>(nullptr);
+    }
+
+ private:
+    static ObjectPoolMetric& GetMetric() {
+        static ObjectPoolMetric metric(ObjectPoolName<T>::Value(),
+                                       GetPooledObjectNum<T>);
+        return metric;
+    }
+};
+
+}   // namespace client
+}   // namespace curve
+
+#endif  // SRC_CLIENT_CLIENT_OBJECT_POOL_H_
@@ -168,11 +168,25 @@ typedef struct FailureRequestOption {
 /**
  * 发送rpc给chunkserver的配置
  * @chunkserverEnableAppliedIndexRead: 是否开启使用appliedindex read
+ * @chunkserverEnableFollowerRead: 是否允许携带appliedindex的读请求发往follower，
+ *                                 依赖chunkserverEnableAppliedIndexRead
+ * @chunkserverEnableChecksum: 是否对读写数据进行端到端的crc校验
+ * @chunkserverEnableHedgedRead: leader上的读请求超过一定时间未返回时，
+ *                               是否向follower再发送一个读请求，先成功的返回，
+ *                               依赖chunkserverEnableAppliedIndexRead
+ * @chunkserverHedgedReadPercentile: 发送备份读请求的等待时间取文件read rpc
+ *                                   时延的百分位数，取值范围1~99
+ * @chunkserverHedgedReadMinDelayUS: 发送备份读请求的最小等待时间
  * @inflightOpt: 一个文件向chunkserver发送请求时的inflight 请求控制配置
  * @failRequestOpt: rpc发送失败之后，需要进行rpc重试的相关配置
  */
 typedef struct IOSenderOption {
     bool chunkserverEnableAppliedIndexRead;
+    bool chunkserverEnableFollowerRead{false};
+    bool chunkserverEnableChecksum{false};
+    bool chunkserverEnableHedgedRead{false};
+    uint32_t chunkserverHedgedReadPercentile{99};
+    uint64_t chunkserverHedgedReadMinDelayUS{1000};
     InFlightIOCntlInfo_t inflightOpt;
     FailureRequestOption_t failRequestOpt;
 } IOSenderOption_t;
@@ -182,14 +196,17 @@ typedef struct IOSenderOption {
  * 线程池，线程池中的线程各自配置一个队列
  * @scheduleQueueCapacity: schedule模块配置的队列深度
  * @scheduleThreadpoolSize: schedule模块线程池大小
+ * @scheduleDirectDispatch: 是否由提交IO的线程直接下发请求，不经过队列和调度线程
  */
 typedef struct RequestScheduleOption {
     uint32_t scheduleQueueCapacity;
     uint32_t scheduleThreadpoolSize;
+    bool scheduleDirectDispatch;
     IOSenderOption_t ioSenderOpt;
     RequestScheduleOption() {
         scheduleQueueCapacity = 1024;
         scheduleThreadpoolSize = 2;
+        scheduleDirectDispatch = false;
     }
 } RequestScheduleOption_t;
 
@@ -210,6 +227,16 @@ typedef struct RequestScheduleOption {
  *                            backup request的时间就为该值。
  * @metacacheGetLeaderBackupRequestLbName: 为getleader backup rpc
  *                            选择底层服务节点的策略
+ * @metacacheZeroChunkCacheEnable: 是否缓存读出全0的chunk，开启后读请求不再为未分配
+ *                            的segment分配空间，未分配的segment以及chunkserver返回
+ *                            不存在的chunk记录在metacache中，之后的读请求直接在本地
+ *                            返回全0，写请求会使对应chunk的记录失效。
+ *                            只有本client写入文件时才可以开启，clone文件不生效。
+ * @metacacheWarmupOnOpen: 打开文件时是否预先加载所有已分配segment的元数据，
+ *                            开启后打开文件时分批从mds获取segment信息和copyset的
+ *                            server list并加载到metacache，之后IO不再需要同步查询mds
+ * @metacacheWarmupSegmentsPerRPC: 预加载时每次rpc获取的segment个数，最大为256，
+ *                            超过mds的上限时自动减小
  */
 typedef struct MetaCacheOption {
     uint32_t metacacheGetLeaderRetry;
@@ -217,12 +244,18 @@ typedef struct MetaCacheOption {
     uint32_t metacacheGetLeaderRPCTimeOutMS;
     uint32_t metacacheGetLeaderBackupRequestMS;
     std::string metacacheGetLeaderBackupRequestLbName;
+    bool metacacheZeroChunkCacheEnable;
+    bool metacacheWarmupOnOpen;
+    uint32_t metacacheWarmupSegmentsPerRPC;
     MetaCacheOption() {
         metacacheGetLeaderRetry = 3;
         metacacheRPCRetryIntervalUS = 500;
         metacacheGetLeaderRPCTimeOutMS = 1000;
         metacacheGetLeaderBackupRequestMS = 100;
         metacacheGetLeaderBackupRequestLbName = "rr";
+        metacacheZeroChunkCacheEnable = false;
+        metacacheWarmupOnOpen = false;
+        metacacheWarmupSegmentsPerRPC = 64;
     }
 } MetaCacheOption_t;
 
@@ -254,6 +287,26 @@ typedef struct TaskThreadOption {
     }
 } TaskThreadOption_t;
 
+/**
+ * segment异步预分配配置信息
+ * 顺序写的结束位置接近下一个segment边界时，异步批量获取或分配之后的segment，
+ * 避免IO在metacache未命中时同步等待mds分配segment
+ * @segmentPrefetchEnable: 是否开启segment异步预分配
+ * @segmentPrefetchNum: 每次预分配的segment个数
+ * @segmentPrefetchTriggerDistanceMB: 写请求结束位置距离下一个segment边界
+ *                                    小于该值时触发预分配
+ */
+typedef struct SegmentPrefetchOption {
+    bool        segmentPrefetchEnable;
+    uint32_t    segmentPrefetchNum;
+    uint32_t    segmentPrefetchTriggerDistanceMB;
+    SegmentPrefetchOption() {
+        segmentPrefetchEnable = false;
+        segmentPrefetchNum = 2;
+        segmentPrefetchTriggerDistanceMB = 128;
+    }
+} SegmentPrefetchOption_t;
+
 /**
  * IOOption存储了当前io 操作所需要的所有配置信息
  */
@@ -263,6 +316,7 @@ typedef struct IOOption {
     MetaCacheOption_t       metaCacheOpt;
     TaskThreadOption_t      taskThreadOpt;
     RequestScheduleOption_t reqSchdulerOpt;
+    SegmentPrefetchOption_t segmentPrefetchOpt;
 } IOOption_t;
 
 /**
@@ -24,6 +24,7 @@
 
 #include <glog/logging.h>
 #include <unistd.h>
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -122,15 +123,176 @@ int CopysetClient::ReadChunk(const ChunkIDInfo& idinfo, uint64_t sn,
         }
     }
 
+    bool hedged = false;
     auto task = [&](Closure* done, std::shared_ptr<RequestSender> senderPtr) {
         ReadChunkClosure *readDone = new ReadChunkClosure(this, done);
+        std::shared_ptr<HedgedReadContext> hedgedRead = nullptr;
+        if (hedged) {
+            hedgedRead = NewHedgedRead(idinfo, offset, length, appliedindex,
+                reqclosure, senderPtr->GetChunkServerID());
+            readDone->SetHedgedRead(hedgedRead);
+        }
         senderPtr->ReadChunk(idinfo, sn, offset, length,
                              appliedindex, sourceInfo, readDone);
+        // leader上的读请求发送之后再设置定时器，避免备份读请求先完成请求
+        if (hedgedRead != nullptr) {
+            StartHedgedReadTimer(hedgedRead);
+        }
     };
 
+    // 携带了applied index的读请求可以由任意一个副本处理，
+    // 随机选择一个副本，将读请求分散到copyset的各个副本上
+    RequestContext* reqCtx = reqclosure->GetReqCtx();
+    if (reqCtx != nullptr) {
+        reqCtx->followerRead_ = false;
+        if (NeedFollowerRead(appliedindex, reqCtx) &&
+            reqclosure->GetRetriedTimes() <
+            iosenderopt_.failRequestOpt.chunkserverOPMaxRetry) {
+            ChunkServerID peerId;
+            butil::EndPoint peerAddr;
+            if (0 == metaCache_->GetReadPeer(idinfo.lpid_, idinfo.cpid_,
+                                             &peerId, &peerAddr)) {
+                auto senderPtr = senderManager_->GetOrCreateSender(peerId,
+                                                peerAddr, iosenderopt_);
+                if (nullptr != senderPtr) {
+                    reqclosure->IncremRetriedTimes();
+                    reqCtx->followerRead_ = true;
+                    task(doneGuard.release(), senderPtr);
+                    return 0;
+                }
+            }
+        }
+    }
+
+    // 只对首次发往leader的读请求发送备份读请求，重试的请求按原有流程处理
+    hedged = reqCtx != nullptr &&
+             NeedHedgedRead(appliedindex, sourceInfo, reqclosure);
+
     return DoRPCTask(idinfo, task, doneGuard.release());
 }
 
+bool CopysetClient::NeedFollowerRead(uint64_t appliedindex,
+                                     const RequestContext* reqCtx) const {
+    return iosenderopt_.chunkserverEnableAppliedIndexRead
+        && iosenderopt_.chunkserverEnableFollowerRead
+        && appliedindex > 0
+        && !reqCtx->leaderOnlyRead_;
+}
+
+bool CopysetClient::NeedHedgedRead(uint64_t appliedindex,
+                                   const RequestSourceInfo& sourceInfo,
+                                   RequestClosure* reqclosure) const {
+    return iosenderopt_.chunkserverEnableHedgedRead
+        && iosenderopt_.chunkserverEnableAppliedIndexRead
+        && appliedindex > 0
+        && sourceInfo.cloneFileSource.empty()
+        && reqclosure->GetRetriedTimes() == 0;
+}
+
+std::shared_ptr<HedgedReadContext> CopysetClient::NewHedgedRead(
+    const ChunkIDInfo& idinfo, off_t offset, size_t length,
+    uint64_t appliedindex, RequestClosure* reqclosure,
+    ChunkServerID leaderId) {
+    auto hedgedRead = std::make_shared<HedgedReadContext>();
+    hedgedRead->client = this;
+    hedgedRead->reqDone = reqclosure;
+    hedgedRead->idinfo = idinfo;
+    hedgedRead->offset = offset;
+    hedgedRead->length = length;
+    hedgedRead->appliedindex = appliedindex;
+    hedgedRead->fileId = reqclosure->GetReqCtx()->fileId_;
+    hedgedRead->leaderId = leaderId;
+    hedgedRead->delayUS = HedgedReadDelayUS();
+    return hedgedRead;
+}
+
+void CopysetClient::StartHedgedReadTimer(
+    const std::shared_ptr<HedgedReadContext>& hedgedRead) {
+    auto ref = new std::shared_ptr<HedgedReadContext>(hedgedRead);
+    timespec abstime = butil::microseconds_from_now(hedgedRead->delayUS);
+    int ret = bthread_timer_add(&hedgedRead->timer, abstime,
+                                OnHedgedReadTimer, ref);
+    if (ret != 0) {
+        LOG(WARNING) << "add hedged read timer failed, ret = " << ret
+                     << ", logicpool id = " << hedgedRead->idinfo.lpid_
+                     << ", copyset id = " << hedgedRead->idinfo.cpid_
+                     << ", chunk id = " << hedgedRead->idinfo.cid_;
+        delete ref;
+        return;
+    }
+
+    hedgedRead->timerRef = ref;
+    hedgedRead->timerArmed.store(true, std::memory_order_release);
+}
+
+uint64_t CopysetClient::HedgedReadDelayUS() {
+    uint64_t delay = iosenderopt_.chunkserverHedgedReadMinDelayUS;
+    if (fileMetric_ == nullptr) {
+        return delay;
+    }
+
+    uint32_t percentile = std::min(
+        std::max(iosenderopt_.chunkserverHedgedReadPercentile, 1u), 99u);
+    int64_t latency =
+        fileMetric_->readRPC.latency.latency_percentile(percentile / 100.0);
+    if (latency > 0) {
+        delay = std::max(delay, static_cast<uint64_t>(latency));
+    }
+    return delay;
+}
+
+void CopysetClient::OnHedgedReadTimer(void* arg) {
+    bthread_t tid;
+    if (0 != bthread_start_background(&tid, nullptr, RunHedgedRead, arg)) {
+        LOG(WARNING) << "start hedged read bthread failed";
+        delete static_cast<std::shared_ptr<HedgedReadContext>*>(arg);
+    }
+}
+
+void* CopysetClient::RunHedgedRead(void* arg) {
+    std::unique_ptr<std::shared_ptr<HedgedReadContext>> ref(
+        static_cast<std::shared_ptr<HedgedReadContext>*>(arg));
+    HedgedReadContext* hedgedRead = ref->get();
+
+    // leader上的读请求已经返回时，请求可能已经完成，不能再访问client
+    int expected = HedgedReadContext::kPending;
+    if (hedgedRead->state.compare_exchange_strong(
+            expected, HedgedReadContext::kHedgeSending)) {
+        hedgedRead->client->SendHedgedRead(*ref);
+    }
+
+    return nullptr;
+}
+
+void CopysetClient::SendHedgedRead(
+    const std::shared_ptr<HedgedReadContext>& hedgedRead) {
+    const ChunkIDInfo& idinfo = hedgedRead->idinfo;
+    ChunkServerID peerId;
+    butil::EndPoint peerAddr;
+    std::shared_ptr<RequestSender> senderPtr = nullptr;
+    if (0 == metaCache_->GetHedgedReadPeer(idinfo.lpid_, idinfo.cpid_,
+                                           hedgedRead->leaderId,
+                                           &peerId, &peerAddr)) {
+        senderPtr = senderManager_->GetOrCreateSender(peerId, peerAddr,
+                                                      iosenderopt_);
+    }
+
+    if (nullptr == senderPtr) {
+        // 没有可用的follower，放弃备份读请求，继续等待leader返回
+        hedgedRead->state.store(HedgedReadContext::kPending);
+        return;
+    }
+
+    MetricHelper::IncremHedgedReadNum(fileMetric_);
+
+    // 发送之后请求可能已经由备份读请求完成，不能再访问client
+    senderPtr->HedgedReadChunk(*hedgedRead, new HedgedReadClosure(hedgedRead));
+
+    int expected = HedgedReadContext::kHedgeSending;
+    hedgedRead->state.compare_exchange_strong(
+        expected, HedgedReadContext::kHedgeInflight);
+}
+
 int CopysetClient::WriteChunk(const ChunkIDInfo& idinfo, uint64_t sn,
                               const char* buf, off_t offset, size_t length,
                               const RequestSourceInfo& sourceInfo,
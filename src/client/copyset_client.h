@@ -52,6 +52,8 @@ using ::google::protobuf::Closure;
 // TODO(tongguangxun) :后续除了read、write的接口也需要调整重试逻辑
 class MetaCache;
 class RequestScheduler;
+class RequestClosure;
+struct HedgedReadContext;
 /**
  * 负责管理 ChunkServer 的链接，向上层提供访问
  * 指定 copyset 的 chunk 的 read/write 等接口
@@ -234,6 +236,41 @@ class CopysetClient : public Uncopyable {
         std::function<void(Closure*, std::shared_ptr<RequestSender>)> task,
         Closure *done);
 
+    // 读请求是否可以发往follower
+    bool NeedFollowerRead(uint64_t appliedindex,
+                          const RequestContext* reqCtx) const;
+
+    // 发往leader的读请求是否需要在超时前向follower发送备份读请求
+    bool NeedHedgedRead(uint64_t appliedindex,
+                        const RequestSourceInfo& sourceInfo,
+                        RequestClosure* reqclosure) const;
+
+    /**
+     * 为发往leader的读请求创建hedged read的共享状态
+     * @param: leaderId为读请求发往的chunkserver
+     */
+    std::shared_ptr<HedgedReadContext> NewHedgedRead(
+        const ChunkIDInfo& idinfo, off_t offset, size_t length,
+        uint64_t appliedindex, RequestClosure* reqclosure,
+        ChunkServerID leaderId);
+
+    /**
+     * leader上的读请求发送之后设置定时器，超过等待时间仍未返回时发送备份读请求
+     * 此时请求可能已经完成，只能访问hedgedRead
+     */
+    static void StartHedgedReadTimer(
+        const std::shared_ptr<HedgedReadContext>& hedgedRead);
+
+    // 发送备份读请求前的等待时间，取文件read rpc时延的百分位数
+    uint64_t HedgedReadDelayUS();
+
+    // 选择一个follower发送备份读请求
+    void SendHedgedRead(const std::shared_ptr<HedgedReadContext>& hedgedRead);
+
+    // 定时器回调运行在定时器线程中，不能阻塞，另起bthread发送备份读请求
+    static void OnHedgedReadTimer(void* arg);
+    static void* RunHedgedRead(void* arg);
+
  private:
     // 元数据缓存
     MetaCache            *metaCache_;
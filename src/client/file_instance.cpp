@@ -130,6 +130,36 @@ int FileInstance::AioWrite(CurveAioContext* aioctx) {
     return iomanager4file_.AioWrite(aioctx, mdsclient_);
 }
 
+int FileInstance::AioReadv(CurveAioContext* aioctx, const struct iovec* iov,
+                           int iovcnt) {
+    return iomanager4file_.AioReadv(aioctx, iov, iovcnt, mdsclient_);
+}
+
+int FileInstance::AioReadIOBuf(CurveAioContext* aioctx, butil::IOBuf* data) {
+    return iomanager4file_.AioReadIOBuf(aioctx, data, mdsclient_);
+}
+
+int FileInstance::AioWritev(CurveAioContext* aioctx, const struct iovec* iov,
+                            int iovcnt) {
+    if (readonly_) {
+        DVLOG(9) << "open with read only, do not support write!";
+        return -1;
+    }
+    return iomanager4file_.AioWritev(aioctx, iov, iovcnt, mdsclient_);
+}
+
+int FileInstance::AioSubmitBatch(CurveAioContext* const* ctxs, int n) {
+    if (readonly_) {
+        for (int i = 0; i < n; ++i) {
+            if (ctxs[i]->op == LIBCURVE_OP::LIBCURVE_OP_WRITE) {
+                DVLOG(9) << "open with read only, do not support write!";
+                return -1;
+            }
+        }
+    }
+    return iomanager4file_.AioSubmitBatch(ctxs, n, mdsclient_);
+}
+
 // 两种场景会造成在Open的时候返回LIBCURVE_ERROR::FILE_OCCUPIED
 // 1. 强制重启qemu不会调用close逻辑，然后启动的时候原来的文件sessio还没过期.
 //    导致再次去发起open的时候，返回被占用，这种情况可以通过load sessionmap
@@ -148,6 +178,9 @@ int FileInstance::Open(const std::string& filename,
     if (ret == LIBCURVE_ERROR::OK) {
         ret = leaseexcutor_->Start(finfo_, lease) ? LIBCURVE_ERROR::OK
                                                   : LIBCURVE_ERROR::FAILED;
+        if (ret == LIBCURVE_ERROR::OK) {
+            iomanager4file_.WarmUpMetaCache(mdsclient_);
+        }
         if (nullptr != sessionId) {
             sessionId->assign(lease.sessionID);
         }
@@ -111,6 +111,31 @@ class CURVE_CACHELINE_ALIGNMENT FileInstance {
      * @return: 0为成功，小于0为失败
      */
     int AioWrite(CurveAioContext* aioctx);
+    /**
+     * 向量化异步模式读写
+     * @param: aioctx为异步读写的io上下文，aioctx->buf不使用
+     * @param: iov为用户buffer数组，长度之和需要等于aioctx->length
+     * @param: iovcnt为iov的个数
+     * @return: 0为成功，小于0为失败
+     */
+    int AioReadv(CurveAioContext* aioctx, const struct iovec* iov,
+                 int iovcnt);
+    int AioWritev(CurveAioContext* aioctx, const struct iovec* iov,
+                  int iovcnt);
+    /**
+     * 异步模式读，读取的数据以IOBuf的形式返回
+     * @param: aioctx为异步读写的io上下文，aioctx->buf不使用
+     * @param: data为读取数据的出参
+     * @return: 0为成功，小于0为失败
+     */
+    int AioReadIOBuf(CurveAioContext* aioctx, butil::IOBuf* data);
+    /**
+     * 批量提交异步读写
+     * @param: ctxs为异步io上下文数组
+     * @param: n为ctxs的个数
+     * @return: 0为成功，小于0为失败
+     */
+    int AioSubmitBatch(CurveAioContext* const* ctxs, int n);
 
     int Close();
 
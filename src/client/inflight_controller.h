@@ -71,6 +71,13 @@ class InflightControl {
         curInflightIONum_.fetch_add(1, std::memory_order_release);
     }
 
+    /**
+     * 批量递增inflight num
+     */
+    void IncremInflightNum(uint64_t num) {
+        curInflightIONum_.fetch_add(num, std::memory_order_release);
+    }
+
     /**
      * 递减inflight num
      */
@@ -41,15 +41,26 @@ std::atomic<uint64_t> IOTracker::tracekerID_(1);
 IOTracker::IOTracker(IOManager* iomanager,
                         MetaCache* mc,
                         RequestScheduler* scheduler,
-                        FileMetric* clientMetric):
-                        mc_(mc),
-                        iomanager_(iomanager),
-                        scheduler_(scheduler),
-                        fileMetric_(clientMetric) {
+                        FileMetric* clientMetric) {
+    Reset(iomanager, mc, scheduler, clientMetric);
+}
+
+IOTracker::IOTracker()
+    : IOTracker(nullptr, nullptr, nullptr, nullptr) {}
+
+void IOTracker::Reset(IOManager* iomanager,
+                      MetaCache* mc,
+                      RequestScheduler* scheduler,
+                      FileMetric* clientMetric) {
+    mc_         = mc;
+    iomanager_  = iomanager;
+    scheduler_  = scheduler;
+    fileMetric_ = clientMetric;
     id_         = tracekerID_.fetch_add(1);
     scc_        = nullptr;
     aioctx_     = nullptr;
     data_       = nullptr;
+    readData_   = nullptr;
     type_       = OpType::UNKNOWN;
     errcode_    = LIBCURVE_ERROR::OK;
     offset_     = 0;
@@ -122,6 +133,121 @@ void IOTracker::StartWrite(CurveAioContext* aioctx, const char* buf,
     }
 }
 
+void IOTracker::StartReadIOBuf(CurveAioContext* aioctx, butil::IOBuf* data,
+    off_t offset, size_t length, MDSClient* mdsclient, const FInfo_t* fi) {
+    data_     = nullptr;
+    readData_ = data;
+    offset_   = offset;
+    length_   = length;
+    aioctx_   = aioctx;
+    type_     = OpType::READ;
+
+    DVLOG(9)  << "read iobuf op, offset = " << offset
+              << ", length = " << length;
+
+    int ret = -1;
+    if (readData_ != nullptr) {
+        ret = Splitor::IO2ChunkRequests(this, mc_, &reqlist_, data_,
+                                        offset_, length_, mdsclient, fi);
+    }
+    if (ret == 0) {
+        reqcount_.store(reqlist_.size(), std::memory_order_release);
+        std::for_each(reqlist_.begin(), reqlist_.end(), [&](RequestContext* r) {
+            r->readIOBuf_ = true;
+            r->done_->SetFileMetric(fileMetric_);
+            r->done_->SetIOManager(iomanager_);
+        });
+        ret = scheduler_->ScheduleRequest(reqlist_);
+    } else {
+        LOG(ERROR) << "splitor read iobuf io failed, "
+                   << "offset = " << offset_
+                   << ", length = " << length_;
+    }
+
+    if (ret == -1) {
+        LOG(ERROR) << "split or schedule failed, return and recyle resource!";
+        ReturnOnFail();
+    }
+}
+
+int IOTracker::PrepareAio(CurveAioContext* aioctx,
+    MDSClient* mdsclient, const FInfo_t* fi) {
+    data_   = static_cast<const char*>(aioctx->buf);
+    offset_ = aioctx->offset;
+    length_ = aioctx->length;
+    aioctx_ = aioctx;
+    type_   = aioctx->op == LIBCURVE_OP::LIBCURVE_OP_WRITE ? OpType::WRITE
+                                                         : OpType::READ;
+
+    int ret = Splitor::IO2ChunkRequests(this, mc_, &reqlist_, data_,
+                                        offset_, length_, mdsclient, fi);
+    if (ret != 0) {
+        LOG(ERROR) << "splitor batch io failed, "
+                   << "type = " << static_cast<int>(type_)
+                   << ", offset = " << offset_
+                   << ", length = " << length_;
+        ReturnOnFail();
+        return -1;
+    }
+
+    reqcount_.store(reqlist_.size(), std::memory_order_release);
+    std::for_each(reqlist_.begin(), reqlist_.end(), [&](RequestContext* r) {
+        r->done_->SetFileMetric(fileMetric_);
+        r->done_->SetIOManager(iomanager_);
+    });
+    return 0;
+}
+
+void IOTracker::StartReadv(CurveAioContext* aioctx,
+    const struct iovec* iov, int iovcnt, off_t offset, size_t length,
+    MDSClient* mdsclient, const FInfo_t* fi) {
+    type_ = OpType::READ;
+    StartIOVec(aioctx, iov, iovcnt, offset, length, mdsclient, fi);
+}
+
+void IOTracker::StartWritev(CurveAioContext* aioctx,
+    const struct iovec* iov, int iovcnt, off_t offset, size_t length,
+    MDSClient* mdsclient, const FInfo_t* fi) {
+    type_ = OpType::WRITE;
+    StartIOVec(aioctx, iov, iovcnt, offset, length, mdsclient, fi);
+}
+
+void IOTracker::StartIOVec(CurveAioContext* aioctx,
+    const struct iovec* iov, int iovcnt, off_t offset, size_t length,
+    MDSClient* mdsclient, const FInfo_t* fi) {
+    offset_ = offset;
+    length_ = length;
+    aioctx_ = aioctx;
+    data_   = iovcnt > 0 ? static_cast<const char*>(iov[0].iov_base)
+                         : nullptr;
+
+    DVLOG(9) << "vectored op, type = " << static_cast<int>(type_)
+             << ", offset = " << offset
+             << ", length = " << length
+             << ", iovcnt = " << iovcnt;
+
+    int ret = Splitor::IOVec2ChunkRequests(this, mc_, &reqlist_, iov, iovcnt,
+                                           offset_, length_, mdsclient, fi);
+    if (ret == 0) {
+        reqcount_.store(reqlist_.size(), std::memory_order_release);
+        std::for_each(reqlist_.begin(), reqlist_.end(), [&](RequestContext* r) {
+            r->done_->SetFileMetric(fileMetric_);
+            r->done_->SetIOManager(iomanager_);
+        });
+        ret = scheduler_->ScheduleRequest(reqlist_);
+    } else {
+        LOG(ERROR) << "splitor vectored io failed, "
+                   << "offset = " << offset_
+                   << ", length = " << length_
+                   << ", iovcnt = " << iovcnt;
+    }
+
+    if (ret == -1) {
+        LOG(ERROR) << "split or schedule failed, return and recyle resource!";
+        ReturnOnFail();
+    }
+}
+
 void IOTracker::ReadSnapChunk(const ChunkIDInfo &cinfo,
     uint64_t seq, uint64_t offset, uint64_t len,
     char *buf, SnapCloneClosure* scc) {
@@ -270,6 +396,11 @@ void IOTracker::FillCommonFields(ChunkIDInfo idinfo, RequestContext* req) {
 }
 
 void IOTracker::HandleResponse(RequestContext* reqctx) {
+    // 写请求返回后再次使全0记录失效，期间返回chunk不存在的读请求结果不会被记录
+    if (type_ == OpType::WRITE && mc_ != nullptr) {
+        mc_->InvalidateZeroChunk(reqctx->chunkIdx_);
+    }
+
     int errorcode = reqctx->done_->GetErrorCode();
     if (errorcode != 0) {
         ChunkServerErr2LibcurveErr(static_cast<CHUNK_OP_STATUS>(errorcode),
@@ -302,6 +433,13 @@ void IOTracker::Done() {
         }
     }
 
+    // request按文件偏移顺序拆分，依次追加即为完整的数据，追加只增加block引用
+    if (readData_ != nullptr && errcode_ == LIBCURVE_ERROR::OK) {
+        for (auto iter : reqlist_) {
+            readData_->append(iter->readData_);
+        }
+    }
+
     DestoryRequestList();
 
     // scc_和aioctx都为空的时候肯定是个同步调用
@@ -327,9 +465,9 @@ void IOTracker::Done() {
 
 void IOTracker::DestoryRequestList() {
     for (auto iter : reqlist_) {
-        iter->UnInit();
-        delete iter;
+        RequestContext::RecycleRequestContext(iter);
     }
+    reqlist_.clear();
 }
 
 void IOTracker::ReturnOnFail() {
@@ -370,14 +508,7 @@ void IOTracker::ChunkServerErr2LibcurveErr(CHUNK_OP_STATUS errcode,
 }
 
 RequestContext* IOTracker::GetInitedRequestContext() const {
-    RequestContext* reqNode = new (std::nothrow) RequestContext();
-    if (reqNode != nullptr && reqNode->Init()) {
-        return reqNode;
-    } else {
-        LOG(ERROR) << "allocate req node failed!";
-        delete reqNode;
-        return nullptr;
-    }
+    return RequestContext::NewInitedRequestContext();
 }
 
 }   // namespace client
@@ -22,6 +22,9 @@
 #ifndef SRC_CLIENT_IO_TRACKER_H_
 #define SRC_CLIENT_IO_TRACKER_H_
 
+#include <sys/uio.h>
+#include <butil/iobuf.h>
+
 #include <set>
 #include <list>
 #include <atomic>
@@ -57,8 +60,19 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
               MetaCache* mc,
               RequestScheduler* scheduler,
               FileMetric* clientMetric = nullptr);
+    // 供对象池构造使用，取出后需要调用Reset
+    IOTracker();
     ~IOTracker() = default;
 
+    /**
+     * 重置tracker状态并分配新的id，从对象池中复用tracker时调用
+     * 参数含义与构造函数相同
+     */
+    void Reset(IOManager* iomanager,
+               MetaCache* mc,
+               RequestScheduler* scheduler,
+               FileMetric* clientMetric = nullptr);
+
     /**
      * startread和startwrite将上层的同步和异步读写接口统一了
      * CurveAioContext传入的为空值的时候，代表这个读写是同步，
@@ -82,6 +96,81 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
                      size_t length,
                      MDSClient* mdsclient,
                      const FInfo_t* fi);
+
+    /**
+     * 向量化异步读写，iov中的多段buffer按顺序拼接后对应文件的
+     * [offset, offset + length)，iov在回调之前需要保持有效
+     * @param: aioctx异步io上下文，aioctx->buf不使用
+     * @param: iov是用户buffer数组
+     * @param: iovcnt是iov的个数
+     * @param: offset是读写偏移
+     * @param: length是读写长度，需要等于iov长度之和
+     * @param: mdsclient透传给splitor，与mds通信
+     * @param: fi是当前io对应文件的基本信息
+     */
+    void StartReadv(CurveAioContext* aioctx,
+                    const struct iovec* iov,
+                    int iovcnt,
+                    off_t offset,
+                    size_t length,
+                    MDSClient* mdsclient,
+                    const FInfo_t* fi);
+    void StartWritev(CurveAioContext* aioctx,
+                     const struct iovec* iov,
+                     int iovcnt,
+                     off_t offset,
+                     size_t length,
+                     MDSClient* mdsclient,
+                     const FInfo_t* fi);
+    /**
+     * 异步读，数据不拷贝到用户buffer，rpc返回的数据按顺序追加到data中
+     * 成功回调之前data中为[offset, offset + length)的数据，
+     * data在回调之前需要保持有效
+     * @param: aioctx异步io上下文，aioctx->buf不使用
+     * @param: data为读取数据的出参
+     * @param: offset是读偏移
+     * @param: length是读长度
+     * @param: mdsclient透传给splitor，与mds通信
+     * @param: fi是当前io对应文件的基本信息
+     */
+    void StartReadIOBuf(CurveAioContext* aioctx,
+                        butil::IOBuf* data,
+                        off_t offset,
+                        size_t length,
+                        MDSClient* mdsclient,
+                        const FInfo_t* fi);
+
+    /**
+     * 当前IO是否为读取到IOBuf的读请求
+     */
+    bool IsIOBufRead() const {
+        return readData_ != nullptr;
+    }
+
+    /**
+     * 批量提交时使用，根据aioctx->op完成拆分但不下发，
+     * 拆分出的request由调用方通过GetRequests取出后统一下发
+     * @param: aioctx异步io上下文
+     * @param: mdsclient透传给splitor，与mds通信
+     * @param: fi是当前io对应文件的基本信息
+     * @return: 0为成功，-1为拆分失败，此时已经向上返回失败并回收tracker
+     */
+    int PrepareAio(CurveAioContext* aioctx,
+                   MDSClient* mdsclient,
+                   const FInfo_t* fi);
+
+    /**
+     * 获取拆分后的request列表
+     */
+    const std::list<RequestContext*>& GetRequests() const {
+        return reqlist_;
+    }
+
+    /**
+     * 在io拆分或者，io分发失败的时候需要调用，设置返回状态，并向上返回
+     */
+    void ReturnOnFail();
+
     /**
      * chunk相关接口是提供给snapshot使用的，上层的snapshot和file
      * 接口是分开的，在IOTracker这里会将其统一，这样对下层来说不用
@@ -172,16 +261,30 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
         return id_;
      }
 
+    /**
+     * 获取当前IO所属文件的metric信息
+     */
+    FileMetric* GetFileMetric() const {
+        return fileMetric_;
+    }
+
  private:
     /**
-     * 当IO返回的时候调用done，由done负责向上返回
+     * 向量化读写的公共流程，type_需要在调用前设置
      */
-    void Done();
+    void StartIOVec(CurveAioContext* aioctx,
+                    const struct iovec* iov,
+                    int iovcnt,
+                    off_t offset,
+                    size_t length,
+                    MDSClient* mdsclient,
+                    const FInfo_t* fi);
 
     /**
-     * 在io拆分或者，io分发失败的时候需要调用，设置返回状态，并向上返回
+     * 当IO返回的时候调用done，由done负责向上返回
      */
-    void ReturnOnFail();
+    void Done();
+
     /**
      * 用户下来的大IO会被拆分成多个子IO，这里在返回之前将子IO资源回收
      */
@@ -218,6 +321,9 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
     uint64_t   length_;
     mutable const char*   data_;
 
+    // 读取到IOBuf时的出参，非空时data_为空
+    butil::IOBuf* readData_;
+
     // 当用户下发的是同步IO的时候，其需要在上层进行等待，因为client的
     // IO发送流程全部是异步的，因此这里需要用条件变量等待，待异步IO返回
     // 之后才将这个等待的条件变量唤醒，然后向上返回。
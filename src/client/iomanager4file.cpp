@@ -23,16 +23,29 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <chrono>   // NOLINT
+#include <list>
+#include <utility>
+#include <vector>
 
 #include "src/client/metacache.h"
 #include "src/client/iomanager4file.h"
 #include "src/client/file_instance.h"
 #include "src/client/io_tracker.h"
 #include "src/client/splitor.h"
+#include "src/client/client_object_pool.h"
+#include "src/common/timeutility.h"
 
 namespace curve {
 namespace client {
+
+using curve::common::TimeUtility;
+
+// mds默认一次GetOrAllocateSegments请求最多获取的segment个数，
+// 预加载时每次获取的个数不超过这个值
+static const uint32_t kMaxWarmupSegmentsPerRPC = 256;
+
 Atomic<uint64_t> IOManager::idRecorder_(1);
 IOManager4File::IOManager4File(): scheduler_(nullptr), exit_(false) {
 }
@@ -79,6 +92,12 @@ bool IOManager4File::Initialize(const std::string& filename,
         return false;
     }
 
+    if (!segmentPrefetcher_.Init(ioopt_.segmentPrefetchOpt, &mc_,
+                                 mdsclient, fileMetric_)) {
+        LOG(ERROR) << "segment prefetcher init failed!";
+        return false;
+    }
+
     LOG(INFO) << "iomanager init success! conf info: "
               << "isolationTaskThreadPoolSize = "
               << ioopt_.taskThreadOpt.isolationTaskThreadPoolSize
@@ -105,6 +124,7 @@ void IOManager4File::UnInitialize() {
     }
 
     taskPool_.Stop();
+    segmentPrefetcher_.Fini();
 
     if (scheduler_ != nullptr) {
         scheduler_->WakeupBlockQueueAtExit();
@@ -142,6 +162,7 @@ int IOManager4File::Write(const char* buf, off_t offset,
     size_t length, MDSClient* mdsclient) {
     MetricHelper::IncremUserRPSCount(fileMetric_, OpType::WRITE);
     FlightIOGuard guard(this);
+    segmentPrefetcher_.OnWrite(offset, length);
 
     IOTracker temp(this, &mc_, scheduler_, fileMetric_);
     temp.StartWrite(nullptr, buf, offset, length, mdsclient,
@@ -154,14 +175,14 @@ int IOManager4File::Write(const char* buf, off_t offset,
 int IOManager4File::AioRead(CurveAioContext* ctx, MDSClient* mdsclient) {
     MetricHelper::IncremUserRPSCount(fileMetric_, OpType::READ);
 
-    IOTracker* temp = new (std::nothrow) IOTracker(this, &mc_,
-                                                   scheduler_, fileMetric_);
+    IOTracker* temp = ClientObjectPool<IOTracker>::Get();
     if (temp == nullptr) {
         ctx->ret = -LIBCURVE_ERROR::FAILED;
         ctx->cb(ctx);
         LOG(ERROR) << "allocate tracker failed!";
         return LIBCURVE_ERROR::OK;
     }
+    temp->Reset(this, &mc_, scheduler_, fileMetric_);
 
     inflightCntl_.IncremInflightNum();
     auto task = [this, ctx, mdsclient, temp]() {
@@ -177,14 +198,15 @@ int IOManager4File::AioRead(CurveAioContext* ctx, MDSClient* mdsclient) {
 int IOManager4File::AioWrite(CurveAioContext* ctx, MDSClient* mdsclient) {
     MetricHelper::IncremUserRPSCount(fileMetric_, OpType::WRITE);
 
-    IOTracker* temp = new (std::nothrow) IOTracker(this, &mc_,
-                                                   scheduler_, fileMetric_);
+    IOTracker* temp = ClientObjectPool<IOTracker>::Get();
     if (temp == nullptr) {
         ctx->ret = -LIBCURVE_ERROR::FAILED;
         ctx->cb(ctx);
         LOG(ERROR) << "allocate tracker failed!";
         return LIBCURVE_ERROR::OK;
     }
+    temp->Reset(this, &mc_, scheduler_, fileMetric_);
+    segmentPrefetcher_.OnWrite(ctx->offset, ctx->length);
 
     inflightCntl_.IncremInflightNum();
     auto task = [this, ctx, mdsclient, temp]() {
@@ -197,13 +219,192 @@ int IOManager4File::AioWrite(CurveAioContext* ctx, MDSClient* mdsclient) {
     return LIBCURVE_ERROR::OK;
 }
 
+int IOManager4File::AioReadv(CurveAioContext* ctx, const struct iovec* iov,
+                             int iovcnt, MDSClient* mdsclient) {
+    MetricHelper::IncremUserRPSCount(fileMetric_, OpType::READ);
+
+    IOTracker* temp = ClientObjectPool<IOTracker>::Get();
+    if (temp == nullptr) {
+        ctx->ret = -LIBCURVE_ERROR::FAILED;
+        ctx->cb(ctx);
+        LOG(ERROR) << "allocate tracker failed!";
+        return LIBCURVE_ERROR::OK;
+    }
+    temp->Reset(this, &mc_, scheduler_, fileMetric_);
+
+    inflightCntl_.IncremInflightNum();
+    auto task = [this, ctx, iov, iovcnt, mdsclient, temp]() {
+        temp->StartReadv(ctx, iov, iovcnt, ctx->offset, ctx->length,
+                         mdsclient, this->GetFileInfo());
+    };
+
+    taskPool_.Enqueue(task);
+    return LIBCURVE_ERROR::OK;
+}
+
+int IOManager4File::AioReadIOBuf(CurveAioContext* ctx, butil::IOBuf* data,
+                                 MDSClient* mdsclient) {
+    MetricHelper::IncremUserRPSCount(fileMetric_, OpType::READ);
+
+    IOTracker* temp = ClientObjectPool<IOTracker>::Get();
+    if (temp == nullptr) {
+        ctx->ret = -LIBCURVE_ERROR::FAILED;
+        ctx->cb(ctx);
+        LOG(ERROR) << "allocate tracker failed!";
+        return LIBCURVE_ERROR::OK;
+    }
+    temp->Reset(this, &mc_, scheduler_, fileMetric_);
+
+    inflightCntl_.IncremInflightNum();
+    auto task = [this, ctx, data, mdsclient, temp]() {
+        temp->StartReadIOBuf(ctx, data, ctx->offset, ctx->length,
+                             mdsclient, this->GetFileInfo());
+    };
+
+    taskPool_.Enqueue(task);
+    return LIBCURVE_ERROR::OK;
+}
+
+int IOManager4File::AioWritev(CurveAioContext* ctx, const struct iovec* iov,
+                              int iovcnt, MDSClient* mdsclient) {
+    MetricHelper::IncremUserRPSCount(fileMetric_, OpType::WRITE);
+
+    IOTracker* temp = ClientObjectPool<IOTracker>::Get();
+    if (temp == nullptr) {
+        ctx->ret = -LIBCURVE_ERROR::FAILED;
+        ctx->cb(ctx);
+        LOG(ERROR) << "allocate tracker failed!";
+        return LIBCURVE_ERROR::OK;
+    }
+    temp->Reset(this, &mc_, scheduler_, fileMetric_);
+    segmentPrefetcher_.OnWrite(ctx->offset, ctx->length);
+
+    inflightCntl_.IncremInflightNum();
+    auto task = [this, ctx, iov, iovcnt, mdsclient, temp]() {
+        temp->StartWritev(ctx, iov, iovcnt, ctx->offset, ctx->length,
+                          mdsclient, this->GetFileInfo());
+    };
+
+    taskPool_.Enqueue(task);
+    return LIBCURVE_ERROR::OK;
+}
+
+int IOManager4File::AioSubmitBatch(CurveAioContext* const* ctxs, int n,
+                                   MDSClient* mdsclient) {
+    // ctxs数组本身在返回后不保证有效，因此只保存其中的aioctx指针
+    std::vector<std::pair<IOTracker*, CurveAioContext*>> ios;
+    ios.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        CurveAioContext* ctx = ctxs[i];
+        OpType type = ctx->op == LIBCURVE_OP::LIBCURVE_OP_WRITE
+                      ? OpType::WRITE : OpType::READ;
+        MetricHelper::IncremUserRPSCount(fileMetric_, type);
+
+        IOTracker* temp = ClientObjectPool<IOTracker>::Get();
+        if (temp == nullptr) {
+            ctx->ret = -LIBCURVE_ERROR::FAILED;
+            ctx->cb(ctx);
+            LOG(ERROR) << "allocate tracker failed!";
+            continue;
+        }
+        temp->Reset(this, &mc_, scheduler_, fileMetric_);
+        if (type == OpType::WRITE) {
+            segmentPrefetcher_.OnWrite(ctx->offset, ctx->length);
+        }
+        ios.emplace_back(temp, ctx);
+    }
+
+    if (ios.empty()) {
+        return LIBCURVE_ERROR::OK;
+    }
+
+    // 整批只计数一次、只向任务队列提交一次，拆分后的request一次性放入调度队列
+    inflightCntl_.IncremInflightNum(ios.size());
+    auto task = [this, mdsclient, ios]() {
+        std::vector<IOTracker*> prepared;
+        prepared.reserve(ios.size());
+        std::list<RequestContext*> batch;
+        const FInfo_t* fi = this->GetFileInfo();
+        for (const auto& io : ios) {
+            if (io.first->PrepareAio(io.second, mdsclient, fi) == 0) {
+                const auto& reqs = io.first->GetRequests();
+                batch.insert(batch.end(), reqs.begin(), reqs.end());
+                prepared.push_back(io.first);
+            }
+        }
+
+        if (!batch.empty() && scheduler_->ScheduleRequest(batch) == -1) {
+            LOG(ERROR) << "schedule batch failed, return and recyle resource!";
+            for (auto tracker : prepared) {
+                tracker->ReturnOnFail();
+            }
+        }
+    };
+
+    taskPool_.Enqueue(task);
+    return LIBCURVE_ERROR::OK;
+}
+
 void IOManager4File::UpdateFileInfo(const FInfo_t& fi) {
     mc_.UpdateFileInfo(fi);
 }
 
+void IOManager4File::WarmUpMetaCache(MDSClient* mdsclient) {
+    if (!ioopt_.metaCacheOpt.metacacheWarmupOnOpen) {
+        return;
+    }
+
+    const FInfo_t* fi = mc_.GetFileInfo();
+    uint64_t segmentSize = fi->segmentsize;
+    uint32_t segmentsPerRPC = std::min(kMaxWarmupSegmentsPerRPC,
+        std::max(1u, ioopt_.metaCacheOpt.metacacheWarmupSegmentsPerRPC));
+    if (segmentSize == 0) {
+        return;
+    }
+
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
+    uint64_t segmentNum = 0;
+    uint64_t offset = 0;
+    while (offset < fi->length) {
+        std::vector<SegmentInfo> segInfos;
+        LIBCURVE_ERROR ret = mdsclient->GetOrAllocateSegments(
+            false, offset, segmentsPerRPC, fi, &segInfos);
+        // mds配置的上限可能小于每次获取的个数，减半之后重新获取
+        if (ret == LIBCURVE_ERROR::PARAM_ERROR && segmentsPerRPC > 1) {
+            segmentsPerRPC /= 2;
+            LOG(WARNING) << "warm up metacache segment count exceeds mds "
+                         << "limit, retry with " << segmentsPerRPC
+                         << " segments per rpc, filename = "
+                         << fi->fullPathName;
+            continue;
+        }
+        if (ret != LIBCURVE_ERROR::OK) {
+            LOG(WARNING) << "warm up metacache failed, filename = "
+                         << fi->fullPathName << ", offset = " << offset
+                         << ", error = " << ret;
+            break;
+        }
+
+        if (!Splitor::UpdateSegmentInfos(&mc_, mdsclient, segInfos, fi)) {
+            LOG(WARNING) << "warm up metacache update segment info failed, "
+                         << "filename = " << fi->fullPathName
+                         << ", offset = " << offset;
+            break;
+        }
+        segmentNum += segInfos.size();
+        offset += segmentSize * segmentsPerRPC;
+    }
+
+    uint64_t duration = TimeUtility::GetTimeofDayUs() - startUs;
+    MetricHelper::MetaCacheWarmupRecord(fileMetric_, duration, segmentNum);
+    LOG(INFO) << "warm up metacache finished, filename = "
+              << fi->fullPathName << ", segment num = " << segmentNum
+              << ", cost = " << duration << " us";
+}
+
 void IOManager4File::HandleAsyncIOResponse(IOTracker* iotracker) {
     inflightCntl_.DecremInflightNum();
-    delete iotracker;
+    ClientObjectPool<IOTracker>::Return(iotracker);
 }
 
 void IOManager4File::LeaseTimeoutBlockIO() {
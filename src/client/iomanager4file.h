@@ -23,6 +23,9 @@
 #ifndef SRC_CLIENT_IOMANAGER4FILE_H_
 #define SRC_CLIENT_IOMANAGER4FILE_H_
 
+#include <sys/uio.h>
+#include <butil/iobuf.h>
+
 #include <string>
 #include <atomic>
 #include <mutex>  // NOLINT
@@ -37,6 +40,7 @@
 #include "src/client/request_scheduler.h"
 #include "include/curve_compiler_specific.h"
 #include "src/client/inflight_controller.h"
+#include "src/client/segment_prefetcher.h"
 
 using curve::common::Atomic;
 
@@ -93,6 +97,43 @@ class IOManager4File : public IOManager {
    */
   int AioWrite(CurveAioContext* aioctx,
                       MDSClient* mdsclient);
+  /**
+   * 向量化异步模式读写，iov在回调之前需要保持有效
+   * @param: aioctx为异步读写的io上下文，aioctx->buf不使用
+   * @param: iov为用户buffer数组，长度之和需要等于aioctx->length
+   * @param: iovcnt为iov的个数
+   * @param: mdsclient透传给底层，在必要的时候与mds通信
+   * @return： 0为成功，小于0为失败
+   */
+  int AioReadv(CurveAioContext* aioctx,
+               const struct iovec* iov,
+               int iovcnt,
+               MDSClient* mdsclient);
+  int AioWritev(CurveAioContext* aioctx,
+                const struct iovec* iov,
+                int iovcnt,
+                MDSClient* mdsclient);
+  /**
+   * 异步模式读，数据不拷贝到用户buffer，rpc返回的数据按顺序追加到data中
+   * @param: aioctx为异步读写的io上下文，aioctx->buf不使用
+   * @param: data为读取数据的出参，回调之前需要保持有效
+   * @param: mdsclient透传给底层，在必要的时候与mds通信
+   * @return： 0为成功，小于0为失败
+   */
+  int AioReadIOBuf(CurveAioContext* aioctx,
+                   butil::IOBuf* data,
+                   MDSClient* mdsclient);
+  /**
+   * 批量提交异步读写，整批只进行一次inflight计数和任务提交，
+   * 拆分后的request一次性放入调度队列，每个io仍然通过各自的回调返回
+   * @param: ctxs为异步io上下文数组，数组本身在返回后可以释放
+   * @param: n为ctxs的个数
+   * @param: mdsclient透传给底层，在必要的时候与mds通信
+   * @return： 0为成功，小于0为失败
+   */
+  int AioSubmitBatch(CurveAioContext* const* ctxs,
+                     int n,
+                     MDSClient* mdsclient);
 
   /**
    * 析构，回收资源
@@ -145,6 +186,13 @@ class IOManager4File : public IOManager {
    */
   void UpdateFileInfo(const FInfo_t& fi);
 
+  /**
+   * 打开文件之后预加载所有已分配segment的元数据到metacache，
+   * 未开启预加载时直接返回，预加载失败不影响后续IO
+   * @param: mdsclient用于分批获取segment信息和copyset的server list
+   */
+  void WarmUpMetaCache(MDSClient* mdsclient);
+
   const FInfo* GetFileInfo() const {
     return mc_.GetFileInfo();
   }
@@ -227,6 +275,9 @@ class IOManager4File : public IOManager {
   // inflight rpc控制
   InflightControl inflightRpcCntl_;
 
+  // 顺序写时异步预分配之后的segment
+  SegmentPrefetcher segmentPrefetcher_;
+
   // 是否退出
   bool exit_;
 
@@ -116,6 +116,25 @@ int CurveClient::AioWrite(int fd, CurveAioContext* aioctx) {
     return fileClient_->AioWrite(fd, aioctx);
 }
 
+int CurveClient::AioReadv(int fd, CurveAioContext* aioctx,
+                          const struct iovec* iov, int iovcnt) {
+    return fileClient_->AioReadv(fd, aioctx, iov, iovcnt);
+}
+
+int CurveClient::AioReadIOBuf(int fd, CurveAioContext* aioctx,
+                              butil::IOBuf* data) {
+    return fileClient_->AioReadIOBuf(fd, aioctx, data);
+}
+
+int CurveClient::AioWritev(int fd, CurveAioContext* aioctx,
+                           const struct iovec* iov, int iovcnt) {
+    return fileClient_->AioWritev(fd, aioctx, iov, iovcnt);
+}
+
+int CurveClient::AioSubmitBatch(int fd, CurveAioContext* ctxs[], int n) {
+    return fileClient_->AioSubmitBatch(fd, ctxs, n);
+}
+
 void CurveClient::SetFileClient(FileClient* client) {
     delete fileClient_;
     fileClient_ = client;
@@ -28,6 +28,7 @@
 #include <mutex>    // NOLINT
 #include <memory>
 #include <algorithm>
+#include <vector>
 #include "src/client/libcurve_file.h"
 #include "src/client/client_common.h"
 #include "src/client/client_config.h"
@@ -347,6 +348,136 @@ int FileClient::AioWrite(int fd, CurveAioContext* aioctx) {
     return ret;
 }
 
+int FileClient::AioReadv(int fd, CurveAioContext* aioctx,
+                         const struct iovec* iov, int iovcnt) {
+    // 长度为0，直接返回，不做任何操作
+    if (aioctx->length == 0) {
+        return -LIBCURVE_ERROR::OK;
+    }
+
+    if (CheckAligned(aioctx->offset, aioctx->length) == false) {
+        return -LIBCURVE_ERROR::NOT_ALIGNED;
+    }
+
+    if (iov == nullptr || iovcnt <= 0) {
+        LOG(ERROR) << "invalid iov, iovcnt = " << iovcnt;
+        return -LIBCURVE_ERROR::FAILED;
+    }
+
+    int ret = -LIBCURVE_ERROR::FAILED;
+    ReadLockGuard lk(rwlock_);
+    if (CURVE_UNLIKELY(fileserviceMap_.find(fd) == fileserviceMap_.end())) {
+        LOG(ERROR) << "invalid fd!";
+        ret = -LIBCURVE_ERROR::BAD_FD;
+    } else {
+        ret = fileserviceMap_[fd]->AioReadv(aioctx, iov, iovcnt);
+    }
+
+    return ret;
+}
+
+int FileClient::AioReadIOBuf(int fd, CurveAioContext* aioctx,
+                             butil::IOBuf* data) {
+    // 长度为0，直接返回，不做任何操作
+    if (aioctx->length == 0) {
+        return -LIBCURVE_ERROR::OK;
+    }
+
+    if (CheckAligned(aioctx->offset, aioctx->length) == false) {
+        return -LIBCURVE_ERROR::NOT_ALIGNED;
+    }
+
+    if (data == nullptr) {
+        LOG(ERROR) << "invalid iobuf!";
+        return -LIBCURVE_ERROR::FAILED;
+    }
+
+    int ret = -LIBCURVE_ERROR::FAILED;
+    ReadLockGuard lk(rwlock_);
+    if (CURVE_UNLIKELY(fileserviceMap_.find(fd) == fileserviceMap_.end())) {
+        LOG(ERROR) << "invalid fd!";
+        ret = -LIBCURVE_ERROR::BAD_FD;
+    } else {
+        ret = fileserviceMap_[fd]->AioReadIOBuf(aioctx, data);
+    }
+
+    return ret;
+}
+
+int FileClient::AioWritev(int fd, CurveAioContext* aioctx,
+                          const struct iovec* iov, int iovcnt) {
+    // 长度为0，直接返回，不做任何操作
+    if (aioctx->length == 0) {
+        return -LIBCURVE_ERROR::OK;
+    }
+
+    if (CheckAligned(aioctx->offset, aioctx->length) == false) {
+        return -LIBCURVE_ERROR::NOT_ALIGNED;
+    }
+
+    if (iov == nullptr || iovcnt <= 0) {
+        LOG(ERROR) << "invalid iov, iovcnt = " << iovcnt;
+        return -LIBCURVE_ERROR::FAILED;
+    }
+
+    int ret = -LIBCURVE_ERROR::FAILED;
+    ReadLockGuard lk(rwlock_);
+    if (CURVE_UNLIKELY(fileserviceMap_.find(fd) == fileserviceMap_.end())) {
+        LOG(ERROR) << "invalid fd!";
+        ret = -LIBCURVE_ERROR::BAD_FD;
+    } else {
+        ret = fileserviceMap_[fd]->AioWritev(aioctx, iov, iovcnt);
+    }
+
+    return ret;
+}
+
+int FileClient::AioSubmitBatch(int fd, CurveAioContext* ctxs[], int n) {
+    if (ctxs == nullptr || n < 0) {
+        LOG(ERROR) << "invalid batch, n = " << n;
+        return -LIBCURVE_ERROR::FAILED;
+    }
+
+    // 先校验整批io，任意一个非法则整批都不提交
+    std::vector<CurveAioContext*> valid;
+    valid.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        CurveAioContext* aioctx = ctxs[i];
+        if (aioctx == nullptr ||
+            (aioctx->op != LIBCURVE_OP::LIBCURVE_OP_READ &&
+             aioctx->op != LIBCURVE_OP::LIBCURVE_OP_WRITE)) {
+            LOG(ERROR) << "invalid aio context in batch, index = " << i;
+            return -LIBCURVE_ERROR::FAILED;
+        }
+
+        // 长度为0，直接跳过，与AioRead/AioWrite行为一致
+        if (aioctx->length == 0) {
+            continue;
+        }
+
+        if (CheckAligned(aioctx->offset, aioctx->length) == false) {
+            return -LIBCURVE_ERROR::NOT_ALIGNED;
+        }
+        valid.push_back(aioctx);
+    }
+
+    if (valid.empty()) {
+        return -LIBCURVE_ERROR::OK;
+    }
+
+    int ret = -LIBCURVE_ERROR::FAILED;
+    ReadLockGuard lk(rwlock_);
+    if (CURVE_UNLIKELY(fileserviceMap_.find(fd) == fileserviceMap_.end())) {
+        LOG(ERROR) << "invalid fd!";
+        ret = -LIBCURVE_ERROR::BAD_FD;
+    } else {
+        ret = fileserviceMap_[fd]->AioSubmitBatch(
+            valid.data(), static_cast<int>(valid.size()));
+    }
+
+    return ret;
+}
+
 int FileClient::Rename(const UserInfo_t& userinfo,
     const std::string& oldpath, const std::string& newpath) {
     LIBCURVE_ERROR ret;
@@ -709,6 +840,44 @@ int AioWrite(int fd, CurveAioContext* aioctx) {
     return globalclient->AioWrite(fd, aioctx);
 }
 
+int AioReadv(int fd, CurveAioContext* aioctx,
+             const struct iovec* iov, int iovcnt) {
+    if (globalclient == nullptr) {
+        LOG(ERROR) << "not inited!";
+        return -LIBCURVE_ERROR::FAILED;
+    }
+
+    DVLOG(9) << "offset: " << aioctx->offset
+        << " length: " << aioctx->length
+        << " op: " << aioctx->op
+        << " iovcnt: " << iovcnt;
+    return globalclient->AioReadv(fd, aioctx, iov, iovcnt);
+}
+
+int AioWritev(int fd, CurveAioContext* aioctx,
+              const struct iovec* iov, int iovcnt) {
+    if (globalclient == nullptr) {
+        LOG(ERROR) << "not inited!";
+        return -LIBCURVE_ERROR::FAILED;
+    }
+
+    DVLOG(9) << "offset: " << aioctx->offset
+        << " length: " << aioctx->length
+        << " op: " << aioctx->op
+        << " iovcnt: " << iovcnt;
+    return globalclient->AioWritev(fd, aioctx, iov, iovcnt);
+}
+
+int AioSubmitBatch(int fd, CurveAioContext* ctxs[], int n) {
+    if (globalclient == nullptr) {
+        LOG(ERROR) << "not inited!";
+        return -LIBCURVE_ERROR::FAILED;
+    }
+
+    DVLOG(9) << "batch size: " << n;
+    return globalclient->AioSubmitBatch(fd, ctxs, n);
+}
+
 int Create(const char* filename, const C_UserInfo_t* userinfo, size_t size) {
     if (globalclient == nullptr) {
         LOG(ERROR) << "not inited!";
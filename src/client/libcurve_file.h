@@ -149,6 +149,40 @@ class FileClient {
      */
     virtual int AioWrite(int fd, CurveAioContext* aioctx);
 
+    /**
+     * 向量化异步模式读写
+     * @param: fd为当前open返回的文件描述符
+     * @param: aioctx为异步读写的io上下文，buf不使用
+     * @param: iov为用户buffer数组，长度之和需要等于aioctx->length
+     * @param: iovcnt为iov的个数
+     * @return: 成功返回0,否则返回小于0的错误码
+     */
+    virtual int AioReadv(int fd, CurveAioContext* aioctx,
+                         const struct iovec* iov, int iovcnt);
+    virtual int AioWritev(int fd, CurveAioContext* aioctx,
+                          const struct iovec* iov, int iovcnt);
+
+    /**
+     * 异步模式读，数据不拷贝到用户buffer，rpc返回的数据直接追加到data中，
+     * 供快照克隆等内部模块使用
+     * @param: fd为当前open返回的文件描述符
+     * @param: aioctx为异步读写的io上下文，buf不使用
+     * @param: data为读取数据的出参，回调之前需要保持有效
+     * @return: 成功返回0,否则返回小于0的错误码
+     */
+    virtual int AioReadIOBuf(int fd, CurveAioContext* aioctx,
+                             butil::IOBuf* data);
+
+    /**
+     * 批量提交异步读写，读写类型由各自的aioctx->op决定
+     * 任意一个io参数非法时整批都不提交，length为0的io直接跳过
+     * @param: fd为当前open返回的文件描述符
+     * @param: ctxs为异步io上下文数组，数组本身在返回后可以释放
+     * @param: n为ctxs的个数
+     * @return: 成功返回0,否则返回小于0的错误码
+     */
+    virtual int AioSubmitBatch(int fd, CurveAioContext* ctxs[], int n);
+
     /**
      * 重命名文件
      * @param: userinfo是用户信息
@@ -49,6 +49,7 @@ using curve::mds::CreateFileResponse;
 using curve::mds::DeleteFileResponse;
 using curve::mds::GetFileInfoResponse;
 using curve::mds::GetOrAllocateSegmentResponse;
+using curve::mds::GetOrAllocateSegmentsResponse;
 using curve::mds::RenameFileResponse;
 using curve::mds::ExtendFileResponse;
 using curve::mds::ChangeOwnerResponse;
@@ -70,6 +71,25 @@ using curve::mds::topology::GetChunkServerListInCopySetsResponse;
 
 namespace curve {
 namespace client {
+
+// 将mds返回的segment信息转换为client使用的segment信息
+static void PageFileSegment2SegmentInfo(const PageFileSegment& pfs,
+                                        SegmentInfo* segInfo) {
+    segInfo->chunksize = pfs.chunksize();
+    segInfo->segmentsize = pfs.segmentsize();
+    segInfo->startoffset = pfs.startoffset();
+    LogicPoolID logicpoolid = pfs.logicalpoolid();
+    segInfo->lpcpIDInfo.lpid = logicpoolid;
+
+    int chunksNum = pfs.chunks_size();
+    for (int i = 0; i < chunksNum; i++) {
+        ChunkID chunkid = pfs.chunks(i).chunkid();
+        CopysetID copysetid = pfs.chunks(i).copysetid();
+        segInfo->lpcpIDInfo.cpidVec.push_back(copysetid);
+        segInfo->chunkvec.emplace_back(chunkid, logicpoolid, copysetid);
+    }
+}
+
 MDSClient::MDSClient() {
     inited_   = false;
 }
@@ -872,24 +892,59 @@ LIBCURVE_ERROR MDSClient::GetOrAllocateSegment(bool allocate, uint64_t offset,
             default: break;
         }
 
-        PageFileSegment pfs = response.pagefilesegment();
-        segInfo->chunksize = pfs.chunksize();
-        segInfo->segmentsize = pfs.segmentsize();
-        segInfo->startoffset = pfs.startoffset();
-        LogicPoolID logicpoolid = pfs.logicalpoolid();
-        segInfo->lpcpIDInfo.lpid = pfs.logicalpoolid();
-
-        int chunksNum = pfs.chunks_size();
-        if (allocate && chunksNum <= 0) {
+        const PageFileSegment& pfs = response.pagefilesegment();
+        if (allocate && pfs.chunks_size() <= 0) {
             LOG(ERROR) << "MDS allocate segment, but no chunkinfo!";
             return LIBCURVE_ERROR::FAILED;
         }
 
-        for (int i = 0; i < chunksNum; i++) {
-            ChunkID chunkid = pfs.chunks(i).chunkid();
-            CopysetID copysetid = pfs.chunks(i).copysetid();
-            segInfo->lpcpIDInfo.cpidVec.push_back(copysetid);
-            segInfo->chunkvec.emplace_back(chunkid, logicpoolid, copysetid);
+        PageFileSegment2SegmentInfo(pfs, segInfo);
+        return LIBCURVE_ERROR::OK;
+    };
+    return rpcExcutor.DoRPCTask(task, IOPathMaxRetryMS);
+}
+
+LIBCURVE_ERROR MDSClient::GetOrAllocateSegments(bool allocate, uint64_t offset,
+    uint32_t count, const FInfo_t* fi, std::vector<SegmentInfo>* segInfos) {
+    auto task = RPCTaskDefine {
+        GetOrAllocateSegmentsResponse response;
+        mdsClientMetric_.getOrAllocateSegments.qps.count << 1;
+        LatencyGuard lg(&mdsClientMetric_.getOrAllocateSegments.latency);
+        mdsClientBase_.GetOrAllocateSegments(allocate, offset, count, fi,
+                                             &response, cntl, channel);
+        if (cntl->Failed()) {
+            mdsClientMetric_.getOrAllocateSegments.eps.count << 1;
+            LOG_EVERY_SECOND(ERROR)
+                << "allocate segments failed, error code = "
+                << cntl->ErrorCode()
+                << ", error content:" << cntl->ErrorText()
+                << ", offset:" << offset
+                << ", count:" << count;
+            return -cntl->ErrorCode();
+        }
+
+        auto statuscode = response.statuscode();
+        if (statuscode == StatusCode::kOwnerAuthFail) {
+            LOG(ERROR) << "GetOrAllocateSegments Auth failed!";
+            return LIBCURVE_ERROR::AUTHFAIL;
+        } else if (statuscode != StatusCode::kOK) {
+            LOG(ERROR) << "GetOrAllocateSegments failed, offset = " << offset
+                       << ", count = " << count
+                       << ", error msg = " << StatusCode_Name(statuscode);
+            // count超过mds的上限时返回PARAM_ERROR，调用方可以减小count重试
+            return statuscode == StatusCode::kParaError
+                   ? LIBCURVE_ERROR::PARAM_ERROR : LIBCURVE_ERROR::FAILED;
+        }
+
+        segInfos->clear();
+        segInfos->reserve(response.pagefilesegments_size());
+        for (const auto& pfs : response.pagefilesegments()) {
+            if (allocate && pfs.chunks_size() <= 0) {
+                LOG(ERROR) << "MDS allocate segment, but no chunkinfo!";
+                return LIBCURVE_ERROR::FAILED;
+            }
+            segInfos->emplace_back();
+            PageFileSegment2SegmentInfo(pfs, &segInfos->back());
         }
         return LIBCURVE_ERROR::OK;
     };
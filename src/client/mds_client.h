@@ -127,6 +127,23 @@ class MDSClient {
                             uint64_t offset,
                             const FInfo_t* fi,
                             SegmentInfo *segInfo);
+    /**
+     * 批量获取从offset所在segment开始的连续count个segment的chunk信息，
+     * 一次rpc完成，超出文件长度的segment忽略
+     * @param: allocate为true的时候mds端发现不存在就分配，
+     *         为false的时候不分配，且未分配的segment不返回
+     * @param: offset为文件整体偏移
+     * @param: count为segment的个数
+     * @param: fi是当前文件的基本信息
+     * @param[out]: segInfos获取到的segment信息
+     * @return: 成功返回LIBCURVE_ERROR::OK,如果认证失败返回LIBCURVE_ERROR::AUTHFAIL，
+     *          否则返回LIBCURVE_ERROR::FAILED
+     */
+    LIBCURVE_ERROR GetOrAllocateSegments(bool allocate,
+                            uint64_t offset,
+                            uint32_t count,
+                            const FInfo_t* fi,
+                            std::vector<SegmentInfo>* segInfos);
     /**
      * 获取文件信息，fi是出参
      * @param: filename是文件名
@@ -359,6 +359,34 @@ void MDSClientBase::GetOrAllocateSegment(bool allocate,
     stub.GetOrAllocateSegment(cntl, &request, response, NULL);
 }
 
+void MDSClientBase::GetOrAllocateSegments(bool allocate,
+                                uint64_t offset,
+                                uint32_t count,
+                                const FInfo_t* fi,
+                                GetOrAllocateSegmentsResponse* response,
+                                brpc::Controller* cntl,
+                                brpc::Channel* channel) {
+    GetOrAllocateSegmentsRequest request;
+
+    uint64_t segmentsize = fi->segmentsize;
+    uint64_t seg_offset = (offset / segmentsize) * segmentsize;
+    request.set_filename(fi->fullPathName);
+    request.set_offset(seg_offset);
+    request.set_count(count);
+    request.set_allocateifnotexist(allocate);
+    FillUserInfo<GetOrAllocateSegmentsRequest>(&request, fi->userinfo);
+
+    LOG(INFO) << "GetOrAllocateSegments: allocate = " << allocate
+                << ", owner = " << fi->owner.c_str()
+                << ", offset = " << offset
+                << ", segment offset = " << seg_offset
+                << ", count = " << count
+                << ", log id = " << cntl->log_id();
+
+    curve::mds::CurveFSService_Stub stub(channel);
+    stub.GetOrAllocateSegments(cntl, &request, response, NULL);
+}
+
 void MDSClientBase::RenameFile(const UserInfo_t& userinfo,
                                 const std::string &origin,
                                 const std::string &destination,
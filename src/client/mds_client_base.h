@@ -73,6 +73,8 @@ using curve::mds::SetCloneFileStatusRequest;
 using curve::mds::SetCloneFileStatusResponse;
 using curve::mds::GetOrAllocateSegmentRequest;
 using curve::mds::GetOrAllocateSegmentResponse;
+using curve::mds::GetOrAllocateSegmentsRequest;
+using curve::mds::GetOrAllocateSegmentsResponse;
 using curve::mds::CheckSnapShotStatusRequest;
 using curve::mds::CheckSnapShotStatusResponse;
 using curve::mds::ListSnapShotFileInfoRequest;
@@ -325,6 +327,23 @@ class MDSClientBase {
                     GetOrAllocateSegmentResponse* response,
                     brpc::Controller* cntl,
                     brpc::Channel* channel);
+    /**
+     * 批量获取从offset所在segment开始的连续count个segment的chunk信息
+     * @param: allocate为true的时候mds端发现不存在就分配，为false的时候不分配
+     * @param: offset为文件整体偏移
+     * @param: count为segment的个数
+     * @param: fi是当前文件的基本信息
+     * @param[out]: response为该rpc的response，提供给外部处理
+     * @param[in|out]: cntl既是入参，也是出参，返回RPC状态
+     * @param[in]:channel是当前与mds建立的通道
+     */
+    void GetOrAllocateSegments(bool allocate,
+                    uint64_t offset,
+                    uint32_t count,
+                    const FInfo_t* fi,
+                    GetOrAllocateSegmentsResponse* response,
+                    brpc::Controller* cntl,
+                    brpc::Channel* channel);
     /**
      * @brief 重名文件
      * @param:userinfo 用户信息
@@ -23,6 +23,7 @@
 #include <glog/logging.h>
 
 #include <bthread/bthread.h>
+#include <butil/fast_rand.h>
 
 #include <utility>
 #include <algorithm>
@@ -53,7 +54,46 @@ void MetaCache::Init(MetaCacheOption_t metaCacheOpt, MDSClient* mdsclient) {
               << metacacheopt_.metacacheGetLeaderRPCTimeOutMS;
 }
 
+MetaCache::~MetaCache() {
+    delete chunkIndexTable_.load(std::memory_order_acquire);
+}
+
+void MetaCache::UpdateFileInfo(const FInfo& fileInfo) {
+    fileInfo_ = fileInfo;
+    if (chunkIndexTable_.load(std::memory_order_acquire) != nullptr ||
+        fileInfo.chunksize == 0 || fileInfo.length == 0) {
+        return;
+    }
+
+    uint64_t chunkNum = (fileInfo.length + fileInfo.chunksize - 1)
+                      / fileInfo.chunksize;
+    ChunkIndexTable* table = new ChunkIndexTable(chunkNum);
+    WriteLockGuard wrlk(rwlock4ChunkInfo_);
+    if (chunkIndexTable_.load(std::memory_order_acquire) != nullptr) {
+        delete table;
+        return;
+    }
+    // 创建表之前已经缓存的chunk信息迁移到表中
+    for (auto iter = chunkindex2idMap_.begin();
+         iter != chunkindex2idMap_.end();) {
+        if (table->Set(iter->first, iter->second)) {
+            iter = chunkindex2idMap_.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+    chunkIndexTable_.store(table, std::memory_order_release);
+    LOG(INFO) << "create chunk index table for " << fileInfo.fullPathName
+              << ", chunk num = " << chunkNum;
+}
+
 MetaCacheErrorType MetaCache::GetChunkInfoByIndex(ChunkIndex chunkidx, ChunkIDInfo_t* chunxinfo ) {  // NOLINT
+    ChunkIndexTable* table = chunkIndexTable_.load(std::memory_order_acquire);
+    if (table != nullptr && chunkidx < table->Size()) {
+        return table->Get(chunkidx, chunxinfo) ?
+               MetaCacheErrorType::OK : MetaCacheErrorType::CHUNKINFO_NOT_FOUND;
+    }
+
     ReadLockGuard rdlk(rwlock4ChunkInfo_);
     auto iter = chunkindex2idMap_.find(chunkidx);
     if (iter != chunkindex2idMap_.end()) {
@@ -65,17 +105,14 @@ MetaCacheErrorType MetaCache::GetChunkInfoByIndex(ChunkIndex chunkidx, ChunkIDIn
 
 bool MetaCache::IsLeaderMayChange(LogicPoolID logicPoolId,
                                   CopysetID copysetId) {
-    rwlock4ChunkInfo_.RDLock();
+    ReadLockGuard rdlk(rwlock4CopysetInfo_);
     auto iter = lpcsid2CopsetInfoMap_.find(
-        LogicPoolCopysetID2Str(logicPoolId, copysetId));
+        CalcLogicPoolCopysetID(logicPoolId, copysetId));
     if (iter == lpcsid2CopsetInfoMap_.end()) {
-        rwlock4ChunkInfo_.Unlock();
         return false;
     }
 
-    bool flag = iter->second.LeaderMayChange();
-    rwlock4ChunkInfo_.Unlock();
-    return flag;
+    return iter->second.LeaderMayChange();
 }
 
 int MetaCache::GetLeader(LogicPoolID logicPoolId,
@@ -84,19 +121,23 @@ int MetaCache::GetLeader(LogicPoolID logicPoolId,
                         EndPoint* serverAddr,
                         bool refresh,
                         FileMetric* fm) {
-    std::string mapkey = LogicPoolCopysetID2Str(logicPoolId, copysetId);
+    LogicPoolCopysetID mapkey = CalcLogicPoolCopysetID(logicPoolId, copysetId);
 
     CopysetInfo_t targetInfo;
-    rwlock4CopysetInfo_.RDLock();
-    auto iter = lpcsid2CopsetInfoMap_.find(mapkey);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
-        rwlock4CopysetInfo_.Unlock();
-        LOG(ERROR) << "server list not exist, LogicPoolID = " << logicPoolId
-                   << ", CopysetID = " << copysetId;
-        return -1;
+    {
+        ReadLockGuard rdlk(rwlock4CopysetInfo_);
+        auto iter = lpcsid2CopsetInfoMap_.find(mapkey);
+        if (iter == lpcsid2CopsetInfoMap_.end()) {
+            LOG(ERROR) << "server list not exist, LogicPoolID = "
+                       << logicPoolId << ", CopysetID = " << copysetId;
+            return -1;
+        }
+        // 不需要刷新leader时直接取出leader信息，不拷贝整个copyset信息
+        if (!refresh && !iter->second.LeaderMayChange()) {
+            return iter->second.GetLeaderInfo(serverId, serverAddr);
+        }
+        targetInfo = iter->second;
     }
-    targetInfo = iter->second;
-    rwlock4CopysetInfo_.Unlock();
 
     int ret = 0;
     if (refresh || targetInfo.LeaderMayChange()) {
@@ -134,6 +175,62 @@ int MetaCache::GetLeader(LogicPoolID logicPoolId,
     return targetInfo.GetLeaderInfo(serverId, serverAddr);
 }
 
+int MetaCache::GetReadPeer(LogicPoolID logicPoolId,
+                           CopysetID copysetId,
+                           ChunkServerID* serverId,
+                           EndPoint* serverAddr) {
+    LogicPoolCopysetID mapkey = CalcLogicPoolCopysetID(logicPoolId, copysetId);
+
+    ReadLockGuard rdlk(rwlock4CopysetInfo_);
+    auto iter = lpcsid2CopsetInfoMap_.find(mapkey);
+    if (iter == lpcsid2CopsetInfoMap_.end()) {
+        return -1;
+    }
+
+    const CopysetInfo_t& info = iter->second;
+    if (info.csinfos_.empty() || info.leaderMayChange_) {
+        return -1;
+    }
+
+    size_t index = butil::fast_rand_less_than(info.csinfos_.size());
+    *serverId = info.csinfos_[index].chunkserverid_;
+    *serverAddr = info.csinfos_[index].csaddr_.addr_;
+    return 0;
+}
+
+int MetaCache::GetHedgedReadPeer(LogicPoolID logicPoolId,
+                                 CopysetID copysetId,
+                                 ChunkServerID leaderId,
+                                 ChunkServerID* serverId,
+                                 EndPoint* serverAddr) {
+    LogicPoolCopysetID mapkey = CalcLogicPoolCopysetID(logicPoolId, copysetId);
+
+    ReadLockGuard rdlk(rwlock4CopysetInfo_);
+    auto iter = lpcsid2CopsetInfoMap_.find(mapkey);
+    if (iter == lpcsid2CopsetInfoMap_.end()) {
+        return -1;
+    }
+
+    const CopysetInfo_t& info = iter->second;
+    if (info.csinfos_.size() < 2 || info.leaderMayChange_) {
+        return -1;
+    }
+
+    // 从一个随机位置开始，选择第一个不是leader的副本
+    size_t size = info.csinfos_.size();
+    size_t start = butil::fast_rand_less_than(size);
+    for (size_t i = 0; i < size; ++i) {
+        const auto& peer = info.csinfos_[(start + i) % size];
+        if (peer.chunkserverid_ != leaderId) {
+            *serverId = peer.chunkserverid_;
+            *serverAddr = peer.csaddr_.addr_;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
 int MetaCache::UpdateLeaderInternal(LogicPoolID logicPoolId,
                                     CopysetID copysetId,
                                     CopysetInfo* toupdateCopyset,
@@ -223,7 +320,7 @@ void MetaCache::UpdateCopysetInfoIfMatchCurrentLeader(
 
 CopysetInfo_t MetaCache::GetServerList(LogicPoolID logicPoolId,
                                        CopysetID copysetId) {
-    std::string mapkey = LogicPoolCopysetID2Str(logicPoolId, copysetId);
+    LogicPoolCopysetID mapkey = CalcLogicPoolCopysetID(logicPoolId, copysetId);
     CopysetInfo_t ret;
 
     ReadLockGuard rdlk(rwlock4CopysetInfo_);
@@ -242,7 +339,7 @@ CopysetInfo_t MetaCache::GetServerList(LogicPoolID logicPoolId,
  */
 int MetaCache::UpdateLeader(LogicPoolID logicPoolId,
     CopysetID copysetId, ChunkServerID* leaderId, const EndPoint &leaderAddr) {
-    std::string mapkey = LogicPoolCopysetID2Str(logicPoolId, copysetId);
+    LogicPoolCopysetID mapkey = CalcLogicPoolCopysetID(logicPoolId, copysetId);
 
     ReadLockGuard rdlk(rwlock4CopysetInfo_);
     auto iter = lpcsid2CopsetInfoMap_.find(mapkey);
@@ -256,20 +353,65 @@ int MetaCache::UpdateLeader(LogicPoolID logicPoolId,
 }
 
 void MetaCache::UpdateChunkInfoByIndex(ChunkIndex cindex, ChunkIDInfo_t cinfo) {
+    ChunkIndexTable* table = chunkIndexTable_.load(std::memory_order_acquire);
+    if (table != nullptr && table->Set(cindex, cinfo)) {
+        return;
+    }
+
     WriteLockGuard wrlk(rwlock4ChunkInfo_);
+    // 表可能在加锁之前刚刚创建，迁移已经结束，写入map的信息不会再被读到
+    table = chunkIndexTable_.load(std::memory_order_acquire);
+    if (table != nullptr && table->Set(cindex, cinfo)) {
+        return;
+    }
     chunkindex2idMap_[cindex] = cinfo;
 }
 
+void MetaCache::MarkZeroChunks(ChunkIndex cindex, uint64_t count,
+                               uint64_t epoch) {
+    if (!ZeroChunkCacheEnabled()) {
+        return;
+    }
+
+    WriteLockGuard wrlk(rwlock4ZeroChunks_);
+    if (zeroChunkEpoch_.load(std::memory_order_acquire) != epoch) {
+        return;
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        zeroChunks_.insert(cindex + i);
+    }
+}
+
+bool MetaCache::IsZeroChunk(ChunkIndex cindex) {
+    if (!ZeroChunkCacheEnabled()) {
+        return false;
+    }
+
+    ReadLockGuard rdlk(rwlock4ZeroChunks_);
+    return zeroChunks_.count(cindex) != 0;
+}
+
+void MetaCache::InvalidateZeroChunk(ChunkIndex cindex) {
+    if (!ZeroChunkCacheEnabled()) {
+        return;
+    }
+
+    // 先递增计数再删除记录，正在返回的读请求不会再把该chunk记录为全0
+    zeroChunkEpoch_.fetch_add(1, std::memory_order_acq_rel);
+    WriteLockGuard wrlk(rwlock4ZeroChunks_);
+    zeroChunks_.erase(cindex);
+}
+
 void MetaCache::UpdateCopysetInfo(LogicPoolID logicPoolid, CopysetID copysetid,
                                   const CopysetInfo& csinfo) {
-    auto key = LogicPoolCopysetID2Str(logicPoolid, copysetid);
+    auto key = CalcLogicPoolCopysetID(logicPoolid, copysetid);
     WriteLockGuard wrlk(rwlock4CopysetInfo_);
     lpcsid2CopsetInfoMap_[key] = csinfo;
 }
 
 void MetaCache::UpdateAppliedIndex(LogicPoolID logicPoolId,
     CopysetID copysetId, uint64_t appliedindex) {
-    std::string mapkey = LogicPoolCopysetID2Str(logicPoolId, copysetId);
+    LogicPoolCopysetID mapkey = CalcLogicPoolCopysetID(logicPoolId, copysetId);
 
     WriteLockGuard wrlk(rwlock4CopysetInfo_);
     auto iter = lpcsid2CopsetInfoMap_.find(mapkey);
@@ -281,7 +423,7 @@ void MetaCache::UpdateAppliedIndex(LogicPoolID logicPoolId,
 
 uint64_t MetaCache::GetAppliedIndex(LogicPoolID logicPoolId,
                                     CopysetID copysetId) {
-    std::string mapkey = LogicPoolCopysetID2Str(logicPoolId, copysetId);
+    LogicPoolCopysetID mapkey = CalcLogicPoolCopysetID(logicPoolId, copysetId);
 
     ReadLockGuard rdlk(rwlock4CopysetInfo_);
     auto iter = lpcsid2CopsetInfoMap_.find(mapkey);
@@ -328,7 +470,7 @@ void MetaCache::SetChunkserverUnstable(ChunkServerID csid) {
 
     ReadLockGuard rdlk(rwlock4CopysetInfo_);
     for (auto it : copysetIDSet) {
-        std::string mapkey = LogicPoolCopysetID2Str(it.lpid, it.cpid);
+        LogicPoolCopysetID mapkey = CalcLogicPoolCopysetID(it.lpid, it.cpid);
         auto cpinfo = lpcsid2CopsetInfoMap_.find(mapkey);
         if (cpinfo != lpcsid2CopsetInfoMap_.end()) {
             ChunkServerID leaderid;
@@ -354,7 +496,7 @@ void MetaCache::AddCopysetIDInfo(ChunkServerID csid,
 void MetaCache::UpdateChunkserverCopysetInfo(LogicPoolID lpid,
     const CopysetInfo_t& cpinfo) {
     ReadLockGuard rdlk(rwlock4CopysetInfo_);
-    std::string mapkey = LogicPoolCopysetID2Str(lpid, cpinfo.cpid_);
+    LogicPoolCopysetID mapkey = CalcLogicPoolCopysetID(lpid, cpinfo.cpid_);
     // 先获取原来的chunkserver到copyset映射
     auto previouscpinfo = lpcsid2CopsetInfoMap_.find(mapkey);
     if (previouscpinfo != lpcsid2CopsetInfoMap_.end()) {
@@ -397,7 +539,7 @@ void MetaCache::UpdateChunkserverCopysetInfo(LogicPoolID lpid,
 
 CopysetInfo_t MetaCache::GetCopysetinfo(LogicPoolID lpid, CopysetID csid) {
     ReadLockGuard rdlk(rwlock4CopysetInfo_);
-    std::string mapkey = LogicPoolCopysetID2Str(lpid, csid);
+    LogicPoolCopysetID mapkey = CalcLogicPoolCopysetID(lpid, csid);
     auto cpinfo = lpcsid2CopsetInfoMap_.find(mapkey);
     if (cpinfo != lpcsid2CopsetInfoMap_.end()) {
         return cpinfo->second;
@@ -412,9 +554,5 @@ std::string MetaCache::LogicPoolCopysetChunkID2Str(LogicPoolID lpid,
                                 .append("_")
                                 .append(std::to_string(chunkid));
 }
-std::string MetaCache::LogicPoolCopysetID2Str(LogicPoolID lpid,
-    CopysetID csid) {
-    return std::to_string(lpid).append("_").append(std::to_string(csid));
-}
 }   // namespace client
 }   // namespace curve
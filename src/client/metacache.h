@@ -22,12 +22,14 @@
 #ifndef SRC_CLIENT_METACACHE_H_
 #define SRC_CLIENT_METACACHE_H_
 
+#include <atomic>
 #include <string>
 #include <list>
 #include <map>
 #include <set>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "src/client/client_config.h"
 #include "src/common/concurrent/rw_lock.h"
@@ -51,13 +53,13 @@ enum class MetaCacheErrorType {
 
 class MetaCache {
  public:
-    using CopysetLogicPoolIDStr      = std::string;
+    using LogicPoolCopysetID         = uint64_t;
     using ChunkInfoMap               = std::unordered_map<ChunkID, ChunkIDInfo_t>;       // NOLINT
-    using CopysetInfoMap             = std::unordered_map<CopysetLogicPoolIDStr, CopysetInfo_t>;            // NOLINT
+    using CopysetInfoMap             = std::unordered_map<LogicPoolCopysetID, CopysetInfo_t>;            // NOLINT
     using ChunkIndexInfoMap          = std::map<ChunkIndex, ChunkIDInfo_t>;
 
-    MetaCache() = default;
-    virtual ~MetaCache() = default;
+    MetaCache() : chunkIndexTable_(nullptr), zeroChunkEpoch_(0) {}
+    virtual ~MetaCache();
 
     /**
      * 初始化函数
@@ -111,6 +113,38 @@ class MetaCache {
                                 butil::EndPoint* serverAddr,
                                 bool refresh = false,
                                 FileMetric* fm = nullptr);
+
+    /**
+     * follower read时为读请求选择一个副本，在copyset的所有副本中随机选择，
+     * 使读请求分散到各个副本上。leader可能发生变更时不做选择，由调用者
+     * 走leader的流程去刷新copyset信息
+     * @param: lpid逻辑池id
+     * @param: cpid是copysetid
+     * @param: serverId对应chunkserver的id信息，是出参
+     * @param: serverAddr为serverid对应的ip信息，是出参
+     * @return: 成功返回0， 否则返回-1
+     */
+    virtual int GetReadPeer(LogicPoolID logicPoolId,
+                            CopysetID copysetId,
+                            ChunkServerID* serverId,
+                            butil::EndPoint* serverAddr);
+
+    /**
+     * hedged read时为备份读请求选择一个follower，在copyset中除leader之外的
+     * 副本中随机选择。leader可能发生变更时不做选择
+     * @param: lpid逻辑池id
+     * @param: cpid是copysetid
+     * @param: leaderId为当前请求发往的leader，不会被选中
+     * @param: serverId对应chunkserver的id信息，是出参
+     * @param: serverAddr为serverid对应的ip信息，是出参
+     * @return: 成功返回0， 否则返回-1
+     */
+    virtual int GetHedgedReadPeer(LogicPoolID logicPoolId,
+                                  CopysetID copysetId,
+                                  ChunkServerID leaderId,
+                                  ChunkServerID* serverId,
+                                  butil::EndPoint* serverAddr);
+
     /**
      * 更新某个copyset的leader信息
      * @param: lpid逻辑池id
@@ -172,14 +206,6 @@ class MetaCache {
     virtual CopysetInfo_t GetServerList(LogicPoolID logicPoolId,
                                         CopysetID copysetId);
 
-    /**
-     * 将ID转化为cache的key
-     * @param: lpid逻辑池id
-     * @param: cpid是copysetid
-     * @return: 为当前的key
-     */
-    inline std::string LogicPoolCopysetID2Str(LogicPoolID lpid,
-                                        CopysetID csid);
     /**
      * 将ID转化为cache的key
      * @param: lpid逻辑池id
@@ -223,9 +249,11 @@ class MetaCache {
     virtual void UpdateChunkserverCopysetInfo(LogicPoolID lpid,
                                               const CopysetInfo_t& cpinfo);
 
-    void UpdateFileInfo(const FInfo& fileInfo) {
-        fileInfo_ = fileInfo;
-    }
+    /**
+     * 更新文件信息，第一次更新时根据文件长度创建chunk信息表
+     * @param: fileInfo为文件信息
+     */
+    void UpdateFileInfo(const FInfo& fileInfo);
 
     const FInfo* GetFileInfo() const {
         return &fileInfo_;
@@ -239,6 +267,43 @@ class MetaCache {
         fileInfo_.seqnum = newSn;
     }
 
+    /**
+     * 是否缓存读出全0的chunk，clone文件的chunk需要从源文件读取，不做缓存
+     */
+    bool ZeroChunkCacheEnabled() const {
+        return metacacheopt_.metacacheZeroChunkCacheEnable &&
+               fileInfo_.cloneSource.empty();
+    }
+
+    /**
+     * 获取当前的写请求计数，读请求在下发之前获取，
+     * 返回后据此判断期间是否有写请求
+     */
+    uint64_t GetZeroChunkEpoch() const {
+        return zeroChunkEpoch_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * 记录从chunk index开始的count个chunk读出全0，
+     * 如果epoch之后有写请求下发或返回则不记录
+     * @param: cindex为第一个chunk index
+     * @param: count为chunk个数
+     * @param: epoch为读请求下发之前获取的写请求计数
+     */
+    void MarkZeroChunks(ChunkIndex cindex, uint64_t count, uint64_t epoch);
+
+    /**
+     * 判断chunk是否已知读出全0
+     * @param: cindex为chunk index
+     */
+    bool IsZeroChunk(ChunkIndex cindex);
+
+    /**
+     * 写请求下发和返回时调用，使chunk读出全0的记录失效
+     * @param: cindex为写请求对应的chunk index
+     */
+    void InvalidateZeroChunk(ChunkIndex cindex);
+
     /**
      * 获取对应的copyset的LeaderMayChange标志
      */
@@ -295,7 +360,11 @@ class MetaCache {
     MDSClient*          mdsclient_;
     MetaCacheOption_t   metacacheopt_;
 
-    // chunkindex到chunkidinfo的映射表
+    // 按chunk index索引的chunk信息表，打开文件时创建，之后不再替换
+    std::atomic<ChunkIndexTable*> chunkIndexTable_;
+
+    // chunkindex到chunkidinfo的映射表，保存chunk信息表范围之外的chunk，
+    // 例如文件扩容之后新增的chunk，或者没有文件信息的快照读写
     CURVE_CACHELINE_ALIGNMENT ChunkIndexInfoMap     chunkindex2idMap_;
 
     // logicalpoolid和copysetid到copysetinfo的映射表
@@ -321,6 +390,14 @@ class MetaCache {
 
     // 当前文件信息
     FInfo fileInfo_;
+
+    // 已知读出全0的chunk index，包括未分配segment中的chunk
+    // 以及读请求时chunkserver返回不存在的chunk
+    std::unordered_set<ChunkIndex> zeroChunks_;
+    // 写请求计数，写请求下发和返回时递增，与写请求并发的读请求结果不记录
+    std::atomic<uint64_t> zeroChunkEpoch_;
+    // 保护zeroChunks_，记录时在锁内检查写请求计数
+    CURVE_CACHELINE_ALIGNMENT RWLock rwlock4ZeroChunks_;
 };
 
 }   // namespace client
@@ -24,6 +24,7 @@
 #define SRC_CLIENT_METACACHE_STRUCT_H_
 
 #include <atomic>
+#include <memory>
 #include <string>
 #include <list>
 #include <map>
@@ -250,13 +251,17 @@ typedef struct CURVE_CACHELINE_ALIGNMENT CopysetInfo {
      * @param: ep是出参
      */
     int GetLeaderInfo(ChunkServerID* chunkserverid, EndPoint* ep) {
+        // metacache中的copyset信息可能同时被更新leader，需要加锁
+        spinlock_.Lock();
         // 第一次获取leader,如果当前leader信息没有确定，返回-1，由外部主动发起更新leader
         if (leaderindex_ < 0 || leaderindex_ >= csinfos_.size()) {
+            spinlock_.UnLock();
             return -1;
         }
 
         *chunkserverid = csinfos_[leaderindex_].chunkserverid_;
         *ep = csinfos_[leaderindex_].csaddr_.addr_;
+        spinlock_.UnLock();
         return 0;
     }
 
@@ -333,6 +338,95 @@ operator==(const CopysetIDInfo& cpidinfo1, const CopysetIDInfo& cpidinfo2) {
            cpidinfo1.lpid == cpidinfo2.lpid;
 }
 
+/**
+ * 将逻辑池id和copyset id合成为一个整数，作为copyset信息表的key
+ */
+static inline uint64_t
+CalcLogicPoolCopysetID(LogicPoolID lpid, CopysetID cpid) {
+    return (static_cast<uint64_t>(lpid) << 32) | cpid;
+}
+
+/**
+ * 按照chunk index直接索引的chunk信息表，每次IO拆分请求时都需要查询
+ * 1. 大小在打开文件时根据文件长度确定，之后不再变化
+ * 2. 读不加锁，每个槽位通过序号判断读到的信息是否完整(seqlock)，
+ *    序号为奇数时表示正在写入，读前后序号不一致时需要重新读取
+ * 3. 写由写锁串行化，只在分配segment时发生
+ */
+class ChunkIndexTable {
+ public:
+    explicit ChunkIndexTable(uint64_t size)
+        : size_(size), slots_(new Slot[size]) {}
+
+    uint64_t Size() const {
+        return size_;
+    }
+
+    /**
+     * @param: index为chunk index
+     * @param: info是出参，为chunk对应的id信息
+     * @return: 槽位中已经有chunk信息返回true，否则返回false
+     */
+    bool Get(ChunkIndex index, ChunkIDInfo_t* info) const {
+        if (index >= size_) {
+            return false;
+        }
+        const Slot& slot = slots_[index];
+        uint64_t chunkId;
+        uint64_t lpcpId;
+        uint32_t seq;
+        do {
+            seq = slot.seq.load(std::memory_order_acquire);
+            chunkId = slot.chunkId.load(std::memory_order_relaxed);
+            lpcpId = slot.lpcpId.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((seq & 1) ||
+                 seq != slot.seq.load(std::memory_order_relaxed));
+
+        if (lpcpId == 0) {
+            return false;
+        }
+        info->cid_ = chunkId;
+        info->lpid_ = static_cast<LogicPoolID>(lpcpId >> 32);
+        info->cpid_ = static_cast<CopysetID>(lpcpId);
+        return true;
+    }
+
+    /**
+     * @param: index为chunk index
+     * @param: info为chunk对应的id信息
+     * @return: index超出表的范围返回false
+     */
+    bool Set(ChunkIndex index, const ChunkIDInfo_t& info) {
+        if (index >= size_) {
+            return false;
+        }
+        Slot& slot = slots_[index];
+        writeLock_.Lock();
+        uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+        slot.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.chunkId.store(info.cid_, std::memory_order_relaxed);
+        slot.lpcpId.store(CalcLogicPoolCopysetID(info.lpid_, info.cpid_),
+                          std::memory_order_relaxed);
+        slot.seq.store(seq + 2, std::memory_order_release);
+        writeLock_.UnLock();
+        return true;
+    }
+
+ private:
+    struct Slot {
+        std::atomic<uint32_t> seq{0};
+        std::atomic<uint64_t> chunkId{0};
+        // 逻辑池id和copyset id，为0表示槽位中还没有chunk信息
+        std::atomic<uint64_t> lpcpId{0};
+    };
+
+    const uint64_t size_;
+    std::unique_ptr<Slot[]> slots_;
+    SpinLock writeLock_;
+};
+
 }   // namespace client
 }   // namespace curve
 
@@ -32,13 +32,20 @@ using curve::common::WriteLockGuard;
 namespace curve {
 namespace client {
 
-RequestClosure::RequestClosure(RequestContext* reqctx) : ioManager_(nullptr) {
+RequestClosure::RequestClosure(RequestContext* reqctx) {
+    Reset(reqctx);
+}
+
+void RequestClosure::Reset(RequestContext* reqctx) {
     suspendRPC_ = false;
     managerID_ = 0;
     retryTimes_ = 0;
     errcode_ = -1;
+    tracker_ = nullptr;
     reqCtx_ = reqctx;
     metric_ = nullptr;
+    starttime_ = 0;
+    ioManager_ = nullptr;
     nextTimeoutMS_ = 0;
 }
 
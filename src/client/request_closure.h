@@ -48,6 +48,12 @@ class RequestClosure : public ::google::protobuf::Closure {
     explicit RequestClosure(RequestContext* reqctx);
     virtual ~RequestClosure() = default;
 
+    /**
+     * 重置closure的状态，从对象池中复用closure时调用
+     * @param: reqctx为closure新归属的request
+     */
+    void Reset(RequestContext* reqctx);
+
     /**
      * clouser的callback执行函数
      */
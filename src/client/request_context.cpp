@@ -23,8 +23,11 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
+#include <cstring>
+
 #include "src/client/request_context.h"
 #include "src/client/request_closure.h"
+#include "src/client/client_object_pool.h"
 
 namespace curve {
 namespace client {
@@ -32,8 +35,19 @@ namespace client {
 std::atomic<uint64_t> RequestContext::reqCtxID_(1);
 
 RequestContext::RequestContext() {
+    Reset();
+}
+
+void RequestContext::Reset() {
+    idinfo_ = ChunkIDInfo();
+    optype_ = OpType::UNKNOWN;
+
     readBuffer_ = nullptr;
     writeBuffer_ = nullptr;
+    iov_.clear();
+    readIOBuf_ = false;
+    readData_.clear();
+    done_ = nullptr;
     chunkinfodetail_ = nullptr;
 
     id_         = reqCtxID_.fetch_add(1);
@@ -43,14 +57,81 @@ RequestContext::RequestContext() {
     rawlength_  = 0;
 
     appliedindex_ = 0;
+    followerRead_ = false;
+    leaderOnlyRead_ = false;
+
+    chunksize_ = 0;
+    // clear只清空内容，保留已分配的内存，复用时不再重新分配
+    location_.clear();
+    sourceInfo_.cloneFileSource.clear();
+    sourceInfo_.cloneFileOffset = 0;
+    correctedSeq_ = 0;
+    fileId_       = 0;
+    scheduleTimeUs_ = 0;
+    chunkIdx_ = 0;
+    zeroRead_ = false;
+    zeroChunkEpoch_ = 0;
 }
+
 bool RequestContext::Init() {
-    done_ = new (std::nothrow) RequestClosure(this);
-    return done_ != nullptr;
+    done_ = ClientObjectPool<RequestClosure>::Get(this);
+    if (done_ == nullptr) {
+        return false;
+    }
+    done_->Reset(this);
+    return true;
 }
 
 void RequestContext::UnInit() {
-    delete done_;
+    ClientObjectPool<RequestClosure>::Return(done_);
+    done_ = nullptr;
+    // 归还对象池之前释放读到的数据，否则空闲的context会一直持有rpc的
+    // IOBuf block；iov_指向用户buffer，也不能在io结束后继续保留
+    readData_.clear();
+    iov_.clear();
+}
+
+RequestContext* RequestContext::NewInitedRequestContext() {
+    RequestContext* ctx = ClientObjectPool<RequestContext>::Get();
+    if (ctx == nullptr) {
+        LOG(ERROR) << "Allocate RequestContext Failed!";
+        return nullptr;
+    }
+
+    ctx->Reset();
+    if (!ctx->Init()) {
+        LOG(ERROR) << "Init RequestContext Failed!";
+        ClientObjectPool<RequestContext>::Return(ctx);
+        return nullptr;
+    }
+
+    return ctx;
+}
+
+void RequestContext::ZeroReadBuffer() {
+    if (readIOBuf_) {
+        readData_.clear();
+        readData_.resize(rawlength_);
+        return;
+    }
+
+    if (iov_.empty()) {
+        memset(readBuffer_, 0, rawlength_);
+        return;
+    }
+
+    for (const auto& piece : iov_) {
+        memset(piece.iov_base, 0, piece.iov_len);
+    }
+}
+
+void RequestContext::RecycleRequestContext(RequestContext* ctx) {
+    if (ctx == nullptr) {
+        return;
+    }
+
+    ctx->UnInit();
+    ClientObjectPool<RequestContext>::Return(ctx);
 }
 
 }  // namespace client
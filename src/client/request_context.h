@@ -23,8 +23,12 @@
 #ifndef SRC_CLIENT_REQUEST_CONTEXT_H_
 #define SRC_CLIENT_REQUEST_CONTEXT_H_
 
+#include <sys/uio.h>
+#include <butil/iobuf.h>
+
 #include <atomic>
 #include <string>
+#include <vector>
 
 #include "src/client/client_common.h"
 #include "src/client/request_closure.h"
@@ -57,8 +61,33 @@ class RequestContext {
     RequestContext();
     ~RequestContext() = default;
     bool Init();
+
+    /**
+     * 归还done_，并释放读到的数据和用户buffer片段，回收到对象池之前调用
+     */
     void UnInit();
 
+    /**
+     * 重置request context的所有字段并分配新的id，从对象池中复用时调用
+     */
+    void Reset();
+
+    /**
+     * 从对象池中获取一个初始化后的RequestContext
+     * @return: 获取或初始化失败返回nullptr
+     */
+    static RequestContext* NewInitedRequestContext();
+
+    /**
+     * 回收RequestContext及其done_到对象池
+     */
+    static void RecycleRequestContext(RequestContext* ctx);
+
+    /**
+     * 将读请求对应的用户buffer置0，读取到IOBuf时填充全0数据
+     */
+    void ZeroReadBuffer();
+
     // chunk的ID信息，sender在发送rpc的时候需要附带其ID信息
     ChunkIDInfo         idinfo_;
 
@@ -71,6 +100,15 @@ class RequestContext {
     char*               readBuffer_;
     const char*         writeBuffer_;
 
+    // 向量化IO时当前request对应的用户buffer片段，按顺序拼接后长度为rawlength_
+    // 非空时以iov_为准，readBuffer_/writeBuffer_指向第一个片段
+    std::vector<struct iovec> iov_;
+
+    // 为true时读请求不拷贝到用户buffer，rpc返回的数据直接保存在readData_中，
+    // 由IOTracker按顺序拼接后交给调用方，此时readBuffer_为空
+    bool                readIOBuf_;
+    butil::IOBuf        readData_;
+
     // 因为RPC都是异步发送，因此在一个Request结束时，RPC回调调用当前的done
     // 来告知当前的request结束了
     RequestClosure*     done_;
@@ -79,6 +117,10 @@ class RequestContext {
     uint64_t            seq_;
     // appliedindex_表示当前IO是否走chunkserver端的raft协议，为0的时候走raft
     uint64_t            appliedindex_;
+    // 本次读请求是否发往了副本选择出的节点(follower read)
+    bool                followerRead_;
+    // follower拒绝过该读请求(applied index落后)，之后只发往leader
+    bool                leaderOnlyRead_;
 
     // 这个对应的GetChunkInfo的出参
     ChunkInfoDetail*    chunkinfodetail_;
@@ -90,6 +132,19 @@ class RequestContext {
     // create clone chunk时候用于修改chunk的correctedSn
     uint64_t            correctedSeq_;
 
+    // 请求所属的文件id，chunkserver据此按卷进行QoS限流，0表示不携带
+    uint64_t            fileId_;
+
+    // 请求提交给调度器的时间，用于统计调度排队时延
+    uint64_t            scheduleTimeUs_;
+
+    // 请求所在chunk在文件中的index
+    ChunkIndex          chunkIdx_;
+    // 为true时读请求对应的chunk已知读出全0，由调度器在本地直接返回，不发送rpc
+    bool                zeroRead_;
+    // 读请求拆分时的写请求计数，chunk不存在时据此判断能否记录到metacache
+    uint64_t            zeroChunkEpoch_;
+
     // 当前request context id
     uint64_t            id_;
 
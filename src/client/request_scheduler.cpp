@@ -25,13 +25,20 @@
 #include <brpc/closure_guard.h>
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "src/client/request_context.h"
 #include "src/client/request_closure.h"
 #include "src/client/chunk_closure.h"
+#include "src/client/io_tracker.h"
+#include "src/common/timeutility.h"
 
 namespace curve {
 namespace client {
 
+using curve::common::TimeUtility;
+
 RequestScheduler::~RequestScheduler() {
 }
 
@@ -40,6 +47,7 @@ int RequestScheduler::Init(const RequestScheduleOption_t& reqSchdulerOpt,
                            FileMetric* fm) {
     blockIO_.store(false);
     reqschopt_ = reqSchdulerOpt;
+    fileMetric_ = fm;
 
     int rc = 0;
     rc = queue_.Init(reqschopt_.scheduleQueueCapacity);
@@ -62,7 +70,9 @@ int RequestScheduler::Init(const RequestScheduleOption_t& reqSchdulerOpt,
               << "scheduleQueueCapacity = "
               << reqschopt_.scheduleQueueCapacity
               << ", scheduleThreadpoolSize = "
-              << reqschopt_.scheduleThreadpoolSize;
+              << reqschopt_.scheduleThreadpoolSize
+              << ", scheduleDirectDispatch = "
+              << reqschopt_.scheduleDirectDispatch;
     return 0;
 }
 
@@ -89,11 +99,29 @@ int RequestScheduler::Fini() {
 
 int RequestScheduler::ScheduleRequest(const std::list<RequestContext *> requests) {   //NOLINT
     if (running_.load(std::memory_order_acquire)) {
-        /* TODO(wudemiao): 后期考虑 qos */
+        auto zeroIt = std::find_if(requests.begin(), requests.end(),
+            [](RequestContext* req) { return req->zeroRead_; });
+        if (zeroIt != requests.end()) {
+            return ScheduleWithZeroRead(requests);
+        }
+
+        uint64_t now = TimeUtility::GetTimeofDayUs();
         for (auto it : requests) {
-            BBQItem<RequestContext *> req(it);
-            queue_.PutBack(req);
+            it->scheduleTimeUs_ = now;
         }
+
+        // 直接下发模式下在提交者的上下文中发送，不经过队列和调度线程
+        // requests是调用方列表的拷贝，最后一个request发送之后tracker
+        // 可能已经回收了所有request，遍历拷贝的列表不受影响
+        if (CanDispatchDirectly()) {
+            for (auto it : requests) {
+                Dispatch(it);
+            }
+            return 0;
+        }
+
+        /* TODO(wudemiao): 后期考虑 qos */
+        queue_.PutBack(requests.begin(), requests.end());
         return 0;
     }
     return -1;
@@ -101,6 +129,17 @@ int RequestScheduler::ScheduleRequest(const std::list<RequestContext *> requests
 
 int RequestScheduler::ScheduleRequest(RequestContext *request) {
     if (running_.load(std::memory_order_acquire)) {
+        if (request->zeroRead_) {
+            CompleteZeroRead(request);
+            return 0;
+        }
+
+        request->scheduleTimeUs_ = TimeUtility::GetTimeofDayUs();
+        if (CanDispatchDirectly()) {
+            Dispatch(request);
+            return 0;
+        }
+
         BBQItem<RequestContext *> req(request);
         queue_.PutBack(req);
         return 0;
@@ -108,8 +147,44 @@ int RequestScheduler::ScheduleRequest(RequestContext *request) {
     return -1;
 }
 
+int RequestScheduler::ScheduleWithZeroRead(
+    const std::list<RequestContext *>& requests) {
+    std::list<RequestContext *> remote;
+    std::vector<RequestContext *> zeroReads;
+    for (auto it : requests) {
+        if (it->zeroRead_) {
+            zeroReads.push_back(it);
+        } else {
+            remote.push_back(it);
+        }
+    }
+
+    // 先下发需要发送rpc的请求，全0的请求最后完成，
+    // 最后一个请求完成时tracker会回收所有request，之后不再访问
+    if (!remote.empty() && ScheduleRequest(remote) != 0) {
+        return -1;
+    }
+
+    for (auto it : zeroReads) {
+        CompleteZeroRead(it);
+    }
+    return 0;
+}
+
+void RequestScheduler::CompleteZeroRead(RequestContext *req) {
+    DVLOG(9) << "Complete zero read request locally, " << *req;
+
+    // 没有发送rpc也没有获取inflight rpc令牌，直接交给tracker处理
+    req->ZeroReadBuffer();
+    req->done_->SetFailed(0);
+    MetricHelper::IncremZeroReadNum(fileMetric_);
+    req->done_->GetIOTracker()->HandleResponse(req);
+}
+
 int RequestScheduler::ReSchedule(RequestContext *request) {
+    // 重试请求来自rpc回调，始终放回队列由调度线程等待session恢复后下发
     if (running_.load(std::memory_order_acquire)) {
+        request->scheduleTimeUs_ = TimeUtility::GetTimeofDayUs();
         BBQItem<RequestContext *> req(request);
         queue_.PutFront(req);
         return 0;
@@ -139,71 +214,7 @@ void RequestScheduler::Process() {
         WaitValidSession();
         BBQItem<RequestContext *> item = queue_.TakeFront();
         if (!item.IsStop()) {
-            RequestContext *req = item.Item();
-            brpc::ClosureGuard guard(req->done_);
-            switch (req->optype_) {
-                case OpType::READ:
-                    DVLOG(9) << "Processing read request, buf header: "
-                             << " buf: " << *(unsigned int*)req->readBuffer_;
-                    {
-                        req->done_->GetInflightRPCToken();
-                        client_.ReadChunk(req->idinfo_,
-                                        req->seq_,
-                                        req->offset_,
-                                        req->rawlength_,
-                                        req->appliedindex_,
-                                        req->sourceInfo_,
-                                        guard.release());
-                    }
-                    break;
-                case OpType::WRITE:
-                    DVLOG(9) << "Processing write request, buf header: "
-                             << " buf: " << *(unsigned int*)req->writeBuffer_;
-                    {
-                        req->done_->GetInflightRPCToken();
-                        client_.WriteChunk(req->idinfo_,
-                                        req->seq_,
-                                        req->writeBuffer_,
-                                        req->offset_,
-                                        req->rawlength_,
-                                        req->sourceInfo_,
-                                        guard.release());
-                    }
-                    break;
-                case OpType::READ_SNAP:
-                    client_.ReadChunkSnapshot(req->idinfo_,
-                                        req->seq_,
-                                        req->offset_,
-                                        req->rawlength_,
-                                        guard.release());
-                    break;
-                case OpType::DELETE_SNAP:
-                    client_.DeleteChunkSnapshotOrCorrectSn(req->idinfo_,
-                                        req->correctedSeq_,
-                                        guard.release());
-                    break;
-                case OpType::GET_CHUNK_INFO:
-                    client_.GetChunkInfo(req->idinfo_,
-                                        guard.release());
-                    break;
-                case OpType::CREATE_CLONE:
-                    client_.CreateCloneChunk(req->idinfo_,
-                                        req->location_,
-                                        req->seq_,
-                                        req->correctedSeq_,
-                                        req->chunksize_,
-                                        guard.release());
-                    break;
-                case OpType::RECOVER_CHUNK:
-                    client_.RecoverChunk(req->idinfo_,
-                                         req->offset_, req->rawlength_,
-                                         guard.release());
-                    break;
-                default:
-                    /* TODO(wudemiao) 后期整个链路错误发统一了在处理 */
-                    req->done_->SetFailed(-1);
-                    LOG(ERROR) << "unknown op type: OpType::UNKNOWN";
-            }
+            Dispatch(item.Item());
         } else {
             /**
              * 一旦遇到stop item，所有线程都可以退出，因为此时
@@ -214,5 +225,75 @@ void RequestScheduler::Process() {
     }
 }
 
+void RequestScheduler::Dispatch(RequestContext *req) {
+    MetricHelper::ScheduleLatencyRecord(fileMetric_,
+        TimeUtility::GetTimeofDayUs() - req->scheduleTimeUs_);
+
+    brpc::ClosureGuard guard(req->done_);
+    switch (req->optype_) {
+        case OpType::READ:
+            // 读取到IOBuf的请求没有用户buffer，这里不打印buffer内容
+            DVLOG(9) << "Processing read request, " << *req;
+            {
+                req->done_->GetInflightRPCToken();
+                client_.ReadChunk(req->idinfo_,
+                                req->seq_,
+                                req->offset_,
+                                req->rawlength_,
+                                req->appliedindex_,
+                                req->sourceInfo_,
+                                guard.release());
+            }
+            break;
+        case OpType::WRITE:
+            DVLOG(9) << "Processing write request, buf header: "
+                     << " buf: " << *(unsigned int*)req->writeBuffer_;
+            {
+                req->done_->GetInflightRPCToken();
+                client_.WriteChunk(req->idinfo_,
+                                req->seq_,
+                                req->writeBuffer_,
+                                req->offset_,
+                                req->rawlength_,
+                                req->sourceInfo_,
+                                guard.release());
+            }
+            break;
+        case OpType::READ_SNAP:
+            client_.ReadChunkSnapshot(req->idinfo_,
+                                req->seq_,
+                                req->offset_,
+                                req->rawlength_,
+                                guard.release());
+            break;
+        case OpType::DELETE_SNAP:
+            client_.DeleteChunkSnapshotOrCorrectSn(req->idinfo_,
+                                req->correctedSeq_,
+                                guard.release());
+            break;
+        case OpType::GET_CHUNK_INFO:
+            client_.GetChunkInfo(req->idinfo_,
+                                guard.release());
+            break;
+        case OpType::CREATE_CLONE:
+            client_.CreateCloneChunk(req->idinfo_,
+                                req->location_,
+                                req->seq_,
+                                req->correctedSeq_,
+                                req->chunksize_,
+                                guard.release());
+            break;
+        case OpType::RECOVER_CHUNK:
+            client_.RecoverChunk(req->idinfo_,
+                                 req->offset_, req->rawlength_,
+                                 guard.release());
+            break;
+        default:
+            /* TODO(wudemiao) 后期整个链路错误发统一了在处理 */
+            req->done_->SetFailed(-1);
+            LOG(ERROR) << "unknown op type: OpType::UNKNOWN";
+    }
+}
+
 }   // namespace client
 }   // namespace curve
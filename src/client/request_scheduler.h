@@ -51,8 +51,9 @@ class RequestScheduler : public Uncopyable {
     RequestScheduler()
         : running_(false),
           stop_(true),
+          client_(),
           blockingQueue_(true),
-          client_() {}
+          fileMetric_(nullptr) {}
     virtual ~RequestScheduler();
 
     /**
@@ -138,6 +139,32 @@ class RequestScheduler : public Uncopyable {
      */
     void Process();
 
+    /**
+     * 将request下发到对应的chunkserver，并记录其在调度器中的排队时延
+     */
+    void Dispatch(RequestContext *request);
+
+    /**
+     * 请求列表中有已知读出全0的请求时，其余请求正常调度，全0的请求在本地完成
+     * @param requests:请求列表
+     * @return 0成功，-1失败
+     */
+    int ScheduleWithZeroRead(const std::list<RequestContext *>& requests);
+
+    /**
+     * 已知读出全0的请求不发送rpc，填充全0之后直接返回给tracker
+     */
+    void CompleteZeroRead(RequestContext *request);
+
+    /**
+     * 开启直接下发且lease有效时，调用线程直接下发request，不经过队列
+     * lease续约失败时仍然走队列，由WaitValidSession阻塞
+     */
+    bool CanDispatchDirectly() const {
+        return reqschopt_.scheduleDirectDispatch &&
+               !blockIO_.load(std::memory_order_acquire);
+    }
+
     inline void WaitValidSession() {
       // lease续约失败的时候需要阻塞IO直到续约成功
       if (blockIO_.load(std::memory_order_acquire) && blockingQueue_) {
@@ -172,6 +199,8 @@ class RequestScheduler : public Uncopyable {
     std::condition_variable leaseRefreshcv_;
     // 阻塞队列
     bool blockingQueue_;
+    // 文件的metric信息，用于记录调度排队时延
+    FileMetric* fileMetric_;
 };
 
 }   // namespace client
@@ -26,8 +26,10 @@
 #include <algorithm>
 
 #include "proto/chunk.pb.h"
+#include "src/common/crc32.h"
 #include "src/common/timeutility.h"
 #include "src/client/request_closure.h"
+#include "src/client/client_object_pool.h"
 #include "src/common/location_operator.h"
 
 using curve::common::TimeUtility;
@@ -62,7 +64,7 @@ int RequestSender::ReadChunk(ChunkIDInfo idinfo,
     MetricHelper::IncremRPCRPSCount(rc->GetMetric(), OpType::READ);
     rc->SetStartTime(TimeUtility::GetTimeofDayUs());
 
-    brpc::Controller *cntl = new brpc::Controller();
+    brpc::Controller *cntl = ClientObjectPool<brpc::Controller>::Get();
     cntl->set_timeout_ms(
     std::max(rc->GetNextTimeoutMS(),
         iosenderopt_.failRequestOpt.chunkserverRPCTimeoutMS));
@@ -85,8 +87,51 @@ int RequestSender::ReadChunk(ChunkIDInfo idinfo,
         request.set_clonefileoffset(sourceInfo.cloneFileOffset);
     }
 
+    RequestContext* ctx = rc->GetReqCtx();
     if (iosenderopt_.chunkserverEnableAppliedIndexRead && appliedindex > 0) {
         request.set_appliedindex(appliedindex);
+        if (ctx != nullptr && ctx->followerRead_) {
+            request.set_followerread(true);
+        }
+    }
+
+    if (ctx != nullptr && ctx->fileId_ != 0) {
+        request.set_fileid(ctx->fileId_);
+    }
+    if (iosenderopt_.chunkserverEnableChecksum) {
+        request.set_returncrc(true);
+    }
+    ChunkService_Stub stub(&channel_);
+    stub.ReadChunk(cntl, &request, response, doneGuard.release());
+
+    return 0;
+}
+
+int RequestSender::HedgedReadChunk(const HedgedReadContext& hedgedRead,
+                                   HedgedReadClosure *done) {
+    brpc::ClosureGuard doneGuard(done);
+
+    brpc::Controller *cntl = ClientObjectPool<brpc::Controller>::Get();
+    cntl->set_timeout_ms(iosenderopt_.failRequestOpt.chunkserverRPCTimeoutMS);
+    done->SetCntl(cntl);
+    ChunkResponse *response = new ChunkResponse();
+    done->SetResponse(response);
+
+    ChunkRequest request;
+    request.set_optype(curve::chunkserver::CHUNK_OP_TYPE::CHUNK_OP_READ);
+    request.set_logicpoolid(hedgedRead.idinfo.lpid_);
+    request.set_copysetid(hedgedRead.idinfo.cpid_);
+    request.set_chunkid(hedgedRead.idinfo.cid_);
+    request.set_offset(hedgedRead.offset);
+    request.set_size(hedgedRead.length);
+    request.set_appliedindex(hedgedRead.appliedindex);
+    request.set_followerread(true);
+
+    if (hedgedRead.fileId != 0) {
+        request.set_fileid(hedgedRead.fileId);
+    }
+    if (iosenderopt_.chunkserverEnableChecksum) {
+        request.set_returncrc(true);
     }
     ChunkService_Stub stub(&channel_);
     stub.ReadChunk(cntl, &request, response, doneGuard.release());
@@ -109,7 +154,7 @@ int RequestSender::WriteChunk(ChunkIDInfo idinfo,
 
     DVLOG(9) << "Sending request, buf header: "
              << " buf: " << *(unsigned int *)buf;
-    brpc::Controller *cntl = new brpc::Controller();
+    brpc::Controller *cntl = ClientObjectPool<brpc::Controller>::Get();
     cntl->set_timeout_ms(
     std::max(rc->GetNextTimeoutMS(),
         iosenderopt_.failRequestOpt.chunkserverRPCTimeoutMS));
@@ -133,8 +178,27 @@ int RequestSender::WriteChunk(ChunkIDInfo idinfo,
         request.set_clonefileoffset(sourceInfo.cloneFileOffset);
     }
 
-    cntl->request_attachment().append_user_data(
-        const_cast<char*>(buf), length, EmptyDeleter);
+    RequestContext* ctx = rc->GetReqCtx();
+    if (ctx != nullptr && ctx->fileId_ != 0) {
+        request.set_fileid(ctx->fileId_);
+    }
+
+    // 向量化IO的各个片段直接挂到attachment上，不拷贝到连续buffer中
+    if (ctx != nullptr && !ctx->iov_.empty()) {
+        for (const auto& piece : ctx->iov_) {
+            cntl->request_attachment().append_user_data(
+                piece.iov_base, piece.iov_len, EmptyDeleter);
+        }
+    } else {
+        cntl->request_attachment().append_user_data(
+            const_cast<char*>(buf), length, EmptyDeleter);
+    }
+
+    if (iosenderopt_.chunkserverEnableChecksum) {
+        request.set_crc(
+            curve::common::CRC32(0, cntl->request_attachment()));
+    }
+
     ChunkService_Stub stub(&channel_);
     stub.WriteChunk(cntl, &request, response, doneGuard.release());
 
@@ -149,7 +213,7 @@ int RequestSender::ReadChunkSnapshot(ChunkIDInfo idinfo,
     brpc::ClosureGuard doneGuard(done);
 
     RequestClosure* rc = static_cast<RequestClosure*>(done->GetClosure());
-    brpc::Controller *cntl = new brpc::Controller();
+    brpc::Controller *cntl = ClientObjectPool<brpc::Controller>::Get();
     cntl->set_timeout_ms(
     std::max(rc->GetNextTimeoutMS(),
         iosenderopt_.failRequestOpt.chunkserverRPCTimeoutMS));
@@ -177,7 +241,7 @@ int RequestSender::DeleteChunkSnapshotOrCorrectSn(ChunkIDInfo idinfo,
     brpc::ClosureGuard doneGuard(done);
 
     RequestClosure* rc = static_cast<RequestClosure*>(done->GetClosure());
-    brpc::Controller *cntl = new brpc::Controller();
+    brpc::Controller *cntl = ClientObjectPool<brpc::Controller>::Get();
     cntl->set_timeout_ms(
     std::max(rc->GetNextTimeoutMS(),
         iosenderopt_.failRequestOpt.chunkserverRPCTimeoutMS));
@@ -204,7 +268,7 @@ int RequestSender::GetChunkInfo(ChunkIDInfo idinfo,
     brpc::ClosureGuard doneGuard(done);
 
     RequestClosure* rc = static_cast<RequestClosure*>(done->GetClosure());
-    brpc::Controller *cntl = new brpc::Controller();
+    brpc::Controller *cntl = ClientObjectPool<brpc::Controller>::Get();
     cntl->set_timeout_ms(
     std::max(rc->GetNextTimeoutMS(),
         iosenderopt_.failRequestOpt.chunkserverRPCTimeoutMS));
@@ -230,7 +294,7 @@ int RequestSender::CreateCloneChunk(ChunkIDInfo idinfo,
     brpc::ClosureGuard doneGuard(done);
 
     RequestClosure* rc = static_cast<RequestClosure*>(done->GetClosure());
-    brpc::Controller *cntl = new brpc::Controller();
+    brpc::Controller *cntl = ClientObjectPool<brpc::Controller>::Get();
     cntl->set_timeout_ms(
     std::max(rc->GetNextTimeoutMS(),
         iosenderopt_.failRequestOpt.chunkserverRPCTimeoutMS));
@@ -260,7 +324,7 @@ int RequestSender::RecoverChunk(const ChunkIDInfo& idinfo,
     brpc::ClosureGuard doneGuard(done);
 
     RequestClosure* rc = static_cast<RequestClosure*>(done->GetClosure());
-    brpc::Controller *cntl = new brpc::Controller();
+    brpc::Controller *cntl = ClientObjectPool<brpc::Controller>::Get();
     cntl->set_timeout_ms(
     std::max(rc->GetNextTimeoutMS(),
         iosenderopt_.failRequestOpt.chunkserverRPCTimeoutMS));
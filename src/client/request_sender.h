@@ -77,6 +77,15 @@ class RequestSender {
                   const RequestSourceInfo& sourceInfo,
                   ClientClosure *done);
 
+    /**
+     * 发送hedged read的备份读请求，请求携带appliedindex并作为follower read，
+     * 副本的appliedindex落后时会拒绝该请求
+     * @param hedgedRead为本次备份读请求的相关信息
+     * @param done:备份读请求的closure
+     */
+    int HedgedReadChunk(const HedgedReadContext& hedgedRead,
+                        HedgedReadClosure *done);
+
     /**
    * 写Chunk
    * @param idinfo为chunk相关的id信息
@@ -174,6 +183,10 @@ class RequestSender {
     int ResetSender(ChunkServerID chunkServerId,
                     butil::EndPoint serverEndPoint);
 
+    ChunkServerID GetChunkServerID() const {
+        return chunkServerId_;
+    }
+
     bool IsSocketHealth() {
        return channel_.CheckHealth() == 0;
     }
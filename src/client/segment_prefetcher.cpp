@@ -0,0 +1,177 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include "src/client/segment_prefetcher.h"
+
+#include <glog/logging.h>
+
+#include <vector>
+
+#include "src/client/metacache.h"
+#include "src/client/mds_client.h"
+#include "src/client/splitor.h"
+
+namespace curve {
+namespace client {
+
+// 预分配任务队列的容量，队列满时直接放弃本次预分配
+static const int kPrefetchQueueCapacity = 4;
+
+bool SegmentPrefetcher::Init(const SegmentPrefetchOption_t& opt,
+                             MetaCache* mc,
+                             MDSClient* mdsclient,
+                             FileMetric* fileMetric) {
+    opt_ = opt;
+    mc_ = mc;
+    mdsclient_ = mdsclient;
+    fileMetric_ = fileMetric;
+
+    if (!opt_.segmentPrefetchEnable || opt_.segmentPrefetchNum == 0 ||
+        mc_ == nullptr || mdsclient_ == nullptr) {
+        enable_ = false;
+        return true;
+    }
+
+    int ret = prefetchPool_.Start(1, kPrefetchQueueCapacity);
+    if (ret != 0) {
+        LOG(ERROR) << "segment prefetch thread pool start failed!";
+        return false;
+    }
+
+    enable_ = true;
+    return true;
+}
+
+void SegmentPrefetcher::Fini() {
+    if (!enable_) {
+        return;
+    }
+
+    enable_ = false;
+    prefetchPool_.Stop();
+}
+
+bool SegmentPrefetcher::IsSegmentCached(uint64_t segOffset) const {
+    const FInfo_t* fi = mc_->GetFileInfo();
+    ChunkIDInfo_t chunkIdInfo;
+    return mc_->GetChunkInfoByIndex(segOffset / fi->chunksize,
+                                    &chunkIdInfo) == MetaCacheErrorType::OK;
+}
+
+void SegmentPrefetcher::OnWrite(off_t offset, size_t length) {
+    if (!enable_) {
+        return;
+    }
+
+    uint64_t end = offset + length;
+    uint64_t lastEnd = lastWriteEnd_.exchange(end, std::memory_order_relaxed);
+    if (lastEnd != static_cast<uint64_t>(offset)) {
+        return;
+    }
+
+    const FInfo_t* fi = mc_->GetFileInfo();
+    uint64_t segmentSize = fi->segmentsize;
+    uint64_t fileLength = fi->length;
+    if (segmentSize == 0) {
+        return;
+    }
+
+    uint64_t nextSegment = (end + segmentSize - 1) / segmentSize * segmentSize;
+    uint64_t triggerDistance =
+        static_cast<uint64_t>(opt_.segmentPrefetchTriggerDistanceMB) << 20;
+    if (nextSegment - end > triggerDistance) {
+        return;
+    }
+
+    // 跳过已经在metacache中或者正在预分配的segment
+    uint64_t limit = nextSegment + segmentSize * opt_.segmentPrefetchNum;
+    uint64_t start = nextSegment;
+    while (start < limit && start < fileLength) {
+        bool skip = false;
+        {
+            std::lock_guard<std::mutex> lk(inflightMtx_);
+            skip = inflight_.count(start) != 0;
+        }
+        if (!skip && !IsSegmentCached(start)) {
+            break;
+        }
+        start += segmentSize;
+    }
+
+    if (start >= limit || start >= fileLength) {
+        return;
+    }
+
+    uint32_t count = 0;
+    {
+        std::lock_guard<std::mutex> lk(inflightMtx_);
+        for (uint64_t off = start; off < limit && off < fileLength;
+             off += segmentSize) {
+            if (!inflight_.insert(off).second) {
+                break;
+            }
+            ++count;
+        }
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    // 队列满时不阻塞写请求，放弃本次预分配
+    if (!prefetchPool_.TryEnqueue(&SegmentPrefetcher::Prefetch, this,
+                                  start, count)) {
+        std::lock_guard<std::mutex> lk(inflightMtx_);
+        for (uint32_t i = 0; i < count; ++i) {
+            inflight_.erase(start + i * segmentSize);
+        }
+    }
+}
+
+void SegmentPrefetcher::Prefetch(uint64_t start, uint32_t count) {
+    const FInfo_t* fi = mc_->GetFileInfo();
+    std::vector<SegmentInfo> segInfos;
+
+    LIBCURVE_ERROR ret = mdsclient_->GetOrAllocateSegments(
+        true, start, count, fi, &segInfos);
+    if (ret != LIBCURVE_ERROR::OK) {
+        LOG(WARNING) << "prefetch segment failed, filename = " << fi->filename
+                     << ", offset = " << start << ", count = " << count
+                     << ", error = " << ret;
+    } else {
+        uint64_t prefetched = 0;
+        for (const auto& segInfo : segInfos) {
+            if (Splitor::UpdateSegmentInfo(mc_, mdsclient_, segInfo, fi)) {
+                ++prefetched;
+            }
+        }
+        MetricHelper::IncremSegmentPrefetchNum(fileMetric_, prefetched);
+    }
+
+    std::lock_guard<std::mutex> lk(inflightMtx_);
+    for (uint32_t i = 0; i < count; ++i) {
+        inflight_.erase(start + i * static_cast<uint64_t>(fi->segmentsize));
+    }
+}
+
+}   // namespace client
+}   // namespace curve
@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef SRC_CLIENT_SEGMENT_PREFETCHER_H_
+#define SRC_CLIENT_SEGMENT_PREFETCHER_H_
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <mutex>    // NOLINT
+#include <set>
+
+#include "src/client/config_info.h"
+#include "src/client/client_metric.h"
+#include "src/common/uncopyable.h"
+#include "src/common/concurrent/task_thread_pool.h"
+
+namespace curve {
+namespace client {
+
+class MetaCache;
+class MDSClient;
+
+/**
+ * segment异步预分配
+ * 顺序写接近下一个segment边界时，在后台线程中通过一次mds rpc
+ * 批量获取或分配之后的若干个segment，并更新到metacache中，
+ * 这样写到新segment时IO不需要同步等待mds分配segment
+ */
+class SegmentPrefetcher : public curve::common::Uncopyable {
+ public:
+    SegmentPrefetcher()
+        : enable_(false),
+          mc_(nullptr),
+          mdsclient_(nullptr),
+          fileMetric_(nullptr),
+          lastWriteEnd_(0) {}
+
+    ~SegmentPrefetcher() {
+        Fini();
+    }
+
+    /**
+     * 初始化，未开启预分配时不启动后台线程
+     * @param: opt为预分配的配置信息
+     * @param: mc为文件的metacache，预分配的segment信息更新到其中
+     * @param: mdsclient用于与mds通信
+     * @param: fileMetric为文件的metric信息
+     * @return: 成功true，失败false
+     */
+    bool Init(const SegmentPrefetchOption_t& opt,
+              MetaCache* mc,
+              MDSClient* mdsclient,
+              FileMetric* fileMetric);
+
+    /**
+     * 停止后台线程，队列中尚未执行的预分配任务直接丢弃
+     */
+    void Fini();
+
+    /**
+     * 写请求下发时调用，检查是否需要预分配之后的segment
+     * @param: offset为写请求的偏移
+     * @param: length为写请求的长度
+     */
+    void OnWrite(off_t offset, size_t length);
+
+ private:
+    /**
+     * 后台线程执行的预分配任务
+     * @param: start为第一个segment的起始偏移
+     * @param: count为segment个数
+     */
+    void Prefetch(uint64_t start, uint32_t count);
+
+    /**
+     * 判断segment对应的元数据是否已经在metacache中
+     */
+    bool IsSegmentCached(uint64_t segOffset) const;
+
+ private:
+    SegmentPrefetchOption_t opt_;
+    std::atomic<bool> enable_;
+
+    MetaCache* mc_;
+    MDSClient* mdsclient_;
+    FileMetric* fileMetric_;
+
+    // 上一个写请求的结束位置，用于判断是否为顺序写
+    std::atomic<uint64_t> lastWriteEnd_;
+
+    // 正在预分配的segment起始偏移，避免重复提交
+    std::mutex inflightMtx_;
+    std::set<uint64_t> inflight_;
+
+    // 执行预分配任务的后台线程
+    curve::common::TaskThreadPool prefetchPool_;
+};
+
+}   // namespace client
+}   // namespace curve
+
+#endif  // SRC_CLIENT_SEGMENT_PREFETCHER_H_
@@ -23,6 +23,10 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <algorithm>
+#include <iterator>
+#include <map>
+#include <set>
+#include <utility>
 #include <vector>
 #include <string>
 #include "src/client/splitor.h"
@@ -31,9 +35,13 @@
 #include "src/client/request_closure.h"
 #include "src/client/metacache_struct.h"
 #include "src/common/location_operator.h"
+#include "src/common/timeutility.h"
 
 namespace curve {
 namespace client {
+
+using curve::common::TimeUtility;
+
 IOSplitOPtion_t Splitor::iosplitopt_;
 void Splitor::Init(IOSplitOPtion_t ioSplitOpt) {
     iosplitopt_ = ioSplitOpt;
@@ -47,11 +55,16 @@ int Splitor::IO2ChunkRequests(IOTracker* iotracker,
                               size_t length,
                               MDSClient* mdsclient,
                               const FInfo_t* fi) {
-    if (targetlist == nullptr|| data == nullptr || mdsclient == nullptr ||
+    if (targetlist == nullptr || mdsclient == nullptr ||
         mc == nullptr || iotracker == nullptr || fi == nullptr) {
         return -1;
     }
 
+    // 读取到IOBuf时没有用户buffer
+    if (data == nullptr && !iotracker->IsIOBufRead()) {
+        return -1;
+    }
+
     uint64_t chunksize = fi->chunksize;
 
     uint64_t startchunkindex = offset / chunksize;
@@ -77,7 +90,8 @@ int Splitor::IO2ChunkRequests(IOTracker* iotracker,
                  << ", chunkindex = " << startchunkindex
                  << ", endchunkindex = " << endchunkindex;
 
-        if (!AssignInternal(iotracker, mc, targetlist, data + dataoff,
+        const char* buf = data == nullptr ? nullptr : data + dataoff;
+        if (!AssignInternal(iotracker, mc, targetlist, buf,
                             off, len, mdsclient, fi, startchunkindex)) {
             LOG(ERROR)  << "request split failed"
                         << ", off = " << off
@@ -100,6 +114,95 @@ int Splitor::IO2ChunkRequests(IOTracker* iotracker,
     return 0;
 }
 
+int Splitor::IOVec2ChunkRequests(IOTracker* iotracker,
+                                 MetaCache* mc,
+                                 std::list<RequestContext*>* targetlist,
+                                 const struct iovec* iov,
+                                 int iovcnt,
+                                 off_t offset,
+                                 size_t length,
+                                 MDSClient* mdsclient,
+                                 const FInfo_t* fi) {
+    if (targetlist == nullptr || iov == nullptr || iovcnt <= 0) {
+        return -1;
+    }
+
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; ++i) {
+        if (iov[i].iov_base == nullptr && iov[i].iov_len != 0) {
+            LOG(ERROR) << "invalid iov, index = " << i;
+            return -1;
+        }
+        total += iov[i].iov_len;
+    }
+    if (total != length) {
+        LOG(ERROR) << "iov length mismatch, iov total = " << total
+                   << ", length = " << length;
+        return -1;
+    }
+
+    // 只有一段buffer时与连续IO完全相同
+    if (iovcnt == 1) {
+        return IO2ChunkRequests(iotracker, mc, targetlist,
+                                static_cast<const char*>(iov[0].iov_base),
+                                offset, length, mdsclient, fi);
+    }
+
+    // 拆分只依赖offset和length，以第一段buffer为基址先按连续IO拆分，
+    // 拆分出的request在文件内连续且有序，再依次把iov切片分配给各个request
+    auto last = targetlist->empty() ? targetlist->end()
+                                    : std::prev(targetlist->end());
+    int ret = IO2ChunkRequests(iotracker, mc, targetlist,
+                               static_cast<const char*>(iov[0].iov_base),
+                               offset, length, mdsclient, fi);
+    auto first = last == targetlist->end() ? targetlist->begin()
+                                           : std::next(last);
+    AssignIOVec(first, targetlist->end(), iov, iovcnt);
+    return ret;
+}
+
+void Splitor::AssignIOVec(std::list<RequestContext*>::iterator begin,
+                          std::list<RequestContext*>::iterator end,
+                          const struct iovec* iov,
+                          int iovcnt) {
+    int index = 0;
+    size_t inner = 0;
+    for (auto it = begin; it != end; ++it) {
+        RequestContext* req = *it;
+        req->iov_.clear();
+
+        size_t left = req->rawlength_;
+        while (left > 0 && index < iovcnt) {
+            size_t avail = iov[index].iov_len - inner;
+            if (avail == 0) {
+                ++index;
+                inner = 0;
+                continue;
+            }
+
+            size_t piece = std::min(avail, left);
+            struct iovec slice;
+            slice.iov_base = static_cast<char*>(iov[index].iov_base) + inner;
+            slice.iov_len = piece;
+            req->iov_.push_back(slice);
+
+            inner += piece;
+            left -= piece;
+        }
+
+        if (req->iov_.empty()) {
+            continue;
+        }
+
+        char* first = static_cast<char*>(req->iov_.front().iov_base);
+        if (req->optype_ == OpType::WRITE) {
+            req->writeBuffer_ = first;
+        } else {
+            req->readBuffer_ = first;
+        }
+    }
+}
+
 // this offset is begin by chunk
 int Splitor::SingleChunkIO2ChunkRequests(IOTracker* iotracker,
                                         MetaCache* mc,
@@ -109,9 +212,12 @@ int Splitor::SingleChunkIO2ChunkRequests(IOTracker* iotracker,
                                         off_t offset,
                                         uint64_t length,
                                         uint64_t seq) {
-    if (targetlist == nullptr || mc == nullptr ||
-        iotracker == nullptr   || data == nullptr) {
-            return -1;
+    if (targetlist == nullptr || mc == nullptr || iotracker == nullptr) {
+        return -1;
+    }
+
+    if (data == nullptr && !iotracker->IsIOBufRead()) {
+        return -1;
     }
 
     auto max_split_size_bytes = 1024 * iosplitopt_.fileIOSplitMaxSizeKB;
@@ -130,10 +236,11 @@ int Splitor::SingleChunkIO2ChunkRequests(IOTracker* iotracker,
         }
 
         newreqNode->seq_         = seq;
+        const char* buf = data == nullptr ? nullptr : data + off;
         if (iotracker->Optype() == OpType::WRITE) {
-            newreqNode->writeBuffer_ = data + off;
+            newreqNode->writeBuffer_ = buf;
         } else {
-            newreqNode->readBuffer_  = const_cast<char*>(data + off);
+            newreqNode->readBuffer_  = const_cast<char*>(buf);
         }
         // newreqNode->data_        = data + off;
         newreqNode->offset_      = tempoff;
@@ -171,53 +278,48 @@ bool Splitor::AssignInternal(IOTracker* iotracker,
     ChunkIDInfo_t chinfo;
     SegmentInfo segInfo;
     LogicalPoolCopysetIDInfo_t lpcsIDInfo;
+
+    // 开启全0 chunk缓存时，读请求不分配segment，已知读出全0的chunk直接在本地返回
+    bool zeroCache = mc->ZeroChunkCacheEnabled();
+    bool isRead = iotracker->Optype() == OpType::READ;
+    uint64_t zeroEpoch = mc->GetZeroChunkEpoch();
+    if (zeroCache && !isRead) {
+        mc->InvalidateZeroChunk(chunkidx);
+    } else if (zeroCache && mc->IsZeroChunk(chunkidx)) {
+        return AssignZeroRead(iotracker, targetlist, buf, off, len, chunkidx);
+    }
+
     MetaCacheErrorType chunkidxexist = mc->GetChunkInfoByIndex(chunkidx, &chinfo);          // NOLINT
 
     if (chunkidxexist == MetaCacheErrorType::CHUNKINFO_NOT_FOUND) {
-        LIBCURVE_ERROR re = mdsclient->GetOrAllocateSegment(true,
+        // 当前IO需要等待segment分配完成才能继续下发
+        uint64_t startUs = TimeUtility::GetTimeofDayUs();
+        bool allocate = !(zeroCache && isRead);
+        LIBCURVE_ERROR re = mdsclient->GetOrAllocateSegment(allocate,
                                         (off_t)chunkidx * fileinfo->chunksize,
                                         fileinfo,
                                         &segInfo);
+        if (re == LIBCURVE_ERROR::NOT_ALLOCATE && !allocate) {
+            // segment未分配，其中所有chunk都读出全0
+            uint64_t chunksPerSegment =
+                fileinfo->segmentsize / fileinfo->chunksize;
+            ChunkIndex segStartIdx =
+                chunkidx / chunksPerSegment * chunksPerSegment;
+            mc->MarkZeroChunks(segStartIdx, chunksPerSegment, zeroEpoch);
+            return AssignZeroRead(iotracker, targetlist, buf, off, len,
+                                  chunkidx);
+        }
         if (re == LIBCURVE_ERROR::FAILED || re == LIBCURVE_ERROR::AUTHFAIL) {
             LOG(ERROR) << "GetOrAllocateSegment failed! "
                        << "offset = " << chunkidx * fileinfo->chunksize;
             return false;
-        } else {
-            int count = 0;
-            for (auto chunkidinfo : segInfo.chunkvec) {
-                uint64_t index = (segInfo.startoffset +
-                         count * fileinfo->chunksize) / fileinfo->chunksize;
-                mc->UpdateChunkInfoByIndex(index, chunkidinfo);
-                ++count;
-            }
-
-            std::vector<CopysetInfo_t> cpinfoVec;
-            re = mdsclient->GetServerList(segInfo.lpcpIDInfo.lpid,
-                            segInfo.lpcpIDInfo.cpidVec, &cpinfoVec);
-            for (auto cpinfo : cpinfoVec) {
-                for (auto peerinfo : cpinfo.csinfos_) {
-                    mc->AddCopysetIDInfo(peerinfo.chunkserverid_,
-                        CopysetIDInfo(segInfo.lpcpIDInfo.lpid, cpinfo.cpid_));
-                }
-            }
+        }
 
-            if (re == LIBCURVE_ERROR::FAILED) {
-                std::string cpidstr;
-                for (auto id : segInfo.lpcpIDInfo.cpidVec) {
-                    cpidstr.append(std::to_string(id))
-                        .append(",");
-                }
-
-                LOG(ERROR) << "GetServerList failed! "
-                           << "logicpool id = " << segInfo.lpcpIDInfo.lpid
-                           << ", copyset list = " << cpidstr.c_str();
-                return false;
-            } else {
-                for (auto cpinfo : cpinfoVec) {
-                    mc->UpdateCopysetInfo(segInfo.lpcpIDInfo.lpid,
-                    cpinfo.cpid_, cpinfo);
-                }
-            }
+        bool updated = UpdateSegmentInfo(mc, mdsclient, segInfo, fileinfo);
+        MetricHelper::SegmentAllocStallRecord(iotracker->GetFileMetric(),
+            TimeUtility::GetTimeofDayUs() - startUs);
+        if (!updated) {
+            return false;
         }
 
         chunkidxexist = mc->GetChunkInfoByIndex(chunkidx, &chinfo);
@@ -232,6 +334,9 @@ bool Splitor::AssignInternal(IOTracker* iotracker,
 
             for_each(templist.begin(), templist.end(), [&](RequestContext* it) {
                 it->appliedindex_ = appliedindex_;
+                it->fileId_ = fileinfo->id;
+                it->chunkIdx_ = chunkidx;
+                it->zeroChunkEpoch_ = zeroEpoch;
                 it->sourceInfo_ =
                     CalcRequestSourceInfo(iotracker, mc, chunkidx);
             });
@@ -254,6 +359,9 @@ bool Splitor::AssignInternal(IOTracker* iotracker,
             newreqNode->optype_       = iotracker->Optype();
             newreqNode->idinfo_       = chinfo;
             newreqNode->appliedindex_ = appliedindex_;
+            newreqNode->fileId_       = fileinfo->id;
+            newreqNode->chunkIdx_     = chunkidx;
+            newreqNode->zeroChunkEpoch_ = zeroEpoch;
             newreqNode->sourceInfo_ =
                 CalcRequestSourceInfo(iotracker, mc, chunkidx);
             newreqNode->done_->SetIOTracker(iotracker);
@@ -267,15 +375,115 @@ bool Splitor::AssignInternal(IOTracker* iotracker,
     return false;
 }
 
-RequestContext* Splitor::GetInitedRequestContext() {
-    RequestContext* ctx = new (std::nothrow) RequestContext();
-    if (ctx && ctx->Init()) {
-        return ctx;
-    } else {
-        LOG(ERROR) << "Allocate RequestContext Failed!";
-        delete ctx;
-        return nullptr;
+bool Splitor::AssignZeroRead(IOTracker* iotracker,
+                             std::list<RequestContext*>* targetlist,
+                             const char* buf,
+                             off_t off,
+                             size_t len,
+                             ChunkIndex chunkidx) {
+    // 不发送rpc，无需按照最大拆分大小拆分
+    RequestContext* newreqNode = GetInitedRequestContext();
+    if (newreqNode == nullptr) {
+        return false;
+    }
+
+    newreqNode->readBuffer_ = const_cast<char*>(buf);
+    newreqNode->offset_     = off;
+    newreqNode->rawlength_  = len;
+    newreqNode->optype_     = OpType::READ;
+    newreqNode->chunkIdx_   = chunkidx;
+    newreqNode->zeroRead_   = true;
+    newreqNode->done_->SetIOTracker(iotracker);
+    targetlist->push_back(newreqNode);
+
+    DVLOG(9) << "zero read, chunk index = " << chunkidx
+             << ", off = " << off
+             << ", len = " << len;
+    return true;
+}
+
+bool Splitor::UpdateSegmentInfo(MetaCache* mc,
+                                MDSClient* mdsclient,
+                                const SegmentInfo& segInfo,
+                                const FInfo_t* fileinfo) {
+    int count = 0;
+    for (auto chunkidinfo : segInfo.chunkvec) {
+        uint64_t index = (segInfo.startoffset +
+                 count * fileinfo->chunksize) / fileinfo->chunksize;
+        mc->UpdateChunkInfoByIndex(index, chunkidinfo);
+        ++count;
+    }
+
+    return UpdateServerList(mc, mdsclient, segInfo.lpcpIDInfo.lpid,
+                            segInfo.lpcpIDInfo.cpidVec);
+}
+
+bool Splitor::UpdateSegmentInfos(MetaCache* mc,
+                                 MDSClient* mdsclient,
+                                 const std::vector<SegmentInfo>& segInfos,
+                                 const FInfo_t* fileinfo) {
+    // 按逻辑池合并所有segment的copyset，去重后每个逻辑池只获取一次server list
+    std::map<LogicPoolID, std::vector<CopysetID>> lpCopysets;
+    std::set<std::pair<LogicPoolID, CopysetID>> seen;
+    for (const auto& segInfo : segInfos) {
+        int count = 0;
+        for (auto chunkidinfo : segInfo.chunkvec) {
+            uint64_t index = (segInfo.startoffset +
+                     count * fileinfo->chunksize) / fileinfo->chunksize;
+            mc->UpdateChunkInfoByIndex(index, chunkidinfo);
+            ++count;
+        }
+
+        LogicPoolID lpid = segInfo.lpcpIDInfo.lpid;
+        for (auto cpid : segInfo.lpcpIDInfo.cpidVec) {
+            if (seen.emplace(lpid, cpid).second) {
+                lpCopysets[lpid].push_back(cpid);
+            }
+        }
+    }
+
+    for (const auto& item : lpCopysets) {
+        if (!UpdateServerList(mc, mdsclient, item.first, item.second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Splitor::UpdateServerList(MetaCache* mc,
+                               MDSClient* mdsclient,
+                               LogicPoolID lpid,
+                               const std::vector<CopysetID>& cpidVec) {
+    std::vector<CopysetInfo_t> cpinfoVec;
+    LIBCURVE_ERROR re = mdsclient->GetServerList(lpid, cpidVec, &cpinfoVec);
+    for (auto cpinfo : cpinfoVec) {
+        for (auto peerinfo : cpinfo.csinfos_) {
+            mc->AddCopysetIDInfo(peerinfo.chunkserverid_,
+                CopysetIDInfo(lpid, cpinfo.cpid_));
+        }
     }
+
+    if (re == LIBCURVE_ERROR::FAILED) {
+        std::string cpidstr;
+        for (auto id : cpidVec) {
+            cpidstr.append(std::to_string(id))
+                .append(",");
+        }
+
+        LOG(ERROR) << "GetServerList failed! "
+                   << "logicpool id = " << lpid
+                   << ", copyset list = " << cpidstr.c_str();
+        return false;
+    }
+
+    for (auto cpinfo : cpinfoVec) {
+        mc->UpdateCopysetInfo(lpid, cpinfo.cpid_, cpinfo);
+    }
+    return true;
+}
+
+RequestContext* Splitor::GetInitedRequestContext() {
+    return RequestContext::NewInitedRequestContext();
 }
 
 RequestSourceInfo Splitor::CalcRequestSourceInfo(IOTracker* ioTracker,
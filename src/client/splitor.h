@@ -22,8 +22,11 @@
 #ifndef SRC_CLIENT_SPLITOR_H_
 #define SRC_CLIENT_SPLITOR_H_
 
+#include <sys/uio.h>
+
 #include <list>
 #include <string>
+#include <vector>
 
 #include "src/client/metacache.h"
 #include "src/client/io_tracker.h"
@@ -57,6 +60,29 @@ class Splitor {
                            size_t length,
                            MDSClient* mdsclient,
                            const FInfo_t* fi);
+    /**
+     * 向量化用户IO拆分成Chunk级别的IO，拆分规则与IO2ChunkRequests相同，
+     * 单个request可以跨越多个iov，其数据片段记录在RequestContext::iov_中
+     * @param: iotracker大IO上下文信息
+     * @param: mc是io拆分过程中需要使用的缓存信息
+     * @param: targetlist大IO被拆分之后的小IO存储列表
+     * @param: iov是用户buffer数组
+     * @param: iovcnt是iov的个数
+     * @param: offset用户下发IO的起始偏移
+     * @param: length数据长度，需要等于iov长度之和
+     * @param: mdsclient在查找metacahe失败时，通过mdsclient查找信息
+     * @param: fi存储当前IO的一些基本信息，比如chunksize等
+     */
+    static int IOVec2ChunkRequests(IOTracker* iotracker,
+                           MetaCache* mc,
+                           std::list<RequestContext*>* targetlist,
+                           const struct iovec* iov,
+                           int iovcnt,
+                           off_t offset,
+                           size_t length,
+                           MDSClient* mdsclient,
+                           const FInfo_t* fi);
+
     /**
      * 对单ChunkIO进行细粒度拆分
      * @param: iotracker大IO上下文信息
@@ -88,6 +114,34 @@ class Splitor {
                                                    MetaCache* metaCache,
                                                    ChunkIndex chunkIdx);
 
+    /**
+     * @brief 将从mds获取的segment信息更新到metacache，
+     *        并获取segment内copyset的server list
+     * @param mc 文件缓存信息
+     * @param mdsclient 用于获取copyset的server list
+     * @param segInfo 从mds获取的segment信息
+     * @param fi 文件基本信息
+     * @return 成功返回true，获取server list失败返回false
+     */
+    static bool UpdateSegmentInfo(MetaCache* mc,
+                                  MDSClient* mdsclient,
+                                  const SegmentInfo& segInfo,
+                                  const FInfo_t* fi);
+
+    /**
+     * @brief 批量将从mds获取的segment信息更新到metacache，
+     *        同一个逻辑池内的copyset只获取一次server list
+     * @param mc 文件缓存信息
+     * @param mdsclient 用于获取copyset的server list
+     * @param segInfos 从mds获取的segment信息
+     * @param fi 文件基本信息
+     * @return 成功返回true，获取server list失败返回false
+     */
+    static bool UpdateSegmentInfos(MetaCache* mc,
+                                   MDSClient* mdsclient,
+                                   const std::vector<SegmentInfo>& segInfos,
+                                   const FInfo_t* fi);
+
  private:
     /**
      * IO2ChunkRequests内部会调用这个函数，进行真正的拆分操作
@@ -111,6 +165,46 @@ class Splitor {
                            const FInfo_t* fi,
                            ChunkIndex chunkidx);
 
+    /**
+     * 为已知读出全0的chunk生成一个读请求，由调度器在本地直接返回全0
+     * @param: iotracker大IO上下文信息
+     * @param: targetlist大IO被拆分之后的小IO存储列表
+     * @param: data是待读取的用户buffer
+     * @param: offset是当前chunk内的偏移
+     * @param: length数据长度
+     * @param: chunkidx是当前chunk在vdisk中的索引值
+     */
+    /**
+     * 获取一个逻辑池内一组copyset的server list并更新到metacache
+     * @param: mc是文件缓存信息
+     * @param: mdsclient用于获取copyset的server list
+     * @param: lpid是逻辑池id
+     * @param: cpidVec是copyset id列表
+     * @return: 成功返回true，获取server list失败返回false
+     */
+    static bool UpdateServerList(MetaCache* mc,
+                                 MDSClient* mdsclient,
+                                 LogicPoolID lpid,
+                                 const std::vector<CopysetID>& cpidVec);
+
+    static bool AssignZeroRead(IOTracker* iotracker,
+                               std::list<RequestContext*>* targetlist,
+                               const char* data,
+                               off_t offset,
+                               size_t length,
+                               ChunkIndex chunkidx);
+
+    /**
+     * 按顺序将iov切片分配给拆分出的request
+     * @param: begin/end是待分配的request范围，request在文件内连续且有序
+     * @param: iov是用户buffer数组
+     * @param: iovcnt是iov的个数
+     */
+    static void AssignIOVec(std::list<RequestContext*>::iterator begin,
+                            std::list<RequestContext*>::iterator end,
+                            const struct iovec* iov,
+                            int iovcnt);
+
     static RequestContext* GetInitedRequestContext();
 
  private:
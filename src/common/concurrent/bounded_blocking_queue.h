@@ -99,6 +99,30 @@ class BoundedBlockingDeque : public Uncopyable {
         notEmpty_.notify_one();
     }
 
+    /**
+     * 批量放入队尾，整批只加一次锁，队列满时等待空位后继续放入
+     * @param: begin/end为待放入元素的范围，元素需要能够构造出T
+     */
+    template<typename Iterator>
+    void PutBack(Iterator begin, Iterator end) {
+        std::unique_lock<std::mutex> guard(mutex_);
+        size_t count = 0;
+        for (; begin != end; ++begin) {
+            while (deque_.size() == capacity_) {
+                notEmpty_.notify_all();
+                notFull_.wait(guard);
+            }
+            deque_.emplace_back(*begin);
+            ++count;
+        }
+
+        if (count == 1) {
+            notEmpty_.notify_one();
+        } else if (count > 1) {
+            notEmpty_.notify_all();
+        }
+    }
+
     void PutFront(const T &x) {
         std::unique_lock<std::mutex> guard(mutex_);
         while (deque_.size() == capacity_) {
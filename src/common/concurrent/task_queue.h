@@ -45,14 +45,14 @@ class TaskQueue {
         auto task = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
         std::unique_lock<std::mutex> lk(mtx_);
         notfullcv_.wait(lk, [this]()->bool{return this->tasks_.size() < this->capacity_;});     // NOLINT
-        tasks_.push(task);
+        tasks_.push(std::move(task));
         notemptycv_.notify_one();
     };                                                                                          // NOLINT
 
     Task Pop() {
         std::unique_lock<std::mutex> lk(mtx_);
         notemptycv_.wait(lk, [this]()->bool{return this->tasks_.size() > 0;});                  // NOLINT
-        Task t = tasks_.front();
+        Task t = std::move(tasks_.front());
         tasks_.pop();
         notfullcv_.notify_one();
         return t;
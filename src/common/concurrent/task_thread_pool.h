@@ -72,6 +72,13 @@ class TaskThreadPool : public Uncopyable {
     template<class F, class... Args>
     void Enqueue(F &&f, Args &&... args);
 
+    /**
+     * 与Enqueue相同，但是队列满时不阻塞，直接返回
+     * @return 成功 push 进队列返回 true，队列满返回 false
+     */
+    template<class F, class... Args>
+    bool TryEnqueue(F &&f, Args &&... args);
+
     /* 返回线程池 queue 的容量 */
     int QueueCapacity() const;
     /* 返回线程池当前 queue 中的 task 数量，线程安全 */
@@ -108,6 +115,18 @@ void TaskThreadPool::Enqueue(F &&f, Args &&... args) {
     notEmpty_.notify_one();
 }
 
+template<class F, class... Args>
+bool TaskThreadPool::TryEnqueue(F &&f, Args &&... args) {
+    std::unique_lock<std::mutex> guard(mutex_);
+    if (IsFullUnlock()) {
+        return false;
+    }
+    auto task = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
+    queue_.push_back(std::move(task));
+    notEmpty_.notify_one();
+    return true;
+}
+
 }  // namespace common
 }  // namespace curve
 
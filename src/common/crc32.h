@@ -27,6 +27,7 @@
 #include <sys/types.h>
 
 #include <butil/crc32c.h>
+#include <butil/iobuf.h>
 
 namespace curve {
 namespace common {
@@ -54,6 +55,22 @@ inline uint32_t CRC32(uint32_t crc, const char *pData, size_t iLen) {
     return butil::crc32c::Extend(crc, pData, iLen);
 }
 
+/**
+ * 计算IOBuf数据的CRC32校验码(CRC32C)，按照IOBuf底层的block依次继承式计算，
+ * 不需要将数据拷贝到连续的内存中
+ * @param crc 起始的crc校验码
+ * @param buf 待计算的数据
+ * @return 32位的数据CRC32校验码
+ */
+inline uint32_t CRC32(uint32_t crc, const butil::IOBuf &buf) {
+    const size_t blockNum = buf.backing_block_num();
+    for (size_t i = 0; i < blockNum; ++i) {
+        butil::StringPiece block = buf.backing_block(i);
+        crc = butil::crc32c::Extend(crc, block.data(), block.size());
+    }
+    return crc;
+}
+
 }  // namespace common
 }  // namespace curve
 
@@ -100,6 +100,7 @@ bool CurveFS::Init(std::shared_ptr<NameServerStorage> storage,
     rootAuthOptions_ = curveFSOptions.authOptions;
 
     defaultChunkSize_ = curveFSOptions.defaultChunkSize;
+    maxSegmentsPerRequest_ = curveFSOptions.maxSegmentsPerRequest;
     topology_ = topology;
 
     InitRootFile();
@@ -886,6 +887,59 @@ StatusCode CurveFS::GetOrAllocateSegment(const std::string & filename,
         return StatusCode::kParaError;
     }
 
+    return GetOrAllocateSegmentOfFile(fileInfo, offset, allocateIfNoExist,
+                                      segment);
+}
+
+StatusCode CurveFS::GetOrAllocateSegments(const std::string & filename,
+        offset_t offset, uint32_t count, bool allocateIfNoExist,
+        std::vector<PageFileSegment> *segments) {
+    assert(segments != nullptr);
+
+    // 整批segment都在文件写锁下获取和分配，限制一次请求的segment个数
+    if (count == 0 || count > maxSegmentsPerRequest_) {
+        LOG(INFO) << "segment count " << count << " is invalid, max = "
+                  << maxSegmentsPerRequest_;
+        return StatusCode::kParaError;
+    }
+
+    FileInfo  fileInfo;
+    auto ret = GetFileInfo(filename, &fileInfo);
+    if (ret != StatusCode::kOK) {
+        LOG(INFO) << "get source file error, errCode = " << ret;
+        return  ret;
+    }
+
+    if (fileInfo.filetype() != FileType::INODE_PAGEFILE) {
+        LOG(INFO) << "not pageFile, can't do this";
+        return StatusCode::kParaError;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        offset_t segOffset =
+            offset + static_cast<uint64_t>(i) * fileInfo.segmentsize();
+        // 第一个segment需要合法，之后超出文件长度的segment直接忽略
+        if (i > 0 && segOffset + fileInfo.segmentsize() > fileInfo.length()) {
+            break;
+        }
+
+        PageFileSegment segment;
+        ret = GetOrAllocateSegmentOfFile(fileInfo, segOffset,
+                                         allocateIfNoExist, &segment);
+        if (ret == StatusCode::kSegmentNotAllocated) {
+            continue;
+        } else if (ret != StatusCode::kOK) {
+            return ret;
+        }
+        segments->push_back(std::move(segment));
+    }
+
+    return StatusCode::kOK;
+}
+
+StatusCode CurveFS::GetOrAllocateSegmentOfFile(const FileInfo& fileInfo,
+        offset_t offset, bool allocateIfNoExist,
+        PageFileSegment *segment) {
     if (offset % fileInfo.segmentsize() != 0) {
         LOG(INFO) << "offset not align with segment";
         return StatusCode::kParaError;
@@ -901,7 +955,8 @@ StatusCode CurveFS::GetOrAllocateSegment(const std::string & filename,
         return StatusCode::kOK;
     } else if (storeRet == StoreStatus::KeyNotExist) {
         if (allocateIfNoExist == false) {
-            LOG(INFO) << "file = " << filename <<", segment offset = " << offset
+            LOG(INFO) << "file = " << fileInfo.filename()
+                      << ", segment offset = " << offset
                       << ", not allocated";
             return  StatusCode::kSegmentNotAllocated;
         } else {
@@ -1773,6 +1828,10 @@ uint64_t CurveFS::GetDefaultChunkSize() {
     return defaultChunkSize_;
 }
 
+uint32_t CurveFS::GetMaxSegmentsPerRequest() {
+    return maxSegmentsPerRequest_;
+}
+
 CurveFS &kCurveFS = CurveFS::GetInstance();
 
 uint64_t GetOpenFileNum(void *varg) {
@@ -51,6 +51,8 @@ struct RootAuthOption {
 
 struct CurveFSOption {
     uint64_t defaultChunkSize;
+    // 一次GetOrAllocateSegments请求最多获取的segment个数
+    uint32_t maxSegmentsPerRequest = 256;
     RootAuthOption authOptions;
     FileRecordOptions fileRecordOptions;
 };
@@ -212,6 +214,23 @@ class CurveFS {
         offset_t offset,
         bool allocateIfNoExist, PageFileSegment *segment);
 
+    /**
+     *  @brief 批量查询从offset开始的连续count个segment，超出文件长度的segment忽略
+     *  @param filename：文件名
+     *         offset: 第一个segment的偏移
+     *         count: segment的个数
+     *         allocateIfNoExist：如果segment不存在，是否需要创建新的segment，
+     *                            为false时不存在的segment不返回
+     *         segments：返回查询到的segment信息
+     *  @return 是否成功，成功返回StatusCode::kOK
+     */
+    StatusCode GetOrAllocateSegments(
+        const std::string & filename,
+        offset_t offset,
+        uint32_t count,
+        bool allocateIfNoExist,
+        std::vector<PageFileSegment> *segments);
+
     /**
      *  @brief 获取root文件信息
      *  @param
@@ -456,6 +475,12 @@ class CurveFS {
      */
     uint64_t GetDefaultChunkSize();
 
+    /**
+     *  @brief 获取一次GetOrAllocateSegments请求最多获取的segment个数
+     *  @return 返回maxSegmentsPerRequest配置
+     */
+    uint32_t GetMaxSegmentsPerRequest();
+
  private:
     CurveFS() = default;
 
@@ -574,6 +599,19 @@ class CurveFS {
                                 AllocatedSize* allocSize);
 
  private:
+    /**
+     *  @brief 查询文件的一个segment，不存在时根据allocateIfNoExist决定是否分配
+     *  @param: fileInfo 文件信息，需要为pagefile
+     *  @param: offset segment的偏移
+     *  @param: allocateIfNoExist 如果segment不存在，是否需要创建新的segment
+     *  @param[out]: segment 返回查询到的segment信息
+     *  @return 是否成功，成功返回StatusCode::kOK
+     */
+    StatusCode GetOrAllocateSegmentOfFile(const FileInfo& fileInfo,
+                                          offset_t offset,
+                                          bool allocateIfNoExist,
+                                          PageFileSegment *segment);
+
     FileInfo rootFileInfo_;
     std::shared_ptr<NameServerStorage> storage_;
     std::shared_ptr<InodeIDGenerator> InodeIDGenerator_;
@@ -585,6 +623,7 @@ class CurveFS {
     struct RootAuthOption       rootAuthOptions_;
 
     uint64_t defaultChunkSize_;
+    uint32_t maxSegmentsPerRequest_;
     std::chrono::steady_clock::time_point startTime_;
 };
 extern CurveFS &kCurveFS;
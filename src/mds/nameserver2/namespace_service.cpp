@@ -336,6 +336,101 @@ void NameSpaceService::GetOrAllocateSegment(
     return;
 }
 
+void NameSpaceService::GetOrAllocateSegments(
+                    ::google::protobuf::RpcController* controller,
+                    const ::curve::mds::GetOrAllocateSegmentsRequest* request,
+                    ::curve::mds::GetOrAllocateSegmentsResponse* response,
+                    ::google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+
+    if (!isPathValid(request->filename())) {
+        response->set_statuscode(StatusCode::kParaError);
+        LOG(ERROR) << "logid = " << cntl->log_id()
+            << ", GetOrAllocateSegments request path is invalid, filename = "
+            << request->filename()
+            << ", offset = " << request->offset()
+            << ", count = " << request->count()
+            << ", allocateTag = " << request->allocateifnotexist();
+        return;
+    }
+
+    LOG(INFO) << "logid = " << cntl->log_id()
+        << ", GetOrAllocateSegments request, filename = "
+        << request->filename()
+        << ", offset = " << request->offset()
+        << ", count = " << request->count()
+        << ", allocateTag = " << request->allocateifnotexist();
+
+    FileWriteLockGuard guard(fileLockManager_, request->filename());
+
+    std::string signature;
+    if (request->has_signature()) {
+        signature = request->signature();
+    }
+
+    StatusCode retCode;
+    retCode = kCurveFS.CheckFileOwner(request->filename(), request->owner(),
+                                      signature, request->date());
+    if (retCode != StatusCode::kOK) {
+        response->set_statuscode(retCode);
+        if (google::ERROR != GetMdsLogLevel(retCode)) {
+            LOG(WARNING) << "logid = " << cntl->log_id()
+                << ", CheckFileOwner fail, filename = " <<  request->filename()
+                << ", owner = " << request->owner()
+                << ", statusCode = " << retCode;
+        } else {
+            LOG(ERROR) << "logid = " << cntl->log_id()
+                << ", CheckFileOwner fail, filename = " <<  request->filename()
+                << ", owner = " << request->owner()
+                << ", statusCode = " << retCode;
+        }
+        return;
+    }
+
+    std::vector<PageFileSegment> segments;
+    retCode = kCurveFS.GetOrAllocateSegments(request->filename(),
+                request->offset(),
+                request->count(),
+                request->allocateifnotexist(),
+                &segments);
+
+    if (retCode != StatusCode::kOK)  {
+        response->set_statuscode(retCode);
+        if (google::ERROR != GetMdsLogLevel(retCode)) {
+            LOG(WARNING) << "logid = " << cntl->log_id()
+                << ", GetOrAllocateSegments fail, filename = "
+                <<  request->filename()
+                << ", offset = " << request->offset()
+                << ", count = " << request->count()
+                << ", allocateTag = " << request->allocateifnotexist()
+                << ", statusCode = " << retCode
+                << ", StatusCode_Name = " << StatusCode_Name(retCode);
+        } else {
+            LOG(ERROR) << "logid = " << cntl->log_id()
+                << ", GetOrAllocateSegments fail, filename = "
+                <<  request->filename()
+                << ", offset = " << request->offset()
+                << ", count = " << request->count()
+                << ", allocateTag = " << request->allocateifnotexist()
+                << ", statusCode = " << retCode
+                << ", StatusCode_Name = " << StatusCode_Name(retCode);
+        }
+    } else {
+        response->set_statuscode(StatusCode::kOK);
+        for (auto& segment : segments) {
+            response->add_pagefilesegments()->Swap(&segment);
+        }
+        LOG(INFO) << "logid = " << cntl->log_id()
+            << ", GetOrAllocateSegments ok, filename = " << request->filename()
+            << ", offset = " << request->offset()
+            << ", count = " << request->count()
+            << ", segment num = " << response->pagefilesegments_size()
+            << ", allocateTag = " << request->allocateifnotexist();
+    }
+    return;
+}
+
 void NameSpaceService::RenameFile(::google::protobuf::RpcController* controller,
                          const ::curve::mds::RenameFileRequest* request,
                          ::curve::mds::RenameFileResponse* response,
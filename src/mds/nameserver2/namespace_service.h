@@ -89,6 +89,11 @@ class NameSpaceService: public CurveFSService {
                        ::curve::mds::GetOrAllocateSegmentResponse* response,
                        ::google::protobuf::Closure* done) override;
 
+    void GetOrAllocateSegments(::google::protobuf::RpcController* controller,
+                       const ::curve::mds::GetOrAllocateSegmentsRequest* request,
+                       ::curve::mds::GetOrAllocateSegmentsResponse* response,
+                       ::google::protobuf::Closure* done) override;
+
     void RenameFile(::google::protobuf::RpcController* controller,
                        const ::curve::mds::RenameFileRequest* request,
                        ::curve::mds::RenameFileResponse* response,
@@ -458,6 +458,12 @@ void MDS::InitAuthOptions(RootAuthOption *authOptions) {
 void MDS::InitCurveFSOptions(CurveFSOption *curveFSOptions) {
     conf_->GetValueFatalIfFail(
         "mds.curvefs.defaultChunkSize", &curveFSOptions->defaultChunkSize);
+    if (!conf_->GetUInt32Value("mds.curvefs.maxSegmentsPerRequest",
+                               &curveFSOptions->maxSegmentsPerRequest)) {
+        LOG(WARNING) << "config no mds.curvefs.maxSegmentsPerRequest info, "
+                     << "using default value "
+                     << curveFSOptions->maxSegmentsPerRequest;
+    }
     FileRecordOptions fileRecordOptions;
     InitFileRecordOptions(&curveFSOptions->fileRecordOptions);
 
@@ -0,0 +1,384 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+/**
+ * chunkserver datastore和apply路径的性能基准测试，用于衡量datastore相关优化的效果
+ * 运行方式:
+ *   bazel run //test/chunkserver/benchmark:datastore_benchmark -- \
+ *       --fs_type=memory --benchmark_out=result.json \
+ *       --benchmark_out_format=json --benchmark_repetitions=5
+ * fs_type=memory时数据放在内存中，只衡量datastore本身的开销；
+ * fs_type=ext4时数据放在bench_dir下，bench_dir应为tmpfs或loop设备的挂载点，
+ * 避免结果受到物理盘波动的影响
+ */
+
+#include <benchmark/benchmark.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/chunkserver/concurrent_apply.h"
+#include "src/chunkserver/datastore/chunkfile_pool.h"
+#include "src/chunkserver/datastore/chunkserver_datastore.h"
+#include "src/fs/local_filesystem.h"
+#include "test/chunkserver/benchmark/mem_local_filesystem.h"
+#include "test/chunkserver/datastore/chunkfilepool_helper.h"
+
+DEFINE_string(fs_type, "memory", "file system used by benchmark, "
+              "memory or ext4");
+DEFINE_string(bench_dir, "/dev/shm/curve_datastore_benchmark",
+              "work directory when fs_type is ext4, should be tmpfs "
+              "or a loop device");
+DEFINE_uint32(chunk_size, 16 * 1024 * 1024, "chunk size");
+DEFINE_uint32(pool_chunks, 16, "preallocated chunks in chunkfile pool");
+
+namespace curve {
+namespace chunkserver {
+
+using curve::fs::FileSystemType;
+using curve::fs::LocalFsFactory;
+
+namespace {
+
+const PageSizeType kPageSize = 4096;
+const uint32_t kLocationLimit = 3000;
+const char kCloneLocation[] = "/benchmark/origin@cs";
+// 固定随机种子，保证每次运行访问的位置相同
+const uint32_t kRandomSeed = 20201018;
+
+/**
+ * 每个benchmark使用独立的文件系统目录、chunkfilepool和datastore，
+ * 构造和析构不计入测试时间
+ */
+class BenchmarkEnv {
+ public:
+    BenchmarkEnv() {
+        if (FLAGS_fs_type == "ext4") {
+            lfs_ = LocalFsFactory::CreateFs(FileSystemType::EXT4, "");
+            workDir_ = FLAGS_bench_dir;
+        } else {
+            CHECK(FLAGS_fs_type == "memory")
+                << "unknown fs type: " << FLAGS_fs_type;
+            lfs_ = std::make_shared<MemLocalFileSystem>();
+            workDir_ = "/benchmark";
+        }
+        CHECK(lfs_ != nullptr) << "create local file system failed";
+        if (lfs_->DirExists(workDir_)) {
+            lfs_->Delete(workDir_);
+        }
+        CHECK_EQ(0, lfs_->Mkdir(workDir_));
+
+        std::string poolDir = workDir_ + "/chunkfilepool";
+        std::string poolMetaPath = workDir_ + "/chunkfilepool.meta";
+        allocateChunk(lfs_, FLAGS_pool_chunks, poolDir, FLAGS_chunk_size);
+        CHECK_EQ(0, ChunkfilePoolHelper::PersistEnCodeMetaInfo(lfs_,
+            FLAGS_chunk_size, kPageSize, poolDir, poolMetaPath));
+        ChunkfilePoolOptions poolOptions;
+        poolOptions.chunkSize = FLAGS_chunk_size;
+        poolOptions.metaPageSize = kPageSize;
+        memcpy(poolOptions.metaPath, poolMetaPath.c_str(),
+               poolMetaPath.size());
+        chunkfilePool_ = std::make_shared<ChunkfilePool>(lfs_);
+        CHECK(chunkfilePool_->Initialize(poolOptions))
+            << "init chunkfile pool failed";
+
+        DataStoreOptions options;
+        options.baseDir = workDir_ + "/data";
+        options.chunkSize = FLAGS_chunk_size;
+        options.pageSize = kPageSize;
+        options.locationLimit = kLocationLimit;
+        dataStore_ = std::make_shared<CSDataStore>(lfs_,
+                                                   chunkfilePool_,
+                                                   options);
+        CHECK(dataStore_->Initialize()) << "init datastore failed";
+    }
+
+    ~BenchmarkEnv() {
+        dataStore_ = nullptr;
+        chunkfilePool_->UnInitialize();
+        lfs_->Delete(workDir_);
+    }
+
+    // 创建chunk并写满，之后的读写不再包含创建chunk的开销
+    void PrepareChunk(ChunkID id, SequenceNum sn) {
+        std::vector<char> buf(kMaxPrepareSize, 'a');
+        for (uint64_t off = 0; off < FLAGS_chunk_size;
+             off += kMaxPrepareSize) {
+            CHECK(CSErrorCode::Success ==
+                  dataStore_->WriteChunk(id, sn, buf.data(), off,
+                                         kMaxPrepareSize, nullptr));
+        }
+    }
+
+    std::shared_ptr<CSDataStore> DataStore() {
+        return dataStore_;
+    }
+
+    std::shared_ptr<ChunkfilePool> Pool() {
+        return chunkfilePool_;
+    }
+
+    std::string ChunkPath(ChunkID id) {
+        return workDir_ + "/data/chunk_" + std::to_string(id);
+    }
+
+ private:
+    static const uint32_t kMaxPrepareSize = 1024 * 1024;
+
+    std::string workDir_;
+    std::shared_ptr<LocalFileSystem> lfs_;
+    std::shared_ptr<ChunkfilePool> chunkfilePool_;
+    std::shared_ptr<CSDataStore> dataStore_;
+};
+
+// 在chunk范围内按照io大小对齐的随机偏移
+off_t RandomOffset(unsigned int* seed, size_t length) {
+    uint64_t slots = FLAGS_chunk_size / length;
+    return (rand_r(seed) % slots) * length;
+}
+
+void SetIOCounters(benchmark::State& state, size_t length) {
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * length);
+}
+
+}  // namespace
+
+static void BM_DataStoreWrite(benchmark::State& state) {
+    BenchmarkEnv env;
+    const ChunkID id = 1;
+    const SequenceNum sn = 1;
+    env.PrepareChunk(id, sn);
+    size_t length = state.range(0);
+    std::vector<char> buf(length, 'b');
+    unsigned int seed = kRandomSeed;
+    for (auto _ : state) {
+        CSErrorCode ret = env.DataStore()->WriteChunk(id, sn, buf.data(),
+            RandomOffset(&seed, length), length, nullptr);
+        if (ret != CSErrorCode::Success) {
+            state.SkipWithError("write chunk failed");
+            break;
+        }
+    }
+    SetIOCounters(state, length);
+}
+BENCHMARK(BM_DataStoreWrite)->RangeMultiplier(4)->Range(4 << 10, 1 << 20);
+
+static void BM_DataStoreRead(benchmark::State& state) {
+    BenchmarkEnv env;
+    const ChunkID id = 1;
+    const SequenceNum sn = 1;
+    env.PrepareChunk(id, sn);
+    size_t length = state.range(0);
+    std::vector<char> buf(length);
+    unsigned int seed = kRandomSeed;
+    for (auto _ : state) {
+        CSErrorCode ret = env.DataStore()->ReadChunk(id, sn, buf.data(),
+            RandomOffset(&seed, length), length);
+        if (ret != CSErrorCode::Success) {
+            state.SkipWithError("read chunk failed");
+            break;
+        }
+    }
+    SetIOCounters(state, length);
+}
+BENCHMARK(BM_DataStoreRead)->RangeMultiplier(4)->Range(4 << 10, 1 << 20);
+
+/**
+ * 打快照之后第一次写每个page都会触发cow；
+ * 所有page都cow过之后删除快照并升高版本号，开始新一轮cow
+ */
+static void BM_DataStoreCowWrite(benchmark::State& state) {
+    BenchmarkEnv env;
+    const ChunkID id = 1;
+    SequenceNum sn = 1;
+    env.PrepareChunk(id, sn);
+    size_t length = state.range(0);
+    std::vector<char> buf(length, 'c');
+    off_t offset = FLAGS_chunk_size;
+    for (auto _ : state) {
+        if (offset + length > FLAGS_chunk_size) {
+            state.PauseTiming();
+            CHECK(CSErrorCode::Success ==
+                  env.DataStore()->DeleteSnapshotChunkOrCorrectSn(id, sn));
+            ++sn;
+            offset = 0;
+            state.ResumeTiming();
+        }
+        CSErrorCode ret = env.DataStore()->WriteChunk(id, sn, buf.data(),
+            offset, length, nullptr);
+        if (ret != CSErrorCode::Success) {
+            state.SkipWithError("cow write chunk failed");
+            break;
+        }
+        offset += length;
+    }
+    SetIOCounters(state, length);
+}
+BENCHMARK(BM_DataStoreCowWrite)->RangeMultiplier(4)->Range(4 << 10, 1 << 20);
+
+/**
+ * 向clone chunk中paste数据，chunk全部paste过之后重新创建clone chunk
+ */
+static void BM_DataStorePaste(benchmark::State& state) {
+    BenchmarkEnv env;
+    const ChunkID id = 1;
+    const SequenceNum sn = 1;
+    size_t length = state.range(0);
+    std::vector<char> buf(length, 'd');
+    off_t offset = FLAGS_chunk_size;
+    for (auto _ : state) {
+        if (offset + length > FLAGS_chunk_size) {
+            state.PauseTiming();
+            env.DataStore()->DeleteChunk(id, sn);
+            CHECK(CSErrorCode::Success ==
+                  env.DataStore()->CreateCloneChunk(id, sn, 0,
+                      FLAGS_chunk_size, kCloneLocation));
+            offset = 0;
+            state.ResumeTiming();
+        }
+        CSErrorCode ret = env.DataStore()->PasteChunk(id, buf.data(),
+                                                      offset, length);
+        if (ret != CSErrorCode::Success) {
+            state.SkipWithError("paste chunk failed");
+            break;
+        }
+        offset += length;
+    }
+    SetIOCounters(state, length);
+}
+BENCHMARK(BM_DataStorePaste)->RangeMultiplier(4)->Range(4 << 10, 1 << 20);
+
+static void BM_DataStoreGetHash(benchmark::State& state) {
+    BenchmarkEnv env;
+    const ChunkID id = 1;
+    env.PrepareChunk(id, 1);
+    size_t length = state.range(0);
+    std::string hash;
+    for (auto _ : state) {
+        CSErrorCode ret = env.DataStore()->GetChunkHash(id, 0, length, &hash);
+        if (ret != CSErrorCode::Success) {
+            state.SkipWithError("get chunk hash failed");
+            break;
+        }
+    }
+    SetIOCounters(state, length);
+}
+BENCHMARK(BM_DataStoreGetHash)->RangeMultiplier(4)->Range(64 << 10, 16 << 20);
+
+/**
+ * 只衡量并发apply模块本身push和调度task的开销
+ */
+static void BM_ConcurrentApplyPush(benchmark::State& state) {
+    ConcurrentApplyModule concurrentapply;
+    CHECK(concurrentapply.Init(state.range(0), 1024));
+    std::atomic<uint64_t> applied(0);
+    uint64_t key = 0;
+    for (auto _ : state) {
+        concurrentapply.Push(key++, [&applied]() {
+            applied.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    concurrentapply.Flush();
+    concurrentapply.Stop();
+    CHECK_EQ(state.iterations(), applied.load());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConcurrentApplyPush)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+
+/**
+ * apply路径: 写请求按照chunk哈希到并发apply模块中执行datastore写，
+ * 包含所有请求执行完成的时间
+ */
+static void BM_ApplyWrite(benchmark::State& state) {
+    BenchmarkEnv env;
+    const SequenceNum sn = 1;
+    const int chunkNum = 4;
+    for (ChunkID id = 1; id <= chunkNum; ++id) {
+        env.PrepareChunk(id, sn);
+    }
+    ConcurrentApplyModule concurrentapply;
+    CHECK(concurrentapply.Init(state.range(0), 1024));
+    size_t length = 4096;
+    std::vector<char> buf(length, 'e');
+    auto dataStore = env.DataStore();
+    std::atomic<uint64_t> failed(0);
+    unsigned int seed = kRandomSeed;
+    uint64_t count = 0;
+    for (auto _ : state) {
+        ChunkID id = count++ % chunkNum + 1;
+        off_t offset = RandomOffset(&seed, length);
+        concurrentapply.Push(id, [&, id, offset]() {
+            if (dataStore->WriteChunk(id, sn, buf.data(), offset,
+                                      length, nullptr)
+                != CSErrorCode::Success) {
+                failed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    concurrentapply.Flush();
+    concurrentapply.Stop();
+    if (failed.load() > 0) {
+        state.SkipWithError("apply write failed");
+    }
+    SetIOCounters(state, length);
+}
+BENCHMARK(BM_ApplyWrite)->Arg(1)->Arg(4)->UseRealTime();
+
+/**
+ * 从chunkfilepool取出chunk后立即回收，池子的大小保持不变
+ */
+static void BM_ChunkfilePoolGetChunk(benchmark::State& state) {
+    BenchmarkEnv env;
+    std::vector<char> metapage(kPageSize, 0);
+    std::string path = env.ChunkPath(1);
+    for (auto _ : state) {
+        if (env.Pool()->GetChunk(path, metapage.data()) != 0) {
+            state.SkipWithError("get chunk failed");
+            break;
+        }
+        state.PauseTiming();
+        CHECK_EQ(0, env.Pool()->RecycleChunk(path));
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ChunkfilePoolGetChunk);
+
+}  // namespace chunkserver
+}  // namespace curve
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    // datastore和chunkfilepool每次操作都会打印info日志，避免影响测试结果
+    FLAGS_minloglevel = google::WARNING;
+    google::InitGoogleLogging(argv[0]);
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,273 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#ifndef TEST_CHUNKSERVER_BENCHMARK_MEM_LOCAL_FILESYSTEM_H_
+#define TEST_CHUNKSERVER_BENCHMARK_MEM_LOCAL_FILESYSTEM_H_
+
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <errno.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "src/fs/local_filesystem.h"
+#include "src/common/concurrent/rw_lock.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::fs::LocalFileSystem;
+using curve::fs::LocalFileSystemOption;
+using curve::fs::FileSystemInfo;
+using curve::common::RWLock;
+using curve::common::ReadLockGuard;
+using curve::common::WriteLockGuard;
+
+/**
+ * 数据全部放在内存中的LocalFileSystem，用于benchmark排除磁盘的影响，
+ * 只衡量datastore本身的开销
+ * 1. 只支持datastore和chunkfilepool用到的接口
+ * 2. 目录只记录路径，文件按照完整路径索引
+ */
+class MemLocalFileSystem : public LocalFileSystem {
+ public:
+    MemLocalFileSystem() : nextFd_(3) {}
+    virtual ~MemLocalFileSystem() {}
+
+    int Init(const LocalFileSystemOption& option) override {
+        return 0;
+    }
+
+    int Statfs(const string& path, struct FileSystemInfo* info) override {
+        std::lock_guard<std::mutex> lk(mtx_);
+        uint64_t stored = 0;
+        for (auto& file : files_) {
+            stored += file.second->data.size();
+        }
+        info->total = UINT64_MAX;
+        info->available = UINT64_MAX - stored;
+        info->stored = stored;
+        info->allocated = stored;
+        return 0;
+    }
+
+    int Open(const string& path, int flags) override {
+        std::lock_guard<std::mutex> lk(mtx_);
+        auto iter = files_.find(path);
+        if (iter == files_.end()) {
+            if (!(flags & O_CREAT)) {
+                return -ENOENT;
+            }
+            iter = files_.emplace(path, std::make_shared<MemFile>()).first;
+        }
+        int fd = nextFd_++;
+        fds_[fd] = iter->second;
+        return fd;
+    }
+
+    int Close(int fd) override {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return fds_.erase(fd) > 0 ? 0 : -EBADF;
+    }
+
+    int Delete(const string& path) override {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (files_.erase(path) > 0) {
+            return 0;
+        }
+        if (dirs_.erase(path) == 0) {
+            return -ENOENT;
+        }
+        // 删除目录时一并删除其下的文件和子目录
+        std::string prefix = path + "/";
+        for (auto iter = files_.begin(); iter != files_.end();) {
+            if (iter->first.compare(0, prefix.size(), prefix) == 0) {
+                iter = files_.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+        for (auto iter = dirs_.begin(); iter != dirs_.end();) {
+            if (iter->compare(0, prefix.size(), prefix) == 0) {
+                iter = dirs_.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+        return 0;
+    }
+
+    int Mkdir(const string& dirPath) override {
+        std::lock_guard<std::mutex> lk(mtx_);
+        // 与ext4的实现一致，逐级创建不存在的父目录
+        size_t pos = 0;
+        while ((pos = dirPath.find('/', pos + 1)) != std::string::npos) {
+            dirs_.insert(dirPath.substr(0, pos));
+        }
+        dirs_.insert(dirPath);
+        return 0;
+    }
+
+    bool DirExists(const string& dirPath) override {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return dirs_.count(dirPath) > 0;
+    }
+
+    bool FileExists(const string& filePath) override {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return files_.count(filePath) > 0;
+    }
+
+    int List(const string& dirPath, vector<std::string>* names) override {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (dirs_.count(dirPath) == 0) {
+            return -ENOENT;
+        }
+        std::string prefix = dirPath + "/";
+        auto addChild = [&](const std::string& path) {
+            if (path.compare(0, prefix.size(), prefix) == 0 &&
+                path.find('/', prefix.size()) == std::string::npos) {
+                names->push_back(path.substr(prefix.size()));
+            }
+        };
+        for (auto& file : files_) {
+            addChild(file.first);
+        }
+        for (auto& dir : dirs_) {
+            addChild(dir);
+        }
+        return 0;
+    }
+
+    int Read(int fd, char* buf, uint64_t offset, int length) override {
+        auto file = GetFile(fd);
+        if (file == nullptr) {
+            return -EBADF;
+        }
+        ReadLockGuard readGuard(file->rwLock);
+        if (offset >= file->data.size()) {
+            return 0;
+        }
+        int readLen = std::min<uint64_t>(length, file->data.size() - offset);
+        memcpy(buf, file->data.data() + offset, readLen);
+        return readLen;
+    }
+
+    int Write(int fd, const char* buf, uint64_t offset, int length) override {
+        auto file = GetFile(fd);
+        if (file == nullptr) {
+            return -EBADF;
+        }
+        WriteLockGuard writeGuard(file->rwLock);
+        if (offset + length > file->data.size()) {
+            file->data.resize(offset + length);
+        }
+        memcpy(file->data.data() + offset, buf, length);
+        return length;
+    }
+
+    int Append(int fd, const char* buf, int length) override {
+        auto file = GetFile(fd);
+        if (file == nullptr) {
+            return -EBADF;
+        }
+        WriteLockGuard writeGuard(file->rwLock);
+        file->data.insert(file->data.end(), buf, buf + length);
+        return length;
+    }
+
+    int Fallocate(int fd, int op, uint64_t offset, int length) override {
+        auto file = GetFile(fd);
+        if (file == nullptr) {
+            return -EBADF;
+        }
+        WriteLockGuard writeGuard(file->rwLock);
+        if (offset + length > file->data.size()) {
+            file->data.resize(offset + length);
+        }
+        return 0;
+    }
+
+    int Fstat(int fd, struct stat* info) override {
+        auto file = GetFile(fd);
+        if (file == nullptr) {
+            return -EBADF;
+        }
+        ReadLockGuard readGuard(file->rwLock);
+        memset(info, 0, sizeof(struct stat));
+        info->st_mode = S_IFREG | 0644;
+        info->st_size = file->data.size();
+        return 0;
+    }
+
+    int Fsync(int fd) override {
+        return GetFile(fd) == nullptr ? -EBADF : 0;
+    }
+
+ private:
+    struct MemFile {
+        RWLock rwLock;
+        std::vector<char> data;
+    };
+    typedef std::shared_ptr<MemFile> MemFilePtr;
+
+    MemFilePtr GetFile(int fd) {
+        std::lock_guard<std::mutex> lk(mtx_);
+        auto iter = fds_.find(fd);
+        return iter == fds_.end() ? nullptr : iter->second;
+    }
+
+    int DoRename(const string& oldPath,
+                 const string& newPath,
+                 unsigned int flags) override {
+        std::lock_guard<std::mutex> lk(mtx_);
+        auto iter = files_.find(oldPath);
+        if (iter == files_.end()) {
+            return -ENOENT;
+        }
+        if ((flags & RENAME_NOREPLACE) && files_.count(newPath) > 0) {
+            return -EEXIST;
+        }
+        files_[newPath] = iter->second;
+        files_.erase(oldPath);
+        return 0;
+    }
+
+ private:
+    std::mutex mtx_;
+    int nextFd_;
+    std::unordered_map<std::string, MemFilePtr> files_;
+    std::set<std::string> dirs_;
+    std::unordered_map<int, MemFilePtr> fds_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // TEST_CHUNKSERVER_BENCHMARK_MEM_LOCAL_FILESYSTEM_H_
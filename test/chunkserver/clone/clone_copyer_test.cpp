@@ -24,6 +24,10 @@
 #include <gmock/gmock.h>
 #include <glog/logging.h>
 
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+
 #include "include/client/libcurve.h"
 #include "src/chunkserver/clone_copyer.h"
 #include "src/chunkserver/clone_core.h"
@@ -61,13 +65,21 @@ class MockDownloadClosure : public DownloadClosure {
         return isRun_;
     }
 
+    // 源文件是异步打开的，需要等待closure被执行
+    bool WaitRun() {
+        for (int i = 0; i < 500 && !isRun_; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return isRun_;
+    }
+
     void Reset() {
         isFailed_ = false;
         isRun_ = false;
     }
 
  private:
-    bool isRun_;
+    std::atomic<bool> isRun_;
 };
 
 class CloneCopyerTest : public testing::Test  {
@@ -120,14 +132,14 @@ TEST_F(CloneCopyerTest, BasicTest) {
         // invalid location
         context.location = "aaaaa";
         copyer.DownloadAsync(&closure);
-        ASSERT_TRUE(closure.IsRun());
+        ASSERT_TRUE(closure.WaitRun());
         ASSERT_TRUE(closure.IsFailed());
         closure.Reset();
 
         // invalid location
         context.location = "aaaaa@cs";
         copyer.DownloadAsync(&closure);
-        ASSERT_TRUE(closure.IsRun());
+        ASSERT_TRUE(closure.WaitRun());
         ASSERT_TRUE(closure.IsFailed());
         closure.Reset();
 
@@ -144,7 +156,7 @@ TEST_F(CloneCopyerTest, BasicTest) {
                 return LIBCURVE_ERROR::OK;
             }));
         copyer.DownloadAsync(&closure);
-        ASSERT_TRUE(closure.IsRun());
+        ASSERT_TRUE(closure.WaitRun());
         ASSERT_FALSE(closure.IsFailed());
         closure.Reset();
 
@@ -161,7 +173,7 @@ TEST_F(CloneCopyerTest, BasicTest) {
                 return LIBCURVE_ERROR::OK;
             }));
         copyer.DownloadAsync(&closure);
-        ASSERT_TRUE(closure.IsRun());
+        ASSERT_TRUE(closure.WaitRun());
         ASSERT_TRUE(closure.IsFailed());
         closure.Reset();
 
@@ -174,7 +186,7 @@ TEST_F(CloneCopyerTest, BasicTest) {
         EXPECT_CALL(*curveClient_, AioRead(_, _))
             .Times(0);
         copyer.DownloadAsync(&closure);
-        ASSERT_TRUE(closure.IsRun());
+        ASSERT_TRUE(closure.WaitRun());
         ASSERT_TRUE(closure.IsFailed());
         closure.Reset();
 
@@ -187,7 +199,7 @@ TEST_F(CloneCopyerTest, BasicTest) {
         EXPECT_CALL(*curveClient_, AioRead(_, _))
             .WillOnce(Return(-1 * LIBCURVE_ERROR::FAILED));
         copyer.DownloadAsync(&closure);
-        ASSERT_TRUE(closure.IsRun());
+        ASSERT_TRUE(closure.WaitRun());
         ASSERT_TRUE(closure.IsFailed());
         closure.Reset();
 
@@ -203,7 +215,7 @@ TEST_F(CloneCopyerTest, BasicTest) {
                     context->cb(s3Client_.get(), context);
                 }));
         copyer.DownloadAsync(&closure);
-        ASSERT_TRUE(closure.IsRun());
+        ASSERT_TRUE(closure.WaitRun());
         ASSERT_FALSE(closure.IsFailed());
         closure.Reset();
 
@@ -218,7 +230,7 @@ TEST_F(CloneCopyerTest, BasicTest) {
                     context->cb(s3Client_.get(), context);
                 }));
         copyer.DownloadAsync(&closure);
-        ASSERT_TRUE(closure.IsRun());
+        ASSERT_TRUE(closure.WaitRun());
         ASSERT_TRUE(closure.IsFailed());
         closure.Reset();
 
@@ -271,7 +283,7 @@ TEST_F(CloneCopyerTest, DisableTest) {
         EXPECT_CALL(*curveClient_, AioRead(_, _))
             .Times(0);
         copyer.DownloadAsync(&closure);
-        ASSERT_TRUE(closure.IsRun());
+        ASSERT_TRUE(closure.WaitRun());
         ASSERT_TRUE(closure.IsFailed());
         closure.Reset();
 
@@ -281,7 +293,7 @@ TEST_F(CloneCopyerTest, DisableTest) {
         EXPECT_CALL(*s3Client_, GetObjectAsync(_))
             .Times(0);
         copyer.DownloadAsync(&closure);
-        ASSERT_TRUE(closure.IsRun());
+        ASSERT_TRUE(closure.WaitRun());
         ASSERT_TRUE(closure.IsFailed());
         closure.Reset();
         delete [] buf;
@@ -290,5 +302,185 @@ TEST_F(CloneCopyerTest, DisableTest) {
     ASSERT_EQ(0, copyer.Fini());
 }
 
+TEST_F(CloneCopyerTest, CacheTest) {
+    const uint32_t extentSize = 8192;
+    OriginCopyer copyer;
+    CopyerOptions options;
+    options.curveConf = CURVE_CONF;
+    options.s3Conf = S3_CONF;
+    options.curveUser.owner = ROOT_OWNER;
+    options.curveUser.password = ROOT_PWD;
+    options.curveClient = curveClient_;
+    options.s3Client = s3Client_;
+    options.cacheExtentSize = extentSize;
+    // 最多缓存2个extent
+    options.cacheCapacity = 2 * extentSize;
+    options.chunkSize = 4 * extentSize;
+    EXPECT_CALL(*curveClient_, Init(StrEq(CURVE_CONF)))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+    ASSERT_EQ(0, copyer.Init(options));
+
+    // 按照源文件中的偏移填充数据，便于校验拷贝的位置
+    auto fillData = [](CurveAioContext* context) -> int {
+        for (size_t i = 0; i < context->length; i += 4096) {
+            memset(static_cast<char*>(context->buf) + i,
+                   'a' + (context->offset + i) / 4096 % 26, 4096);
+        }
+        context->ret = context->length;
+        context->cb(context);
+        return LIBCURVE_ERROR::OK;
+    };
+    auto checkData = [](const char* buf, off_t offset, size_t length) {
+        for (size_t i = 0; i < length; i += 4096) {
+            ASSERT_EQ('a' + (offset + i) / 4096 % 26, buf[i]);
+        }
+    };
+
+    char* buf = new char[2 * extentSize];
+    AsyncDownloadContext context;
+    context.buf = buf;
+    MockDownloadClosure closure(&context);
+    EXPECT_CALL(*curveClient_, Open4ReadOnly("test", _))
+        .WillOnce(Return(1));
+
+    /* 用例:读源chunk中的一个page
+     * 预期:下载page所在的整个extent
+     */
+    context.location = "test:32768@cs";
+    context.offset = 4096;
+    context.size = 4096;
+    EXPECT_CALL(*curveClient_, AioRead(_, _))
+        .WillOnce(Invoke([&](int fd, CurveAioContext* aioCtx) {
+            EXPECT_EQ(32768, aioCtx->offset);
+            EXPECT_EQ(extentSize, aioCtx->length);
+            return fillData(aioCtx);
+        }));
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.WaitRun());
+    ASSERT_FALSE(closure.IsFailed());
+    checkData(buf, 32768 + 4096, 4096);
+    closure.Reset();
+
+    /* 用例:读同一个extent中的其他page
+     * 预期:命中缓存，不需要下载
+     */
+    context.offset = 0;
+    context.size = 4096;
+    EXPECT_CALL(*curveClient_, AioRead(_, _))
+        .Times(0);
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.WaitRun());
+    ASSERT_FALSE(closure.IsFailed());
+    checkData(buf, 32768, 4096);
+    closure.Reset();
+
+    /* 用例:读取的范围跨越两个extent
+     * 预期:只下载不在缓存中的extent
+     */
+    context.offset = 4096;
+    context.size = extentSize;
+    EXPECT_CALL(*curveClient_, AioRead(_, _))
+        .WillOnce(Invoke([&](int fd, CurveAioContext* aioCtx) {
+            EXPECT_EQ(32768 + extentSize, aioCtx->offset);
+            EXPECT_EQ(extentSize, aioCtx->length);
+            return fillData(aioCtx);
+        }));
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.WaitRun());
+    ASSERT_FALSE(closure.IsFailed());
+    checkData(buf, 32768 + 4096, extentSize);
+    closure.Reset();
+
+    /* 用例:缓存满之后读取新的extent
+     * 预期:淘汰最久没有访问的extent
+     */
+    context.offset = 2 * extentSize;
+    context.size = 4096;
+    EXPECT_CALL(*curveClient_, AioRead(_, _))
+        .WillOnce(Invoke([&](int fd, CurveAioContext* aioCtx) {
+            return fillData(aioCtx);
+        }));
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.WaitRun());
+    closure.Reset();
+    context.offset = 0;
+    EXPECT_CALL(*curveClient_, AioRead(_, _))
+        .WillOnce(Invoke([&](int fd, CurveAioContext* aioCtx) {
+            return fillData(aioCtx);
+        }));
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.WaitRun());
+    ASSERT_FALSE(closure.IsFailed());
+    checkData(buf, 32768, 4096);
+    closure.Reset();
+
+    /* 用例:并发读取s3上同一个extent
+     * 预期:只下载一次，下载完成后两个请求都返回
+     */
+    std::shared_ptr<GetObjectAsyncContext> s3Context;
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .WillOnce(SaveArg<0>(&s3Context));
+    context.location = "test@s3";
+    context.offset = 0;
+    context.size = 4096;
+    copyer.DownloadAsync(&closure);
+    ASSERT_FALSE(closure.IsRun());
+
+    char* buf2 = new char[4096];
+    AsyncDownloadContext context2;
+    context2.location = "test@s3";
+    context2.offset = 4096;
+    context2.size = 4096;
+    context2.buf = buf2;
+    MockDownloadClosure closure2(&context2);
+    copyer.DownloadAsync(&closure2);
+    ASSERT_FALSE(closure2.IsRun());
+
+    ASSERT_NE(nullptr, s3Context);
+    ASSERT_EQ(0, s3Context->offset);
+    ASSERT_EQ(extentSize, s3Context->len);
+    memset(s3Context->buf, 'x', 4096);
+    memset(s3Context->buf + 4096, 'y', 4096);
+    s3Context->retCode = 0;
+    s3Context->cb(s3Client_.get(), s3Context);
+    ASSERT_TRUE(closure.WaitRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_TRUE(closure2.WaitRun());
+    ASSERT_FALSE(closure2.IsFailed());
+    ASSERT_EQ('x', buf[0]);
+    ASSERT_EQ('y', buf2[0]);
+    closure.Reset();
+
+    /* 用例:下载extent失败
+     * 预期:请求返回失败，失败的extent不会被缓存
+     */
+    context.location = "test2@s3";
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .Times(2)
+        .WillRepeatedly(Invoke(
+            [&] (const std::shared_ptr<GetObjectAsyncContext>& context) {
+                context->retCode = -1;
+                context->cb(s3Client_.get(), context);
+            }));
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.WaitRun());
+    ASSERT_TRUE(closure.IsFailed());
+    closure.Reset();
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.WaitRun());
+    ASSERT_TRUE(closure.IsFailed());
+    closure.Reset();
+
+    delete [] buf;
+    delete [] buf2;
+    EXPECT_CALL(*curveClient_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*curveClient_, UnInit())
+        .Times(1);
+    EXPECT_CALL(*s3Client_, Deinit())
+        .Times(1);
+    ASSERT_EQ(0, copyer.Fini());
+}
+
 }  // namespace chunkserver
 }  // namespace curve
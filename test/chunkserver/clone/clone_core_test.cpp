@@ -784,5 +784,61 @@ TEST_F(CloneCoreTest, DisablePasteTest) {
     }
 }
 
+/**
+ * 测试paste请求只记录源端位置
+ * result:从源端拷贝数据，产生的paste日志中只有源端位置和范围，没有数据
+ */
+TEST_F(CloneCoreTest, PasteByLocationTest) {
+    off_t offset = 0;
+    size_t length = 5 * PAGE_SIZE;
+    CSChunkInfo info;
+    info.isClone = true;
+    info.pageSize = PAGE_SIZE;
+    info.chunkSize = CHUNK_SIZE;
+    info.location = "test@s3";
+    info.bitmap = std::make_shared<Bitmap>(CHUNK_SIZE / PAGE_SIZE);
+    std::shared_ptr<CloneCore> core
+        = std::make_shared<CloneCore>(SLICE_SIZE, true, copyer_, true);
+
+    std::shared_ptr<ReadChunkRequest> readRequest
+        = GenerateReadRequest(CHUNK_OP_TYPE::CHUNK_OP_RECOVER, offset, length);  //NOLINT
+    EXPECT_CALL(*copyer_, DownloadAsync(_))
+        .WillOnce(Invoke([&](DownloadClosure* closure){
+            brpc::ClosureGuard guard(closure);
+            AsyncDownloadContext* context = closure->GetDownloadContext();
+            ASSERT_EQ(info.location, context->location);
+            memset(context->buf, 'c', length);
+        }));
+    EXPECT_CALL(*datastore_, GetChunkInfo(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(info),
+                        Return(CSErrorCode::Success)));
+    braft::Task task;
+    butil::IOBuf iobuf;
+    task.data = &iobuf;
+    EXPECT_CALL(*node_, Propose(_))
+        .WillOnce(SaveBraftTask<0>(&task));
+
+    ASSERT_EQ(0, core->HandleReadRequest(readRequest,
+                                          readRequest->Closure()));
+    FakeChunkClosure* closure =
+        reinterpret_cast<FakeChunkClosure*>(readRequest->Closure());
+    ASSERT_FALSE(closure->isDone_);
+
+    butil::IOBuf data;
+    ChunkRequest request;
+    auto req = ChunkOpRequest::Decode(*task.data, &request, &data);
+    ASSERT_TRUE(dynamic_cast<PasteChunkInternalRequest*>(req.get()) != nullptr);
+    ASSERT_EQ(CHUNK_ID, request.chunkid());
+    ASSERT_EQ(offset, request.offset());
+    ASSERT_EQ(length, request.size());
+    ASSERT_EQ(info.location, request.location());
+    ASSERT_TRUE(data.empty());
+    ASSERT_TRUE(PasteChunkInternalRequest::IsLocationOnly(request, data));
+
+    ASSERT_NE(nullptr, task.done);
+    task.done->Run();
+    ASSERT_TRUE(closure->isDone_);
+}
+
 }  // namespace chunkserver
 }  // namespace curve
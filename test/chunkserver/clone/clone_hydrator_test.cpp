@@ -0,0 +1,226 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "src/chunkserver/clone_hydrator.h"
+#include "src/fs/local_filesystem.h"
+#include "test/chunkserver/mock_copyset_node.h"
+#include "test/chunkserver/datastore/mock_datastore.h"
+
+namespace curve {
+namespace chunkserver {
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+using ::testing::DoAll;
+using curve::fs::FileSystemType;
+using curve::fs::LocalFsFactory;
+
+const uint32_t kPageSize = 4096;
+const uint32_t kSliceSize = 2 * kPageSize;
+const uint32_t kChunkSize = 4 * kSliceSize;
+const ChunkID kChunkId = 1;
+
+class MockCloneHydrator : public CloneHydrator {
+ public:
+    MOCK_METHOD1(ListCopysetNodes, void(std::vector<CopysetNodePtr>*));
+    MOCK_METHOD2(ListChunks, int(const CopysetNodePtr&,
+                                 std::vector<ChunkID>*));
+    MOCK_METHOD0(ForegroundIops, uint64_t());
+    MOCK_METHOD4(RecoverChunk, int(const CopysetNodePtr&,
+                                   ChunkID,
+                                   off_t,
+                                   size_t));
+};
+
+class CloneHydratorTest : public testing::Test {
+ public:
+    void SetUp() {
+        node_ = std::make_shared<MockCopysetNode>();
+        datastore_ = std::make_shared<MockDataStore>();
+        cloneMgr_ = std::make_shared<CloneManager>();
+        options_.enable = true;
+        options_.sliceSize = kSliceSize;
+        options_.bandwidthBytes = 0;
+        options_.pauseCheckIntervalMs = 1;
+        options_.copysetNodeManager = &CopysetNodeManager::GetInstance();
+        options_.cloneManager = cloneMgr_.get();
+        options_.localFileSystem =
+            LocalFsFactory::CreateFs(FileSystemType::EXT4, "");
+
+        std::vector<CopysetNodePtr> nodes{node_};
+        ON_CALL(hydrator_, ListCopysetNodes(_))
+            .WillByDefault(SetArgPointee<0>(nodes));
+        std::vector<ChunkID> chunks{kChunkId};
+        ON_CALL(hydrator_, ListChunks(_, _))
+            .WillByDefault(DoAll(SetArgPointee<1>(chunks), Return(0)));
+        ON_CALL(hydrator_, ForegroundIops()).WillByDefault(Return(0));
+        ON_CALL(*node_, IsActivated()).WillByDefault(Return(true));
+        ON_CALL(*node_, IsLeaderTerm()).WillByDefault(Return(true));
+        ON_CALL(*node_, GetDataStore()).WillByDefault(Return(datastore_));
+
+        DataStoreStatus status;
+        status.cloneChunkCount = 1;
+        ON_CALL(*datastore_, GetStatus()).WillByDefault(Return(status));
+
+        bitmap_ = std::make_shared<Bitmap>(kChunkSize / kPageSize);
+        ON_CALL(*datastore_, GetChunkInfo(kChunkId, _))
+            .WillByDefault(Invoke([this](ChunkID id, CSChunkInfo* info) {
+                info->chunkId = id;
+                info->chunkSize = kChunkSize;
+                info->pageSize = kPageSize;
+                info->isClone =
+                    bitmap_->NextClearBit(0, kChunkSize / kPageSize - 1) !=
+                    Bitmap::NO_POS;
+                info->bitmap = std::make_shared<Bitmap>(*bitmap_);
+                return CSErrorCode::Success;
+            }));
+    }
+
+    void TearDown() {
+        hydrator_.Fini();
+    }
+
+    // 模拟recover成功，将对应的页置为已写
+    int Recover(const CopysetNodePtr& node, ChunkID id,
+                off_t offset, size_t length) {
+        bitmap_->Set(offset / kPageSize, (offset + length - 1) / kPageSize);
+        return 0;
+    }
+
+ protected:
+    MockCloneHydrator hydrator_;
+    std::shared_ptr<MockCopysetNode> node_;
+    std::shared_ptr<MockDataStore> datastore_;
+    std::shared_ptr<CloneManager> cloneMgr_;
+    std::shared_ptr<Bitmap> bitmap_;
+    HydratorOptions options_;
+};
+
+TEST_F(CloneHydratorTest, InitTest) {
+    HydratorOptions options = options_;
+    options.cloneManager = nullptr;
+    ASSERT_EQ(-1, hydrator_.Init(options));
+
+    // slice大小需要按照4096对齐
+    options = options_;
+    options.sliceSize = 1000;
+    ASSERT_EQ(-1, hydrator_.Init(options));
+
+    options = options_;
+    options.scanIntervalS = 0;
+    ASSERT_EQ(-1, hydrator_.Init(options));
+
+    ASSERT_EQ(0, hydrator_.Init(options_));
+}
+
+TEST_F(CloneHydratorTest, SkipWrittenSliceTest) {
+    ASSERT_EQ(0, hydrator_.Init(options_));
+
+    // 第二个slice已经被前台io写过，第三个slice只写过一页
+    bitmap_->Set(2, 3);
+    bitmap_->Set(4);
+    EXPECT_CALL(hydrator_, RecoverChunk(_, kChunkId, 0, kSliceSize))
+        .WillOnce(Invoke(this, &CloneHydratorTest::Recover));
+    EXPECT_CALL(hydrator_, RecoverChunk(_, kChunkId, kSliceSize, _))
+        .Times(0);
+    EXPECT_CALL(hydrator_, RecoverChunk(_, kChunkId, 2 * kSliceSize,
+                                        kSliceSize))
+        .WillOnce(Invoke(this, &CloneHydratorTest::Recover));
+    EXPECT_CALL(hydrator_, RecoverChunk(_, kChunkId, 3 * kSliceSize,
+                                        kSliceSize))
+        .WillOnce(Invoke(this, &CloneHydratorTest::Recover));
+    hydrator_.HydrateOnce();
+    ASSERT_EQ(Bitmap::NO_POS,
+              bitmap_->NextClearBit(0, kChunkSize / kPageSize - 1));
+}
+
+TEST_F(CloneHydratorTest, SkipCopysetTest) {
+    ASSERT_EQ(0, hydrator_.Init(options_));
+    EXPECT_CALL(hydrator_, RecoverChunk(_, _, _, _)).Times(0);
+
+    // 非leader不回填
+    EXPECT_CALL(*node_, IsLeaderTerm())
+        .WillOnce(Return(false))
+        .WillRepeatedly(Return(true));
+    hydrator_.HydrateOnce();
+
+    // 没有clone chunk的copyset不需要遍历chunk
+    DataStoreStatus status;
+    EXPECT_CALL(*datastore_, GetStatus()).WillOnce(Return(status));
+    EXPECT_CALL(hydrator_, ListChunks(_, _)).Times(0);
+    hydrator_.HydrateOnce();
+}
+
+TEST_F(CloneHydratorTest, RecoverFailedTest) {
+    ASSERT_EQ(0, hydrator_.Init(options_));
+
+    // recover失败时放弃当前chunk，下一轮重新回填
+    EXPECT_CALL(hydrator_, RecoverChunk(_, kChunkId, 0, kSliceSize))
+        .WillOnce(Return(-1))
+        .WillOnce(Invoke(this, &CloneHydratorTest::Recover));
+    hydrator_.HydrateOnce();
+
+    EXPECT_CALL(hydrator_, RecoverChunk(_, kChunkId, kSliceSize, kSliceSize))
+        .WillOnce(Invoke(this, &CloneHydratorTest::Recover));
+    EXPECT_CALL(hydrator_, RecoverChunk(_, kChunkId, 2 * kSliceSize,
+                                        kSliceSize))
+        .WillOnce(Invoke(this, &CloneHydratorTest::Recover));
+    EXPECT_CALL(hydrator_, RecoverChunk(_, kChunkId, 3 * kSliceSize,
+                                        kSliceSize))
+        .WillOnce(Invoke(this, &CloneHydratorTest::Recover));
+    hydrator_.HydrateOnce();
+    ASSERT_EQ(Bitmap::NO_POS,
+              bitmap_->NextClearBit(0, kChunkSize / kPageSize - 1));
+}
+
+TEST_F(CloneHydratorTest, PauseTest) {
+    HydratorOptions options = options_;
+    options.pauseIops = 100;
+    ASSERT_EQ(0, hydrator_.Init(options));
+
+    // 前台负载高时暂停，负载下降后继续
+    EXPECT_CALL(hydrator_, ForegroundIops())
+        .WillOnce(Return(200))
+        .WillOnce(Return(200))
+        .WillRepeatedly(Return(10));
+    EXPECT_CALL(hydrator_, RecoverChunk(_, kChunkId, _, kSliceSize))
+        .Times(4)
+        .WillRepeatedly(Invoke(this, &CloneHydratorTest::Recover));
+    hydrator_.HydrateOnce();
+
+    // 模块停止之后不再回填
+    bitmap_->Clear();
+    ASSERT_EQ(0, hydrator_.Fini());
+    EXPECT_CALL(hydrator_, RecoverChunk(_, _, _, _)).Times(0);
+    hydrator_.HydrateOnce();
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -37,6 +37,8 @@ class MockChunkCopyer : public OriginCopyer {
     MockChunkCopyer() = default;
     ~MockChunkCopyer() = default;
     MOCK_METHOD1(DownloadAsync, void(DownloadClosure*));
+    MOCK_METHOD4(DownloadSync, int(const string&, off_t, size_t,
+                                   butil::IOBuf*));
 };
 
 }  // namespace chunkserver
@@ -67,6 +67,8 @@ class OpRequestTest : public testing::Test {
     }
 
     void FakeCopysetNode() {
+        EXPECT_CALL(*node_, IsActivated())
+            .WillRepeatedly(Return(true));
         EXPECT_CALL(*node_, IsLeaderTerm())
             .WillRepeatedly(Return(true));
         EXPECT_CALL(*node_, GetDataStore())
@@ -982,6 +984,203 @@ TEST_F(OpRequestTest, ReadChunkTest) {
     closure->Release();
 }
 
+TEST_F(OpRequestTest, FollowerReadChunkTest) {
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 10001;
+    uint64_t chunkId = 12345;
+    uint32_t offset = 0;
+    uint32_t length = 5 * PAGE_SIZE;
+    ChunkRequest* request = new ChunkRequest();
+    request->set_logicpoolid(logicPoolId);
+    request->set_copysetid(copysetId);
+    request->set_chunkid(chunkId);
+    request->set_optype(CHUNK_OP_READ);
+    request->set_offset(offset);
+    request->set_size(length);
+    request->set_appliedindex(LAST_INDEX);
+    request->set_followerread(true);
+    brpc::Controller *cntl = new brpc::Controller();
+    ChunkResponse *response = new ChunkResponse();
+    UnitTestClosure *closure = new UnitTestClosure();
+    closure->SetCntl(cntl);
+    closure->SetRequest(request);
+    closure->SetResponse(response);
+    std::shared_ptr<ReadChunkRequest> opReq =
+        std::make_shared<ReadChunkRequest>(node_,
+                                           cloneMgr_.get(),
+                                           cntl,
+                                           request,
+                                           response,
+                                           closure);
+    EXPECT_CALL(*node_, IsLeaderTerm())
+        .WillRepeatedly(Return(false));
+    EXPECT_CALL(*node_, Propose(_))
+        .Times(0);
+
+    /**
+     * 测试Process
+     * 用例： follower没有跟随有效的leader
+     * 预期： 返回CHUNK_OP_STATUS_REDIRECTED
+     */
+    {
+        EXPECT_CALL(*node_, IsFollowingLeader())
+            .WillOnce(Return(false));
+
+        opReq->Process();
+
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED,
+                  closure->response_->status());
+    }
+    /**
+     * 测试Process
+     * 用例： 请求的 apply index 大于 follower的 apply index
+     * 预期： 返回CHUNK_OP_STATUS_REDIRECTED
+     */
+    {
+        closure->Reset();
+        request->set_appliedindex(LAST_INDEX + 1);
+        EXPECT_CALL(*node_, IsFollowingLeader())
+            .WillOnce(Return(true));
+
+        opReq->Process();
+
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED,
+                  closure->response_->status());
+    }
+    /**
+     * 测试Process
+     * 用例： 请求未允许follower read
+     * 预期： 返回CHUNK_OP_STATUS_REDIRECTED
+     */
+    {
+        closure->Reset();
+        request->set_appliedindex(LAST_INDEX);
+        request->set_followerread(false);
+
+        opReq->Process();
+
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED,
+                  closure->response_->status());
+        request->set_followerread(true);
+    }
+    /**
+     * 测试Process
+     * 用例： 请求的 apply index 小于等于 follower的 apply index
+     * 预期： 请求提交给concurrentApplyModule_处理
+     */
+    {
+        closure->Reset();
+        EXPECT_CALL(*node_, IsFollowingLeader())
+            .WillOnce(Return(true));
+
+        opReq->Process();
+
+        ASSERT_FALSE(closure->isDone_);
+        ASSERT_FALSE(closure->response_->has_status());
+
+        closure->Run();
+        ASSERT_TRUE(closure->isDone_);
+    }
+    /**
+     * 测试Process
+     * 用例： copyset的datastore还没有加载
+     * 预期： follower返回CHUNK_OP_STATUS_REDIRECTED；leader走raft读，
+     *       不提交给concurrentApplyModule_
+     */
+    {
+        closure->Reset();
+        EXPECT_CALL(*node_, IsActivated())
+            .WillRepeatedly(Return(false));
+        EXPECT_CALL(*node_, IsFollowingLeader())
+            .WillOnce(Return(true));
+
+        opReq->Process();
+
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED,
+                  closure->response_->status());
+
+        closure->Reset();
+        EXPECT_CALL(*node_, IsLeaderTerm())
+            .WillRepeatedly(Return(true));
+        braft::Task task;
+        EXPECT_CALL(*node_, Propose(_))
+            .WillOnce(SaveArg<0>(&task));
+
+        opReq->Process();
+
+        ASSERT_FALSE(closure->isDone_);
+        ASSERT_FALSE(closure->response_->has_status());
+        ASSERT_NE(nullptr, task.done);
+        task.done->Run();
+        ASSERT_TRUE(closure->isDone_);
+
+        EXPECT_CALL(*node_, IsActivated())
+            .WillRepeatedly(Return(true));
+        EXPECT_CALL(*node_, IsLeaderTerm())
+            .WillRepeatedly(Return(false));
+    }
+    /**
+     * 测试OnApply
+     * 用例：follower上请求的chunk需要从源端拷贝数据
+     * 预期：不转发给clone manager，返回CHUNK_OP_STATUS_REDIRECTED
+     */
+    {
+        closure->Reset();
+        CSChunkInfo info;
+        info.isClone = true;
+        info.pageSize = PAGE_SIZE;
+        info.chunkSize = CHUNK_SIZE;
+        info.bitmap = std::make_shared<Bitmap>(CHUNK_SIZE / PAGE_SIZE);
+        EXPECT_CALL(*datastore_, GetChunkInfo(_, _))
+            .WillOnce(DoAll(SetArgPointee<1>(info),
+                            Return(CSErrorCode::Success)));
+        EXPECT_CALL(*cloneMgr_, GenerateCloneTask(_, _))
+            .Times(0);
+        EXPECT_CALL(*node_, UpdateAppliedIndex(_))
+            .Times(0);
+
+        opReq->OnApply(LAST_INDEX, closure);
+
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED,
+                  closure->response_->status());
+    }
+    /**
+     * 测试OnApply
+     * 用例：follower上请求的chunk不需要拷贝数据
+     * 预期：从本地读chunk,返回 CHUNK_OP_STATUS_SUCCESS
+     */
+    {
+        closure->Reset();
+        CSChunkInfo info;
+        info.isClone = false;
+        EXPECT_CALL(*datastore_, GetChunkInfo(_, _))
+            .WillOnce(DoAll(SetArgPointee<1>(info),
+                            Return(CSErrorCode::Success)));
+        char chunkData[length]= {0};
+        memset(chunkData, 'a', length);
+        EXPECT_CALL(*datastore_, ReadChunk(_, _, _, offset, length))
+            .WillOnce(DoAll(SetArrayArgument<2>(chunkData,
+                                                chunkData + length),
+                            Return(CSErrorCode::Success)));
+        EXPECT_CALL(*node_, UpdateAppliedIndex(_))
+            .Times(1);
+
+        opReq->OnApply(LAST_INDEX, closure);
+
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                  closure->response_->status());
+        ASSERT_EQ(LAST_INDEX, closure->response_->appliedindex());
+    }
+    // 释放资源
+    closure->Release();
+}
+
 TEST_F(OpRequestTest, RecoverChunkTest) {
     // 创建CreateCloneChunkRequest
     LogicPoolID logicPoolId = 1;
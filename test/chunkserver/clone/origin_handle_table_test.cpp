@@ -0,0 +1,159 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>  // NOLINT
+#include <set>
+#include <string>
+#include <vector>
+
+#include "src/chunkserver/origin_handle_table.h"
+#include "src/common/concurrent/count_down_event.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::common::CountDownEvent;
+
+class OriginHandleTableTest : public testing::Test {
+ public:
+    void SetUp() {
+        nextFd_ = 1;
+        failOpen_ = false;
+        openEvent_.reset(new CountDownEvent(0));
+    }
+
+    OriginHandleTable::OpenFunc Opener() {
+        return [this](const std::string& fileName) {
+            openEvent_->Wait();
+            std::lock_guard<std::mutex> lk(mtx_);
+            opened_[fileName]++;
+            return failOpen_ ? -1 : nextFd_++;
+        };
+    }
+
+    OriginHandleTable::CloseFunc Closer() {
+        return [this](int fd) {
+            std::lock_guard<std::mutex> lk(mtx_);
+            closed_.insert(fd);
+        };
+    }
+
+    // 同步获取句柄
+    scoped_refptr<OriginHandle> GetHandle(OriginHandleTable* table,
+                                          const std::string& fileName) {
+        scoped_refptr<OriginHandle> result;
+        CountDownEvent event(1);
+        table->Get(fileName, [&](const scoped_refptr<OriginHandle>& handle) {
+            result = handle;
+            event.Signal();
+        });
+        event.Wait();
+        return result;
+    }
+
+ protected:
+    std::mutex mtx_;
+    int nextFd_;
+    bool failOpen_;
+    std::map<std::string, int> opened_;
+    std::set<int> closed_;
+    std::unique_ptr<CountDownEvent> openEvent_;
+};
+
+TEST_F(OriginHandleTableTest, CoalesceOpenTest) {
+    OriginHandleTable table(4, 16, Opener(), Closer());
+
+    // 打开完成之前的请求等待同一次打开
+    openEvent_.reset(new CountDownEvent(1));
+    const int kRequests = 10;
+    CountDownEvent done(kRequests);
+    std::atomic<int> fd(0);
+    for (int i = 0; i < kRequests; ++i) {
+        table.Get("file1", [&](const scoped_refptr<OriginHandle>& handle) {
+            ASSERT_TRUE(handle != nullptr);
+            fd = handle->Fd();
+            done.Signal();
+        });
+    }
+    openEvent_->Signal();
+    done.Wait();
+    ASSERT_EQ(1, fd.load());
+    ASSERT_EQ(1, opened_["file1"]);
+
+    // 已经打开的句柄直接返回
+    ASSERT_EQ(1, GetHandle(&table, "file1")->Fd());
+    ASSERT_EQ(1, opened_["file1"]);
+    ASSERT_EQ(1, table.Size());
+
+    table.CloseAll();
+    ASSERT_EQ(0, table.Size());
+    ASSERT_EQ(1, closed_.count(1));
+}
+
+TEST_F(OriginHandleTableTest, OpenFailedTest) {
+    OriginHandleTable table(4, 16, Opener(), Closer());
+
+    // 打开失败不缓存，下次请求重新打开
+    failOpen_ = true;
+    ASSERT_TRUE(GetHandle(&table, "file1") == nullptr);
+    ASSERT_EQ(0, table.Size());
+    failOpen_ = false;
+    ASSERT_TRUE(GetHandle(&table, "file1") != nullptr);
+    ASSERT_EQ(2, opened_["file1"]);
+    ASSERT_EQ(1, table.Size());
+}
+
+TEST_F(OriginHandleTableTest, EvictTest) {
+    // 只有一个分片，最多保留2个句柄
+    OriginHandleTable table(1, 2, Opener(), Closer());
+    ASSERT_EQ(1, GetHandle(&table, "file1")->Fd());
+    // 模拟file2上有未完成的读请求
+    scoped_refptr<OriginHandle> inflight = GetHandle(&table, "file2");
+    ASSERT_EQ(2, inflight->Fd());
+    // 访问file1之后file2是最久未使用的
+    ASSERT_EQ(1, GetHandle(&table, "file1")->Fd());
+
+    // 淘汰file2，但是读请求结束之前不会关闭
+    ASSERT_EQ(3, GetHandle(&table, "file3")->Fd());
+    ASSERT_EQ(2, table.Size());
+    ASSERT_TRUE(closed_.empty());
+
+    // 释放引用之后，在下一次Get时关闭
+    inflight = nullptr;
+    ASSERT_EQ(1, GetHandle(&table, "file1")->Fd());
+    ASSERT_EQ(1, closed_.size());
+    ASSERT_EQ(1, closed_.count(2));
+
+    // 再次访问file2需要重新打开
+    ASSERT_EQ(4, GetHandle(&table, "file2")->Fd());
+    ASSERT_EQ(2, opened_["file2"]);
+
+    table.CloseAll();
+    ASSERT_EQ(4, closed_.size());
+}
+
+}  // namespace chunkserver
+}  // namespace curve
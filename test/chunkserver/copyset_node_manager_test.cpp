@@ -81,6 +81,7 @@ class CopysetNodeManagerTest : public ::testing::Test {
             &CopysetNodeManager::GetInstance();
         copysetNodeManager->Fini();
         ::system("rm -rf node_manager_test");
+        ::system("rm -f node_manager_test.hint");
     }
 
  protected:
@@ -140,6 +141,9 @@ TEST_F(CopysetNodeManagerTest, NormalTest) {
         LOG(FATAL) << "Fail to start Server";
     }
 
+    QosOptions qosOptions;
+    qosOptions.enable = true;
+    defaultOptions_.qosThrottle = std::make_shared<QosThrottle>(qosOptions);
     ASSERT_EQ(0, copysetNodeManager->Init(defaultOptions_));
 
     // 本地 copyset 未加载完成，则无法创建新的copyset
@@ -167,9 +171,16 @@ TEST_F(CopysetNodeManagerTest, NormalTest) {
     copysetNodeManager->GetAllCopysetNodes(&copysetNodes);
     ASSERT_EQ(1, copysetNodes.size());
 
+    // 删除copyset时清理它的限流参数
+    QosLimit limit;
+    limit.iopsLimit = 100;
+    defaultOptions_.qosThrottle->UpdateCopysetLimit(logicPoolId, copysetId,
+                                                    limit);
     ASSERT_TRUE(copysetNodeManager->DeleteCopysetNode(logicPoolId,
                                                       copysetId));
     ASSERT_FALSE(copysetNodeManager->IsExist(logicPoolId, copysetId));
+    ASSERT_TRUE(defaultOptions_.qosThrottle->GetCopysetLimit(
+        logicPoolId, copysetId).IsUnlimited());
 
     ASSERT_EQ(0, copysetNodeManager->Fini());
     ASSERT_EQ(0, server.Stop(0));
@@ -334,5 +345,69 @@ TEST_F(CopysetNodeManagerTest, ReloadTest) {
     ASSERT_EQ(0, copysetNodes.size());
 }
 
+TEST_F(CopysetNodeManagerTest, LazyActivateTest) {
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 10001;
+    Configuration conf;
+    CopysetNodeManager *copysetNodeManager = &CopysetNodeManager::GetInstance();
+
+    // start server
+    brpc::Server server;
+    butil::EndPoint addr(butil::IP_ANY, port);
+    ASSERT_EQ(0, copysetNodeManager->AddService(&server, addr));
+    if (server.Start(port, NULL) != 0) {
+        LOG(FATAL) << "Fail to start Server";
+    }
+
+    // 构造初始环境，退出时记录加载提示
+    defaultOptions_.loadHintPath = "node_manager_test.hint";
+    ASSERT_EQ(0, copysetNodeManager->Init(defaultOptions_));
+    ASSERT_EQ(0, copysetNodeManager->Run());
+    int copysetNum = 5;
+    for (int i = 0; i < copysetNum; ++i) {
+        ASSERT_TRUE(copysetNodeManager->CreateCopysetNode(logicPoolId,
+                                                          copysetId + i,
+                                                          conf));
+    }
+    std::vector<std::shared_ptr<CopysetNode>> copysetNodes;
+    copysetNodeManager->GetAllCopysetNodes(&copysetNodes);
+    for (auto &node : copysetNodes) {
+        ASSERT_TRUE(node->IsActivated());
+    }
+    ASSERT_EQ(0, copysetNodeManager->Fini());
+    ASSERT_EQ(0, ::access(defaultOptions_.loadHintPath.c_str(), F_OK));
+
+    // 延迟激活，copyset注册之后即加载完成，datastore在后台激活
+    defaultOptions_.lazyActivate = true;
+    ASSERT_EQ(0, copysetNodeManager->Init(defaultOptions_));
+    ASSERT_EQ(0, copysetNodeManager->Run());
+    ASSERT_TRUE(copysetNodeManager->LoadFinished());
+    copysetNodes.clear();
+    copysetNodeManager->GetAllCopysetNodes(&copysetNodes);
+    ASSERT_EQ(copysetNum, copysetNodes.size());
+    for (auto &node : copysetNodes) {
+        int retry = 0;
+        while (!node->IsActivated() && retry++ < 100) {
+            ::usleep(100 * 1000);
+        }
+        ASSERT_TRUE(node->IsActivated());
+    }
+    // 已经激活的copyset不会重复激活
+    copysetNodeManager->ActivateCopysets();
+    ASSERT_EQ(0, copysetNodeManager->SaveLoadHints());
+    ASSERT_EQ(0, copysetNodeManager->Fini());
+    copysetNodes.clear();
+
+    // 获取datastore不会触发激活，需要显式激活
+    CopysetNode node(logicPoolId, copysetId, conf);
+    ASSERT_EQ(0, node.Init(defaultOptions_));
+    ASSERT_FALSE(node.IsActivated());
+    ASSERT_NE(nullptr, node.GetDataStore());
+    ASSERT_FALSE(node.IsActivated());
+    ASSERT_EQ(0, node.Activate());
+    ASSERT_TRUE(node.IsActivated());
+    ASSERT_EQ(0, node.Activate());
+}
+
 }  // namespace chunkserver
 }  // namespace curve
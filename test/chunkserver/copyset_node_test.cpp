@@ -41,6 +41,7 @@
 #include "proto/heartbeat.pb.h"
 #include "src/chunkserver/raftsnapshot/curve_snapshot_attachment.h"
 #include "test/chunkserver/mock_curve_filesystem_adaptor.h"
+#include "test/chunkserver/clone/mock_clone_copyer.h"
 
 namespace curve {
 namespace chunkserver {
@@ -1008,5 +1009,66 @@ TEST_F(CopysetNodeTest, get_leader_status) {
     }
 }
 
+TEST_F(CopysetNodeTest, fetch_clone_data) {
+    LogicPoolID logicPoolID = 123;
+    CopysetID copysetID = 1345;
+    Configuration conf;
+    std::shared_ptr<MockChunkCopyer> copyer =
+        std::make_shared<MockChunkCopyer>();
+    CopysetNodeOptions options = defaultOptions_;
+    options.copyer = copyer;
+    options.fetchCloneDataRetryTimes = 2;
+    options.fetchCloneDataRetryIntervalMs = 1;
+
+    ChunkRequest request;
+    request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_PASTE);
+    request.set_logicpoolid(logicPoolID);
+    request.set_copysetid(copysetID);
+    request.set_chunkid(1);
+    request.set_offset(0);
+    request.set_size(4096);
+    request.set_location("/file@cs");
+
+    // 重试后成功，返回重试拿到的数据
+    {
+        CopysetNode copysetNode(logicPoolID, copysetID, conf);
+        ASSERT_EQ(0, copysetNode.Init(options));
+        butil::IOBuf data;
+        EXPECT_CALL(*copyer, DownloadSync("/file@cs", 0, 4096, _))
+            .Times(2)
+            .WillOnce(Invoke([](const std::string&, off_t, size_t,
+                                butil::IOBuf *buf) {
+                buf->append("partial");
+                return -1;
+            }))
+            .WillOnce(Invoke([](const std::string&, off_t, size_t size,
+                                butil::IOBuf *buf) {
+                buf->append(std::string(size, 'a'));
+                return 0;
+            }));
+        ASSERT_EQ(0, copysetNode.FetchCloneData(request, &data));
+        ASSERT_EQ(std::string(4096, 'a'), data.to_string());
+    }
+
+    // 重试次数用完仍然失败，返回失败
+    {
+        CopysetNode copysetNode(logicPoolID, copysetID, conf);
+        ASSERT_EQ(0, copysetNode.Init(options));
+        butil::IOBuf data;
+        EXPECT_CALL(*copyer, DownloadSync(_, _, _, _))
+            .Times(3)
+            .WillRepeatedly(Return(-1));
+        ASSERT_EQ(-1, copysetNode.FetchCloneData(request, &data));
+    }
+
+    // 没有copyer直接返回失败
+    {
+        CopysetNode copysetNode(logicPoolID, copysetID, conf);
+        ASSERT_EQ(0, copysetNode.Init(defaultOptions_));
+        butil::IOBuf data;
+        ASSERT_EQ(-1, copysetNode.FetchCloneData(request, &data));
+    }
+}
+
 }  // namespace chunkserver
 }  // namespace curve
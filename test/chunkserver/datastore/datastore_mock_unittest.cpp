@@ -3986,6 +3986,55 @@ TEST_F(CSDataStore_test, GetStatusTest) {
         .Times(1);
 }
 
+/*
+ * metapage中applied index的编解码测试
+ */
+TEST_F(CSDataStore_test, MetaPageAppliedIndexTest) {
+    char buf[PAGE_SIZE];
+    char otherBuf[PAGE_SIZE];
+    ChunkFileMetaPage metaPage;
+    metaPage.version = FORMAT_VERSION;
+    metaPage.sn = 2;
+    metaPage.correctedSn = 0;
+    metaPage.location = "test@cs";
+    metaPage.bitmap = std::make_shared<Bitmap>(CHUNK_SIZE / PAGE_SIZE);
+
+    // 编码后可以解析出applied index
+    memset(buf, 0, PAGE_SIZE);
+    metaPage.appliedIndex = 100;
+    metaPage.encode(buf);
+    ChunkFileMetaPage decoded;
+    ASSERT_EQ(CSErrorCode::Success, decoded.decode(buf));
+    ASSERT_EQ(100, decoded.appliedIndex);
+    ASSERT_EQ(2, decoded.sn);
+    ASSERT_EQ("test@cs", decoded.location);
+
+    // 找到applied index所在的位置，模拟老版本写入的metapage
+    memset(otherBuf, 0, PAGE_SIZE);
+    metaPage.appliedIndex = 200;
+    metaPage.encode(otherBuf);
+    int offset = 0;
+    while (offset < PAGE_SIZE && buf[offset] == otherBuf[offset]) {
+        ++offset;
+    }
+    ASSERT_LT(offset, PAGE_SIZE);
+    memset(buf + offset, 0, PAGE_SIZE - offset);
+    ChunkFileMetaPage oldMetaPage;
+    ASSERT_EQ(CSErrorCode::Success, oldMetaPage.decode(buf));
+    ASSERT_EQ(0, oldMetaPage.appliedIndex);
+    ASSERT_EQ(2, oldMetaPage.sn);
+
+    // applied index损坏时当作0处理，不影响metapage的其他内容
+    metaPage.encode(buf);
+    buf[offset] ^= 0xff;
+    ChunkFileMetaPage corrupted;
+    ASSERT_EQ(CSErrorCode::Success, corrupted.decode(buf));
+    ASSERT_EQ(0, corrupted.appliedIndex);
+
+    // chunk不存在时applied index为0
+    ASSERT_EQ(0, dataStore->GetChunkAppliedIndex(1));
+}
+
 }  // namespace chunkserver
 }  // namespace curve
 
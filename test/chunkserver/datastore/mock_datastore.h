@@ -66,6 +66,12 @@ class MockDataStore : public CSDataStore {
                                          off_t,
                                          size_t));
     MOCK_METHOD2(GetChunkInfo, CSErrorCode(ChunkID, CSChunkInfo*));
+    MOCK_METHOD4(GetChunkHash, CSErrorCode(ChunkID,
+                                           off_t,
+                                           size_t,
+                                           std::string*));
+    MOCK_METHOD2(UpdateAppliedIndex, void(ChunkID, uint64_t));
+    MOCK_METHOD1(GetChunkAppliedIndex, uint64_t(ChunkID));
     MOCK_METHOD0(GetStatus, DataStoreStatus());
 };
 
@@ -26,6 +26,7 @@
 #include <gmock/gmock.h>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "src/chunkserver/copyset_node.h"
 
@@ -40,8 +41,11 @@ class MockCopysetNode : public CopysetNode {
     MOCK_METHOD1(Init, int(const CopysetNodeOptions&));
     MOCK_METHOD0(Run, int());
     MOCK_METHOD0(Fini, void());
+    MOCK_CONST_METHOD0(IsActivated, bool());
     MOCK_CONST_METHOD0(IsLeaderTerm, bool());
+    MOCK_CONST_METHOD0(IsFollowingLeader, bool());
     MOCK_CONST_METHOD0(GetLeaderId, PeerId());
+    MOCK_METHOD1(ListPeers, void(std::vector<Peer>*));
     MOCK_CONST_METHOD0(GetConfEpoch, uint64_t());
     MOCK_METHOD1(UpdateAppliedIndex, void(uint64_t));
     MOCK_CONST_METHOD0(GetAppliedIndex, uint64_t());
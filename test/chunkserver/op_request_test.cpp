@@ -32,6 +32,7 @@
 #include "src/chunkserver/copyset_node.h"
 #include "src/chunkserver/copyset_node_manager.h"
 #include "src/chunkserver/op_request.h"
+#include "src/common/crc32.h"
 #include "test/chunkserver/fake_datastore.h"
 
 namespace curve {
@@ -694,5 +695,79 @@ TEST(ChunkOpRequestTest, OnApplyFromLogTest) {
     }
 }
 
+TEST(ChunkOpRequestTest, CheckDataCrcTest) {
+    ChunkRequest request;
+    request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+    request.set_logicpoolid(1);
+    request.set_copysetid(1);
+    request.set_chunkid(1);
+    request.set_offset(0);
+    request.set_size(8192);
+
+    std::string str(8192, 'a');
+    butil::IOBuf data;
+    data.append(str.c_str(), 4096);
+    data.append(str.c_str() + 4096, 4096);
+
+    // 没有携带crc时不校验
+    ASSERT_TRUE(WriteChunkRequest::CheckDataCrc(request, data));
+
+    request.set_crc(curve::common::CRC32(str.c_str(), str.size()));
+    ASSERT_TRUE(WriteChunkRequest::CheckDataCrc(request, data));
+
+    // 数据被破坏
+    butil::IOBuf broken;
+    str[100] = 'b';
+    broken.append(str);
+    ASSERT_FALSE(WriteChunkRequest::CheckDataCrc(request, broken));
+}
+
+TEST(ChunkOpRequestTest, DecodeLogEntryTest) {
+    ChunkRequest request;
+    request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+    request.set_logicpoolid(1);
+    request.set_copysetid(1);
+    request.set_chunkid(2);
+    request.set_offset(4096);
+    request.set_size(8192);
+    std::string str(8192, 'a');
+    butil::IOBuf attachment;
+    attachment.append(str);
+
+    butil::IOBuf log;
+    ASSERT_EQ(0, ChunkOpRequest::Encode(&request, &attachment, &log));
+
+    // 解析不修改log，data中是请求携带的数据
+    ChunkRequest decoded;
+    butil::IOBuf data;
+    data.append("stale");
+    size_t logSize = log.size();
+    ASSERT_EQ(0, ChunkOpRequest::DecodeLogEntry(log, &decoded, &data));
+    ASSERT_EQ(logSize, log.size());
+    ASSERT_EQ(request.SerializeAsString(), decoded.SerializeAsString());
+    ASSERT_EQ(str, data.to_string());
+
+    // log不完整
+    butil::IOBuf broken;
+    log.append_to(&broken, log.size() - str.size() - 1);
+    ASSERT_EQ(-1, ChunkOpRequest::DecodeLogEntry(broken, &decoded, &data));
+    broken.clear();
+    log.append_to(&broken, 2);
+    ASSERT_EQ(-1, ChunkOpRequest::DecodeLogEntry(broken, &decoded, &data));
+
+    // 同一种op类型共用一个applier
+    ChunkOpRequest *applier =
+        ChunkOpRequest::GetLogApplier(CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+    ASSERT_TRUE(dynamic_cast<WriteChunkRequest*>(applier) != nullptr);
+    ASSERT_EQ(applier,
+              ChunkOpRequest::GetLogApplier(CHUNK_OP_TYPE::CHUNK_OP_WRITE));
+    ASSERT_EQ(ChunkOpRequest::GetLogApplier(CHUNK_OP_TYPE::CHUNK_OP_READ),
+              ChunkOpRequest::GetLogApplier(CHUNK_OP_TYPE::CHUNK_OP_RECOVER));
+    ASSERT_TRUE(dynamic_cast<PasteChunkInternalRequest*>(
+        ChunkOpRequest::GetLogApplier(CHUNK_OP_TYPE::CHUNK_OP_PASTE)));
+    ASSERT_TRUE(ChunkOpRequest::GetLogApplier(
+        CHUNK_OP_TYPE::CHUNK_OP_UNKNOWN) == nullptr);
+}
+
 }  // namespace chunkserver
 }  // namespace curve
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "src/chunkserver/op_trace.h"
+
+namespace curve {
+namespace chunkserver {
+
+TEST(OpTraceTest, StageLatencyTest) {
+    OpTrace trace;
+    ASSERT_FALSE(trace.Started());
+
+    // 走applied index的读请求不经过propose和commit阶段
+    trace.timeUs[kOpStageReceived] = 100;
+    trace.timeUs[kOpStageThrottled] = 110;
+    trace.timeUs[kOpStageApplyBegin] = 150;
+    trace.timeUs[kOpStageIODone] = 250;
+    trace.timeUs[kOpStageResponded] = 260;
+    ASSERT_TRUE(trace.Started());
+    ASSERT_EQ(-1, trace.StageLatency(kOpStageReceived));
+    ASSERT_EQ(10, trace.StageLatency(kOpStageThrottled));
+    ASSERT_EQ(-1, trace.StageLatency(kOpStageProposed));
+    ASSERT_EQ(-1, trace.StageLatency(kOpStageCommitted));
+    ASSERT_EQ(40, trace.StageLatency(kOpStageApplyBegin));
+    ASSERT_EQ(100, trace.StageLatency(kOpStageIODone));
+    ASSERT_EQ(10, trace.StageLatency(kOpStageResponded));
+    ASSERT_EQ(160, trace.TotalLatency());
+
+    ASSERT_STREQ("apply_queue", OpStageName(kOpStageApplyBegin));
+    ASSERT_STREQ("io", OpStageName(kOpStageIODone));
+}
+
+TEST(OpTraceTest, SlowRequestTest) {
+    OpTracer* tracer = OpTracer::GetInstance();
+    OpTracerOptions options;
+    ASSERT_FALSE(tracer->ShouldSample());
+
+    options.sampleInterval = 2;
+    options.slowRequestUs = 1000;
+    options.slowRequestNum = 2;
+    tracer->Init(options);
+    ASSERT_TRUE(tracer->Enabled());
+    int sampled = 0;
+    for (int i = 0; i < 10; ++i) {
+        sampled += tracer->ShouldSample() ? 1 : 0;
+    }
+    ASSERT_EQ(5, sampled);
+
+    ChunkRequest request;
+    request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+    request.set_logicpoolid(1);
+    request.set_copysetid(2);
+    request.set_chunkid(3);
+    ChunkResponse response;
+    response.set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+
+    OpTrace trace;
+    trace.timeUs[kOpStageReceived] = 1;
+    trace.timeUs[kOpStageProposed] = 10;
+    trace.timeUs[kOpStageCommitted] = 900;
+    trace.timeUs[kOpStageResponded] = 500;
+    // 没有超过阈值不记录
+    tracer->OnFinish(request, response, trace);
+    ASSERT_TRUE(tracer->DumpSlowRequests().empty());
+
+    trace.timeUs[kOpStageResponded] = 2001;
+    for (uint64_t id = 1; id <= 3; ++id) {
+        request.set_chunkid(id);
+        tracer->OnFinish(request, response, trace);
+    }
+    // 只保留最近的2个慢请求，新的在前
+    std::string dump = tracer->DumpSlowRequests();
+    ASSERT_EQ(std::string::npos, dump.find("chunkid: 1 "));
+    ASSERT_LT(dump.find("chunkid: 3 "), dump.find("chunkid: 2 "));
+    ASSERT_NE(std::string::npos, dump.find("replicate: 890us"));
+    ASSERT_NE(std::string::npos, dump.find("total: 2000us"));
+
+    tracer->Init(OpTracerOptions());
+    ASSERT_FALSE(tracer->Enabled());
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,281 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include "src/common/timeutility.h"
+#include "src/chunkserver/qos_throttle.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::common::TimeUtility;
+
+TEST(TokenBucketTest, basic) {
+    uint64_t waitUs = 0;
+    // rate为0表示不限制
+    {
+        TokenBucket bucket(0, 0);
+        ASSERT_TRUE(bucket.Reserve(1000000, 0, 0, &waitUs));
+        ASSERT_EQ(0, waitUs);
+    }
+    // 桶满时不需要等待，透支后按照速率计算等待时间
+    {
+        TokenBucket bucket(100, 0);
+        ASSERT_EQ(100, bucket.Burst());
+        uint64_t now = TimeUtility::GetTimeofDayUs() + 1000000;
+        ASSERT_TRUE(bucket.Reserve(0, now, 1000000, &waitUs));
+        for (int i = 0; i < 100; ++i) {
+            ASSERT_TRUE(bucket.Reserve(1, now, 1000000, &waitUs));
+            ASSERT_EQ(0, waitUs);
+        }
+        // 透支1个令牌，需要等待10ms
+        ASSERT_TRUE(bucket.Reserve(1, now, 1000000, &waitUs));
+        ASSERT_EQ(10000, waitUs);
+        // 后来的请求排在后面
+        ASSERT_TRUE(bucket.Reserve(1, now, 1000000, &waitUs));
+        ASSERT_EQ(20000, waitUs);
+        // 经过20ms之后令牌补齐
+        ASSERT_TRUE(bucket.Reserve(1, now + 30000, 1000000, &waitUs));
+        ASSERT_EQ(0, waitUs);
+    }
+    // 令牌补充不会超过burst
+    {
+        TokenBucket bucket(100, 10);
+        uint64_t now = TimeUtility::GetTimeofDayUs() + 1000000;
+        ASSERT_TRUE(bucket.Reserve(0, now, 1000000, &waitUs));
+        now += 10000000;
+        for (int i = 0; i < 10; ++i) {
+            ASSERT_TRUE(bucket.Reserve(1, now, 1000000, &waitUs));
+            ASSERT_EQ(0, waitUs);
+        }
+        ASSERT_TRUE(bucket.Reserve(1, now, 1000000, &waitUs));
+        ASSERT_EQ(10000, waitUs);
+    }
+}
+
+TEST(TokenBucketTest, OverdraftLimit) {
+    uint64_t waitUs = 0;
+    TokenBucket bucket(100, 0);
+    uint64_t now = TimeUtility::GetTimeofDayUs() + 1000000;
+    ASSERT_TRUE(bucket.Reserve(100, now, 50000, &waitUs));
+    ASSERT_EQ(0, waitUs);
+    // 透支的令牌在50ms内可以补齐
+    for (int i = 1; i <= 5; ++i) {
+        ASSERT_TRUE(bucket.Reserve(1, now, 50000, &waitUs));
+        ASSERT_EQ(i * 10000, waitUs);
+    }
+    // 继续透支需要等待超过50ms，不再预留，透支不会继续增长
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_FALSE(bucket.Reserve(1, now, 50000, &waitUs));
+    }
+    // 补充10ms的令牌后又可以预留
+    ASSERT_TRUE(bucket.Reserve(1, now + 10000, 50000, &waitUs));
+    ASSERT_EQ(50000, waitUs);
+
+    // 归还令牌之后等待时间相应减少
+    bucket.Cancel(1);
+    ASSERT_TRUE(bucket.Reserve(1, now + 10000, 50000, &waitUs));
+    ASSERT_EQ(50000, waitUs);
+
+    // 桶中没有透支时，超过桶容量的大请求也可以预留
+    TokenBucket bigBucket(100, 0);
+    ASSERT_TRUE(bigBucket.Reserve(1000, now, 50000, &waitUs));
+    ASSERT_EQ(9000000, waitUs);
+    ASSERT_FALSE(bigBucket.Reserve(1, now, 50000, &waitUs));
+}
+
+TEST(QosThrottleTest, basic) {
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 100001;
+    uint64_t waitUs = 0;
+    // 没有开启QoS
+    {
+        QosOptions options;
+        options.enable = false;
+        options.copysetLimit.iopsLimit = 1;
+        QosThrottle throttle(options);
+        ASSERT_FALSE(throttle.Enabled());
+        for (int i = 0; i < 10; ++i) {
+            ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 1, 4096,
+                                         &waitUs));
+            ASSERT_EQ(0, waitUs);
+        }
+    }
+    // 默认不限流
+    {
+        QosOptions options;
+        options.enable = true;
+        QosThrottle throttle(options);
+        for (int i = 0; i < 10; ++i) {
+            ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 1, 4096,
+                                         &waitUs));
+            ASSERT_EQ(0, waitUs);
+        }
+        ASSERT_TRUE(throttle.GetCopysetLimit(logicPoolId, copysetId)
+                    .IsUnlimited());
+    }
+    // copyset粒度的限流
+    {
+        QosOptions options;
+        options.enable = true;
+        options.copysetLimit.iopsLimit = 10;
+        QosThrottle throttle(options);
+        for (int i = 0; i < 10; ++i) {
+            ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 0, 4096,
+                                         &waitUs));
+            ASSERT_EQ(0, waitUs);
+        }
+        ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 0, 4096,
+                                     &waitUs));
+        ASSERT_LT(0, waitUs);
+        // 其他copyset不受影响
+        ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId + 1, 0, 4096,
+                                     &waitUs));
+        ASSERT_EQ(0, waitUs);
+    }
+    // 卷粒度的限流，等待时间不超过maxWaitUs，已经透支时超过的请求被拒绝
+    {
+        QosOptions options;
+        options.enable = true;
+        options.fileLimit.bpsLimit = 4096;
+        options.maxWaitUs = 500000;
+        QosThrottle throttle(options);
+        ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 1, 4096,
+                                     &waitUs));
+        ASSERT_EQ(0, waitUs);
+        ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 1, 4096,
+                                     &waitUs));
+        ASSERT_EQ(500000, waitUs);
+        ASSERT_FALSE(throttle.Reserve(logicPoolId, copysetId, 1, 4096,
+                                      &waitUs));
+        ASSERT_FALSE(throttle.Throttle(logicPoolId, copysetId, 1, 4096));
+        // 其他卷以及不携带file id的请求不受影响
+        ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 2, 4096,
+                                     &waitUs));
+        ASSERT_EQ(0, waitUs);
+        ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 0, 4096,
+                                     &waitUs));
+        ASSERT_EQ(0, waitUs);
+    }
+    // 卷上的请求被拒绝时，归还copyset上预留的令牌
+    {
+        QosOptions options;
+        options.enable = true;
+        options.copysetLimit.iopsLimit = 3;
+        options.fileLimit.iopsLimit = 1;
+        options.maxWaitUs = 100000;
+        QosThrottle throttle(options);
+        ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 1, 4096,
+                                     &waitUs));
+        ASSERT_EQ(0, waitUs);
+        ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 1, 4096,
+                                     &waitUs));
+        ASSERT_EQ(100000, waitUs);
+        for (int i = 0; i < 10; ++i) {
+            ASSERT_FALSE(throttle.Reserve(logicPoolId, copysetId, 1, 4096,
+                                          &waitUs));
+        }
+        // copyset上还剩1个令牌
+        ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 2, 4096,
+                                     &waitUs));
+        ASSERT_EQ(0, waitUs);
+    }
+}
+
+TEST(QosThrottleTest, UpdateLimit) {
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 100001;
+    uint64_t waitUs = 0;
+    QosOptions options;
+    options.enable = true;
+    QosThrottle throttle(options);
+
+    QosLimit limit;
+    limit.iopsLimit = 1;
+    throttle.UpdateCopysetLimit(logicPoolId, copysetId, limit);
+    QosLimit current = throttle.GetCopysetLimit(logicPoolId, copysetId);
+    ASSERT_EQ(1, current.iopsLimit);
+    ASSERT_EQ(1, current.iopsBurst);
+    ASSERT_EQ(0, current.bpsLimit);
+    ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 0, 4096, &waitUs));
+    ASSERT_EQ(0, waitUs);
+    ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 0, 4096, &waitUs));
+    ASSERT_LT(0, waitUs);
+
+    // 修改为不限流
+    throttle.UpdateCopysetLimit(logicPoolId, copysetId, QosLimit());
+    ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 0, 4096, &waitUs));
+    ASSERT_EQ(0, waitUs);
+
+    // 删除copyset之后恢复默认值
+    throttle.RemoveCopyset(logicPoolId, copysetId);
+    ASSERT_TRUE(throttle.GetCopysetLimit(logicPoolId, copysetId)
+                .IsUnlimited());
+
+    limit.iopsLimit = 0;
+    limit.bpsLimit = 1024;
+    limit.bpsBurst = 2048;
+    throttle.UpdateFileLimit(1, limit);
+    current = throttle.GetFileLimit(1);
+    ASSERT_EQ(1024, current.bpsLimit);
+    ASSERT_EQ(2048, current.bpsBurst);
+    ASSERT_TRUE(throttle.GetFileLimit(2).IsUnlimited());
+    ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 1, 2048, &waitUs));
+    ASSERT_EQ(0, waitUs);
+    ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 1, 1, &waitUs));
+    ASSERT_LT(0, waitUs);
+}
+
+TEST(QosThrottleTest, RecycleIdleFileBuckets) {
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 100001;
+    uint64_t waitUs = 0;
+    QosOptions options;
+    options.enable = true;
+    options.fileLimit.bpsLimit = 1;
+    options.fileLimit.bpsBurst = 4096;
+    options.maxWaitUs = 100000;
+    options.fileBucketIdleS = 1;
+    QosThrottle throttle(options);
+
+    // 卷1使用默认限流参数，卷2单独设置过限流参数，两个卷都透支
+    throttle.UpdateFileLimit(2, options.fileLimit);
+    for (uint64_t fileId = 1; fileId <= 2; ++fileId) {
+        ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, fileId, 8192,
+                                     &waitUs));
+        ASSERT_FALSE(throttle.Reserve(logicPoolId, copysetId, fileId, 1,
+                                      &waitUs));
+    }
+
+    // 空闲超过1s之后，卷1的令牌桶被回收，重新创建的令牌桶是满的；
+    // 卷2的令牌桶保留，仍然处于透支状态
+    ::usleep(1100 * 1000);
+    ASSERT_TRUE(throttle.Reserve(logicPoolId, copysetId, 1, 4096, &waitUs));
+    ASSERT_EQ(0, waitUs);
+    ASSERT_FALSE(throttle.Reserve(logicPoolId, copysetId, 2, 1, &waitUs));
+    ASSERT_EQ(1, throttle.GetFileLimit(2).bpsLimit);
+}
+
+}  // namespace chunkserver
+}  // namespace curve
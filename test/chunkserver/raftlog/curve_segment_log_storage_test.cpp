@@ -0,0 +1,216 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <braft/log_entry.h>
+#include <braft/configuration_manager.h>
+
+#include <memory>
+#include <string>
+
+#include "src/fs/local_filesystem.h"
+#include "src/chunkserver/datastore/chunkfile_pool.h"
+#include "src/chunkserver/raftlog/curve_segment_log_storage.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::fs::FileSystemType;
+using curve::fs::LocalFileSystem;
+using curve::fs::LocalFsFactory;
+
+const char kRaftLogTestDir[] = "./raftlogtest";
+const char kWalPoolDir[] = "./raftlogtest/walpool";
+const char kWalPoolMeta[] = "./raftlogtest/walpool.meta";
+const char kLogDir[] = "./raftlogtest/log";
+const uint32_t kSegmentSize = 64 * 1024;
+const uint32_t kMetaPageSize = 4096;
+const int kPoolFileNum = 16;
+
+class CurveSegmentLogStorageTest : public testing::Test {
+ public:
+    void SetUp() {
+        fsptr_ = LocalFsFactory::CreateFs(FileSystemType::EXT4, "");
+        fsptr_->Mkdir(kRaftLogTestDir);
+        fsptr_->Mkdir(kWalPoolDir);
+        // 预先生成格式化好的segment文件
+        char data[kSegmentSize + kMetaPageSize];
+        memset(data, 'a', sizeof(data));
+        for (int i = 1; i <= kPoolFileNum; ++i) {
+            std::string filename = std::string(kWalPoolDir) + "/"
+                                 + std::to_string(i);
+            int fd = fsptr_->Open(filename.c_str(), O_RDWR | O_CREAT);
+            ASSERT_GE(fd, 0);
+            ASSERT_EQ(sizeof(data),
+                      fsptr_->Write(fd, data, 0, sizeof(data)));
+            fsptr_->Close(fd);
+        }
+        ASSERT_EQ(0, ChunkfilePoolHelper::PersistEnCodeMetaInfo(
+            fsptr_, kSegmentSize, kMetaPageSize, kWalPoolDir, kWalPoolMeta));
+
+        ChunkfilePoolOptions options;
+        options.getChunkFromPool = true;
+        options.chunkSize = kSegmentSize;
+        options.metaPageSize = kMetaPageSize;
+        options.cpMetaFileSize = 4096;
+        memcpy(options.chunkFilePoolDir, kWalPoolDir, strlen(kWalPoolDir));
+        memcpy(options.metaPath, kWalPoolMeta, strlen(kWalPoolMeta));
+        walPool_ = std::make_shared<ChunkfilePool>(fsptr_);
+        ASSERT_TRUE(walPool_->Initialize(options));
+    }
+
+    void TearDown() {
+        walPool_->UnInitialize();
+        fsptr_->Delete(kRaftLogTestDir);
+    }
+
+    // 追加[firstIndex, lastIndex]的entry，每条entry的数据为dataSize字节
+    void AppendEntries(braft::LogStorage* storage, int64_t firstIndex,
+                       int64_t lastIndex, int64_t term, size_t dataSize) {
+        std::vector<braft::LogEntry*> entries;
+        for (int64_t index = firstIndex; index <= lastIndex; ++index) {
+            braft::LogEntry* entry = new braft::LogEntry();
+            entry->AddRef();
+            entry->type = braft::ENTRY_TYPE_DATA;
+            entry->id = braft::LogId(index, term);
+            entry->data.append(std::string(dataSize, 'a' + index % 26));
+            entries.push_back(entry);
+        }
+        ASSERT_EQ(entries.size(), storage->append_entries(entries, nullptr));
+        for (auto entry : entries) {
+            entry->Release();
+        }
+    }
+
+    void CheckEntry(braft::LogStorage* storage, int64_t index, int64_t term,
+                    size_t dataSize) {
+        braft::LogEntry* entry = storage->get_entry(index);
+        ASSERT_NE(nullptr, entry);
+        ASSERT_EQ(index, entry->id.index);
+        ASSERT_EQ(term, entry->id.term);
+        ASSERT_EQ(braft::ENTRY_TYPE_DATA, entry->type);
+        ASSERT_EQ(std::string(dataSize, 'a' + index % 26),
+                  entry->data.to_string());
+        ASSERT_EQ(term, storage->get_term(index));
+        entry->Release();
+    }
+
+ protected:
+    std::shared_ptr<LocalFileSystem> fsptr_;
+    std::shared_ptr<ChunkfilePool> walPool_;
+};
+
+TEST_F(CurveSegmentLogStorageTest, AppendAndGet) {
+    braft::ConfigurationManager confMgr;
+    CurveSegmentLogStorage storage(kLogDir, walPool_);
+    ASSERT_EQ(0, storage.init(&confMgr));
+    ASSERT_EQ(1, storage.first_log_index());
+    ASSERT_EQ(0, storage.last_log_index());
+    ASSERT_EQ(kPoolFileNum, walPool_->Size());
+
+    // 每个segment可以容纳16条entry，总共写入4个segment
+    AppendEntries(&storage, 1, 50, 1, 4000);
+    ASSERT_EQ(1, storage.first_log_index());
+    ASSERT_EQ(50, storage.last_log_index());
+    ASSERT_EQ(kPoolFileNum - 4, walPool_->Size());
+    ASSERT_EQ(3, storage.Segments().size());
+    for (int64_t index = 1; index <= 50; ++index) {
+        CheckEntry(&storage, index, 1, 4000);
+    }
+    ASSERT_EQ(nullptr, storage.get_entry(51));
+    ASSERT_EQ(0, storage.get_term(51));
+
+    // 超过segment大小的entry不能写入
+    braft::LogEntry* entry = new braft::LogEntry();
+    entry->AddRef();
+    entry->type = braft::ENTRY_TYPE_DATA;
+    entry->id = braft::LogId(51, 1);
+    entry->data.append(std::string(kSegmentSize, 'a'));
+    std::vector<braft::LogEntry*> entries{entry};
+    ASSERT_EQ(0, storage.append_entries(entries, nullptr));
+    entry->Release();
+    ASSERT_EQ(50, storage.last_log_index());
+}
+
+TEST_F(CurveSegmentLogStorageTest, Reload) {
+    {
+        braft::ConfigurationManager confMgr;
+        CurveSegmentLogStorage storage(kLogDir, walPool_);
+        ASSERT_EQ(0, storage.init(&confMgr));
+        AppendEntries(&storage, 1, 20, 1, 4000);
+    }
+    // 重启之后entry都能读到，open segment被关闭，新的entry写入新的segment
+    braft::ConfigurationManager confMgr;
+    CurveSegmentLogStorage storage(kLogDir, walPool_);
+    ASSERT_EQ(0, storage.init(&confMgr));
+    ASSERT_EQ(1, storage.first_log_index());
+    ASSERT_EQ(20, storage.last_log_index());
+    ASSERT_EQ(2, storage.Segments().size());
+    for (int64_t index = 1; index <= 20; ++index) {
+        CheckEntry(&storage, index, 1, 4000);
+    }
+    AppendEntries(&storage, 21, 25, 2, 4000);
+    ASSERT_EQ(kPoolFileNum - 3, walPool_->Size());
+    for (int64_t index = 21; index <= 25; ++index) {
+        CheckEntry(&storage, index, 2, 4000);
+    }
+}
+
+TEST_F(CurveSegmentLogStorageTest, Truncate) {
+    braft::ConfigurationManager confMgr;
+    CurveSegmentLogStorage storage(kLogDir, walPool_);
+    ASSERT_EQ(0, storage.init(&confMgr));
+    AppendEntries(&storage, 1, 50, 1, 4000);
+    ASSERT_EQ(kPoolFileNum - 4, walPool_->Size());
+
+    // truncate suffix，被删除的segment回收到池中
+    ASSERT_EQ(0, storage.truncate_suffix(10));
+    ASSERT_EQ(10, storage.last_log_index());
+    ASSERT_EQ(kPoolFileNum - 1, walPool_->Size());
+    ASSERT_EQ(nullptr, storage.get_entry(11));
+    CheckEntry(&storage, 10, 1, 4000);
+
+    // 覆盖写入新term的entry
+    AppendEntries(&storage, 11, 40, 2, 4000);
+    ASSERT_EQ(40, storage.last_log_index());
+    CheckEntry(&storage, 10, 1, 4000);
+    CheckEntry(&storage, 11, 2, 4000);
+
+    // truncate prefix
+    size_t before = walPool_->Size();
+    ASSERT_EQ(0, storage.truncate_prefix(35));
+    ASSERT_EQ(35, storage.first_log_index());
+    ASSERT_LT(before, walPool_->Size());
+    ASSERT_EQ(nullptr, storage.get_entry(34));
+    CheckEntry(&storage, 35, 2, 4000);
+
+    // reset
+    ASSERT_EQ(0, storage.reset(100));
+    ASSERT_EQ(100, storage.first_log_index());
+    ASSERT_EQ(99, storage.last_log_index());
+    ASSERT_EQ(kPoolFileNum, walPool_->Size());
+    AppendEntries(&storage, 100, 101, 3, 4000);
+    CheckEntry(&storage, 101, 3, 4000);
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,175 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+/**
+ * 对比每个copyset独立的raft日志(braft SegmentLogStorage)与所有copyset共享
+ * 同一个日志(SharedLogStorage)的写入性能，每个copyset一个bthread循环追加
+ * entry，统计总的IOPS和p99延迟，例如:
+ *   ./shared_log_bench --copyset_nums=100,500,1000 --duration_s=30
+ */
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <bthread/bthread.h>
+#include <butil/atomicops.h>
+#include <butil/file_util.h>
+#include <butil/string_splitter.h>
+#include <bvar/bvar.h>
+#include <braft/log.h>
+#include <braft/log_entry.h>
+#include <braft/configuration_manager.h>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/chunkserver/raftlog/shared_log.h"
+#include "src/chunkserver/raftlog/shared_log_storage.h"
+
+DEFINE_string(copyset_nums, "100,500,1000",
+              "Copyset numbers to test, separated by comma");
+DEFINE_string(dir, "./shared_log_bench", "Directory of the raft logs");
+DEFINE_int32(duration_s, 10, "Duration of each test case");
+DEFINE_int32(entry_size, 4096, "Data size of each entry");
+DEFINE_int32(batch_size, 1, "Entries of each append");
+DEFINE_bool(test_local, true, "Test per-copyset braft segment log");
+DEFINE_bool(test_shared, true, "Test shared log");
+
+using curve::chunkserver::SharedLog;
+using curve::chunkserver::SharedLogOptions;
+using curve::chunkserver::SharedLogStorage;
+
+struct BenchContext {
+    braft::LogStorage* storage;
+    butil::atomic<bool>* stop;
+    bvar::LatencyRecorder* latency;
+    int64_t nextIndex;
+};
+
+static void* AppendLoop(void* arg) {
+    BenchContext* ctx = static_cast<BenchContext*>(arg);
+    std::string data(FLAGS_entry_size, 'a');
+    while (!ctx->stop->load(butil::memory_order_relaxed)) {
+        std::vector<braft::LogEntry*> entries;
+        for (int i = 0; i < FLAGS_batch_size; ++i) {
+            braft::LogEntry* entry = new braft::LogEntry();
+            entry->AddRef();
+            entry->type = braft::ENTRY_TYPE_DATA;
+            entry->id = braft::LogId(ctx->nextIndex++, 1);
+            entry->data.append(data);
+            entries.push_back(entry);
+        }
+        int64_t start = butil::cpuwide_time_us();
+        int ret = ctx->storage->append_entries(entries, nullptr);
+        *ctx->latency << butil::cpuwide_time_us() - start;
+        CHECK_EQ(FLAGS_batch_size, ret) << "Fail to append entries";
+        for (auto entry : entries) {
+            entry->Release();
+        }
+    }
+    return nullptr;
+}
+
+static void RunCase(const std::string& name, int copysetNum,
+                    const std::vector<braft::LogStorage*>& storages) {
+    butil::atomic<bool> stop(false);
+    bvar::LatencyRecorder latency;
+    std::vector<BenchContext> ctxs(copysetNum);
+    std::vector<bthread_t> tids(copysetNum);
+    for (int i = 0; i < copysetNum; ++i) {
+        ctxs[i].storage = storages[i];
+        ctxs[i].stop = &stop;
+        ctxs[i].latency = &latency;
+        ctxs[i].nextIndex = storages[i]->last_log_index() + 1;
+        CHECK_EQ(0, bthread_start_background(&tids[i], nullptr,
+                                             AppendLoop, &ctxs[i]));
+    }
+    bthread_usleep(FLAGS_duration_s * 1000000L);
+    stop.store(true);
+    for (int i = 0; i < copysetNum; ++i) {
+        bthread_join(tids[i], nullptr);
+    }
+
+    std::cout << name << " copysets: " << copysetNum
+              << ", iops: " << latency.count() / FLAGS_duration_s
+              << ", avg latency(us): " << latency.latency()
+              << ", p99 latency(us): " << latency.latency_percentile(0.99)
+              << std::endl;
+}
+
+static void BenchLocal(int copysetNum) {
+    std::string dir = FLAGS_dir + "/local";
+    std::vector<braft::LogStorage*> storages;
+    for (int i = 0; i < copysetNum; ++i) {
+        braft::LogStorage* storage = new braft::SegmentLogStorage(
+            dir + "/" + std::to_string(i + 1) + "/log");
+        braft::ConfigurationManager confMgr;
+        CHECK_EQ(0, storage->init(&confMgr));
+        storages.push_back(storage);
+    }
+    RunCase("local", copysetNum, storages);
+    for (auto storage : storages) {
+        delete storage;
+    }
+    butil::DeleteFile(butil::FilePath(dir), true);
+}
+
+static void BenchShared(int copysetNum) {
+    std::string dir = FLAGS_dir + "/shared";
+    SharedLogOptions options;
+    options.path = dir + "/sharedlog";
+    SharedLog sharedLog(options);
+    CHECK_EQ(0, sharedLog.Init());
+    CHECK_EQ(0, sharedLog.Run());
+
+    std::vector<braft::LogStorage*> storages;
+    for (int i = 0; i < copysetNum; ++i) {
+        braft::LogStorage* storage = new SharedLogStorage(
+            dir + "/copysets/" + std::to_string(i + 1) + "/log", &sharedLog);
+        braft::ConfigurationManager confMgr;
+        CHECK_EQ(0, storage->init(&confMgr));
+        storages.push_back(storage);
+    }
+    RunCase("shared", copysetNum, storages);
+    for (auto storage : storages) {
+        delete storage;
+    }
+    sharedLog.Fini();
+    butil::DeleteFile(butil::FilePath(dir), true);
+}
+
+int main(int argc, char* argv[]) {
+    google::ParseCommandLineFlags(&argc, &argv, true);
+
+    for (butil::StringSplitter sp(FLAGS_copyset_nums.c_str(), ',');
+         sp; ++sp) {
+        int copysetNum = std::stoi(std::string(sp.field(), sp.length()));
+        if (FLAGS_test_local) {
+            BenchLocal(copysetNum);
+        }
+        if (FLAGS_test_shared) {
+            BenchShared(copysetNum);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,272 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <braft/log_entry.h>
+#include <braft/configuration_manager.h>
+
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/fs/local_filesystem.h"
+#include "src/chunkserver/raftlog/shared_log.h"
+#include "src/chunkserver/raftlog/shared_log_storage.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::fs::FileSystemType;
+using curve::fs::LocalFileSystem;
+using curve::fs::LocalFsFactory;
+
+const char kSharedLogTestDir[] = "./sharedlogtest";
+const char kSharedLogDir[] = "./sharedlogtest/log";
+const char kSharedLogCopysetsDir[] = "./sharedlogtest/copysets";
+const size_t kEntryDataSize = 1000;
+
+class SharedLogTest : public testing::Test {
+ public:
+    void SetUp() {
+        fsptr_ = LocalFsFactory::CreateFs(FileSystemType::EXT4, "");
+        fsptr_->Mkdir(kSharedLogTestDir);
+        options_.path = kSharedLogDir;
+        options_.segmentSize = 16 * 1024;
+        options_.maxSegments = 2;
+    }
+
+    void TearDown() {
+        fsptr_->Delete(kSharedLogTestDir);
+    }
+
+    void Append(SharedLog* log, GroupNid groupId, int64_t firstIndex,
+                int64_t lastIndex, int64_t term) {
+        std::vector<braft::LogEntry*> entries;
+        for (int64_t index = firstIndex; index <= lastIndex; ++index) {
+            braft::LogEntry* entry = new braft::LogEntry();
+            entry->AddRef();
+            entry->type = braft::ENTRY_TYPE_DATA;
+            entry->id = braft::LogId(index, term);
+            entry->data.append(
+                std::string(kEntryDataSize, 'a' + (groupId + index) % 26));
+            entries.push_back(entry);
+        }
+        ASSERT_EQ(entries.size(), log->AppendEntries(groupId, entries));
+        for (auto entry : entries) {
+            entry->Release();
+        }
+    }
+
+    void Check(SharedLog* log, GroupNid groupId, int64_t index,
+               int64_t term) {
+        braft::LogEntry* entry = log->GetEntry(groupId, index);
+        ASSERT_NE(nullptr, entry);
+        ASSERT_EQ(index, entry->id.index);
+        ASSERT_EQ(term, entry->id.term);
+        ASSERT_EQ(std::string(kEntryDataSize, 'a' + (groupId + index) % 26),
+                  entry->data.to_string());
+        ASSERT_EQ(term, log->GetTerm(groupId, index));
+        entry->Release();
+    }
+
+ protected:
+    std::shared_ptr<LocalFileSystem> fsptr_;
+    SharedLogOptions options_;
+};
+
+TEST_F(SharedLogTest, AppendAndReload) {
+    {
+        SharedLog log(options_);
+        ASSERT_EQ(0, log.Init());
+        ASSERT_EQ(1, log.FirstLogIndex(1));
+        ASSERT_EQ(0, log.LastLogIndex(1));
+
+        // 多个copyset交替写入
+        for (int64_t index = 1; index <= 30; index += 10) {
+            Append(&log, 1, index, index + 9, 1);
+            Append(&log, 2, index, index + 9, 2);
+        }
+        ASSERT_EQ(30, log.LastLogIndex(1));
+        ASSERT_EQ(30, log.LastLogIndex(2));
+        ASSERT_LT(1, log.SegmentCount());
+        for (int64_t index = 1; index <= 30; ++index) {
+            Check(&log, 1, index, 1);
+            Check(&log, 2, index, 2);
+        }
+        ASSERT_EQ(nullptr, log.GetEntry(1, 31));
+        ASSERT_EQ(nullptr, log.GetEntry(3, 1));
+        ASSERT_EQ(0, log.GetTerm(1, 31));
+        ASSERT_EQ(0, log.Fini());
+    }
+
+    // 重启之后重放日志
+    SharedLog log(options_);
+    ASSERT_EQ(0, log.Init());
+    ASSERT_EQ(2, log.GroupCount());
+    ASSERT_EQ(1, log.FirstLogIndex(1));
+    ASSERT_EQ(30, log.LastLogIndex(1));
+    for (int64_t index = 1; index <= 30; ++index) {
+        Check(&log, 1, index, 1);
+        Check(&log, 2, index, 2);
+    }
+    Append(&log, 1, 31, 35, 3);
+    Check(&log, 1, 35, 3);
+}
+
+TEST_F(SharedLogTest, Truncate) {
+    {
+        SharedLog log(options_);
+        ASSERT_EQ(0, log.Init());
+        Append(&log, 1, 1, 20, 1);
+        Append(&log, 2, 1, 20, 1);
+
+        ASSERT_EQ(0, log.TruncateSuffix(1, 10));
+        ASSERT_EQ(10, log.LastLogIndex(1));
+        ASSERT_EQ(nullptr, log.GetEntry(1, 11));
+        Append(&log, 1, 11, 15, 2);
+        Check(&log, 1, 11, 2);
+
+        ASSERT_EQ(0, log.TruncatePrefix(1, 5));
+        ASSERT_EQ(5, log.FirstLogIndex(1));
+        ASSERT_EQ(nullptr, log.GetEntry(1, 4));
+
+        ASSERT_EQ(0, log.Reset(2, 100));
+        ASSERT_EQ(100, log.FirstLogIndex(2));
+        ASSERT_EQ(99, log.LastLogIndex(2));
+        ASSERT_EQ(0, log.Fini());
+    }
+
+    SharedLog log(options_);
+    ASSERT_EQ(0, log.Init());
+    ASSERT_EQ(5, log.FirstLogIndex(1));
+    ASSERT_EQ(15, log.LastLogIndex(1));
+    for (int64_t index = 5; index <= 10; ++index) {
+        Check(&log, 1, index, 1);
+    }
+    for (int64_t index = 11; index <= 15; ++index) {
+        Check(&log, 1, index, 2);
+    }
+    ASSERT_EQ(100, log.FirstLogIndex(2));
+    ASSERT_EQ(99, log.LastLogIndex(2));
+}
+
+TEST_F(SharedLogTest, Compact) {
+    {
+        SharedLog log(options_);
+        ASSERT_EQ(0, log.Init());
+        // copyset 2的entry都在最老的segment中
+        Append(&log, 2, 1, 3, 1);
+        for (int64_t index = 1; index <= 60; index += 5) {
+            Append(&log, 1, index, index + 4, 1);
+        }
+        size_t segments = log.SegmentCount();
+        ASSERT_LT(4, segments);
+
+        ASSERT_EQ(0, log.TruncatePrefix(1, 55));
+        ASSERT_LT(2, log.Compact());
+        ASSERT_GT(segments, log.SegmentCount());
+        for (int64_t index = 1; index <= 3; ++index) {
+            Check(&log, 2, index, 1);
+        }
+        for (int64_t index = 55; index <= 60; ++index) {
+            Check(&log, 1, index, 1);
+        }
+        // 被搬移之后的entry可以正常truncate
+        ASSERT_EQ(0, log.TruncateSuffix(2, 1));
+        ASSERT_EQ(1, log.LastLogIndex(2));
+        ASSERT_EQ(0, log.Fini());
+    }
+
+    SharedLog log(options_);
+    ASSERT_EQ(0, log.Init());
+    ASSERT_EQ(55, log.FirstLogIndex(1));
+    ASSERT_EQ(60, log.LastLogIndex(1));
+    ASSERT_EQ(1, log.FirstLogIndex(2));
+    ASSERT_EQ(1, log.LastLogIndex(2));
+    Check(&log, 2, 1, 1);
+    for (int64_t index = 55; index <= 60; ++index) {
+        Check(&log, 1, index, 1);
+    }
+}
+
+TEST_F(SharedLogTest, RemoveDeletedCopyset) {
+    // 只有copyset 1的目录存在
+    fsptr_->Mkdir(kSharedLogCopysetsDir);
+    fsptr_->Mkdir(std::string(kSharedLogCopysetsDir) + "/1");
+    options_.copysetsDir = kSharedLogCopysetsDir;
+    options_.maxSegments = 1;
+
+    SharedLog log(options_);
+    ASSERT_EQ(0, log.Init());
+    Append(&log, 1, 1, 20, 1);
+    Append(&log, 2, 1, 20, 1);
+    ASSERT_EQ(2, log.GroupCount());
+    ASSERT_LT(0, log.Compact());
+    ASSERT_EQ(1, log.GroupCount());
+    ASSERT_EQ(0, log.LastLogIndex(2));
+    for (int64_t index = 1; index <= 20; ++index) {
+        Check(&log, 1, index, 1);
+    }
+}
+
+TEST_F(SharedLogTest, ConcurrentAppend) {
+    options_.segmentSize = 1024 * 1024;
+    SharedLog log(options_);
+    ASSERT_EQ(0, log.Init());
+
+    const int kGroupNum = 8;
+    const int64_t kEntryNum = 100;
+    std::vector<std::thread> threads;
+    for (int i = 1; i <= kGroupNum; ++i) {
+        threads.emplace_back([&, i] {
+            for (int64_t index = 1; index <= kEntryNum; ++index) {
+                Append(&log, i, index, index, 1);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (int i = 1; i <= kGroupNum; ++i) {
+        ASSERT_EQ(kEntryNum, log.LastLogIndex(i));
+        for (int64_t index = 1; index <= kEntryNum; ++index) {
+            Check(&log, i, index, 1);
+        }
+    }
+}
+
+TEST(SharedLogStorageTest, ParseGroupId) {
+    GroupNid groupId = 0;
+    ASSERT_EQ(0, SharedLogStorage::ParseGroupId(
+        "./0/copysets/4294967297/log", &groupId));
+    ASSERT_EQ(4294967297, groupId);
+    ASSERT_EQ(0, SharedLogStorage::ParseGroupId(
+        "/data/copysets/4294967298/log/", &groupId));
+    ASSERT_EQ(4294967298, groupId);
+    ASSERT_EQ(-1, SharedLogStorage::ParseGroupId(
+        "./0/copysets/abc/log", &groupId));
+    ASSERT_EQ(-1, SharedLogStorage::ParseGroupId("log", &groupId));
+}
+
+}  // namespace chunkserver
+}  // namespace curve
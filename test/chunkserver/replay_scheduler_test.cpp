@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <bthread/bthread.h>
+
+#include <vector>
+#include <mutex>  // NOLINT
+
+#include "src/chunkserver/replay_scheduler.h"
+
+namespace curve {
+namespace chunkserver {
+
+namespace {
+
+struct ReplayTask {
+    ReplayScheduler *scheduler;
+    int64_t remaining;
+    std::mutex *mtx;
+    std::vector<int64_t> *order;
+};
+
+void *RunReplayTask(void *arg) {
+    ReplayTask *task = static_cast<ReplayTask *>(arg);
+    uint64_t ticket = task->scheduler->Submit(task->remaining);
+    if (!task->scheduler->Wait(ticket)) {
+        return nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> lk(*task->mtx);
+        task->order->push_back(task->remaining);
+    }
+    task->scheduler->Release();
+    return nullptr;
+}
+
+}  // namespace
+
+TEST(ReplaySchedulerTest, basic) {
+    ReplayScheduler scheduler(2);
+    ASSERT_EQ(0, scheduler.Running());
+    ASSERT_EQ(0, scheduler.Waiting());
+
+    // 名额未满时直接获得
+    ASSERT_TRUE(scheduler.Wait(scheduler.Submit(100)));
+    ASSERT_TRUE(scheduler.Wait(scheduler.Submit(10)));
+    ASSERT_EQ(2, scheduler.Running());
+    ASSERT_EQ(0, scheduler.Waiting());
+
+    scheduler.Release();
+    ASSERT_EQ(1, scheduler.Running());
+    scheduler.Release();
+    ASSERT_EQ(0, scheduler.Running());
+}
+
+TEST(ReplaySchedulerTest, ShortestRemainingFirst) {
+    ReplayScheduler scheduler(1);
+    // 占住唯一的名额，后面的copyset都需要排队
+    ASSERT_TRUE(scheduler.Wait(scheduler.Submit(1)));
+
+    std::mutex mtx;
+    std::vector<int64_t> order;
+    std::vector<int64_t> remainings = {300, 100, 200, 100};
+    std::vector<ReplayTask> tasks;
+    for (auto remaining : remainings) {
+        tasks.push_back({&scheduler, remaining, &mtx, &order});
+    }
+    std::vector<bthread_t> tids(tasks.size());
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        ASSERT_EQ(0, bthread_start_background(&tids[i], nullptr,
+                                              RunReplayTask, &tasks[i]));
+    }
+    while (scheduler.Waiting() < tasks.size()) {
+        bthread_usleep(1000);
+    }
+    ASSERT_EQ(1, scheduler.Running());
+
+    scheduler.Release();
+    for (auto tid : tids) {
+        bthread_join(tid, nullptr);
+    }
+    ASSERT_EQ(0, scheduler.Running());
+    ASSERT_EQ(0, scheduler.Waiting());
+    std::vector<int64_t> expected = {100, 100, 200, 300};
+    ASSERT_EQ(expected, order);
+}
+
+TEST(ReplaySchedulerTest, Cancel) {
+    ReplayScheduler scheduler(1);
+    uint64_t holder = scheduler.Submit(1);
+    ASSERT_TRUE(scheduler.Wait(holder));
+
+    // 排队中的申请被取消后，Wait返回false且不占用名额
+    uint64_t first = scheduler.Submit(10);
+    uint64_t second = scheduler.Submit(20);
+    ASSERT_EQ(2, scheduler.Waiting());
+    ASSERT_TRUE(scheduler.Cancel(first));
+    ASSERT_FALSE(scheduler.Cancel(first));
+    // 申请在Wait之前已经被取消时直接返回
+    ASSERT_FALSE(scheduler.Wait(first));
+    ASSERT_EQ(1, scheduler.Waiting());
+    ASSERT_EQ(1, scheduler.Running());
+
+    // 已经获得名额的申请不能取消
+    ASSERT_FALSE(scheduler.Cancel(holder));
+    scheduler.Release();
+    ASSERT_TRUE(scheduler.Wait(second));
+    ASSERT_FALSE(scheduler.Cancel(second));
+    ASSERT_EQ(0, scheduler.Waiting());
+    ASSERT_EQ(1, scheduler.Running());
+    scheduler.Release();
+    ASSERT_EQ(0, scheduler.Running());
+}
+
+}  // namespace chunkserver
+}  // namespace curve
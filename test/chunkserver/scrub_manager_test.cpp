@@ -0,0 +1,293 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/chunkserver/scrub_manager.h"
+#include "src/fs/local_filesystem.h"
+#include "test/chunkserver/mock_copyset_node.h"
+#include "test/chunkserver/datastore/mock_datastore.h"
+
+namespace curve {
+namespace chunkserver {
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+using ::testing::DoAll;
+using curve::fs::FileSystemType;
+using curve::fs::LocalFsFactory;
+
+const LogicPoolID kLogicPoolId = 1;
+const CopysetID kCopysetId = 100;
+const uint32_t kReadSize = 4096;
+
+class MockScrubManager : public ScrubManager {
+ public:
+    MOCK_METHOD2(GetCopysetNode, CopysetNodePtr(LogicPoolID, CopysetID));
+    MOCK_METHOD2(ListChunks, int(const CopysetNodePtr&,
+                                 std::vector<ChunkID>*));
+    MOCK_METHOD0(ForegroundIops, uint64_t());
+    MOCK_METHOD6(GetPeerChunkHash, int(const CopysetNodePtr&,
+                                       const Peer&,
+                                       ChunkID,
+                                       off_t,
+                                       size_t,
+                                       std::string*));
+};
+
+class ScrubManagerTest : public testing::Test {
+ public:
+    void SetUp() {
+        node_ = std::make_shared<MockCopysetNode>();
+        datastore_ = std::make_shared<MockDataStore>();
+        options_.enable = true;
+        options_.bandwidthBytes = 0;
+        options_.readSize = kReadSize;
+        options_.pauseCheckIntervalMs = 1;
+        options_.mismatchRetryTimes = 1;
+        options_.mismatchRetryIntervalMs = 1;
+        options_.copysetNodeManager = &CopysetNodeManager::GetInstance();
+        options_.localFileSystem =
+            LocalFsFactory::CreateFs(FileSystemType::EXT4, "");
+
+        ON_CALL(manager_, GetCopysetNode(kLogicPoolId, kCopysetId))
+            .WillByDefault(Return(node_));
+        ON_CALL(manager_, ForegroundIops()).WillByDefault(Return(0));
+        ON_CALL(*node_, IsActivated()).WillByDefault(Return(true));
+        ON_CALL(*node_, GetDataStore()).WillByDefault(Return(datastore_));
+    }
+
+    void TearDown() {
+        manager_.Fini();
+    }
+
+    // 等待任务进入指定状态，超时返回false
+    bool WaitJobState(int32_t jobId, INTEGRITY_JOB_STATE state,
+                      IntegrityJob* job) {
+        for (int i = 0; i < 500; ++i) {
+            std::vector<IntegrityJob> jobs;
+            manager_.ListJobs(&jobs);
+            for (const auto& item : jobs) {
+                if (item.id() == jobId && item.state() == state) {
+                    *job = item;
+                    return true;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+ protected:
+    MockScrubManager manager_;
+    std::shared_ptr<MockCopysetNode> node_;
+    std::shared_ptr<MockDataStore> datastore_;
+    ScrubOptions options_;
+};
+
+TEST_F(ScrubManagerTest, InitTest) {
+    ScrubOptions options = options_;
+    options.copysetNodeManager = nullptr;
+    ASSERT_EQ(-1, manager_.Init(options));
+
+    // 读取大小需要按照4096对齐
+    options = options_;
+    options.readSize = 1000;
+    ASSERT_EQ(-1, manager_.Init(options));
+
+    ASSERT_EQ(0, manager_.Init(options_));
+}
+
+TEST_F(ScrubManagerTest, JobStateTest) {
+    ASSERT_EQ(0, manager_.Init(options_));
+
+    // copyset不存在
+    EXPECT_CALL(manager_, GetCopysetNode(kLogicPoolId, kCopysetId + 1))
+        .WillOnce(Return(nullptr));
+    ASSERT_EQ(-1, manager_.ScheduleJob(kLogicPoolId, kCopysetId + 1,
+                                       nullptr));
+
+    IntegrityJob job;
+    ASSERT_EQ(0, manager_.ScheduleJob(kLogicPoolId, kCopysetId, &job));
+    ASSERT_EQ(INTEGRITY_OP_STATE_WAITING, job.state());
+    ASSERT_EQ(kLogicPoolId, job.logicpoolid());
+    ASSERT_EQ(kCopysetId, job.copyset());
+    int32_t jobId = job.id();
+    // 同一个copyset不能同时有多个未结束的任务
+    ASSERT_EQ(-1, manager_.ScheduleJob(kLogicPoolId, kCopysetId, nullptr));
+
+    ASSERT_EQ(-1, manager_.ResumeJob(jobId, &job));
+    ASSERT_EQ(0, manager_.PauseJob(jobId, &job));
+    ASSERT_EQ(INTEGRITY_OP_STATE_PAUSED, job.state());
+    ASSERT_EQ(-1, manager_.PauseJob(jobId, &job));
+    ASSERT_EQ(0, manager_.ResumeJob(jobId, &job));
+    ASSERT_EQ(INTEGRITY_OP_STATE_WAITING, job.state());
+    ASSERT_EQ(0, manager_.CancelJob(jobId, &job));
+    ASSERT_EQ(INTEGRITY_OP_STATE_CANCELED, job.state());
+    ASSERT_EQ(-1, manager_.CancelJob(jobId, &job));
+    ASSERT_EQ(-1, manager_.CancelJob(jobId + 100, &job));
+
+    // 任务取消之后可以重新下发
+    ASSERT_EQ(0, manager_.ScheduleJob(kLogicPoolId, kCopysetId, &job));
+    ASSERT_NE(jobId, job.id());
+    std::vector<IntegrityJob> jobs;
+    manager_.ListJobs(&jobs);
+    ASSERT_EQ(2, jobs.size());
+}
+
+TEST_F(ScrubManagerTest, ScrubTest) {
+    ASSERT_EQ(0, manager_.Init(options_));
+
+    // chunk 2读取失败，chunk 3与副本的数据不一致
+    std::vector<ChunkID> chunks = {1, 2, 3};
+    EXPECT_CALL(manager_, ListChunks(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(chunks), Return(0)));
+    CSChunkInfo info;
+    info.chunkSize = 2 * kReadSize;
+    EXPECT_CALL(*datastore_, GetChunkInfo(_, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(info),
+                              Return(CSErrorCode::Success)));
+    EXPECT_CALL(*datastore_, GetChunkHash(_, _, _, _))
+        .WillRepeatedly(Invoke([](ChunkID id, off_t offset, size_t length,
+                                  std::string* hash) {
+            if (id == 2) {
+                return CSErrorCode::InternalError;
+            }
+            *hash = "100";
+            return CSErrorCode::Success;
+        }));
+
+    std::vector<Peer> peers(3);
+    peers[0].set_address("127.0.0.1:8200:0");
+    peers[1].set_address("127.0.0.1:8201:0");
+    peers[2].set_address("127.0.0.1:8202:0");
+    EXPECT_CALL(*node_, IsLeaderTerm()).WillRepeatedly(Return(true));
+    EXPECT_CALL(*node_, GetLeaderId())
+        .WillRepeatedly(Return(PeerId("127.0.0.1:8200:0")));
+    EXPECT_CALL(*node_, ListPeers(_))
+        .WillRepeatedly(SetArgPointee<0>(peers));
+    EXPECT_CALL(manager_, GetPeerChunkHash(_, _, _, _, _, _))
+        .WillRepeatedly(Invoke([](const CopysetNodePtr& node,
+                                  const Peer& peer,
+                                  ChunkID id,
+                                  off_t offset,
+                                  size_t length,
+                                  std::string* hash) {
+            EXPECT_NE("127.0.0.1:8200:0", peer.address());
+            *hash = (id == 3 && peer.address() == "127.0.0.1:8202:0") ?
+                    "200" : "100";
+            return 0;
+        }));
+
+    IntegrityJob job;
+    ASSERT_EQ(0, manager_.ScheduleJob(kLogicPoolId, kCopysetId, &job));
+    ASSERT_EQ(0, manager_.Run());
+    ASSERT_TRUE(WaitJobState(job.id(), INTEGRITY_OP_STATE_FINISHED, &job));
+    ASSERT_EQ(100, job.progress());
+    ASSERT_EQ(3, job.totalchunks());
+    ASSERT_EQ(3, job.scannedchunks());
+    ASSERT_EQ(1, job.errorchunks());
+    ASSERT_EQ(1, job.mismatchchunks());
+    ASSERT_EQ(2, job.badchunks_size());
+    ASSERT_EQ(2, job.badchunks(0));
+    ASSERT_EQ(3, job.badchunks(1));
+    ASSERT_LT(0, job.start_time());
+}
+
+TEST_F(ScrubManagerTest, PauseUnderForegroundLoadTest) {
+    options_.pauseIops = 100;
+    options_.compareReplicas = false;
+    ASSERT_EQ(0, manager_.Init(options_));
+
+    std::vector<ChunkID> chunks = {1};
+    EXPECT_CALL(manager_, ListChunks(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(chunks), Return(0)));
+    CSChunkInfo info;
+    info.chunkSize = kReadSize;
+    EXPECT_CALL(*datastore_, GetChunkInfo(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(info),
+                        Return(CSErrorCode::Success)));
+    EXPECT_CALL(*datastore_, GetChunkHash(1, 0, kReadSize, _))
+        .WillOnce(Return(CSErrorCode::Success));
+    // 前台负载下降之后才开始读取
+    EXPECT_CALL(manager_, ForegroundIops())
+        .WillOnce(Return(1000))
+        .WillOnce(Return(1000))
+        .WillRepeatedly(Return(0));
+
+    IntegrityJob job;
+    ASSERT_EQ(0, manager_.ScheduleJob(kLogicPoolId, kCopysetId, &job));
+    ASSERT_EQ(0, manager_.Run());
+    ASSERT_TRUE(WaitJobState(job.id(), INTEGRITY_OP_STATE_FINISHED, &job));
+    ASSERT_EQ(0, job.errorchunks());
+    ASSERT_EQ(0, job.mismatchchunks());
+}
+
+TEST_F(ScrubManagerTest, PauseRunningJobTest) {
+    options_.compareReplicas = false;
+    ASSERT_EQ(0, manager_.Init(options_));
+
+    std::vector<ChunkID> chunks = {1, 2};
+    EXPECT_CALL(manager_, ListChunks(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(chunks), Return(0)));
+    CSChunkInfo info;
+    info.chunkSize = kReadSize;
+    EXPECT_CALL(*datastore_, GetChunkInfo(_, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(info),
+                              Return(CSErrorCode::Success)));
+
+    // 扫描第一个chunk时暂停任务
+    int32_t jobId = 0;
+    EXPECT_CALL(*datastore_, GetChunkHash(_, _, _, _))
+        .WillRepeatedly(Invoke([&](ChunkID id, off_t offset, size_t length,
+                                   std::string* hash) {
+            if (id == 1) {
+                EXPECT_EQ(0, manager_.PauseJob(jobId, nullptr));
+            }
+            return CSErrorCode::Success;
+        }));
+
+    IntegrityJob job;
+    ASSERT_EQ(0, manager_.ScheduleJob(kLogicPoolId, kCopysetId, &job));
+    jobId = job.id();
+    ASSERT_EQ(0, manager_.Run());
+    ASSERT_TRUE(WaitJobState(jobId, INTEGRITY_OP_STATE_PAUSED, &job));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_TRUE(WaitJobState(jobId, INTEGRITY_OP_STATE_PAUSED, &job));
+    ASSERT_EQ(1, job.scannedchunks());
+
+    ASSERT_EQ(0, manager_.ResumeJob(jobId, &job));
+    ASSERT_EQ(INTEGRITY_OP_STATE_RUNNING, job.state());
+    ASSERT_TRUE(WaitJobState(jobId, INTEGRITY_OP_STATE_FINISHED, &job));
+    ASSERT_EQ(2, job.scannedchunks());
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+/**
+ * client metacache查询的性能基准测试，每个IO拆分出的请求都会查询metacache
+ * 运行方式:
+ *   bazel run //test/client/benchmark:metacache_benchmark -- \
+ *       --benchmark_out=result.json --benchmark_out_format=json
+ */
+
+#include <benchmark/benchmark.h>
+#include <butil/endpoint.h>
+
+#include "src/client/metacache.h"
+
+namespace curve {
+namespace client {
+
+namespace {
+
+const uint64_t kChunkSize = 16ull * 1024 * 1024;
+// 1T的文件
+const uint64_t kChunkNum = 64 * 1024;
+const LogicPoolID kLogicPoolId = 1;
+const CopysetID kCopysetNum = 1024;
+
+/**
+ * 所有benchmark共用的metacache，模拟一个已经打开并且写满的1T文件
+ */
+MetaCache* GetMetaCache() {
+    static MetaCache* mc = [] {
+        MetaCache* cache = new MetaCache();
+        FInfo_t fileInfo;
+        fileInfo.chunksize = kChunkSize;
+        fileInfo.length = kChunkSize * kChunkNum;
+        cache->UpdateFileInfo(fileInfo);
+        for (ChunkIndex i = 0; i < kChunkNum; ++i) {
+            cache->UpdateChunkInfoByIndex(i,
+                ChunkIDInfo_t(i + 1, kLogicPoolId, i % kCopysetNum + 1));
+        }
+        for (CopysetID id = 1; id <= kCopysetNum; ++id) {
+            CopysetInfo_t csinfo;
+            csinfo.cpid_ = id;
+            for (int i = 0; i < 3; ++i) {
+                EndPoint addr;
+                butil::str2endpoint("127.0.0.1", 8200 + (id + i) % 16,
+                                    &addr);
+                csinfo.csinfos_.push_back(
+                    CopysetPeerInfo((id + i) % 16 + 1, ChunkServerAddr(addr)));
+            }
+            csinfo.UpdateLeaderIndex(0);
+            cache->UpdateCopysetInfo(kLogicPoolId, id, csinfo);
+        }
+        return cache;
+    }();
+    return mc;
+}
+
+}  // namespace
+
+static void BM_GetChunkInfoByIndex(benchmark::State& state) {
+    MetaCache* mc = GetMetaCache();
+    ChunkIndex index = state.thread_index * 7919;
+    ChunkIDInfo_t info;
+    for (auto _ : state) {
+        mc->GetChunkInfoByIndex(index++ % kChunkNum, &info);
+        benchmark::DoNotOptimize(info);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetChunkInfoByIndex)->ThreadRange(1, 16)->UseRealTime();
+
+static void BM_GetLeader(benchmark::State& state) {
+    MetaCache* mc = GetMetaCache();
+    CopysetID copysetId = state.thread_index * 31;
+    ChunkServerID leaderId;
+    EndPoint leaderAddr;
+    for (auto _ : state) {
+        mc->GetLeader(kLogicPoolId, copysetId++ % kCopysetNum + 1,
+                      &leaderId, &leaderAddr);
+        benchmark::DoNotOptimize(leaderAddr);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetLeader)->ThreadRange(1, 16)->UseRealTime();
+
+static void BM_IsLeaderMayChange(benchmark::State& state) {
+    MetaCache* mc = GetMetaCache();
+    CopysetID copysetId = state.thread_index * 31;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(mc->IsLeaderMayChange(kLogicPoolId,
+            copysetId++ % kCopysetNum + 1));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IsLeaderMayChange)->ThreadRange(1, 16)->UseRealTime();
+
+static void BM_UpdateAppliedIndex(benchmark::State& state) {
+    MetaCache* mc = GetMetaCache();
+    CopysetID copysetId = state.thread_index * 31;
+    uint64_t appliedIndex = 1;
+    for (auto _ : state) {
+        mc->UpdateAppliedIndex(kLogicPoolId, copysetId++ % kCopysetNum + 1,
+                               appliedIndex++);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UpdateAppliedIndex)->ThreadRange(1, 16)->UseRealTime();
+
+}  // namespace client
+}  // namespace curve
+
+BENCHMARK_MAIN();
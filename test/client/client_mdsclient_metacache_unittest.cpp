@@ -28,12 +28,18 @@
 #include <fiu-control.h>
 #include <brpc/channel.h>
 #include <brpc/errno.pb.h>
+#include <bthread/bthread.h>
 
+#include <atomic>
+#include <functional>
+#include <mutex>    //NOLINT
+#include <set>
 #include <string>
 #include <thread>   //NOLINT
 #include <chrono>   //NOLINT
 #include <vector>
 #include <algorithm>
+#include <utility>
 
 #include "src/client/client_common.h"
 #include "src/client/file_instance.h"
@@ -48,6 +54,9 @@
 #include "src/client/config_info.h"
 #include "test/client/fake/fakeMDS.h"
 #include "src/client/metacache_struct.h"
+#include "src/client/splitor.h"
+#include "src/client/segment_prefetcher.h"
+#include "src/client/iomanager4file.h"
 #include "src/common/net_common.h"
 #include "test/integration/cluster_common/cluster.h"
 #include "test/util/config_generator.h"
@@ -1091,6 +1100,390 @@ TEST_F(MDSClientTest, GetOrAllocateSegment) {
     delete faktopologyeret;
 }
 
+TEST_F(MDSClientTest, GetOrAllocateSegmentsAndWarmUp) {
+    curve::client::FInfo_t fi;
+    fi.userinfo = userinfo;
+    fi.fullPathName = "/1_userinfo_";
+    fi.chunksize   = 4 * 1024 * 1024;
+    fi.segmentsize = 1 * 1024 * 1024 * 1024ul;
+    fi.length = 4 * fi.segmentsize;
+
+    // mds返回错误
+    curve::mds::GetOrAllocateSegmentsResponse failResp;
+    failResp.set_statuscode(::curve::mds::StatusCode::kOwnerAuthFail);
+    FakeReturn* failRet = new FakeReturn(nullptr,
+                static_cast<void*>(&failResp));
+    curvefsservice.SetGetOrAllocateSegmentsFakeReturn(failRet);
+
+    std::vector<SegmentInfo> segInfos;
+    ASSERT_EQ(LIBCURVE_ERROR::AUTHFAIL,
+        mdsclient_.GetOrAllocateSegments(false, 0, 4, &fi, &segInfos));
+    ASSERT_TRUE(segInfos.empty());
+
+    // 只有第0和第2个segment已分配，两个segment的copyset有重叠
+    curve::mds::GetOrAllocateSegmentsResponse response;
+    response.set_statuscode(::curve::mds::StatusCode::kOK);
+    for (int seg : {0, 2}) {
+        auto pfs = response.add_pagefilesegments();
+        pfs->set_logicalpoolid(1234);
+        pfs->set_segmentsize(fi.segmentsize);
+        pfs->set_chunksize(fi.chunksize);
+        pfs->set_startoffset(seg * fi.segmentsize);
+        for (int i = 0; i < 256; i++) {
+            auto chunk = pfs->add_chunks();
+            chunk->set_copysetid(i % 16 + seg);
+            chunk->set_chunkid(seg * 256 + i + 1);
+        }
+    }
+    FakeReturn* fakeret = new FakeReturn(nullptr,
+                static_cast<void*>(&response));
+    curvefsservice.SetGetOrAllocateSegmentsFakeReturn(fakeret);
+
+    ::curve::mds::topology::GetChunkServerListInCopySetsResponse topoResp;
+    topoResp.set_statuscode(0);
+    for (int i = 0; i < 18; i++) {
+        auto csinfo = topoResp.add_csinfo();
+        csinfo->set_copysetid(i);
+        for (int j = 0; j < 3; j++) {
+            auto cslocs = csinfo->add_cslocs();
+            cslocs->set_chunkserverid(i * 3 + j + 1);
+            cslocs->set_hostip("127.0.0.1");
+            cslocs->set_port(5000);
+        }
+    }
+    FakeReturn* faketopo = new FakeReturn(nullptr,
+        static_cast<void*>(&topoResp));
+    topologyservice.SetFakeReturn(faketopo);
+
+    ASSERT_EQ(LIBCURVE_ERROR::OK,
+        mdsclient_.GetOrAllocateSegments(false, 0, 4, &fi, &segInfos));
+    ASSERT_EQ(2, segInfos.size());
+    ASSERT_EQ(0, segInfos[0].startoffset);
+    ASSERT_EQ(2 * fi.segmentsize, segInfos[1].startoffset);
+    ASSERT_EQ(256, segInfos[1].chunkvec.size());
+
+    curve::client::MetaCache mc;
+    mc.UpdateFileInfo(fi);
+    ASSERT_TRUE(curve::client::Splitor::UpdateSegmentInfos(
+        &mc, &mdsclient_, segInfos, &fi));
+
+    curve::client::ChunkIDInfo_t cinfo;
+    ASSERT_EQ(MetaCacheErrorType::OK, mc.GetChunkInfoByIndex(0, &cinfo));
+    ASSERT_EQ(1, cinfo.cid_);
+    ASSERT_EQ(MetaCacheErrorType::OK, mc.GetChunkInfoByIndex(512, &cinfo));
+    ASSERT_EQ(513, cinfo.cid_);
+    ASSERT_EQ(2, cinfo.cpid_);
+    ASSERT_EQ(MetaCacheErrorType::CHUNKINFO_NOT_FOUND,
+              mc.GetChunkInfoByIndex(256, &cinfo));
+    for (int i = 0; i < 18; i++) {
+        ASSERT_TRUE(mc.GetServerList(1234, i).IsValid());
+    }
+
+    delete failRet;
+    delete fakeret;
+    delete faketopo;
+}
+
+// 按照请求的offset和count返回全部已分配的segment，copyset为0~15
+static void FillSegments(
+    const curve::client::FInfo_t& fi,
+    const ::curve::mds::GetOrAllocateSegmentsRequest* request,
+    ::curve::mds::GetOrAllocateSegmentsResponse* response) {
+    response->set_statuscode(::curve::mds::StatusCode::kOK);
+    uint64_t chunkNum = fi.segmentsize / fi.chunksize;
+    for (uint32_t i = 0; i < request->count(); ++i) {
+        uint64_t offset = request->offset() +
+                          static_cast<uint64_t>(i) * fi.segmentsize;
+        if (offset + fi.segmentsize > fi.length) {
+            break;
+        }
+        auto pfs = response->add_pagefilesegments();
+        pfs->set_logicalpoolid(1234);
+        pfs->set_segmentsize(fi.segmentsize);
+        pfs->set_chunksize(fi.chunksize);
+        pfs->set_startoffset(offset);
+        for (uint64_t j = 0; j < chunkNum; ++j) {
+            auto chunk = pfs->add_chunks();
+            chunk->set_copysetid(j % 16);
+            chunk->set_chunkid(offset / fi.chunksize + j + 1);
+        }
+    }
+}
+
+static void SetFakeServerList(FakeTopologyService* topologyservice,
+    ::curve::mds::topology::GetChunkServerListInCopySetsResponse* topoResp) {
+    topoResp->set_statuscode(0);
+    for (int i = 0; i < 16; i++) {
+        auto csinfo = topoResp->add_csinfo();
+        csinfo->set_copysetid(i);
+        for (int j = 0; j < 3; j++) {
+            auto cslocs = csinfo->add_cslocs();
+            cslocs->set_chunkserverid(i * 3 + j + 1);
+            cslocs->set_hostip("127.0.0.1");
+            cslocs->set_port(5000);
+        }
+    }
+}
+
+static bool WaitUntil(std::function<bool()> cond) {
+    for (int i = 0; i < 500; ++i) {
+        if (cond()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return cond();
+}
+
+TEST_F(MDSClientTest, SegmentPrefetcherTest) {
+    curve::client::FInfo_t fi;
+    fi.userinfo = userinfo;
+    fi.fullPathName = "/1_userinfo_";
+    fi.chunksize   = 4 * 1024 * 1024;
+    fi.segmentsize = 1 * 1024 * 1024 * 1024ul;
+    fi.length = 16 * fi.segmentsize;
+    const uint64_t segSize = fi.segmentsize;
+    const uint64_t chunksPerSeg = fi.segmentsize / fi.chunksize;
+
+    curve::mds::GetOrAllocateSegmentsResponse response;
+    FakeReturn* fakeret = new FakeReturn(nullptr,
+                static_cast<void*>(&response));
+    curvefsservice.SetGetOrAllocateSegmentsFakeReturn(fakeret);
+
+    // mds收到的请求，可以阻塞请求以便观察队列中的预分配任务
+    std::mutex mtx;
+    std::vector<std::pair<uint64_t, uint32_t>> requests;
+    std::atomic<bool> block(false);
+    curvefsservice.SetGetOrAllocateSegmentsTask(
+        [&](const ::curve::mds::GetOrAllocateSegmentsRequest* request,
+            ::curve::mds::GetOrAllocateSegmentsResponse* response) {
+            {
+                std::lock_guard<std::mutex> lk(mtx);
+                requests.emplace_back(request->offset(), request->count());
+            }
+            while (block.load()) {
+                bthread_usleep(1000);
+            }
+            FillSegments(fi, request, response);
+        });
+    auto requestNum = [&]() {
+        std::lock_guard<std::mutex> lk(mtx);
+        return requests.size();
+    };
+
+    ::curve::mds::topology::GetChunkServerListInCopySetsResponse topoResp;
+    SetFakeServerList(&topologyservice, &topoResp);
+    FakeReturn* faketopo = new FakeReturn(nullptr,
+        static_cast<void*>(&topoResp));
+    topologyservice.SetFakeReturn(faketopo);
+
+    curve::client::MetaCache mc;
+    mc.UpdateFileInfo(fi);
+    auto segmentCached = [&](uint64_t seg) {
+        curve::client::ChunkIDInfo_t cinfo;
+        return mc.GetChunkInfoByIndex(seg * chunksPerSeg, &cinfo) ==
+               MetaCacheErrorType::OK;
+    };
+
+    curve::client::SegmentPrefetchOption_t opt;
+    opt.segmentPrefetchEnable = true;
+    opt.segmentPrefetchNum = 2;
+    opt.segmentPrefetchTriggerDistanceMB = 128;
+    curve::client::SegmentPrefetcher prefetcher;
+    ASSERT_TRUE(prefetcher.Init(opt, &mc, &mdsclient_, nullptr));
+
+    // 1. 距离下一个segment较远时不触发预分配
+    prefetcher.OnWrite(0, 4096);
+    // 2. 非顺序写不触发预分配
+    prefetcher.OnWrite(segSize - 64 * 1024 * 1024, 4096);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_EQ(0, requestNum());
+
+    // 3. 顺序写接近segment边界，预分配之后的两个segment
+    block = true;
+    prefetcher.OnWrite(segSize - 64 * 1024 * 1024 + 4096, 4096);
+    ASSERT_TRUE(WaitUntil([&]() { return requestNum() == 1; }));
+
+    // 4. segment正在预分配，继续顺序写不会重复提交
+    prefetcher.OnWrite(segSize - 64 * 1024 * 1024 + 8192, 4096);
+
+    // 5. 后台线程阻塞时，队列中放满4个任务，之后的预分配直接丢弃
+    for (uint64_t seg : {3, 5, 7, 9, 11}) {
+        uint64_t off = seg * segSize - 64 * 1024 * 1024;
+        prefetcher.OnWrite(off, 4096);
+        prefetcher.OnWrite(off + 4096, 4096);
+    }
+
+    block = false;
+    ASSERT_TRUE(WaitUntil([&]() {
+        return requestNum() == 5 && segmentCached(10);
+    }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_EQ(5, requestNum());
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        for (int i = 0; i < 5; ++i) {
+            ASSERT_EQ((2 * i + 1) * segSize, requests[i].first);
+            ASSERT_EQ(2, requests[i].second);
+        }
+    }
+    for (uint64_t seg = 1; seg <= 10; ++seg) {
+        ASSERT_TRUE(segmentCached(seg)) << seg;
+    }
+    ASSERT_FALSE(segmentCached(11));
+    ASSERT_FALSE(segmentCached(12));
+
+    // 6. 被丢弃的预分配不会残留在inflight中，再次顺序写时重新提交
+    uint64_t off = 11 * segSize - 64 * 1024 * 1024;
+    prefetcher.OnWrite(off, 4096);
+    prefetcher.OnWrite(off + 4096, 4096);
+    ASSERT_TRUE(WaitUntil([&]() { return segmentCached(12); }));
+    ASSERT_EQ(6, requestNum());
+
+    // 7. 已经在metacache中的segment不再预分配
+    prefetcher.OnWrite(off + 8192, 4096);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_EQ(6, requestNum());
+
+    prefetcher.Fini();
+    curvefsservice.SetGetOrAllocateSegmentsTask(nullptr);
+    delete fakeret;
+    delete faketopo;
+}
+
+TEST_F(MDSClientTest, WarmUpMetaCachePagingTest) {
+    curve::client::FInfo_t fi;
+    fi.userinfo = userinfo;
+    fi.fullPathName = "/1_userinfo_";
+    fi.chunksize   = 16 * 1024 * 1024;
+    fi.segmentsize = 1 * 1024 * 1024 * 1024ul;
+    fi.length = 10 * fi.segmentsize;
+    const uint64_t chunkNum = fi.length / fi.chunksize;
+
+    curve::mds::GetOrAllocateSegmentsResponse response;
+    FakeReturn* fakeret = new FakeReturn(nullptr,
+                static_cast<void*>(&response));
+    curvefsservice.SetGetOrAllocateSegmentsFakeReturn(fakeret);
+
+    std::vector<std::pair<uint64_t, uint32_t>> requests;
+    curvefsservice.SetGetOrAllocateSegmentsTask(
+        [&](const ::curve::mds::GetOrAllocateSegmentsRequest* request,
+            ::curve::mds::GetOrAllocateSegmentsResponse* response) {
+            requests.emplace_back(request->offset(), request->count());
+            FillSegments(fi, request, response);
+        });
+
+    ::curve::mds::topology::GetChunkServerListInCopySetsResponse topoResp;
+    SetFakeServerList(&topologyservice, &topoResp);
+    FakeReturn* faketopo = new FakeReturn(nullptr,
+        static_cast<void*>(&topoResp));
+    topologyservice.SetFakeReturn(faketopo);
+
+    curve::client::IOOption_t ioopt;
+    ioopt.ioSplitOpt.fileIOSplitMaxSizeKB = 64;
+    ioopt.reqSchdulerOpt.scheduleQueueCapacity = 4096;
+    ioopt.reqSchdulerOpt.scheduleThreadpoolSize = 1;
+    ioopt.metaCacheOpt.metacacheWarmupOnOpen = true;
+    // 每页超过4个segment，10个segment分两页获取
+    ioopt.metaCacheOpt.metacacheWarmupSegmentsPerRPC = 6;
+
+    curve::client::IOManager4File iomanager;
+    ASSERT_TRUE(iomanager.Initialize(fi.fullPathName, ioopt, &mdsclient_));
+    iomanager.UpdateFileInfo(fi);
+    iomanager.WarmUpMetaCache(&mdsclient_);
+
+    ASSERT_EQ(2, requests.size());
+    ASSERT_EQ(0, requests[0].first);
+    ASSERT_EQ(6, requests[0].second);
+    ASSERT_EQ(6 * fi.segmentsize, requests[1].first);
+    ASSERT_EQ(6, requests[1].second);
+
+    // 每个segment的每个chunk都已经在metacache中
+    curve::client::MetaCache* mc = iomanager.GetMetaCache();
+    for (uint64_t index = 0; index < chunkNum; ++index) {
+        curve::client::ChunkIDInfo_t cinfo;
+        ASSERT_EQ(MetaCacheErrorType::OK,
+                  mc->GetChunkInfoByIndex(index, &cinfo)) << index;
+        ASSERT_EQ(index + 1, cinfo.cid_);
+    }
+    for (int i = 0; i < 16; i++) {
+        ASSERT_TRUE(mc->GetServerList(1234, i).IsValid());
+    }
+
+    iomanager.UnInitialize();
+    curvefsservice.SetGetOrAllocateSegmentsTask(nullptr);
+    delete fakeret;
+    delete faketopo;
+}
+
+TEST_F(MDSClientTest, WarmUpMetaCacheExceedMdsLimitTest) {
+    curve::client::FInfo_t fi;
+    fi.userinfo = userinfo;
+    fi.fullPathName = "/1_userinfo_";
+    fi.chunksize   = 16 * 1024 * 1024;
+    fi.segmentsize = 1 * 1024 * 1024 * 1024ul;
+    fi.length = 10 * fi.segmentsize;
+    const uint64_t chunkNum = fi.length / fi.chunksize;
+
+    curve::mds::GetOrAllocateSegmentsResponse response;
+    FakeReturn* fakeret = new FakeReturn(nullptr,
+                static_cast<void*>(&response));
+    curvefsservice.SetGetOrAllocateSegmentsFakeReturn(fakeret);
+
+    // mds一次最多返回4个segment
+    const uint32_t mdsLimit = 4;
+    std::vector<std::pair<uint64_t, uint32_t>> requests;
+    curvefsservice.SetGetOrAllocateSegmentsTask(
+        [&](const ::curve::mds::GetOrAllocateSegmentsRequest* request,
+            ::curve::mds::GetOrAllocateSegmentsResponse* response) {
+            requests.emplace_back(request->offset(), request->count());
+            if (request->count() > mdsLimit) {
+                response->set_statuscode(::curve::mds::StatusCode::kParaError);
+                return;
+            }
+            FillSegments(fi, request, response);
+        });
+
+    ::curve::mds::topology::GetChunkServerListInCopySetsResponse topoResp;
+    SetFakeServerList(&topologyservice, &topoResp);
+    FakeReturn* faketopo = new FakeReturn(nullptr,
+        static_cast<void*>(&topoResp));
+    topologyservice.SetFakeReturn(faketopo);
+
+    curve::client::IOOption_t ioopt;
+    ioopt.ioSplitOpt.fileIOSplitMaxSizeKB = 64;
+    ioopt.reqSchdulerOpt.scheduleQueueCapacity = 4096;
+    ioopt.reqSchdulerOpt.scheduleThreadpoolSize = 1;
+    ioopt.metaCacheOpt.metacacheWarmupOnOpen = true;
+    ioopt.metaCacheOpt.metacacheWarmupSegmentsPerRPC = 6;
+
+    curve::client::IOManager4File iomanager;
+    ASSERT_TRUE(iomanager.Initialize(fi.fullPathName, ioopt, &mdsclient_));
+    iomanager.UpdateFileInfo(fi);
+    iomanager.WarmUpMetaCache(&mdsclient_);
+
+    // 6个超过上限被拒绝，之后每次获取3个
+    ASSERT_EQ(5, requests.size());
+    ASSERT_EQ(0, requests[0].first);
+    ASSERT_EQ(6, requests[0].second);
+    for (int i = 1; i < 5; ++i) {
+        ASSERT_EQ((i - 1) * 3 * fi.segmentsize, requests[i].first);
+        ASSERT_EQ(3, requests[i].second);
+    }
+
+    curve::client::MetaCache* mc = iomanager.GetMetaCache();
+    for (uint64_t index = 0; index < chunkNum; ++index) {
+        curve::client::ChunkIDInfo_t cinfo;
+        ASSERT_EQ(MetaCacheErrorType::OK,
+                  mc->GetChunkInfoByIndex(index, &cinfo)) << index;
+    }
+
+    iomanager.UnInitialize();
+    curvefsservice.SetGetOrAllocateSegmentsTask(nullptr);
+    delete fakeret;
+    delete faketopo;
+}
+
 TEST_F(MDSClientTest, GetServerList) {
     brpc::Server server;
 
@@ -2303,6 +2696,151 @@ TEST_F(ServiceHelperGetLeaderTest, EmptyCopysetPeerInfoTest) {
                                            &leaderId, nullptr));
 }
 
+TEST(MetaCacheReadPeerTest, GetReadPeerTest) {
+    curve::client::MetaCache mc;
+    ChunkServerID csid = 0;
+    curve::client::EndPoint ep;
+
+    // copyset不存在
+    ASSERT_EQ(-1, mc.GetReadPeer(1, 1, &csid, &ep));
+
+    // copyset没有副本信息
+    CopysetInfo_t csinfo;
+    mc.UpdateCopysetInfo(1, 1, csinfo);
+    ASSERT_EQ(-1, mc.GetReadPeer(1, 1, &csid, &ep));
+
+    for (int i = 1; i <= 3; ++i) {
+        curve::client::EndPoint peerAddr;
+        butil::str2endpoint("127.0.0.1", 9000 + i, &peerAddr);
+        csinfo.csinfos_.push_back(CopysetPeerInfo(
+            i, curve::client::ChunkServerAddr(peerAddr)));
+    }
+    mc.UpdateCopysetInfo(1, 1, csinfo);
+
+    // 读请求分散到所有副本上
+    std::set<ChunkServerID> peers;
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(0, mc.GetReadPeer(1, 1, &csid, &ep));
+        ASSERT_EQ(9000 + csid, ep.port);
+        peers.insert(csid);
+    }
+    ASSERT_EQ(3, peers.size());
+
+    // leader可能发生变更时不选择副本
+    csinfo.SetLeaderUnstableFlag();
+    mc.UpdateCopysetInfo(1, 1, csinfo);
+    ASSERT_EQ(-1, mc.GetReadPeer(1, 1, &csid, &ep));
+}
+
+TEST(MetaCacheReadPeerTest, GetHedgedReadPeerTest) {
+    curve::client::MetaCache mc;
+    ChunkServerID csid = 0;
+    curve::client::EndPoint ep;
+
+    // copyset不存在
+    ASSERT_EQ(-1, mc.GetHedgedReadPeer(1, 1, 1, &csid, &ep));
+
+    // 只有leader一个副本时没有可选的follower
+    CopysetInfo_t csinfo;
+    curve::client::EndPoint leaderAddr;
+    butil::str2endpoint("127.0.0.1", 9001, &leaderAddr);
+    csinfo.csinfos_.push_back(CopysetPeerInfo(
+        1, curve::client::ChunkServerAddr(leaderAddr)));
+    mc.UpdateCopysetInfo(1, 1, csinfo);
+    ASSERT_EQ(-1, mc.GetHedgedReadPeer(1, 1, 1, &csid, &ep));
+
+    for (int i = 2; i <= 3; ++i) {
+        curve::client::EndPoint peerAddr;
+        butil::str2endpoint("127.0.0.1", 9000 + i, &peerAddr);
+        csinfo.csinfos_.push_back(CopysetPeerInfo(
+            i, curve::client::ChunkServerAddr(peerAddr)));
+    }
+    mc.UpdateCopysetInfo(1, 1, csinfo);
+
+    // 备份读请求分散到leader以外的副本上
+    std::set<ChunkServerID> peers;
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(0, mc.GetHedgedReadPeer(1, 1, 1, &csid, &ep));
+        ASSERT_EQ(9000 + csid, ep.port);
+        peers.insert(csid);
+    }
+    ASSERT_EQ(2, peers.size());
+    ASSERT_EQ(0, peers.count(1));
+
+    // leader可能发生变更时不选择副本
+    csinfo.SetLeaderUnstableFlag();
+    mc.UpdateCopysetInfo(1, 1, csinfo);
+    ASSERT_EQ(-1, mc.GetHedgedReadPeer(1, 1, 1, &csid, &ep));
+}
+
+TEST(MetaCacheChunkIndexTest, ChunkIndexTableTest) {
+    curve::client::MetaCache mc;
+    curve::client::ChunkIDInfo_t cinfo;
+
+    // 没有文件信息时保存在map中
+    mc.UpdateChunkInfoByIndex(1, curve::client::ChunkIDInfo_t(11, 1, 1));
+    ASSERT_EQ(MetaCacheErrorType::OK, mc.GetChunkInfoByIndex(1, &cinfo));
+    ASSERT_EQ(11, cinfo.cid_);
+
+    // 更新文件信息后创建chunk信息表，已有的chunk信息迁移到表中
+    curve::client::FInfo_t fileInfo;
+    fileInfo.chunksize = 4 * 1024 * 1024;
+    fileInfo.length = 10 * fileInfo.chunksize;
+    mc.UpdateFileInfo(fileInfo);
+    ASSERT_EQ(MetaCacheErrorType::OK, mc.GetChunkInfoByIndex(1, &cinfo));
+    ASSERT_EQ(11, cinfo.cid_);
+    ASSERT_EQ(1, cinfo.lpid_);
+    ASSERT_EQ(1, cinfo.cpid_);
+    ASSERT_EQ(MetaCacheErrorType::CHUNKINFO_NOT_FOUND,
+              mc.GetChunkInfoByIndex(0, &cinfo));
+
+    for (curve::client::ChunkIndex i = 0; i < 10; ++i) {
+        mc.UpdateChunkInfoByIndex(
+            i, curve::client::ChunkIDInfo_t(100 + i, 2, 1000 + i));
+    }
+    for (curve::client::ChunkIndex i = 0; i < 10; ++i) {
+        ASSERT_EQ(MetaCacheErrorType::OK, mc.GetChunkInfoByIndex(i, &cinfo));
+        ASSERT_EQ(100 + i, cinfo.cid_);
+        ASSERT_EQ(2, cinfo.lpid_);
+        ASSERT_EQ(1000 + i, cinfo.cpid_);
+    }
+
+    // 文件扩容后，超出表范围的chunk保存在map中
+    fileInfo.length = 20 * fileInfo.chunksize;
+    mc.UpdateFileInfo(fileInfo);
+    ASSERT_EQ(MetaCacheErrorType::CHUNKINFO_NOT_FOUND,
+              mc.GetChunkInfoByIndex(15, &cinfo));
+    mc.UpdateChunkInfoByIndex(15, curve::client::ChunkIDInfo_t(115, 2, 1015));
+    ASSERT_EQ(MetaCacheErrorType::OK, mc.GetChunkInfoByIndex(15, &cinfo));
+    ASSERT_EQ(115, cinfo.cid_);
+}
+
+TEST(MetaCacheChunkIndexTest, LogicPoolCopysetIDTest) {
+    ASSERT_NE(curve::client::CalcLogicPoolCopysetID(1, 2),
+              curve::client::CalcLogicPoolCopysetID(2, 1));
+
+    curve::client::MetaCache mc;
+    CopysetInfo_t csinfo;
+    curve::client::EndPoint peerAddr;
+    butil::str2endpoint("127.0.0.1", 9001, &peerAddr);
+    csinfo.csinfos_.push_back(CopysetPeerInfo(
+        1, curve::client::ChunkServerAddr(peerAddr)));
+    csinfo.UpdateLeaderIndex(0);
+    mc.UpdateCopysetInfo(1, 2, csinfo);
+
+    // 不需要刷新时直接返回缓存的leader
+    ChunkServerID leaderId = 0;
+    curve::client::EndPoint leaderAddr;
+    ASSERT_EQ(0, mc.GetLeader(1, 2, &leaderId, &leaderAddr));
+    ASSERT_EQ(1, leaderId);
+    ASSERT_EQ(peerAddr, leaderAddr);
+    ASSERT_EQ(-1, mc.GetLeader(2, 1, &leaderId, &leaderAddr));
+
+    mc.UpdateAppliedIndex(1, 2, 100);
+    ASSERT_EQ(100, mc.GetAppliedIndex(1, 2));
+    ASSERT_EQ(0, mc.GetAppliedIndex(2, 1));
+}
+
 TEST_F(MDSClientTest, StatFileStatusTest) {
     std::vector<curve::mds::FileStatus> fileStatus{
         curve::mds::FileStatus::kFileCreated,
@@ -2456,5 +2994,60 @@ TEST_F(MDSClientRefreshSessionTest, NoStartDummyServerTest) {
     ASSERT_FALSE(request.has_clientip());
 }
 
+TEST(MetaCacheZeroChunkTest, MarkAndInvalidateTest) {
+    MetaCacheOption_t opt;
+    FInfo_t fi;
+    fi.length = 10ull * 1024 * 1024 * 1024;
+
+    // 未开启时不记录
+    {
+        MetaCache mc;
+        mc.Init(opt, nullptr);
+        mc.UpdateFileInfo(fi);
+        ASSERT_FALSE(mc.ZeroChunkCacheEnabled());
+        mc.MarkZeroChunks(0, 4, mc.GetZeroChunkEpoch());
+        ASSERT_FALSE(mc.IsZeroChunk(0));
+    }
+
+    opt.metacacheZeroChunkCacheEnable = true;
+
+    // clone文件不生效
+    {
+        MetaCache mc;
+        mc.Init(opt, nullptr);
+        FInfo_t cloneFi = fi;
+        cloneFi.cloneSource = "/clonesource";
+        mc.UpdateFileInfo(cloneFi);
+        ASSERT_FALSE(mc.ZeroChunkCacheEnabled());
+    }
+
+    MetaCache mc;
+    mc.Init(opt, nullptr);
+    mc.UpdateFileInfo(fi);
+    ASSERT_TRUE(mc.ZeroChunkCacheEnabled());
+
+    uint64_t epoch = mc.GetZeroChunkEpoch();
+    mc.MarkZeroChunks(0, 4, epoch);
+    for (ChunkIndex i = 0; i < 4; ++i) {
+        ASSERT_TRUE(mc.IsZeroChunk(i));
+    }
+    ASSERT_FALSE(mc.IsZeroChunk(4));
+
+    // 写请求使对应chunk失效，不影响其他chunk
+    mc.InvalidateZeroChunk(1);
+    ASSERT_FALSE(mc.IsZeroChunk(1));
+    ASSERT_TRUE(mc.IsZeroChunk(0));
+    ASSERT_TRUE(mc.IsZeroChunk(2));
+
+    // 读请求下发之后有写请求，读请求的结果不记录
+    epoch = mc.GetZeroChunkEpoch();
+    mc.InvalidateZeroChunk(8);
+    mc.MarkZeroChunks(8, 1, epoch);
+    ASSERT_FALSE(mc.IsZeroChunk(8));
+
+    mc.MarkZeroChunks(8, 1, mc.GetZeroChunkEpoch());
+    ASSERT_TRUE(mc.IsZeroChunk(8));
+}
+
 }  // namespace client
 }  // namespace curve
@@ -0,0 +1,171 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+#include <brpc/controller.h>
+
+#include <vector>
+
+#include "src/client/client_object_pool.h"
+#include "src/client/request_context.h"
+#include "src/client/request_closure.h"
+#include "src/client/io_tracker.h"
+
+namespace curve {
+namespace client {
+
+TEST(ClientObjectPoolTest, RequestContextReuseTest) {
+    int64_t ctxInUse = ClientObjectPool<RequestContext>::InUse();
+    int64_t closureInUse = ClientObjectPool<RequestClosure>::InUse();
+
+    RequestContext* ctx = RequestContext::NewInitedRequestContext();
+    ASSERT_NE(nullptr, ctx);
+    ASSERT_NE(nullptr, ctx->done_);
+    ASSERT_EQ(ctx, ctx->done_->GetReqCtx());
+    ASSERT_EQ(ctxInUse + 1, ClientObjectPool<RequestContext>::InUse());
+    ASSERT_EQ(closureInUse + 1, ClientObjectPool<RequestClosure>::InUse());
+
+    uint64_t oldId = ctx->id_;
+    ctx->idinfo_ = ChunkIDInfo(1, 2, 3);
+    ctx->optype_ = OpType::WRITE;
+    ctx->offset_ = 4096;
+    ctx->rawlength_ = 4096;
+    ctx->appliedindex_ = 10;
+    ctx->followerRead_ = true;
+    ctx->leaderOnlyRead_ = true;
+    ctx->fileId_ = 100;
+    ctx->location_ = "test@cs";
+    ctx->sourceInfo_ = RequestSourceInfo("/clonesource", 4096);
+    ctx->chunkIdx_ = 5;
+    ctx->zeroRead_ = true;
+    ctx->zeroChunkEpoch_ = 6;
+    ctx->done_->SetFailed(-1);
+    ctx->done_->IncremRetriedTimes();
+    ctx->done_->SetNextTimeOutMS(1000);
+    ctx->done_->SetSuspendRPCFlag();
+    char buf[4096];
+    ctx->iov_.push_back({buf, sizeof(buf)});
+    ctx->readIOBuf_ = true;
+    ctx->readData_.resize(4096);
+
+    RequestContext::RecycleRequestContext(ctx);
+    ASSERT_EQ(ctxInUse, ClientObjectPool<RequestContext>::InUse());
+    ASSERT_EQ(closureInUse, ClientObjectPool<RequestClosure>::InUse());
+    // 归还时已经释放读到的数据和用户buffer片段，不必等到下次复用
+    ASSERT_TRUE(ctx->readData_.empty());
+    ASSERT_TRUE(ctx->iov_.empty());
+
+    // 同一线程上归还后再次获取，复用的对象状态需要全部被重置
+    RequestContext* reused = RequestContext::NewInitedRequestContext();
+    ASSERT_NE(nullptr, reused);
+    ASSERT_NE(oldId, reused->id_);
+    ASSERT_EQ(0, reused->idinfo_.cid_);
+    ASSERT_EQ(0, reused->idinfo_.lpid_);
+    ASSERT_EQ(0, reused->idinfo_.cpid_);
+    ASSERT_EQ(OpType::UNKNOWN, reused->optype_);
+    ASSERT_EQ(0, reused->offset_);
+    ASSERT_EQ(0, reused->rawlength_);
+    ASSERT_EQ(0, reused->appliedindex_);
+    ASSERT_FALSE(reused->followerRead_);
+    ASSERT_FALSE(reused->leaderOnlyRead_);
+    ASSERT_EQ(0, reused->fileId_);
+    ASSERT_TRUE(reused->location_.empty());
+    ASSERT_TRUE(reused->sourceInfo_.cloneFileSource.empty());
+    ASSERT_EQ(0, reused->sourceInfo_.cloneFileOffset);
+    ASSERT_EQ(0, reused->chunkIdx_);
+    ASSERT_FALSE(reused->zeroRead_);
+    ASSERT_EQ(0, reused->zeroChunkEpoch_);
+    ASSERT_EQ(reused, reused->done_->GetReqCtx());
+    ASSERT_EQ(-1, reused->done_->GetErrorCode());
+    ASSERT_EQ(0, reused->done_->GetRetriedTimes());
+    ASSERT_EQ(0, reused->done_->GetNextTimeoutMS());
+    ASSERT_FALSE(reused->done_->IsSuspendRPC());
+    ASSERT_EQ(nullptr, reused->done_->GetIOTracker());
+    ASSERT_EQ(nullptr, reused->done_->GetMetric());
+
+    RequestContext::RecycleRequestContext(reused);
+    ASSERT_EQ(ctxInUse, ClientObjectPool<RequestContext>::InUse());
+
+    // 空指针直接忽略
+    ASSERT_NO_FATAL_FAILURE(RequestContext::RecycleRequestContext(nullptr));
+}
+
+TEST(ClientObjectPoolTest, SteadyStateNoAllocationTest) {
+    // 预热，保证本线程的空闲链表上已有足够的对象
+    std::vector<RequestContext*> ctxs;
+    for (int i = 0; i < 8; ++i) {
+        ctxs.push_back(RequestContext::NewInitedRequestContext());
+    }
+    for (auto ctx : ctxs) {
+        RequestContext::RecycleRequestContext(ctx);
+    }
+
+    uint64_t ctxCreated = ClientObjectPool<RequestContext>::Created();
+    uint64_t closureCreated = ClientObjectPool<RequestClosure>::Created();
+
+    for (int round = 0; round < 1000; ++round) {
+        ctxs.clear();
+        for (int i = 0; i < 8; ++i) {
+            ctxs.push_back(RequestContext::NewInitedRequestContext());
+        }
+        for (auto ctx : ctxs) {
+            RequestContext::RecycleRequestContext(ctx);
+        }
+    }
+
+    ASSERT_EQ(ctxCreated, ClientObjectPool<RequestContext>::Created());
+    ASSERT_EQ(closureCreated, ClientObjectPool<RequestClosure>::Created());
+}
+
+TEST(ClientObjectPoolTest, IOTrackerAndControllerReuseTest) {
+    int64_t trackerInUse = ClientObjectPool<IOTracker>::InUse();
+
+    IOTracker* tracker = ClientObjectPool<IOTracker>::Get();
+    ASSERT_NE(nullptr, tracker);
+    tracker->Reset(nullptr, nullptr, nullptr);
+    uint64_t oldId = tracker->GetID();
+    tracker->SetOpType(OpType::READ);
+    ASSERT_EQ(trackerInUse + 1, ClientObjectPool<IOTracker>::InUse());
+    ClientObjectPool<IOTracker>::Return(tracker);
+    ASSERT_EQ(trackerInUse, ClientObjectPool<IOTracker>::InUse());
+
+    IOTracker* reused = ClientObjectPool<IOTracker>::Get();
+    ASSERT_NE(nullptr, reused);
+    reused->Reset(nullptr, nullptr, nullptr);
+    ASSERT_NE(oldId, reused->GetID());
+    ASSERT_EQ(OpType::UNKNOWN, reused->Optype());
+    ClientObjectPool<IOTracker>::Return(reused);
+
+    brpc::Controller* cntl = ClientObjectPool<brpc::Controller>::Get();
+    ASSERT_NE(nullptr, cntl);
+    cntl->set_timeout_ms(1000);
+    cntl->SetFailed(EHOSTDOWN, "test");
+    cntl->Reset();
+    ClientObjectPool<brpc::Controller>::Return(cntl);
+
+    cntl = ClientObjectPool<brpc::Controller>::Get();
+    ASSERT_FALSE(cntl->Failed());
+    ClientObjectPool<brpc::Controller>::Return(cntl);
+}
+
+}   // namespace client
+}   // namespace curve
@@ -196,6 +196,27 @@ class FakeMDSCurveFSService : public curve::mds::CurveFSService {
         response->CopyFrom(*resp);
     }
 
+    void GetOrAllocateSegments(::google::protobuf::RpcController* controller,
+                    const ::curve::mds::GetOrAllocateSegmentsRequest* request,
+                    ::curve::mds::GetOrAllocateSegmentsResponse* response,
+                    ::google::protobuf::Closure* done) {
+        brpc::ClosureGuard done_guard(done);
+        if (fakeGetOrAllocateSegmentsret_->controller_ != nullptr &&
+             fakeGetOrAllocateSegmentsret_->controller_->Failed()) {
+            controller->SetFailed("failed");
+        }
+
+        retrytimes_++;
+
+        auto resp = static_cast<::curve::mds::GetOrAllocateSegmentsResponse*>(
+                    fakeGetOrAllocateSegmentsret_->response_);
+        response->CopyFrom(*resp);
+
+        if (getOrAllocateSegmentsTask_) {
+            getOrAllocateSegmentsTask_(request, response);
+        }
+    }
+
     void OpenFile(::google::protobuf::RpcController* controller,
                 const ::curve::mds::OpenFileRequest* request,
                 ::curve::mds::OpenFileResponse* response,
@@ -601,6 +622,17 @@ class FakeMDSCurveFSService : public curve::mds::CurveFSService {
         fakeGetOrAllocateSegmentret_ = fakeret;
     }
 
+    void SetGetOrAllocateSegmentsFakeReturn(FakeReturn* fakeret) {
+        fakeGetOrAllocateSegmentsret_ = fakeret;
+    }
+
+    // 在返回预设的response之后调用，可以根据请求填充response或者阻塞请求
+    void SetGetOrAllocateSegmentsTask(
+        std::function<void(const ::curve::mds::GetOrAllocateSegmentsRequest*,
+                           ::curve::mds::GetOrAllocateSegmentsResponse*)> task) {  // NOLINT
+        getOrAllocateSegmentsTask_ = std::move(task);
+    }
+
     void SetOpenFile(FakeReturn* fakeret) {
         fakeopenfile_ = fakeret;
     }
@@ -707,6 +739,10 @@ class FakeMDSCurveFSService : public curve::mds::CurveFSService {
     FakeReturn* fakeGetFileInforet_;
     FakeReturn* fakeGetAllocatedSizeRet_;
     FakeReturn* fakeGetOrAllocateSegmentret_;
+    FakeReturn* fakeGetOrAllocateSegmentsret_;
+    std::function<void(const ::curve::mds::GetOrAllocateSegmentsRequest*,
+                       ::curve::mds::GetOrAllocateSegmentsResponse*)>
+        getOrAllocateSegmentsTask_;
     FakeReturn* fakeopenfile_;
     FakeReturn* fakeclosefile_;
     FakeReturn* fakerenamefile_;
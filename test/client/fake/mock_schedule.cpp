@@ -72,7 +72,12 @@ int Schedule::ScheduleRequest(
                 req->chunkinfodetail_->chunkSn.push_back(2222);
             }
 
-            if (iter->optype_ == curve::client::OpType::READ) {
+            if (iter->optype_ == curve::client::OpType::READ &&
+                iter->readIOBuf_) {
+                iter->readData_.clear();
+                iter->readData_.resize(iter->rawlength_,
+                                       fakedate[processed%10]);
+            } else if (iter->optype_ == curve::client::OpType::READ) {
                 memset(iter->readBuffer_,
                         fakedate[processed%10],
                         iter->rawlength_);
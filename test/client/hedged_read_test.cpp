@@ -0,0 +1,374 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <brpc/controller.h>
+#include <brpc/server.h>
+#include <bthread/bthread.h>
+#include <bthread/unstable.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <chrono>   // NOLINT
+#include <memory>
+#include <thread>   // NOLINT
+
+#include "src/client/chunk_closure.h"
+#include "src/client/copyset_client.h"
+#include "src/client/request_scheduler.h"
+#include "src/common/concurrent/count_down_event.h"
+#include "test/client/mock_chunkservice.h"
+#include "test/client/mock_meta_cache.h"
+#include "test/client/mock_request_context.h"
+
+namespace curve {
+namespace client {
+
+using curve::chunkserver::CHUNK_OP_STATUS;
+using curve::chunkserver::ChunkRequest;
+using curve::chunkserver::ChunkResponse;
+using curve::common::CountDownEvent;
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+
+namespace {
+
+std::atomic<int> gTimerFired{0};
+
+// 模拟定时器回调，释放定时器持有的引用
+void FakeHedgedReadTimer(void* arg) {
+    delete static_cast<std::shared_ptr<HedgedReadContext>*>(arg);
+    gTimerFired.fetch_add(1);
+}
+
+void ArmTimer(const std::shared_ptr<HedgedReadContext>& hedgedRead,
+              uint64_t delayUS) {
+    auto ref = new std::shared_ptr<HedgedReadContext>(hedgedRead);
+    ASSERT_EQ(0, bthread_timer_add(&hedgedRead->timer,
+                                   butil::microseconds_from_now(delayUS),
+                                   FakeHedgedReadTimer, ref));
+    hedgedRead->timerRef = ref;
+    hedgedRead->timerArmed.store(true);
+}
+
+class HedgedReadMetaCache : public MockMetaCache {
+ public:
+    MOCK_METHOD5(GetHedgedReadPeer, int(LogicPoolID, CopysetID, ChunkServerID,
+                                        ChunkServerID*, butil::EndPoint*));
+    MOCK_METHOD1(SetChunkserverUnstable, void(ChunkServerID));
+};
+
+class CountingRequestClosure : public FakeRequestClosure {
+ public:
+    CountingRequestClosure(CountDownEvent* cond, RequestContext* reqCtx)
+        : FakeRequestClosure(cond, reqCtx) {}
+
+    void Run() override {
+        runTimes.fetch_add(1);
+        FakeRequestClosure::Run();
+    }
+
+    std::atomic<int> runTimes{0};
+};
+
+}  // namespace
+
+TEST(HedgedReadContextTest, PrimaryWinsBeforeTimerArmed) {
+    auto hedgedRead = std::make_shared<HedgedReadContext>();
+
+    // leader的读请求在定时器设置之前返回，不需要删除定时器
+    ASSERT_TRUE(hedgedRead->ClaimByPrimary());
+    ASSERT_EQ(HedgedReadContext::kPrimaryDone, hedgedRead->state.load());
+    ASSERT_EQ(nullptr, hedgedRead->timerRef);
+    ASSERT_FALSE(hedgedRead->ClaimByHedge());
+
+    // 之后再设置的定时器触发时，状态已经不是kPending，不会发送备份读请求
+    int expected = HedgedReadContext::kPending;
+    ASSERT_FALSE(hedgedRead->state.compare_exchange_strong(
+        expected, HedgedReadContext::kHedgeSending));
+}
+
+TEST(HedgedReadContextTest, TimerDeletedOrFired) {
+    // 定时器删除成功，由leader的closure释放定时器持有的引用
+    {
+        gTimerFired.store(0);
+        auto hedgedRead = std::make_shared<HedgedReadContext>();
+        ArmTimer(hedgedRead, 10 * 1000 * 1000);
+        ASSERT_EQ(2, hedgedRead.use_count());
+
+        ASSERT_TRUE(hedgedRead->ClaimByPrimary());
+        ASSERT_EQ(nullptr, hedgedRead->timerRef);
+        ASSERT_EQ(1, hedgedRead.use_count());
+        ASSERT_EQ(0, gTimerFired.load());
+    }
+
+    // 定时器已经触发，引用由定时器回调释放，leader的closure不能重复释放
+    {
+        gTimerFired.store(0);
+        auto hedgedRead = std::make_shared<HedgedReadContext>();
+        ArmTimer(hedgedRead, 1000);
+        while (gTimerFired.load() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_EQ(1, hedgedRead.use_count());
+
+        ASSERT_TRUE(hedgedRead->ClaimByPrimary());
+        ASSERT_NE(nullptr, hedgedRead->timerRef);
+        ASSERT_EQ(1, hedgedRead.use_count());
+        ASSERT_EQ(1, gTimerFired.load());
+    }
+}
+
+TEST(HedgedReadContextTest, HedgeWinsWhileSending) {
+    auto hedgedRead = std::make_shared<HedgedReadContext>();
+    hedgedRead->state.store(HedgedReadContext::kHedgeSending);
+
+    // 备份读请求返回时SendHedgedRead可能还未将状态置为kHedgeInflight
+    ASSERT_TRUE(hedgedRead->ClaimByHedge());
+    ASSERT_EQ(HedgedReadContext::kHedgeWon, hedgedRead->state.load());
+
+    // SendHedgedRead不能覆盖kHedgeWon
+    int expected = HedgedReadContext::kHedgeSending;
+    ASSERT_FALSE(hedgedRead->state.compare_exchange_strong(
+        expected, HedgedReadContext::kHedgeInflight));
+
+    ASSERT_FALSE(hedgedRead->ClaimByPrimary());
+    ASSERT_FALSE(hedgedRead->ClaimByHedge());
+}
+
+TEST(HedgedReadContextTest, PrimaryWaitsForHedgeSending) {
+    // 备份读请求发送完成
+    {
+        auto hedgedRead = std::make_shared<HedgedReadContext>();
+        hedgedRead->state.store(HedgedReadContext::kHedgeSending);
+        std::thread sender([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            hedgedRead->state.store(HedgedReadContext::kHedgeInflight);
+        });
+
+        ASSERT_TRUE(hedgedRead->ClaimByPrimary());
+        sender.join();
+        ASSERT_EQ(HedgedReadContext::kPrimaryDone, hedgedRead->state.load());
+        ASSERT_FALSE(hedgedRead->ClaimByHedge());
+    }
+
+    // 没有可用的follower，状态恢复为kPending
+    {
+        auto hedgedRead = std::make_shared<HedgedReadContext>();
+        hedgedRead->state.store(HedgedReadContext::kHedgeSending);
+        std::thread sender([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            hedgedRead->state.store(HedgedReadContext::kPending);
+        });
+
+        ASSERT_TRUE(hedgedRead->ClaimByPrimary());
+        sender.join();
+        ASSERT_EQ(HedgedReadContext::kPrimaryDone, hedgedRead->state.load());
+    }
+}
+
+class HedgedReadTest : public testing::Test {
+ protected:
+    void SetUp() override {
+        listenAddr_ = "127.0.0.1:9118";
+        butil::str2endpoint(listenAddr_.c_str(), &addr_);
+        server_ = new brpc::Server();
+        ASSERT_EQ(0, server_->AddService(&chunkService_,
+                                         brpc::SERVER_DOESNT_OWN_SERVICE));
+        ASSERT_EQ(0, server_->Start(listenAddr_.c_str(), nullptr));
+
+        ioSenderOpt_.failRequestOpt.chunkserverRPCTimeoutMS = 1000;
+        ioSenderOpt_.failRequestOpt.chunkserverOPMaxRetry = 3;
+        ioSenderOpt_.failRequestOpt.chunkserverOPRetryIntervalUS = 500;
+        ioSenderOpt_.failRequestOpt.chunkserverMaxRPCTimeoutMS = 3500;
+        ioSenderOpt_.failRequestOpt.chunkserverMaxRetrySleepIntervalUS =
+            3500000;
+        ioSenderOpt_.chunkserverEnableAppliedIndexRead = 1;
+        ioSenderOpt_.chunkserverEnableHedgedRead = true;
+        ioSenderOpt_.chunkserverHedgedReadMinDelayUS = 100 * 1000;
+
+        UnstableHelper::GetInstance().ResetState();
+    }
+
+    void TearDown() override {
+        scheduler_.Fini();
+        server_->Stop(0);
+        server_->Join();
+        delete server_;
+        server_ = nullptr;
+        UnstableHelper::GetInstance().ResetState();
+    }
+
+    void Init() {
+        RequestScheduleOption_t reqopt;
+        reqopt.ioSenderOpt = ioSenderOpt_;
+        scheduler_.Init(reqopt, &metaCache_);
+        scheduler_.Run();
+        copysetClient_.Init(&metaCache_, ioSenderOpt_, &scheduler_, &fm_);
+
+        EXPECT_CALL(metaCache_, GetLeader(_, _, _, _, _, _))
+            .Times(1)
+            .WillOnce(DoAll(SetArgPointee<2>(kLeaderId),
+                            SetArgPointee<3>(addr_),
+                            Return(0)));
+    }
+
+    void ReadChunk(CountingRequestClosure** reqDone) {
+        RequestContext* reqCtx = new FakeRequestContext();
+        reqCtx->optype_ = OpType::READ;
+        reqCtx->idinfo_ = ChunkIDInfo(1, 1, 100001);
+        reqCtx->readBuffer_ = buff_;
+        reqCtx->offset_ = 0;
+        reqCtx->rawlength_ = kLength;
+
+        *reqDone = new CountingRequestClosure(&cond_, reqCtx);
+        (*reqDone)->SetFileMetric(&fm_);
+        (*reqDone)->SetIOTracker(&iot_);
+        reqCtx->done_ = *reqDone;
+
+        copysetClient_.ReadChunk(reqCtx->idinfo_, 1, 0, kLength, 10, {},
+                                 *reqDone);
+    }
+
+    // 不同副本通过request中的followerread区分，并按各自的时延返回
+    void ExpectReadChunk(int times, int leaderDelayMs) {
+        EXPECT_CALL(chunkService_, ReadChunk(_, _, _, _))
+            .Times(times)
+            .WillRepeatedly(Invoke(
+                [=](::google::protobuf::RpcController* controller,
+                    const ChunkRequest* request, ChunkResponse* response,
+                    google::protobuf::Closure* done) {
+                    brpc::ClosureGuard doneGuard(done);
+                    auto cntl = dynamic_cast<brpc::Controller*>(controller);
+                    if (!request->followerread()) {
+                        std::this_thread::sleep_for(
+                            std::chrono::milliseconds(leaderDelayMs));
+                    }
+                    cntl->response_attachment().append(
+                        std::string(kLength, 'a'));
+                    response->set_status(
+                        CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+                    response->set_appliedindex(10);
+                }));
+    }
+
+ protected:
+    static constexpr size_t kLength = 8;
+    static constexpr ChunkServerID kLeaderId = 10000;
+    static constexpr ChunkServerID kFollowerId = 10001;
+
+    std::string listenAddr_;
+    butil::EndPoint addr_;
+    brpc::Server* server_;
+    MockChunkServiceImpl chunkService_;
+
+    IOSenderOption_t ioSenderOpt_;
+    HedgedReadMetaCache metaCache_;
+    RequestScheduler scheduler_;
+    CopysetClient copysetClient_;
+
+    FileMetric fm_{"hedged_read_test"};
+    IOTracker iot_{nullptr, nullptr, nullptr, &fm_};
+    CountDownEvent cond_{1};
+    char buff_[kLength + 1] = {0};
+};
+
+constexpr size_t HedgedReadTest::kLength;
+constexpr ChunkServerID HedgedReadTest::kLeaderId;
+constexpr ChunkServerID HedgedReadTest::kFollowerId;
+
+TEST_F(HedgedReadTest, PrimaryWinsBeforeHedgeSent) {
+    ioSenderOpt_.chunkserverHedgedReadMinDelayUS = 1000 * 1000;
+    Init();
+
+    // leader先返回，定时器被删除或者触发时不再发送备份读请求
+    EXPECT_CALL(metaCache_, GetHedgedReadPeer(_, _, _, _, _)).Times(0);
+    ExpectReadChunk(1, 0);
+
+    CountingRequestClosure* reqDone = nullptr;
+    ReadChunk(&reqDone);
+    cond_.Wait();
+    ASSERT_EQ(0, reqDone->GetErrorCode());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1200));
+    ASSERT_EQ(1, reqDone->runTimes.load());
+    ASSERT_EQ(0, fm_.hedgedReadNum.get_value());
+}
+
+TEST_F(HedgedReadTest, NoFollowerAvailable) {
+    Init();
+
+    // 没有可用的follower，放弃备份读请求，由leader完成请求
+    EXPECT_CALL(metaCache_, GetHedgedReadPeer(_, _, kLeaderId, _, _))
+        .Times(1)
+        .WillOnce(Return(-1));
+    ExpectReadChunk(1, 300);
+
+    CountingRequestClosure* reqDone = nullptr;
+    ReadChunk(&reqDone);
+    cond_.Wait();
+    ASSERT_EQ(0, reqDone->GetErrorCode());
+    ASSERT_EQ(1, reqDone->runTimes.load());
+    ASSERT_EQ(0, fm_.hedgedReadNum.get_value());
+    ASSERT_EQ(0, fm_.hedgedReadWinNum.get_value());
+}
+
+TEST_F(HedgedReadTest, PrimaryReturnsAfterHedgeWon) {
+    Init();
+
+    EXPECT_CALL(metaCache_, GetHedgedReadPeer(_, _, kLeaderId, _, _))
+        .Times(1)
+        .WillOnce(DoAll(SetArgPointee<3>(kFollowerId),
+                        SetArgPointee<4>(addr_),
+                        Return(0)));
+    // leader上的读请求超过rpc超时时间才返回
+    ExpectReadChunk(2, 1500);
+
+    // 请求已经完成时文件可能已经关闭，leader超时后只计入超时次数，
+    // 不会访问metacache，也不会再完成请求
+    EXPECT_CALL(metaCache_, SetChunkserverUnstable(_)).Times(0);
+
+    CountingRequestClosure* reqDone = nullptr;
+    ReadChunk(&reqDone);
+    cond_.Wait();
+    ASSERT_EQ(0, reqDone->GetErrorCode());
+    ASSERT_EQ(1, fm_.hedgedReadNum.get_value());
+    ASSERT_EQ(1, fm_.hedgedReadWinNum.get_value());
+    ASSERT_EQ(std::string(kLength, 'a'), std::string(buff_, kLength));
+
+    int waitMs = 0;
+    while (UnstableHelper::GetInstance().GetTimeoutTimes(kLeaderId) == 0 &&
+           waitMs < 3000) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        waitMs += 10;
+    }
+    ASSERT_EQ(1, UnstableHelper::GetInstance().GetTimeoutTimes(kLeaderId));
+    ASSERT_EQ(1, reqDone->runTimes.load());
+    ASSERT_EQ(0, reqDone->GetErrorCode());
+}
+
+}  // namespace client
+}  // namespace curve
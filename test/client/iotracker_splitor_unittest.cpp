@@ -27,6 +27,7 @@
 #include <brpc/server.h>
 #include <fiu-control.h>
 
+#include <map>
 #include <string>
 #include <thread>   //NOLINT
 #include <chrono>   //NOLINT
@@ -91,6 +92,31 @@ void writecallback(CurveAioContext* context) {
     writecv.notify_one();
 }
 
+// 批量提交时记录每个aioctx的回调次数
+std::map<CurveAioContext*, int> batchCallbacks;
+int batchCallbackCount = 0;
+std::mutex batchmtx;
+std::condition_variable batchcv;
+
+void batchcallback(CurveAioContext* context) {
+    LOG(INFO) << "batch aio call back here, errorcode = " << context->ret;
+    std::lock_guard<std::mutex> lk(batchmtx);
+    ++batchCallbacks[context];
+    ++batchCallbackCount;
+    batchcv.notify_one();
+}
+
+void ResetBatchCallbacks() {
+    std::lock_guard<std::mutex> lk(batchmtx);
+    batchCallbacks.clear();
+    batchCallbackCount = 0;
+}
+
+void WaitBatchCallbacks(int count) {
+    std::unique_lock<std::mutex> lk(batchmtx);
+    batchcv.wait(lk, [count]()->bool{return batchCallbackCount >= count;});
+}
+
 class IOTrackerSplitorTest : public ::testing::Test {
  public:
     void SetUp() {
@@ -452,6 +478,42 @@ TEST_F(IOTrackerSplitorTest, ManagerAsyncStartRead) {
     ASSERT_EQ('f', data[aioctx->length - 1]);
 }
 
+TEST_F(IOTrackerSplitorTest, ManagerAsyncStartReadIOBuf) {
+    MockRequestScheduler* mockschuler = new MockRequestScheduler;
+    mockschuler->DelegateToFake();
+
+    auto ioctxmana = fileinstance_->GetIOManager4File();
+    ioctxmana->SetRequestScheduler(mockschuler);
+    CurveAioContext* aioctx = new CurveAioContext;
+    aioctx->offset = 4 * 1024 * 1024 - 4 * 1024;
+    aioctx->length = 4 * 1024 * 1024 + 8 * 1024;
+    aioctx->ret = LIBCURVE_ERROR::OK;
+    aioctx->cb = readcallback;
+    aioctx->buf = nullptr;
+    aioctx->op = LIBCURVE_OP::LIBCURVE_OP_READ;
+
+    ioreadflag = false;
+    butil::IOBuf iobuf;
+    ioctxmana->AioReadIOBuf(aioctx, &iobuf, &mdsclient_);
+
+    {
+        std::unique_lock<std::mutex> lk(readmtx);
+        readcv.wait(lk, []()->bool{return ioreadflag;});
+    }
+
+    // 数据按文件偏移顺序拼接，与读到用户buffer的结果一致
+    ASSERT_EQ(aioctx->length, iobuf.size());
+    std::string data = iobuf.to_string();
+    ASSERT_EQ('a', data[0]);
+    ASSERT_EQ('a', data[4 * 1024 - 1]);
+    ASSERT_EQ('b', data[4 * 1024]);
+    ASSERT_EQ('e', data[4 * 1024 + chunk_size - 1]);
+    ASSERT_EQ('f', data[4 * 1024 + chunk_size]);
+    ASSERT_EQ('f', data[aioctx->length - 1]);
+
+    delete aioctx;
+}
+
 TEST_F(IOTrackerSplitorTest, ManagerAsyncStartWrite) {
     MockRequestScheduler* mockschuler = new MockRequestScheduler;
     mockschuler->DelegateToFake();
@@ -490,6 +552,166 @@ TEST_F(IOTrackerSplitorTest, ManagerAsyncStartWrite) {
     ASSERT_EQ('c', writebuffer[aioctx->length - 1]);
 }
 
+TEST_F(IOTrackerSplitorTest, ManagerAsyncSubmitBatchMixed) {
+    MockRequestScheduler* mockschuler = new MockRequestScheduler;
+    mockschuler->DelegateToFake();
+
+    auto ioctxmana = fileinstance_->GetIOManager4File();
+    ioctxmana->SetRequestScheduler(mockschuler);
+
+    // 跨chunk的读，与ManagerAsyncStartRead中的读相同
+    CurveAioContext readctx;
+    readctx.offset = 4 * 1024 * 1024 - 4 * 1024;
+    readctx.length = 4 * 1024 * 1024 + 8 * 1024;
+    readctx.ret = LIBCURVE_ERROR::OK;
+    readctx.cb = batchcallback;
+    readctx.buf = new char[readctx.length];
+    readctx.op = LIBCURVE_OP::LIBCURVE_OP_READ;
+
+    CurveAioContext writectx;
+    writectx.offset = 8 * 1024 * 1024;
+    writectx.length = 8 * 1024;
+    writectx.ret = LIBCURVE_ERROR::OK;
+    writectx.cb = batchcallback;
+    writectx.buf = new char[writectx.length];
+    writectx.op = LIBCURVE_OP::LIBCURVE_OP_WRITE;
+    memset(writectx.buf, 'w', writectx.length);
+
+    CurveAioContext smallreadctx;
+    smallreadctx.offset = 0;
+    smallreadctx.length = 4 * 1024;
+    smallreadctx.ret = LIBCURVE_ERROR::OK;
+    smallreadctx.cb = batchcallback;
+    smallreadctx.buf = new char[smallreadctx.length];
+    smallreadctx.op = LIBCURVE_OP::LIBCURVE_OP_READ;
+
+    // 整批的request一次性下发
+    EXPECT_CALL(*mockschuler, ScheduleRequest(_)).Times(1);
+
+    ResetBatchCallbacks();
+    CurveAioContext* ctxs[] = {&readctx, &writectx, &smallreadctx};
+    ASSERT_EQ(LIBCURVE_ERROR::OK,
+              ioctxmana->AioSubmitBatch(ctxs, 3, &mdsclient_));
+    WaitBatchCallbacks(3);
+
+    // 每个aioctx各自回调一次，返回各自的长度
+    ASSERT_EQ(3, batchCallbacks.size());
+    ASSERT_EQ(1, batchCallbacks[&readctx]);
+    ASSERT_EQ(1, batchCallbacks[&writectx]);
+    ASSERT_EQ(1, batchCallbacks[&smallreadctx]);
+    ASSERT_EQ(readctx.length, readctx.ret);
+    ASSERT_EQ(writectx.length, writectx.ret);
+    ASSERT_EQ(smallreadctx.length, smallreadctx.ret);
+
+    // 读的request排在批次最前面，数据与单独下发时一致
+    char* data = static_cast<char*>(readctx.buf);
+    ASSERT_EQ('a', data[0]);
+    ASSERT_EQ('a', data[4 * 1024 - 1]);
+    ASSERT_EQ('b', data[4 * 1024]);
+    ASSERT_EQ('e', data[4 * 1024 + chunk_size - 1]);
+    ASSERT_EQ('f', data[4 * 1024 + chunk_size]);
+    ASSERT_EQ('f', data[readctx.length - 1]);
+
+    // 批次中只有一个写，写下去的就是它的数据
+    ASSERT_EQ('w', writebuffer[0]);
+    ASSERT_EQ('w', writebuffer[writectx.length - 1]);
+
+    delete[] static_cast<char*>(readctx.buf);
+    delete[] static_cast<char*>(writectx.buf);
+    delete[] static_cast<char*>(smallreadctx.buf);
+}
+
+TEST_F(IOTrackerSplitorTest, ManagerAsyncSubmitBatchPrepareFail) {
+    MockRequestScheduler* mockschuler = new MockRequestScheduler;
+    mockschuler->DelegateToFake();
+
+    auto ioctxmana = fileinstance_->GetIOManager4File();
+    ioctxmana->SetRequestScheduler(mockschuler);
+
+    CurveAioContext writectx;
+    writectx.offset = 0;
+    writectx.length = 4 * 1024;
+    writectx.ret = LIBCURVE_ERROR::OK;
+    writectx.cb = batchcallback;
+    writectx.buf = new char[writectx.length];
+    writectx.op = LIBCURVE_OP::LIBCURVE_OP_WRITE;
+    memset(writectx.buf, 'w', writectx.length);
+
+    // 与BoundaryTEST相同，超出文件大小，拆分失败
+    CurveAioContext failctx;
+    failctx.offset = 1 * 1024 * 1024 * 1024 - 4 * 1024 * 1024 - 4 * 1024;
+    failctx.length = 4 * 1024 * 1024 + 8 * 1024;
+    failctx.ret = LIBCURVE_ERROR::OK;
+    failctx.cb = batchcallback;
+    failctx.buf = new char[failctx.length];
+    failctx.op = LIBCURVE_OP::LIBCURVE_OP_WRITE;
+
+    CurveAioContext readctx;
+    readctx.offset = 4 * 1024 * 1024;
+    readctx.length = 4 * 1024;
+    readctx.ret = LIBCURVE_ERROR::OK;
+    readctx.cb = batchcallback;
+    readctx.buf = new char[readctx.length];
+    readctx.op = LIBCURVE_OP::LIBCURVE_OP_READ;
+
+    // 拆分失败的io直接返回，前后拆分成功的io仍然一起下发
+    EXPECT_CALL(*mockschuler, ScheduleRequest(_)).Times(1);
+
+    ResetBatchCallbacks();
+    CurveAioContext* ctxs[] = {&writectx, &failctx, &readctx};
+    ASSERT_EQ(LIBCURVE_ERROR::OK,
+              ioctxmana->AioSubmitBatch(ctxs, 3, &mdsclient_));
+    WaitBatchCallbacks(3);
+
+    ASSERT_EQ(3, batchCallbacks.size());
+    ASSERT_EQ(1, batchCallbacks[&writectx]);
+    ASSERT_EQ(1, batchCallbacks[&failctx]);
+    ASSERT_EQ(1, batchCallbacks[&readctx]);
+    ASSERT_EQ(writectx.length, writectx.ret);
+    ASSERT_EQ(-LIBCURVE_ERROR::FAILED, failctx.ret);
+    ASSERT_EQ(readctx.length, readctx.ret);
+
+    delete[] static_cast<char*>(writectx.buf);
+    delete[] static_cast<char*>(failctx.buf);
+    delete[] static_cast<char*>(readctx.buf);
+}
+
+TEST_F(IOTrackerSplitorTest, ManagerAsyncSubmitBatchScheduleFail) {
+    MockRequestScheduler* mockschuler = new MockRequestScheduler;
+    mockschuler->DelegateToFake();
+    mockschuler->EnableScheduleFailed();
+
+    auto ioctxmana = fileinstance_->GetIOManager4File();
+    ioctxmana->SetRequestScheduler(mockschuler);
+
+    const int count = 4;
+    CurveAioContext aioctx[count];
+    CurveAioContext* ctxs[count];
+    for (int i = 0; i < count; ++i) {
+        aioctx[i].offset = i * 64 * 1024;
+        aioctx[i].length = 64 * 1024;
+        aioctx[i].ret = LIBCURVE_ERROR::OK;
+        aioctx[i].cb = batchcallback;
+        aioctx[i].buf = new char[aioctx[i].length];
+        aioctx[i].op = i % 2 == 0 ? LIBCURVE_OP::LIBCURVE_OP_READ
+                                  : LIBCURVE_OP::LIBCURVE_OP_WRITE;
+        ctxs[i] = &aioctx[i];
+    }
+
+    ResetBatchCallbacks();
+    ASSERT_EQ(LIBCURVE_ERROR::OK,
+              ioctxmana->AioSubmitBatch(ctxs, count, &mdsclient_));
+    WaitBatchCallbacks(count);
+
+    // 下发失败时每个io都返回失败，并且只回调一次
+    ASSERT_EQ(count, batchCallbacks.size());
+    for (int i = 0; i < count; ++i) {
+        ASSERT_EQ(1, batchCallbacks[&aioctx[i]]);
+        ASSERT_EQ(-LIBCURVE_ERROR::FAILED, aioctx[i].ret);
+        delete[] static_cast<char*>(aioctx[i].buf);
+    }
+}
+
 /*
 TEST_F(IOTrackerSplitorTest, ManagerAsyncStartWriteReadGetSegmentFail) {
     MockRequestScheduler* mockschuler = new MockRequestScheduler;
@@ -810,6 +1032,107 @@ TEST_F(IOTrackerSplitorTest, largeIOTest) {
     delete[] buf;
 }
 
+TEST_F(IOTrackerSplitorTest, IOVecSplitTest) {
+    MockRequestScheduler mockschuler;
+    mockschuler.DelegateToFake();
+    /**
+     * 与largeIOTest相同的范围拆分成两个64k的request，
+     * 中间的iov跨越两个request
+     */
+    uint64_t length = 2 * 64 * 1024;
+    uint64_t offset = 4 * 1024 * 1024 - length;
+    char* head = new char[32 * 1024];
+    char* middle = new char[64 * 1024];
+    char* tail = new char[32 * 1024];
+    struct iovec iov[3];
+    iov[0].iov_base = head;
+    iov[0].iov_len = 32 * 1024;
+    iov[1].iov_base = middle;
+    iov[1].iov_len = 64 * 1024;
+    iov[2].iov_base = tail;
+    iov[2].iov_len = 32 * 1024;
+
+    FInfo_t fi;
+    fi.seqnum = 0;
+    fi.chunksize = 4 * 1024 * 1024;
+    fi.segmentsize = 1 * 1024 * 1024 * 1024ul;
+    curve::client::IOManager4File* iomana = fileinstance_->GetIOManager4File();
+    MetaCache* mc = fileinstance_->GetIOManager4File()->GetMetaCache();
+
+    IOTracker* iotracker = new IOTracker(iomana, mc, &mockschuler);
+    iotracker->SetOpType(OpType::WRITE);
+
+    curve::client::ChunkIDInfo chinfo(1, 2, 3);
+    mc->UpdateChunkInfoByIndex(0, chinfo);
+
+    // iov长度之和与length不一致
+    std::list<RequestContext*> reqlist;
+    ASSERT_EQ(-1, curve::client::Splitor::IOVec2ChunkRequests(iotracker, mc,
+                                                    &reqlist, iov, 3,
+                                                    offset, length - 4096,
+                                                    &mdsclient_, &fi));
+    ASSERT_EQ(-1, curve::client::Splitor::IOVec2ChunkRequests(iotracker, mc,
+                                                    &reqlist, nullptr, 3,
+                                                    offset, length,
+                                                    &mdsclient_, &fi));
+    ASSERT_TRUE(reqlist.empty());
+
+    ASSERT_EQ(0, curve::client::Splitor::IOVec2ChunkRequests(iotracker, mc,
+                                                    &reqlist, iov, 3,
+                                                    offset, length,
+                                                    &mdsclient_, &fi));
+    ASSERT_EQ(2, reqlist.size());
+
+    RequestContext* first = reqlist.front();
+    reqlist.pop_front();
+    RequestContext* second = reqlist.front();
+    reqlist.pop_front();
+
+    ASSERT_EQ(offset, first->offset_);
+    ASSERT_EQ(64 * 1024, first->rawlength_);
+    ASSERT_EQ(2, first->iov_.size());
+    ASSERT_EQ(head, first->iov_[0].iov_base);
+    ASSERT_EQ(32 * 1024, first->iov_[0].iov_len);
+    ASSERT_EQ(middle, first->iov_[1].iov_base);
+    ASSERT_EQ(32 * 1024, first->iov_[1].iov_len);
+    ASSERT_EQ(head, first->writeBuffer_);
+
+    ASSERT_EQ(4 * 1024 * 1024 - 64 * 1024, second->offset_);
+    ASSERT_EQ(64 * 1024, second->rawlength_);
+    ASSERT_EQ(2, second->iov_.size());
+    ASSERT_EQ(middle + 32 * 1024, second->iov_[0].iov_base);
+    ASSERT_EQ(32 * 1024, second->iov_[0].iov_len);
+    ASSERT_EQ(tail, second->iov_[1].iov_base);
+    ASSERT_EQ(32 * 1024, second->iov_[1].iov_len);
+    ASSERT_EQ(middle + 32 * 1024, second->writeBuffer_);
+
+    RequestContext::RecycleRequestContext(first);
+    RequestContext::RecycleRequestContext(second);
+
+    // 只有一段buffer时与连续IO一致，不记录iov_
+    char* buf = new char[length];
+    struct iovec single;
+    single.iov_base = buf;
+    single.iov_len = length;
+    ASSERT_EQ(0, curve::client::Splitor::IOVec2ChunkRequests(iotracker, mc,
+                                                    &reqlist, &single, 1,
+                                                    offset, length,
+                                                    &mdsclient_, &fi));
+    ASSERT_EQ(2, reqlist.size());
+    ASSERT_TRUE(reqlist.front()->iov_.empty());
+    ASSERT_EQ(buf, reqlist.front()->writeBuffer_);
+    ASSERT_EQ(buf + 64 * 1024, reqlist.back()->writeBuffer_);
+    for (auto req : reqlist) {
+        RequestContext::RecycleRequestContext(req);
+    }
+
+    delete iotracker;
+    delete[] buf;
+    delete[] head;
+    delete[] middle;
+    delete[] tail;
+}
+
 TEST_F(IOTrackerSplitorTest, InvalidParam) {
     uint64_t length = 2 * 64 * 1024;
     uint64_t offset = 4 * 1024 * 1024 - length;
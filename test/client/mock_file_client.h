@@ -43,6 +43,12 @@ class MockFileClient : public FileClient {
     MOCK_METHOD4(Write, int(int, const char*, off_t, size_t));
     MOCK_METHOD2(AioRead, int(int, CurveAioContext*));
     MOCK_METHOD2(AioWrite, int(int, CurveAioContext*));
+    MOCK_METHOD4(AioReadv, int(int, CurveAioContext*,
+                               const struct iovec*, int));
+    MOCK_METHOD4(AioWritev, int(int, CurveAioContext*,
+                                const struct iovec*, int));
+    MOCK_METHOD3(AioReadIOBuf, int(int, CurveAioContext*, butil::IOBuf*));
+    MOCK_METHOD3(AioSubmitBatch, int(int, CurveAioContext**, int));
     MOCK_METHOD3(StatFile, int(const std::string&,
                                const UserInfo_t&,
                                FileStatInfo*));
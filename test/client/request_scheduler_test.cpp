@@ -25,6 +25,9 @@
 #include <gmock/gmock.h>
 #include <brpc/channel.h>
 
+#include <list>
+#include <thread>  // NOLINT
+
 #include "src/client/request_scheduler.h"
 #include "src/client/client_common.h"
 #include "test/client/mock_meta_cache.h"
@@ -597,5 +600,72 @@ TEST(RequestSchedulerTest, CommonTest) {
     ASSERT_EQ(0, sche.Fini());
 }
 
+namespace {
+
+// 记录closure在哪个线程上被回调
+class ThreadRecordClosure : public FakeRequestClosure {
+ public:
+    ThreadRecordClosure(curve::common::CountDownEvent *cond,
+                        RequestContext *reqctx)
+        : FakeRequestClosure(cond, reqctx) {}
+
+    void Run() override {
+        runThread_ = std::this_thread::get_id();
+        FakeRequestClosure::Run();
+    }
+
+    std::thread::id runThread_;
+};
+
+}  // namespace
+
+TEST(RequestSchedulerTest, DirectDispatchTest) {
+    RequestScheduleOption opt;
+    opt.scheduleQueueCapacity = 4096;
+    opt.scheduleThreadpoolSize = 2;
+    opt.scheduleDirectDispatch = true;
+
+    RequestScheduler sche;
+    MetaCache metaCache;
+    FileMetric fm("direct_dispatch_test");
+    ASSERT_EQ(0, sche.Init(opt, &metaCache, &fm));
+    ASSERT_EQ(0, sche.Run());
+
+    // 未知类型的请求在下发时直接失败并回调，可以用来观察下发所在的线程
+    // 直接下发模式下，在提交请求的线程上完成下发
+    {
+        FakeRequestContext reqCtx;
+        reqCtx.optype_ = OpType::UNKNOWN;
+        curve::common::CountDownEvent cond(1);
+        ThreadRecordClosure done(&cond, &reqCtx);
+        reqCtx.done_ = &done;
+
+        uint64_t count = fm.scheduleQueueLatency.count();
+        std::list<RequestContext *> reqCtxs{&reqCtx};
+        ASSERT_EQ(0, sche.ScheduleRequest(reqCtxs));
+        cond.Wait();
+        ASSERT_EQ(std::this_thread::get_id(), done.runThread_);
+        ASSERT_EQ(-1, done.GetErrorCode());
+        ASSERT_EQ(count + 1, fm.scheduleQueueLatency.count());
+    }
+
+    // lease续约失败时，请求仍然进入队列由调度线程下发
+    {
+        sche.LeaseTimeoutBlockIO();
+        FakeRequestContext reqCtx;
+        reqCtx.optype_ = OpType::UNKNOWN;
+        curve::common::CountDownEvent cond(1);
+        ThreadRecordClosure done(&cond, &reqCtx);
+        reqCtx.done_ = &done;
+
+        ASSERT_EQ(0, sche.ScheduleRequest(&reqCtx));
+        sche.RefeshSuccAndResumeIO();
+        cond.Wait();
+        ASSERT_NE(std::this_thread::get_id(), done.runThread_);
+    }
+
+    ASSERT_EQ(0, sche.Fini());
+}
+
 }   // namespace client
 }   // namespace curve
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-18
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+
+#include <list>
+#include <thread>   // NOLINT
+#include <vector>
+
+#include "src/common/concurrent/bounded_blocking_queue.h"
+
+namespace curve {
+namespace common {
+
+TEST(BoundedBlockingDequeTest, BatchPutBackTest) {
+    BoundedBlockingDeque<BBQItem<int>> queue;
+    ASSERT_EQ(0, queue.Init(16));
+
+    std::list<int> items{1, 2, 3, 4};
+    queue.PutBack(items.begin(), items.end());
+    ASSERT_EQ(4, queue.Size());
+
+    // 批量放入的顺序与单个放入一致
+    queue.PutBack(BBQItem<int>(5));
+    for (int i = 1; i <= 5; ++i) {
+        ASSERT_EQ(i, queue.TakeFront().Item());
+    }
+    ASSERT_TRUE(queue.Empty());
+
+    // 空范围不做任何操作
+    queue.PutBack(items.end(), items.end());
+    ASSERT_TRUE(queue.Empty());
+}
+
+TEST(BoundedBlockingDequeTest, BatchPutBackWaitFullTest) {
+    BoundedBlockingDeque<BBQItem<int>> queue;
+    ASSERT_EQ(0, queue.Init(4));
+
+    // 批量放入的数量超过容量时，等待消费者取走后继续放入
+    std::vector<int> items;
+    for (int i = 0; i < 64; ++i) {
+        items.push_back(i);
+    }
+
+    std::vector<int> taken;
+    std::thread consumer([&]() {
+        for (int i = 0; i < 64; ++i) {
+            taken.push_back(queue.TakeFront().Item());
+        }
+    });
+
+    queue.PutBack(items.begin(), items.end());
+    consumer.join();
+
+    ASSERT_EQ(items, taken);
+    ASSERT_TRUE(queue.Empty());
+}
+
+}  // namespace common
+}  // namespace curve
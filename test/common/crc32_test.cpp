@@ -92,5 +92,22 @@ TEST(Crc32TEST, Extend) {
             CRC32(CRC32("hello ", 6), "world", 5));
 }
 
+TEST(Crc32TEST, IOBuf) {
+  char buf[8192];
+  for (size_t i = 0; i < sizeof(buf); i++) {
+    buf[i] = i % 251;
+  }
+  // 数据分散在多个block中
+  butil::IOBuf iobuf;
+  iobuf.append(buf, 100);
+  iobuf.append_user_data(buf + 100, 4000, [](void*) {});
+  iobuf.append(buf + 4100, sizeof(buf) - 4100);
+  ASSERT_GT(iobuf.backing_block_num(), 1);
+  ASSERT_EQ(CRC32(buf, sizeof(buf)), CRC32(0, iobuf));
+
+  butil::IOBuf empty;
+  ASSERT_EQ(CRC32(buf, 0), CRC32(0, empty));
+}
+
 }  // namespace common
 }  // namespace curve
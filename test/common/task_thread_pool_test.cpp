@@ -265,5 +265,45 @@ TEST(TaskThreadPool, basic) {
     }
 }
 
+TEST(TaskThreadPool, TryEnqueue) {
+    const int kQueueCapacity = 2;
+    CountDownEvent startRunCond(1);
+    CountDownEvent cond(1);
+    std::atomic<int32_t> runTaskCount;
+    runTaskCount.store(0, std::memory_order_release);
+
+    auto waitTask = [&] {
+        startRunCond.Signal();
+        cond.Wait();
+        runTaskCount.fetch_add(1, std::memory_order_acq_rel);
+    };
+    auto task = [&] {
+        runTaskCount.fetch_add(1, std::memory_order_acq_rel);
+    };
+
+    TaskThreadPool taskThreadPool;
+    ASSERT_EQ(0, taskThreadPool.Start(1, kQueueCapacity));
+
+    /* 卡住唯一的处理线程 */
+    ASSERT_TRUE(taskThreadPool.TryEnqueue(waitTask));
+    startRunCond.Wait();
+
+    /* queue 满了之后不阻塞，直接返回 false */
+    for (int i = 0; i < kQueueCapacity; ++i) {
+        ASSERT_TRUE(taskThreadPool.TryEnqueue(task));
+    }
+    ASSERT_FALSE(taskThreadPool.TryEnqueue(task));
+    ASSERT_EQ(kQueueCapacity, taskThreadPool.QueueSize());
+
+    cond.Signal();
+    while (runTaskCount.load(std::memory_order_acquire) < 1 + kQueueCapacity) {
+        ::usleep(10);
+    }
+    ASSERT_EQ(0, taskThreadPool.QueueSize());
+    ASSERT_TRUE(taskThreadPool.TryEnqueue(task));
+
+    taskThreadPool.Stop();
+}
+
 }  // namespace common
 }  // namespace curve
@@ -43,6 +43,7 @@ using ::testing::Return;
 using ::testing::ReturnArg;
 using ::testing::DoAll;
 using ::testing::SetArgPointee;
+using ::testing::Invoke;
 using curve::common::Authenticator;
 
 using curve::common::TimeUtility;
@@ -1621,6 +1622,151 @@ TEST_F(CurveFSTest, testGetOrAllocateSegment) {
     }
 }
 
+TEST_F(CurveFSTest, testGetOrAllocateSegments) {
+    FileInfo fileInfo1;
+    fileInfo1.set_filetype(FileType::INODE_DIRECTORY);
+
+    FileInfo fileInfo2;
+    fileInfo2.set_filetype(FileType::INODE_PAGEFILE);
+    fileInfo2.set_length(kMiniFileLength);
+    fileInfo2.set_segmentsize(DefaultSegmentSize);
+
+    // count为0
+    {
+        std::vector<PageFileSegment> segments;
+        ASSERT_EQ(curvefs_->GetOrAllocateSegments("/user1/file2",
+                  0, 0, false, &segments), StatusCode::kParaError);
+    }
+
+    // count超过一次请求的上限
+    {
+        std::vector<PageFileSegment> segments;
+        ASSERT_EQ(curvefs_->GetOrAllocateSegments("/user1/file2", 0,
+                  curvefs_->GetMaxSegmentsPerRequest() + 1, false, &segments),
+                  StatusCode::kParaError);
+    }
+
+    // 不分配时未分配的segment不返回
+    {
+        std::vector<PageFileSegment> segments;
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo1),
+                        Return(StoreStatus::OK)))
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo2),
+                        Return(StoreStatus::OK)));
+
+        EXPECT_CALL(*storage_, GetSegment(_, _, _))
+        .Times(3)
+        .WillOnce(Return(StoreStatus::OK))
+        .WillOnce(Return(StoreStatus::KeyNotExist))
+        .WillOnce(Return(StoreStatus::OK));
+
+        ASSERT_EQ(curvefs_->GetOrAllocateSegments("/user1/file2",
+                  0, 3, false, &segments), StatusCode::kOK);
+        ASSERT_EQ(2, segments.size());
+    }
+
+    // 超出文件长度的segment忽略
+    {
+        std::vector<PageFileSegment> segments;
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo1),
+                        Return(StoreStatus::OK)))
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo2),
+                        Return(StoreStatus::OK)));
+
+        EXPECT_CALL(*storage_, GetSegment(_, _, _))
+        .Times(1)
+        .WillOnce(Return(StoreStatus::KeyNotExist));
+
+        EXPECT_CALL(*mockChunkAllocator_, AllocateChunkSegment(_, _, _, _, _))
+        .Times(1)
+        .WillOnce(Return(true));
+
+        EXPECT_CALL(*storage_, PutSegment(_, _, _, _))
+        .Times(1)
+        .WillOnce(Return(StoreStatus::OK));
+
+        ASSERT_EQ(curvefs_->GetOrAllocateSegments("/user1/file2",
+                  kMiniFileLength - DefaultSegmentSize, 4, true, &segments),
+                  StatusCode::kOK);
+        ASSERT_EQ(1, segments.size());
+    }
+
+    // 第一个segment超出文件长度
+    {
+        std::vector<PageFileSegment> segments;
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo1),
+                        Return(StoreStatus::OK)))
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo2),
+                        Return(StoreStatus::OK)));
+
+        ASSERT_EQ(curvefs_->GetOrAllocateSegments("/user1/file2",
+                  kMiniFileLength, 2, true, &segments),
+                  StatusCode::kParaError);
+    }
+
+    // 分配失败
+    {
+        std::vector<PageFileSegment> segments;
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo1),
+                        Return(StoreStatus::OK)))
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo2),
+                        Return(StoreStatus::OK)));
+
+        EXPECT_CALL(*storage_, GetSegment(_, _, _))
+        .Times(2)
+        .WillOnce(Return(StoreStatus::OK))
+        .WillOnce(Return(StoreStatus::KeyNotExist));
+
+        EXPECT_CALL(*mockChunkAllocator_, AllocateChunkSegment(_, _, _, _, _))
+        .Times(1)
+        .WillOnce(Return(false));
+
+        ASSERT_EQ(curvefs_->GetOrAllocateSegments("/user1/file2",
+                  0, 3, true, &segments), StatusCode::kSegmentAllocateError);
+    }
+
+    // 1GB的segment，批量获取超过4个segment时偏移不能溢出
+    {
+        const uint32_t segmentSize = kGB;
+        const uint32_t count = 6;
+        FileInfo fileInfo3;
+        fileInfo3.set_filetype(FileType::INODE_PAGEFILE);
+        fileInfo3.set_length(8 * kGB);
+        fileInfo3.set_segmentsize(segmentSize);
+
+        std::vector<PageFileSegment> segments;
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo1),
+                        Return(StoreStatus::OK)))
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo3),
+                        Return(StoreStatus::OK)));
+
+        EXPECT_CALL(*storage_, GetSegment(_, _, _))
+        .Times(count)
+        .WillRepeatedly(Invoke([](InodeID id, uint64_t off,
+                                  PageFileSegment *segment) {
+            segment->set_startoffset(off);
+            return StoreStatus::OK;
+        }));
+
+        ASSERT_EQ(curvefs_->GetOrAllocateSegments("/user1/file2",
+                  kGB, count, false, &segments), StatusCode::kOK);
+        ASSERT_EQ(count, segments.size());
+        for (uint32_t i = 0; i < count; ++i) {
+            ASSERT_EQ((i + 1) * kGB, segments[i].startoffset());
+        }
+    }
+}
+
 TEST_F(CurveFSTest, testCreateSnapshotFile) {
     {
         // test client time not expired
@@ -24,6 +24,9 @@
 #include <gtest/gtest.h>
 #include <brpc/channel.h>
 #include <brpc/server.h>
+
+#include <vector>
+
 #include "src/mds/nameserver2/namespace_service.h"
 #include "src/mds/nameserver2/curvefs.h"
 #include "src/mds/nameserver2/chunk_allocator.h"
@@ -1741,6 +1744,93 @@ TEST_F(NameSpaceServiceTest, deletefiletests) {
     delete chunkService;
 }
 
+TEST_F(NameSpaceServiceTest, GetOrAllocateSegmentsTest) {
+    brpc::Server server;
+
+    // start server
+    NameSpaceService namespaceService(new FileLockManager(8));
+    ASSERT_EQ(server.AddService(&namespaceService,
+            brpc::SERVER_DOESNT_OWN_SERVICE), 0);
+
+    brpc::ServerOptions option;
+    option.idle_timeout_sec = -1;
+    ASSERT_EQ(0, server.Start("127.0.0.1", {8900, 8999}, &option));
+
+    // init client
+    brpc::Channel channel;
+    ASSERT_EQ(channel.Init(server.listen_address(), nullptr), 0);
+
+    CurveFSService_Stub stub(&channel);
+
+    brpc::Controller cntl;
+    CreateFileRequest createRequest;
+    CreateFileResponse createResponse;
+    createRequest.set_filename("/segfile");
+    createRequest.set_owner("owner1");
+    createRequest.set_date(TimeUtility::GetTimeofDayUs());
+    createRequest.set_filetype(INODE_PAGEFILE);
+    createRequest.set_filelength(kMiniFileLength);
+    stub.CreateFile(&cntl, &createRequest, &createResponse, NULL);
+    ASSERT_FALSE(cntl.Failed());
+    ASSERT_EQ(StatusCode::kOK, createResponse.statuscode());
+
+    const uint64_t segmentNum = kMiniFileLength / DefaultSegmentSize;
+    // 每页超过4个1GB的segment，按页获取时每个segment都只返回一次
+    const uint32_t pageSize = 6;
+    auto getSegments = [&](bool allocate, std::vector<PageFileSegment>* segs) {
+        for (uint64_t offset = 0; offset < kMiniFileLength;
+             offset += pageSize * DefaultSegmentSize) {
+            brpc::Controller cntl;
+            GetOrAllocateSegmentsRequest request;
+            GetOrAllocateSegmentsResponse response;
+            request.set_filename("/segfile");
+            request.set_owner("owner1");
+            request.set_date(TimeUtility::GetTimeofDayUs());
+            request.set_offset(offset);
+            request.set_count(pageSize);
+            request.set_allocateifnotexist(allocate);
+            stub.GetOrAllocateSegments(&cntl, &request, &response, NULL);
+            ASSERT_FALSE(cntl.Failed());
+            ASSERT_EQ(StatusCode::kOK, response.statuscode());
+            for (const auto& seg : response.pagefilesegments()) {
+                segs->push_back(seg);
+            }
+        }
+    };
+
+    std::vector<PageFileSegment> allocated;
+    getSegments(true, &allocated);
+    ASSERT_EQ(segmentNum, allocated.size());
+
+    std::vector<PageFileSegment> segments;
+    getSegments(false, &segments);
+    ASSERT_EQ(segmentNum, segments.size());
+    for (uint64_t i = 0; i < segmentNum; ++i) {
+        ASSERT_EQ(i * DefaultSegmentSize, allocated[i].startoffset());
+        ASSERT_EQ(allocated[i].SerializeAsString(),
+                  segments[i].SerializeAsString());
+        ASSERT_EQ(DefaultSegmentSize / curveFSOptions.defaultChunkSize,
+                  static_cast<uint64_t>(segments[i].chunks_size()));
+    }
+
+    // count超过上限
+    cntl.Reset();
+    GetOrAllocateSegmentsRequest request;
+    GetOrAllocateSegmentsResponse response;
+    request.set_filename("/segfile");
+    request.set_owner("owner1");
+    request.set_date(TimeUtility::GetTimeofDayUs());
+    request.set_offset(0);
+    request.set_count(kCurveFS.GetMaxSegmentsPerRequest() + 1);
+    request.set_allocateifnotexist(false);
+    stub.GetOrAllocateSegments(&cntl, &request, &response, NULL);
+    ASSERT_FALSE(cntl.Failed());
+    ASSERT_EQ(StatusCode::kParaError, response.statuscode());
+
+    server.Stop(10);
+    server.Join();
+}
+
 TEST_F(NameSpaceServiceTest, isPathValid) {
     // start server
     NameSpaceService namespaceService(new FileLockManager(8));